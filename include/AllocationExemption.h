@@ -0,0 +1,39 @@
+#ifndef ALLOCATION_EXEMPTION_H
+#define ALLOCATION_EXEMPTION_H
+
+namespace DriveGuard {
+
+    /**
+     * @brief 当前线程的分配是否计入稳态分配检查
+     * DriveGuardBench 只统计处理帧的线程：基准线程自身，以及执行 parallelFor 任务体期间沿用其标记的工作线程；
+     * 事件录制、模型录入等后台线程的分配不计入。
+     */
+    inline thread_local bool allocationTracked = false;
+
+    /**
+     * @brief 当前线程是否处于稳态分配检查的豁免区
+     * DriveGuardBench 统计每帧堆分配时，豁免区内的分配单独计数，不计入上限。
+     */
+    inline thread_local bool allocationExempt = false;
+
+    /**
+     * @brief 稳态分配检查的豁免区（作用域内有效）
+     * 只用于一次性的延迟初始化：首次使用时创建的线程、线程局部缓冲区或分类器副本，
+     * 初始化完成后同一路径不再分配。逐帧都会发生的分配不得豁免，应改为复用缓冲区。
+     * 开销为一次线程局部变量的读写。
+     */
+    class AllocationExemption {
+    public:
+        AllocationExemption() : previous_(allocationExempt) { allocationExempt = true; }
+        ~AllocationExemption() { allocationExempt = previous_; }
+
+        AllocationExemption(const AllocationExemption&) = delete;
+        AllocationExemption& operator=(const AllocationExemption&) = delete;
+
+    private:
+        bool previous_;
+    };
+
+} // namespace DriveGuard
+
+#endif // ALLOCATION_EXEMPTION_H
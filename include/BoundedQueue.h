@@ -0,0 +1,147 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace DriveGuard {
+
+    /**
+     * @brief 有界阻塞队列（丢弃最旧策略）
+     * 用于连接流水线各阶段：生产者永不阻塞，队列满时丢弃最旧的元素，
+     * 保证下游始终处理最新的帧，避免延迟无限累积。
+     * 元素存放在构造时分配的环形缓冲区中，入队出队不再分配内存（元素须可默认构造）
+     */
+    template <typename T>
+    class BoundedQueue {
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 队列容量（至少为 1）
+         */
+        explicit BoundedQueue(std::size_t capacity)
+            : capacity_(capacity > 0 ? capacity : 1), closed_(false), slots_(capacity_), head_(0), count_(0) {}
+
+        /**
+         * @brief 入队，队列满时丢弃最旧元素
+         * @param item 待入队元素
+         * @param evicted 非空时接收被丢弃的元素（供调用方回收其缓冲区）
+         * @return 本次被丢弃的元素个数（0 或 1）
+         */
+        std::size_t push(T item, T* evicted = nullptr) {
+            std::size_t dropped = 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (closed_) return 0;
+                if (count_ >= capacity_) {
+                    T& oldest = slots_[head_];
+                    if (evicted) *evicted = std::move(oldest);
+                    head_ = (head_ + 1) % capacity_;
+                    count_--;
+                    dropped = 1;
+                }
+                slots_[(head_ + count_) % capacity_] = std::move(item);
+                count_++;
+            }
+            notEmpty_.notify_one();
+            return dropped;
+        }
+
+        /**
+         * @brief 入队，队列满时阻塞等待（背压模式，用于离线回放等不允许丢帧的场景）
+         * @param item 待入队元素
+         * @return 队列已关闭返回 false
+         */
+        bool pushWait(T item) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                notFull_.wait(lock, [this] { return closed_ || count_ < capacity_; });
+                if (closed_) return false;
+                slots_[(head_ + count_) % capacity_] = std::move(item);
+                count_++;
+            }
+            notEmpty_.notify_one();
+            return true;
+        }
+
+        /**
+         * @brief 出队，队列为空时阻塞等待
+         * @param item 输出元素
+         * @return 成功取出返回 true；队列已关闭且为空返回 false
+         */
+        bool pop(T& item) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            notEmpty_.wait(lock, [this] { return closed_ || count_ > 0; });
+            if (count_ == 0) return false;
+            take(item);
+            lock.unlock();
+            notFull_.notify_one();
+            return true;
+        }
+
+        /**
+         * @brief 非阻塞出队
+         * @param item 输出元素
+         * @return 队列为空时返回 false
+         */
+        bool tryPop(T& item) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (count_ == 0) return false;
+            take(item);
+            lock.unlock();
+            notFull_.notify_one();
+            return true;
+        }
+
+        /**
+         * @brief 队列是否已关闭且为空（不会再有新元素）
+         */
+        bool finished() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return closed_ && count_ == 0;
+        }
+
+        /**
+         * @brief 关闭队列，唤醒所有等待的消费者
+         */
+        void close() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                closed_ = true;
+            }
+            notEmpty_.notify_all();
+            notFull_.notify_all();
+        }
+
+        /**
+         * @brief 当前队列长度
+         */
+        std::size_t size() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return count_;
+        }
+
+    private:
+        // 取出队首元素（须持有锁）
+        void take(T& item) {
+            item = std::move(slots_[head_]);
+            head_ = (head_ + 1) % capacity_;
+            count_--;
+        }
+
+        const std::size_t capacity_;
+        bool closed_;
+        std::vector<T> slots_;   // 环形缓冲区
+        std::size_t head_;       // 队首下标
+        std::size_t count_;      // 元素个数
+        mutable std::mutex mutex_;
+        std::condition_variable notEmpty_;
+        std::condition_variable notFull_;
+    };
+
+} // namespace DriveGuard
+
+#endif // BOUNDED_QUEUE_H
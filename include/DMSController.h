@@ -2,7 +2,9 @@
 #define DMS_CONTROLLER_H
 
 #include <opencv2/opencv.hpp>
+#include <chrono>
 #include <string>
+#include <vector>
 
 namespace DriveGuard {
 
@@ -12,10 +14,36 @@ namespace DriveGuard {
         SLEEPING // 睡眠
     };
 
+    /**
+     * @brief 疲劳判定配置（均按时间计，与帧率无关）
+     */
+    struct DMSConfig {
+        int fatigueMs = 1500;           // 连续闭眼（未检测到眼睛）超过该时长判定疲劳
+        int sleepingMs = 3000;          // 连续闭眼超过该时长判定睡眠
+        int perclosWindowMs = 30000;    // PERCLOS 滑动窗口时长
+        int perclosBuckets = 60;        // 滑动窗口的环形分桶数
+        double perclosThreshold = 0.4;  // 窗口内闭眼时间占比达到该值判定疲劳（<=0 关闭）
+        int maxGapMs = 500;             // 相邻两次观测之间最多计入 PERCLOS 的时长（长间隔不计入观测与闭眼时长）
+        int trackTimeoutMs = 2000;      // 轨迹超过该时长未更新则丢弃其状态；间隔不超过该时长且前后均闭眼时，
+                                        // 连续闭眼计时跨越间隔继续（低头时人脸短暂丢失或降载丢帧不会打断睡眠判定）
+    };
+
+    /**
+     * @brief 疲劳监测控制器（每条驾驶员人脸轨迹一个实例）
+     * 以帧采集时间戳驱动：连续闭眼时长决定疲劳/睡眠，另以固定分桶的环形缓冲
+     * 统计滑动窗口内的闭眼时间占比（PERCLOS），每次更新 O(1)、内存固定。
+     * 丢帧或跳帧只会让观测变稀疏，不影响时间判定：连续闭眼以前后两次闭眼观测的时间戳计算，
+     * 只有间隔超过 trackTimeoutMs 才重新起算。
+     */
     class DMSController {
     public:
-        // 构造函数
-        DMSController();
+        using TimePoint = std::chrono::steady_clock::time_point;
+
+        /**
+         * @brief 构造函数
+         * @param config 疲劳判定配置
+         */
+        explicit DMSController(const DMSConfig& config = DMSConfig());
 
         // 析构函数
         ~DMSController();
@@ -23,9 +51,9 @@ namespace DriveGuard {
         /**
          * @brief 更新驾驶员状态
          * @param getsEyes 是否检测到眼睛
-         * @param fps 当前帧率（用于计算时间）
+         * @param time 该帧的采集时间戳（须单调不减）
          */
-        void update(bool getsEyes, double fps);
+        void update(bool getsEyes, TimePoint time);
 
         /**
          * @brief 获取当前警告信息
@@ -42,13 +70,60 @@ namespace DriveGuard {
          */
         bool isFatigueOrSleeping();
 
+        /**
+         * @brief 获取当前驾驶员状态
+         */
+        DriverState getState() const;
+
+        /**
+         * @brief 当前连续闭眼时长（毫秒）
+         */
+        double closedMs() const;
+
+        /**
+         * @brief 滑动窗口内的闭眼时间占比（窗口内观测不足一半时返回 0）
+         */
+        double perclos() const;
+
+        /**
+         * @brief 最近一次更新的时间
+         */
+        TimePoint lastUpdate() const;
+
+        /**
+         * @brief 获取指定状态对应的警告信息
+         */
+        static const char* warningOf(DriverState state);
+
+        /**
+         * @brief 获取指定状态对应的颜色 (绿/黄/红)
+         */
+        static cv::Scalar colorOf(DriverState state);
+
     private:
-        const int FATIGUE_THRESHOLD_ = 10; // 疲劳阈值
-        const int SLEEPING_THRESHOLD_ = 30; // 睡眠阈值
+        // 滑动窗口的一个时间桶
+        struct Bucket {
+            double observedMs = 0.0; // 桶内观测到的时长
+            double closedMs = 0.0;   // 其中闭眼的时长
+        };
+
+        void advanceTo(long long bucketIndex);
+
+        DMSConfig config_;
+        double bucketMs_;               // 每个桶覆盖的时长
+        std::vector<Bucket> buckets_;   // 环形缓冲
+        long long headIndex_;           // 最新桶的绝对序号（自第一次观测起）
+        double observedMs_;             // 窗口内观测时长之和
+        double windowClosedMs_;         // 窗口内闭眼时长之和
 
-        int NoEyesCount_; // 连续未检测到眼睛的帧数
-        DriverState currentState_; //  驾驶员当前状态
+        bool started_;                  // 是否已有观测
+        TimePoint origin_;              // 第一次观测的时间（桶序号的零点）
+        TimePoint last_;                // 上一次观测的时间
+        bool closed_;                   // 当前是否处于连续闭眼
+        TimePoint closedSince_;         // 本次连续闭眼的开始时间
+        double closedMs_;               // 当前连续闭眼时长
+        DriverState currentState_;      // 驾驶员当前状态
     };
 }
 
-#endif
\ No newline at end of file
+#endif
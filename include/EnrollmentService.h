@@ -0,0 +1,111 @@
+#ifndef ENROLLMENT_SERVICE_H
+#define ENROLLMENT_SERVICE_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FaceRecognizer.h"
+#include "SampleSelector.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 一次录入任务（分析线程采集的样本与用户信息）
+     */
+    struct EnrollmentJob {
+        std::vector<cv::Mat> images;        // 统一尺寸的灰度人脸样本
+        std::vector<double> scores;         // 采集时的质量评分（与 images 一一对应）
+        int label = -1;                     // 分配的标签
+        std::string name;                   // 用户姓名
+        UserRole role = UserRole::UNKNOWN;  // 用户角色
+    };
+
+    /**
+     * @brief 后台录入服务
+     * 识别器以读-复制-更新（RCU）方式发布：分析线程每帧取一次当前模型快照，
+     * 后台线程复制快照后在副本上训练、保存模型与映射表，完成后原子替换已发布的模型。
+     * 已发布的识别器不再被后台线程修改，旧快照在最后一个持有者释放后析构。
+     * 训练前先由 SampleSelector 剔除近似重复的样本，只保留少量差异较大的样本写入图库。
+     * 同一时刻只处理一个录入任务。
+     */
+    class EnrollmentService {
+    public:
+        /**
+         * @brief 构造函数
+         * @param recognizer 初始模型
+         * @param modelPath 识别模型保存路径
+         * @param labelInfoPath ID-Name 映射表保存路径
+         * @param selector 录入样本筛选配置
+         */
+        EnrollmentService(std::shared_ptr<FaceRecognizer> recognizer, const std::string& modelPath,
+                          const std::string& labelInfoPath,
+                          const SampleSelectorConfig& selector = SampleSelectorConfig());
+
+        /**
+         * @brief 析构函数（等待进行中的任务完成后停止后台线程）
+         */
+        ~EnrollmentService();
+
+        EnrollmentService(const EnrollmentService&) = delete;
+        EnrollmentService& operator=(const EnrollmentService&) = delete;
+
+        /**
+         * @brief 启动后台线程
+         */
+        void start();
+
+        /**
+         * @brief 停止后台线程（已提交的任务会先完成并保存）
+         */
+        void stop();
+
+        /**
+         * @brief 当前已发布的模型（线程安全）
+         * 调用方在一帧内应持有同一快照，且不得修改它。
+         */
+        std::shared_ptr<FaceRecognizer> current() const;
+
+        /**
+         * @brief 已发布模型的版本号（每次发布加一）
+         */
+        uint64_t version() const;
+
+        /**
+         * @brief 提交录入任务（线程安全）
+         * @return 已有任务在排队或训练中时返回 false
+         */
+        bool submit(EnrollmentJob job);
+
+        /**
+         * @brief 是否有任务在排队或训练中
+         */
+        bool busy() const;
+
+    private:
+        void run();
+        void process(EnrollmentJob& job);
+
+        std::shared_ptr<FaceRecognizer> recognizer_; // 已发布的模型（经 std::atomic_load/store 访问）
+        std::atomic<uint64_t> version_;
+        std::string modelPath_;
+        std::string labelInfoPath_;
+        SampleSelector selector_;  // 仅由后台线程访问
+
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool hasJob_;
+        bool running_;
+        EnrollmentJob job_;
+        std::atomic<bool> busy_;
+        std::thread thread_;
+    };
+
+} // namespace DriveGuard
+
+#endif // ENROLLMENT_SERVICE_H
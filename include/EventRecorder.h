@@ -0,0 +1,157 @@
+#ifndef EVENT_RECORDER_H
+#define EVENT_RECORDER_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FramePacket.h"
+#include "SpscRing.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 事件类型
+     */
+    enum class EventType : uint8_t {
+        DRIVER_STATE = 1,    // 驾驶员疲劳状态切换（state 为 DriverState）
+        IDENTITY = 2,        // 轨迹的识别身份变化（state 为 UserRole）
+        UNKNOWN_PERSON = 3   // 轨迹被判定为未登记人员
+    };
+
+    /**
+     * @brief 二进制事件记录（32 字节，按主机字节序写入 events.bin）
+     */
+    struct EventRecord {
+        int64_t timeUs;       // 帧采集时刻（Unix 时间，微秒）
+        uint64_t frameSeq;    // 帧序号
+        uint8_t type;         // EventType
+        uint8_t state;        // DriverState 或 UserRole
+        uint16_t reserved;
+        int32_t trackId;      // 人脸轨迹编号
+        int32_t label;        // 识别标签（-1 为未登记人员）
+        float confidence;     // 识别置信度
+    };
+    static_assert(sizeof(EventRecord) == 32, "EventRecord 须为 32 字节");
+
+    /**
+     * @brief 事件与告警片段记录配置
+     */
+    struct EventRecorderConfig {
+        std::string directory;          // 输出目录（events.bin 与各告警片段子目录）
+        int preAlertMs = 5000;          // 告警前保留的帧时长
+        int postAlertMs = 3000;         // 告警后继续录制的帧时长
+        std::size_t frameSlots = 8;     // 待编码帧的环形缓冲区槽位数（满时丢弃新帧）
+        double borrowedScale = 0.5;     // 借用缓冲区的帧（V4L2、帧总线）拷贝时的缩小比例
+        std::size_t eventSlots = 256;   // 待写入事件的环形缓冲区槽位数（满时丢弃新事件）
+        int jpegQuality = 80;           // 片段帧的 JPEG 质量
+    };
+
+    /**
+     * @brief 异步事件日志与告警片段记录器
+     * 分析线程通过两个单生产者单消费者无锁环形缓冲区提交帧与事件：自有的帧缓冲区只增加引用计数
+     * （帧池在记录器释放前不会复用该缓冲区），借用的驱动缓冲区须尽快归还，按 borrowedScale 缩小后
+     * 拷入槽位中复用的缓冲区；事件为定长记录。提交均不加锁、不分配内存、不做磁盘 I/O，
+     * 缓冲区满时直接丢弃并计入指标。
+     * 后台写线程负责全分辨率帧的 JPEG 编码（编码后即释放对帧的引用）、保留最近 preAlertMs 的已编码帧，
+     * 并将事件追加写入 events.bin；
+     * 驾驶员进入 FATIGUE 或 SLEEPING 时，把告警前保留的帧与告警后 postAlertMs 内的帧写入
+     * 独立的片段目录（按帧序号命名的 JPEG 序列，可直接作为 --input 回放）。
+     * 每路摄像头各持有一个实例，生产端由该路的分析阶段串行调用。
+     */
+    class EventRecorder {
+    public:
+        /**
+         * @brief 构造函数
+         * @param config 记录配置
+         */
+        explicit EventRecorder(const EventRecorderConfig& config);
+
+        /**
+         * @brief 析构函数（写完剩余事件与帧后停止后台线程）
+         */
+        ~EventRecorder();
+
+        EventRecorder(const EventRecorder&) = delete;
+        EventRecorder& operator=(const EventRecorder&) = delete;
+
+        /**
+         * @brief 创建输出目录并启动后台写线程
+         * @return 目录或事件文件无法创建时返回 false
+         */
+        bool start();
+
+        /**
+         * @brief 写完剩余事件与帧（含进行中的片段）后停止后台写线程
+         */
+        void stop();
+
+        /**
+         * @brief 提交一帧（分析线程调用，不阻塞）
+         * 自有帧以引用方式提交：调用方在编码完成前不得原地改写该帧（FramePool 与 OverlayRenderer 会检查引用）。
+         * @param packet 已分析的帧数据包
+         */
+        void recordFrame(const FramePacket& packet);
+
+        /**
+         * @brief 提交一条事件（分析线程调用，不阻塞）
+         * @param type 事件类型
+         * @param packet 事件所在的帧
+         * @param result 事件对应的人脸结果
+         */
+        void recordEvent(EventType type, const FramePacket& packet, const FaceResult& result);
+
+    private:
+        // 待编码的帧
+        struct FrameSlot {
+            cv::Mat shared;        // 共享引用的自有帧（编码后释放）
+            cv::Mat scaled;        // 借用帧的缩小拷贝（逐帧复用）
+            bool borrowed = false; // 编码 scaled 而非 shared
+            uint64_t seq = 0;
+            Clock::time_point time;
+        };
+
+        // 待写入的事件（附带帧采集时间，用于计算片段截止时间）
+        struct PendingEvent {
+            EventRecord record{};
+            Clock::time_point time;
+        };
+
+        // 已编码的帧（仅由写线程访问）
+        struct EncodedFrame {
+            uint64_t seq;
+            Clock::time_point time;
+            std::vector<unsigned char> jpeg;
+        };
+
+        void run();
+        bool drain();
+        void writeEvent(const PendingEvent& event);
+        void encodeFrame(FrameSlot& slot);
+        void openClip(const PendingEvent& event);
+        void closeClip();
+        void writeClipFrame(const EncodedFrame& frame);
+
+        EventRecorderConfig config_;
+        SpscRing<FrameSlot> frames_;
+        SpscRing<PendingEvent> events_;
+        std::atomic<bool> running_;
+        std::thread thread_;
+
+        // 以下仅由写线程访问
+        std::ofstream eventFile_;
+        std::deque<EncodedFrame> history_;   // 最近 preAlertMs 的已编码帧
+        std::vector<int> jpegParams_;
+        std::string clipDirectory_;          // 进行中的片段目录（为空表示未在录制）
+        Clock::time_point clipUntil_;        // 片段录制的截止帧时间
+        uint64_t clipLastSeq_;               // 已写入片段的最后一帧序号
+        std::size_t clipFrames_;             // 进行中的片段已写入的帧数
+    };
+
+} // namespace DriveGuard
+
+#endif // EVENT_RECORDER_H
@@ -0,0 +1,98 @@
+#ifndef EYE_TRACKER_H
+#define EYE_TRACKER_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "FaceDetector.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 眼部定位配置
+     */
+    struct EyeTrackerConfig {
+        bool enabled = true;          // 是否在级联检测之间以模板匹配跟踪眼睛（关闭则每帧级联检测）
+        int redetectInterval = 5;     // 级联检测周期（帧）
+        double bandTop = 0.15;        // 搜索带上沿（相对人脸高度）
+        double bandBottom = 0.6;      // 搜索带下沿（相对人脸高度，排除嘴部与下巴）
+        double minEyeRatio = 0.12;    // 最小眼睛尺寸（相对人脸宽度）
+        double maxEyeRatio = 0.4;     // 最大眼睛尺寸（相对人脸宽度）
+        double searchPadding = 0.3;   // 模板匹配窗口相对眼睛尺寸的外扩比例（每侧）
+        double matchThreshold = 0.75; // 模板匹配的最低归一化相关系数（闭眼时低于该值，回退级联检测）
+        int maxIdleFrames = 30;       // 轨迹连续未出现超过该帧数则丢弃其眼睛状态
+    };
+
+    /**
+     * @brief 几何约束与帧间跟踪的眼部定位
+     * 级联检测只在人脸上部的水平带内进行，眼睛尺寸范围由人脸宽度推算，避免嘴部与下巴的误检；
+     * 两次级联检测之间，按人脸轨迹以上次检出的眼睛模板在原位置附近做模板匹配。
+     * 模板只在级联检出（睁眼）时更新，闭眼时匹配度下降即回退级联检测，不会掩盖闭眼。
+     * 眼睛位置以相对人脸框的比例保存，人脸框移动或缩放时随之变换。
+     * 模板统一缩放为固定尺寸保存，匹配时将搜索窗口按同一比例缩放后计算归一化相关系数
+     * （与 cv::TM_CCOEFF_NORMED 定义相同），匹配代价与人脸尺寸无关；
+     * 模板、缩放窗口与批量定位的状态表均为逐帧复用的缓冲区。
+     */
+    class EyeTracker {
+    public:
+        /**
+         * @brief 构造函数
+         * @param detector 人脸检测器（提供眼睛级联分类器）
+         * @param config 眼部定位配置
+         */
+        EyeTracker(FaceDetector& detector, const EyeTrackerConfig& config);
+
+        /**
+         * @brief 开始新的一帧（推进帧计数并丢弃长期未出现的轨迹）
+         */
+        void advance();
+
+        /**
+         * @brief 定位单张人脸的眼睛
+         * @param face 人脸样本
+         * @param eyes 输出的眼睛矩形框列表（相对人脸区域，复用已有容量）
+         */
+        void detect(const FaceSample& face, std::vector<cv::Rect>& eyes);
+
+        /**
+         * @brief 批量定位（多张人脸并行，轨迹编号须各不相同）
+         * @param faces 人脸样本
+         * @param eyes 输出的各人脸眼睛矩形框列表（相对人脸区域），与 faces 一一对应（复用已有容量）
+         */
+        void detectBatch(const std::vector<const FaceSample*>& faces, std::vector<std::vector<cv::Rect>>& eyes);
+
+    private:
+        // 单张人脸最多保留的眼睛数
+        static constexpr int MAX_EYES = 2;
+
+        // 单只眼睛：相对人脸框的位置与级联检出时的模板
+        struct Eye {
+            cv::Rect2d relative;   // 相对人脸框的位置（比例）
+            cv::Mat templ;         // 级联检出时的均衡化灰度模板（固定尺寸，逐次覆盖）
+        };
+
+        // 单条人脸轨迹的眼睛状态（眼睛数组定长，闭眼时清零计数而不释放模板）
+        struct State {
+            Eye eyes[MAX_EYES];
+            int eyeCount = 0;
+            int framesSinceCascade = 0;
+            uint64_t lastSeen = 0;
+            cv::Mat window;        // 按模板比例缩放的搜索窗口（定长缓冲区，按实际尺寸取左上角区域）
+        };
+
+        void locate(const FaceSample& face, State& state, std::vector<cv::Rect>& eyes);
+        bool track(const FaceSample& face, State& state, std::vector<cv::Rect>& eyes);
+        void cascade(const FaceSample& face, State& state, std::vector<cv::Rect>& eyes);
+
+        FaceDetector& detector_;
+        EyeTrackerConfig config_;
+        std::unordered_map<int, State> states_; // 人脸轨迹编号 -> 眼睛状态
+        std::vector<State*> batchStates_;       // 批量定位时各人脸的状态
+        std::vector<State> scratch_;            // 无轨迹人脸的临时状态
+        uint64_t frameIndex_;
+    };
+
+} // namespace DriveGuard
+
+#endif // EYE_TRACKER_H
@@ -2,15 +2,34 @@
 #define FACE_DETECTOR_H
 
 #include <opencv2/opencv.hpp>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
+#include "FrameContext.h"
+#include "HaarCascade.h"
 
 namespace DriveGuard {
 
+    /**
+     * @brief 级联检测后端
+     */
+    enum class CascadeBackend {
+        AUTO,      // 构建包含编译级联时使用编译级联，否则读取 XML 模型
+        OPENCV,    // cv::CascadeClassifier 读取 XML 模型（可替换为自定义模型）
+        COMPILED   // 编译期生成的级联表与专用检测器（不读取模型文件）
+    };
+
     /**
      * @brief 人脸检测器类
-     * 封装了OpenCV的级联分类器，用于实现人脸检测功能
+     * 封装了OpenCV的级联分类器，用于实现人脸检测功能。
+     * 模型文件只读取一次并保存在内存中；cv::CascadeClassifier 检测时会修改内部缓冲区，
+     * 因此每个调用线程从内存中解析一份自己的分类器副本（存放在线程局部存储中，首次使用时创建，
+     * 线程退出时释放），检测时不加锁；同一实例可被多路摄像头、多个线程并发调用，
+     * 内存随存活的线程数而非摄像头数增长。
+     * 构建时生成了编译级联（DRIVEGUARD_COMPILED_CASCADES）时默认改用 HaarCascade，
+     * 检测结果相同，且无需读取与解析模型文件、不再为每个线程复制分类器。
+     * 逐帧调用的接口将结果写入调用方的容器（先清空），容器容量逐帧复用。
      */
     class FaceDetector {
     public:
@@ -18,8 +37,10 @@ namespace DriveGuard {
          * @brief 构造函数
          * @param faceModelPath 人脸识别模型的路径
          * @param eyeModelPath 眼睛识别模型的路径
+         * @param backend 级联检测后端（使用编译级联时不读取上述模型文件）
          */
-        explicit FaceDetector(const std::string& modelPath, const std::string& eyeModelPath);
+        explicit FaceDetector(const std::string& modelPath, const std::string& eyeModelPath,
+                              CascadeBackend backend = CascadeBackend::AUTO);
 
         /**
          * @brief 析构函数
@@ -32,6 +53,26 @@ namespace DriveGuard {
          */
         bool isModelLoaded() const;
 
+        /**
+         * @brief 实际使用的级联检测后端
+         */
+        CascadeBackend backend() const;
+
+        /**
+         * @brief 构建是否包含编译级联
+         */
+        static bool hasCompiledCascades();
+
+        /**
+         * @brief 解析后端名称（auto、opencv、compiled）
+         */
+        static bool parseBackend(const std::string& name, CascadeBackend& backend);
+
+        /**
+         * @brief 后端名称
+         */
+        static const char* backendName(CascadeBackend backend);
+
         /**
          * @brief 检测图像中的人脸
          * @param frame 输入的图像帧
@@ -39,6 +80,25 @@ namespace DriveGuard {
          */
         std::vector<cv::Rect> detect(const cv::Mat& frame);
 
+        /**
+         * @brief 在已预处理的帧中检测人脸（直接使用帧上下文中的均衡化灰度图）
+         * @param context 帧预处理上下文
+         * @param faces 输出的人脸矩形框列表（帧坐标）
+         * @param scale 检测分辨率相对原帧的比例（<1 时缩小后检测，降载时使用）
+         */
+        void detect(const FrameContext& context, std::vector<cv::Rect>& faces, double scale = 1.0);
+
+        /**
+         * @brief 仅在指定区域内检测人脸（用于跟踪模式的局部搜索）
+         * @param context 帧预处理上下文
+         * @param region 搜索区域（帧坐标，越界部分自动裁剪）
+         * @param minSize 最小人脸尺寸
+         * @param maxSize 最大人脸尺寸
+         * @param faces 输出的人脸矩形框列表（帧坐标）
+         */
+        void detectInRegion(const FrameContext& context, const cv::Rect& region, const cv::Size& minSize,
+                            const cv::Size& maxSize, std::vector<cv::Rect>& faces);
+
         /**
          * @brief 在给定的人脸区域中检测眼睛
          * @param faceROI 人脸区域矩形框
@@ -46,11 +106,54 @@ namespace DriveGuard {
          */
         std::vector<cv::Rect> detectEyes(const cv::Mat& faceROI);
 
+        /**
+         * @brief 在人脸样本中检测眼睛（直接使用样本的均衡化灰度区域）
+         * @param face 人脸样本
+         * @param eyes 输出的眼睛矩形框列表（相对人脸区域，复用已有容量）
+         */
+        void detectEyes(const FaceSample& face, std::vector<cv::Rect>& eyes);
+
+        /**
+         * @brief 仅在人脸的指定区域内以给定尺寸范围检测眼睛（用于几何约束的眼部定位）
+         * @param face 人脸样本
+         * @param region 搜索区域（相对人脸区域，越界部分自动裁剪）
+         * @param minSize 最小眼睛尺寸
+         * @param maxSize 最大眼睛尺寸
+         * @param eyes 输出的眼睛矩形框列表（相对人脸区域）
+         */
+        void detectEyesInRegion(const FaceSample& face, const cv::Rect& region, const cv::Size& minSize,
+                                const cv::Size& maxSize, std::vector<cv::Rect>& eyes);
+
+        /**
+         * @brief 批量眼部检测（多张人脸并行检测）
+         * @param faces 人脸样本
+         * @param eyes 输出的各人脸眼睛矩形框列表（相对人脸区域），与 faces 一一对应（复用已有容量）
+         */
+        void detectEyesBatch(const std::vector<const FaceSample*>& faces, std::vector<std::vector<cv::Rect>>& eyes);
+
     private:
-        // 使用智能指针虽然对于cv::CascadeClassifier不是必须的（它自己管理内存），
-        // 但这里为了演示现代C++内存管理风格而使用
-        std::unique_ptr<cv::CascadeClassifier> classifier_;
-        std::unique_ptr<cv::CascadeClassifier> eyeClassifier_;
+        // 单个线程使用的级联分类器副本（按需创建）
+        struct Cascades {
+            std::unique_ptr<cv::CascadeClassifier> face;
+            std::unique_ptr<cv::CascadeClassifier> eye;
+        };
+
+        void runFaceCascade(const cv::Mat& image, std::vector<cv::Rect>& faces, const cv::Size& minSize,
+                            const cv::Size& maxSize = cv::Size());
+        void runEyeCascade(const cv::Mat& grayROI, std::vector<cv::Rect>& eyes,
+                           const cv::Size& minSize = cv::Size(15, 15), const cv::Size& maxSize = cv::Size());
+        Cascades& localCascades();
+        cv::CascadeClassifier& faceClassifier();
+        cv::CascadeClassifier& eyeClassifier();
+        static bool readFile(const std::string& path, std::string& content);
+        static std::unique_ptr<cv::CascadeClassifier> parse(const std::string& xml);
+
+        std::string faceXml_;   // 人脸级联模型文件内容（只读）
+        std::string eyeXml_;    // 眼睛级联模型文件内容（只读）
+        uint64_t instanceId_;   // 实例编号（线程局部的分类器副本按此区分，不复用）
+        CascadeBackend backend_;
+        std::unique_ptr<HaarCascade> compiledFace_; // 编译级联（线程安全，所有线程共用）
+        std::unique_ptr<HaarCascade> compiledEye_;
         bool isLoaded_;
         double scaleFactor_;
         int minNeighbors_;
@@ -2,25 +2,35 @@
 #define FACE_RECOGNIZER_H
 
 #include <opencv2/opencv.hpp>
-#include <opencv2/face.hpp>
 #include <vector>
 #include <string>
-#include <map>
+#include "FrameContext.h"
+#include "LBPFeatureExtractor.h"
+#include "GalleryMatrix.h"
+#include "GalleryIndex.h"
+#include "IdentityStore.h"
 
 namespace DriveGuard {
 
-    // [新增] 定义用户角色枚举
-    enum class UserRole {
-        DRIVER = 0,    // 驾驶员 (监控疲劳)
-        PASSENGER = 1, // 乘客 (仅识别)
-        UNKNOWN = 99   // 未知
-    };
-
+    /**
+     * @brief LBPH 人脸识别器
+     * 特征提取使用 LBPFeatureExtractor（与 cv::face::LBPHFaceRecognizer 直方图逐位一致），
+     * 样本直方图以量化计数存放在连续的 GalleryMatrix 中。模型文件按扩展名区分格式：
+     * .yml/.yaml/.xml 与 OpenCV LBPH 兼容（已有 face_rec.yml 可直接加载），其余路径（如 face_rec.dgm）
+     * 使用 GalleryStore 的二进制格式（启动时 mmap，录入时只追加日志）。
+     * 身份数较多时经 GalleryIndex 先粗排再精排，避免逐样本匹配。
+     * predict 不修改模型（特征缓冲区按线程分配），同一实例可被多个线程并发预测；
+     * predictBatch 据此将一帧内的多张人脸分派到多个核心上并行预测。
+     */
     class FaceRecognizer {
     public:
         // 构造函数
         FaceRecognizer();
 
+        // 复制构造（供后台录入在副本上训练；映射的图库段共享）
+        FaceRecognizer(const FaceRecognizer& other) = default;
+        FaceRecognizer& operator=(const FaceRecognizer&) = delete;
+
         // 析构函数
         ~FaceRecognizer();
 
@@ -32,7 +42,7 @@ namespace DriveGuard {
         // void train(const std::vector<cv::Mat>& images, const std::vector<int>& labels);
 
         /**
-         * @brief 更新模型（增量训练）
+         * @brief 更新模型（增量训练，样本特征在多个核心上并行提取）
          * @param images 新的人脸图像列表
          * @param labels 新的人脸标签列表
          */
@@ -40,17 +50,39 @@ namespace DriveGuard {
 
         /**
          * @brief 预测身份
-         * @param image 人脸图像
+         * @param image 人脸图像（将被转为灰度并缩放至 FACE_SAMPLE_SIZE）
          * @param confidence 置信度
          * @return 预测结果
          */
         int predict(const cv::Mat& image, double& confidence);
 
         /**
-         * @brief 保存模型到文件
+         * @brief 预测身份（使用人脸样本中已预处理的统一尺寸灰度图）
+         * @param face 人脸样本
+         * @param confidence 置信度
+         * @return 预测结果
+         */
+        int predict(FaceSample& face, double& confidence);
+
+        /**
+         * @brief 批量预测（一帧内的多张人脸并行提取特征与匹配）
+         * @param faces 人脸样本（各不相同）
+         * @param labels 输出预测结果，与 faces 一一对应
+         * @param confidences 输出置信度，与 faces 一一对应
+         */
+        void predictBatch(const std::vector<FaceSample*>& faces, std::vector<int>& labels, std::vector<double>& confidences);
+
+        /**
+         * @brief 保存模型到文件（整体写出）
          */
         bool saveModel(const std::string& filepath);
 
+        /**
+         * @brief 增量保存：将上次加载/保存之后新增的样本追加到二进制模型的日志段
+         * 非二进制路径或与上次加载/保存的文件不同时退回 saveModel。
+         */
+        bool appendModel(const std::string& filepath);
+
         /**
          * @brief 从文件加载模型
          */
@@ -58,16 +90,18 @@ namespace DriveGuard {
 
         /**
          * @brief 保存 ID-Name 映射表
+         * @return 写入失败返回 false
          */
-        void saveLabelInfo(const std::string& filepath);
+        bool saveLabelInfo(const std::string& filepath);
 
         /**
          * @brief 加载 ID-Name 映射表
+         * @return 文件无法打开时返回 false
          */
-        void loadLabelInfo(const std::string& filepath);
+        bool loadLabelInfo(const std::string& filepath);
 
         /**
-         * @brief 获取可用标签
+         * @brief 获取可用标签（大于映射表与图库中所有已用的标签）
          */
         int getAvailableLabel();
 
@@ -79,16 +113,51 @@ namespace DriveGuard {
         /**
          * @brief 获取ID对应的名字
          */
-        std::string getLabelName(int label);
+        const std::string& getLabelName(int label) const;
 
         /**
          * @brief 获取ID对应的角色
          */
-        UserRole getLabelRole(int label);
+        UserRole getLabelRole(int label) const;
+
+        /**
+         * @brief 身份信息库
+         */
+        const IdentityStore& identities() const;
+
+        /**
+         * @brief 当前 LBP 参数
+         */
+        const LBPParams& params() const;
+
+        /**
+         * @brief 设置图库索引配置（并按当前图库重建索引）
+         */
+        void setIndexConfig(const GalleryIndexConfig& config);
+
+        /**
+         * @brief 样本直方图图库
+         */
+        const GalleryMatrix& gallery() const;
+
+        /**
+         * @brief 图库索引
+         */
+        const GalleryIndex& index() const;
     private:
-        cv::Ptr<cv::face::LBPHFaceRecognizer> model_;
-        std::map<int, std::string> labelToName_;
-        std::map<int, UserRole> labelToRole_;
+        int predictNormalized(const cv::Mat& gray, double& confidence);
+        bool loadYamlModel(const std::string& filepath);
+        bool loadBinaryModel(const std::string& filepath);
+        void installModel(LBPFeatureExtractor extractor, GalleryMatrix gallery, double threshold, const std::string& filepath);
+        static GalleryMatrix makeGallery(const LBPFeatureExtractor& extractor);
+
+        LBPFeatureExtractor extractor_;
+        GalleryMatrix gallery_;             // 每个训练样本的空间直方图与标签
+        GalleryIndex index_;                // 身份数较多时的近似检索索引
+        double threshold_;                  // 距离阈值（超过则返回 -1）
+        IdentityStore identities_;          // 标签 -> 姓名与角色
+        std::string modelPath_;             // 上次加载/保存的模型文件
+        std::size_t persistedRows_;         // 已写入模型文件的样本行数
     };
 
 }
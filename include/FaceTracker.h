@@ -0,0 +1,90 @@
+#ifndef FACE_TRACKER_H
+#define FACE_TRACKER_H
+
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <vector>
+#include "FaceDetector.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 人脸跟踪配置
+     */
+    struct TrackerConfig {
+        bool enabled = true;          // 是否启用跟踪模式（关闭则每帧全帧检测）
+        int redetectInterval = 10;    // 全帧检测周期（帧）
+        double searchPadding = 0.5;   // 局部搜索窗口相对人脸尺寸的外扩比例（每侧）
+        double minScale = 0.8;        // 局部搜索的最小人脸尺寸（相对上一帧）
+        double maxScale = 1.25;       // 局部搜索的最大人脸尺寸（相对上一帧）
+        int lostTimeoutMs = 2000;     // 丢失的轨迹保留时长（毫秒）；期间人脸在原位置重新出现时沿用原编号
+    };
+
+    /**
+     * @brief 人脸轨迹
+     */
+    struct FaceTrack {
+        int id;          // 轨迹编号（跨帧稳定）
+        cv::Rect box;    // 当前人脸框
+        int age;         // 轨迹已存活的帧数
+        std::chrono::steady_clock::time_point lastSeen; // 最近一次检出的帧时间
+    };
+
+    /**
+     * @brief 跟踪辅助的人脸检测器
+     * 全帧 Haar 扫描之后，后续帧仅在上一帧人脸周围的外扩窗口内、以较窄的
+     * 尺寸范围搜索；按配置周期或有轨迹丢失时重新进行全帧检测。
+     * 轨迹编号在全帧检测间按重叠度关联，保持稳定；未被关联的轨迹转入丢失列表保留 lostTimeoutMs，
+     * 人脸短暂丢失（低头、遮挡、漏检）后在原位置重新出现时关联回原编号，下游按轨迹保存的状态得以延续。
+     * 检测结果、候选框与轨迹使用成员缓冲区，逐帧复用容量。
+     */
+    class FaceTracker {
+    public:
+        using TimePoint = std::chrono::steady_clock::time_point;
+
+        /**
+         * @brief 构造函数
+         * @param detector 人脸检测器
+         * @param config 跟踪配置
+         */
+        FaceTracker(FaceDetector& detector, const TrackerConfig& config);
+
+        /**
+         * @brief 检测（或跟踪）当前帧中的人脸
+         * @param context 帧预处理上下文
+         * @param time 该帧的采集时间戳（须单调不减，用于丢失轨迹的超时）
+         * @param detectScale 全帧检测的分辨率比例（降载时小于 1，局部搜索不受影响）
+         * @return 人脸矩形框列表，与 tracks() 一一对应（下次检测前有效）
+         */
+        const std::vector<cv::Rect>& detect(const FrameContext& context, TimePoint time, double detectScale = 1.0);
+
+        /**
+         * @brief 当前帧的人脸轨迹
+         */
+        const std::vector<FaceTrack>& tracks() const;
+
+        /**
+         * @brief 清空轨迹（含丢失的轨迹），下一帧强制全帧检测
+         */
+        void reset();
+
+    private:
+        void fullDetect(const FrameContext& context, TimePoint time, double scale);
+        bool trackDetect(const FrameContext& context, TimePoint time);
+
+        FaceDetector& detector_;
+        TrackerConfig config_;
+        std::vector<FaceTrack> tracks_;
+        std::vector<FaceTrack> updated_;      // 本帧更新后的轨迹（与 tracks_ 交换）
+        std::vector<cv::Rect> faces_;         // 本帧人脸框
+        std::vector<cv::Rect> candidates_;    // 检测器输出
+        std::vector<FaceTrack> lost_;         // 丢失未超时的轨迹（保留最后位置）
+        std::vector<bool> used_;              // 全帧检测时已关联的轨迹
+        std::vector<bool> lostUsed_;          // 全帧检测时已关联回来的丢失轨迹
+        int nextId_;
+        int framesSinceFull_;
+    };
+
+} // namespace DriveGuard
+
+#endif // FACE_TRACKER_H
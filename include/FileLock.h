@@ -0,0 +1,60 @@
+#ifndef FILE_LOCK_H
+#define FILE_LOCK_H
+
+#include <string>
+
+namespace DriveGuard {
+
+    /**
+     * @brief 跨进程的建议性文件锁（flock，作用域内持有）
+     * 模型与映射表的写入各自持有 <文件>.lock 的独占锁，保证不同进程的写入不会交错；
+     * 修改模型的进程（DriveGuard 主程序、GalleryImport 等工具）在整个运行期间持有
+     * <模型>.owner.lock 的独占锁，同一时刻只允许一个进程修改同一份模型与映射表
+     * （否则各自内存中的身份信息库会过期，分配重复的标签并互相覆盖映射表）。
+     * flock 锁属于打开的文件描述，同一进程内对同一锁文件加锁也会互斥，进程内的并发由调用方的互斥量保证。
+     * Windows 上不加锁（locked() 总是返回 true）。
+     */
+    class FileLock {
+    public:
+        enum class Mode {
+            SHARED,     // 共享锁（读）
+            EXCLUSIVE   // 独占锁（写）
+        };
+
+        /**
+         * @brief 构造函数（打开或创建锁文件并加锁）
+         * @param path 锁文件路径
+         * @param mode 加锁模式
+         * @param wait 锁被占用时是否等待（false 时立即返回，locked() 为 false）
+         */
+        explicit FileLock(const std::string& path, Mode mode = Mode::EXCLUSIVE, bool wait = true);
+
+        // 析构函数（释放锁）
+        ~FileLock();
+
+        FileLock(const FileLock&) = delete;
+        FileLock& operator=(const FileLock&) = delete;
+
+        /**
+         * @brief 是否已持有锁
+         */
+        bool locked() const;
+
+        /**
+         * @brief 写入锁的路径（<文件>.lock）
+         */
+        static std::string lockPath(const std::string& path);
+
+        /**
+         * @brief 模型所有者锁的路径（<模型>.owner.lock）
+         */
+        static std::string ownerLockPath(const std::string& modelPath);
+
+    private:
+        int fd_;
+        bool locked_;
+    };
+
+} // namespace DriveGuard
+
+#endif // FILE_LOCK_H
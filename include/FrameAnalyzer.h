@@ -0,0 +1,149 @@
+#ifndef FRAME_ANALYZER_H
+#define FRAME_ANALYZER_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "EnrollmentService.h"
+#include "EyeTracker.h"
+#include "FaceDetector.h"
+#include "FaceTracker.h"
+#include "FaceRecognizer.h"
+#include "IdentityCache.h"
+#include "LoadShedder.h"
+#include "DMSController.h"
+#include "EventRecorder.h"
+#include "SampleSelector.h"
+#include "FramePacket.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 帧分析配置
+     */
+    struct AnalyzerConfig {
+        int recordMaxImages = 30;           // 单次录入采集的图片数（不合格与近似重复的样本在提交前剔除）
+        int recordIntervalMs = 100;         // 每次采集间隔（毫秒，按帧采集时间戳计）
+        int recordCountdownMs = 5000;       // 请求录入到开始采集的倒计时（毫秒，期间照常识别与监测）
+        double confidenceThreshold = 80.0;  // 置信度阈值（低于该值即通过）
+        TrackerConfig tracker;              // 人脸跟踪配置
+        EyeTrackerConfig eyeTracker;        // 眼部定位配置
+        IdentityCacheConfig identityCache;  // 身份缓存配置
+        DMSConfig dms;                      // 疲劳判定配置
+        LoadShedderConfig shedder;          // 延迟预算与降载配置
+        SampleSelectorConfig selector;      // 录入样本筛选配置
+    };
+
+    /**
+     * @brief 帧分析器
+     * 将原主循环中的检测、识别、眼部检测、疲劳判定与录入逻辑拆分为
+     * 相互独立的阶段，供流水线各线程调用。
+     * detect() 与 analyze() 分别串行调用（由流水线的检测/分析线程，或线程池中同一路的串行任务），
+     * 每路摄像头持有各自的实例（跟踪、身份缓存与 DMS 状态互不影响），检测器与识别模型各路共享。
+     * 识别模型由 EnrollmentService 发布，analyze() 每帧取一次快照；采集完的样本交给后台训练，
+     * 分析线程不会因录入而阻塞。
+     */
+    class FrameAnalyzer {
+    public:
+        /**
+         * @brief 构造函数
+         * @param detector 人脸检测器
+         * @param enrollment 录入服务（提供当前识别模型）
+         * @param config 分析配置
+         * @param initialState 初始工作模式
+         * @param recorder 事件记录器（可选，为空时不记录事件与告警片段）
+         */
+        FrameAnalyzer(FaceDetector& detector, EnrollmentService& enrollment,
+                      const AnalyzerConfig& config, ModelState initialState,
+                      EventRecorder* recorder = nullptr);
+
+        /**
+         * @brief 准入：降载到丢帧级别时，判断该帧是否仍在延迟预算内（由检测阶段在 detect() 之前调用）
+         * @param packet 帧数据包
+         * @return 应丢弃该帧时返回 false
+         */
+        bool admit(const FramePacket& packet);
+
+        /**
+         * @brief 检测阶段：在帧中检测人脸
+         * @param packet 帧数据包（写入 faces）
+         */
+        void detect(FramePacket& packet);
+
+        /**
+         * @brief 分析阶段：识别身份、检测眼睛、更新疲劳状态或采集录入样本
+         * @param packet 帧数据包（写入 results 与模式信息）
+         */
+        void analyze(FramePacket& packet);
+
+        /**
+         * @brief 请求进入录入模式（线程安全，倒计时结束后开始采集）
+         * @param name 用户姓名
+         * @param role 用户角色
+         */
+        void requestRecording(const std::string& name, UserRole role);
+
+    private:
+        void handleRequest(const FramePacket& packet);
+        void recordFaces(FramePacket& packet);
+        void recognizeFaces(FramePacket& packet);
+        void finishRecording();
+        void pruneDriverStates(Clock::time_point now);
+        void reportIdentity(const FramePacket& packet, const FaceResult& result);
+
+        // 已记录的轨迹身份（身份变化时才再次记录事件）
+        struct ReportedIdentity {
+            int label;
+            Clock::time_point seen;
+        };
+
+        FaceDetector& detector_;
+        EnrollmentService& enrollment_;
+        AnalyzerConfig config_;
+        FaceTracker tracker_;  // 仅由检测线程访问
+        LoadShedder shedder_;  // 分析线程报告延迟，检测线程读取级别
+
+        // 以下状态仅由分析线程访问
+        std::shared_ptr<FaceRecognizer> recognizer_; // 当前帧使用的模型快照
+        uint64_t modelVersion_;                      // 快照对应的发布版本
+        IdentityCache identityCache_;
+        EyeTracker eyeTracker_;
+        std::unordered_map<int, DMSController> driverStates_; // 轨迹编号 -> 驾驶员疲劳状态
+        EventRecorder* recorder_;
+        std::unordered_map<int, ReportedIdentity> reportedIdentities_; // 轨迹编号 -> 已记录的身份
+        ModelState state_;
+        std::vector<cv::Mat> trainingImages_;
+        std::vector<double> trainingScores_;         // 与 trainingImages_ 一一对应的质量评分
+        SampleSelector selector_;
+        int rejectedCount_;                          // 本次录入因质量不合格剔除的样本数
+        std::string userName_;
+        int userLabel_;
+        UserRole userRole_;
+        int recordingCount_;
+        bool countingDown_;                          // 录入倒计时中
+        Clock::time_point recordStart_;              // 倒计时结束（开始采集）的时间
+        Clock::time_point lastSample_;               // 上一次采集样本的帧时间
+
+        // 识别模式的逐帧缓冲区（每帧清空，复用容量）
+        std::vector<FaceSample*> pending_;           // 需要完整识别的人脸
+        std::vector<std::size_t> pendingIndex_;
+        std::vector<int> labels_;
+        std::vector<double> confidences_;
+        std::vector<const FaceSample*> drivers_;     // 驾驶员人脸
+        std::vector<std::size_t> driverIndex_;
+        std::vector<std::vector<cv::Rect>> driverEyes_;
+
+        // 来自主线程的录入请求
+        std::mutex requestMutex_;
+        bool hasRequest_;
+        std::string requestName_;
+        UserRole requestRole_;
+    };
+
+} // namespace DriveGuard
+
+#endif // FRAME_ANALYZER_H
@@ -0,0 +1,134 @@
+#ifndef FRAME_BUS_H
+#define FRAME_BUS_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "FramePacket.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 帧总线共享内存头（位于映射区起始处，其后为 FRAME_BUS_MAX_READERS 个读端表项与 slotCount 个槽位）
+     */
+    struct FrameBusHeader {
+        uint32_t magic;                  // FRAME_BUS_MAGIC（初始化完成后最后写入）
+        uint32_t version;                // FRAME_BUS_VERSION
+        uint32_t slotCount;              // 槽位数（至多 FRAME_BUS_MAX_SLOTS）
+        uint32_t reserved;
+        uint64_t slotBytes;              // 每个槽位的像素数据容量
+        uint64_t slotStride;             // 相邻槽位的间距（槽位头 + 像素数据，按缓存行对齐）
+        std::atomic<uint64_t> latest;    // 最新发布的帧：(帧序号 << 8) | 槽位号，0 表示尚无帧
+        std::atomic<uint32_t> closed;    // 发布端已退出（读端据此结束输入）
+    };
+
+    constexpr uint32_t FRAME_BUS_MAGIC = 0x42464744; // "DGFB"（小端）
+    constexpr uint32_t FRAME_BUS_VERSION = 2;
+    constexpr uint32_t FRAME_BUS_MAX_SLOTS = 256;
+    constexpr uint32_t FRAME_BUS_MAX_READERS = 32;
+    constexpr std::size_t FRAME_BUS_SLOT_HEADER = 64; // 槽位头、读端表项与共享内存头均占一个缓存行
+    constexpr std::size_t FRAME_BUS_SLOTS_OFFSET = FRAME_BUS_SLOT_HEADER * (1 + FRAME_BUS_MAX_READERS); // 第一个槽位的偏移
+
+    /**
+     * @brief 帧总线读端表项（每个打开的读端占用一项）
+     * pinned 为该读端按槽位的引用位图，任一读端置位的槽位发布端都会跳过，保证零拷贝读取期间数据不被覆盖。
+     * 引用记在各读端自己的表项中：读端进程异常退出后，发布端按 pid 发现并清除其表项，收回被占住的槽位。
+     */
+    struct FrameBusReader {
+        std::atomic<int32_t> pid;        // 持有该表项的进程号，0 表示空闲
+        uint32_t reserved;
+        std::atomic<uint64_t> pinned[FRAME_BUS_MAX_SLOTS / 64];
+    };
+
+    /**
+     * @brief 帧总线槽位头（像素数据紧随其后，起始于 FRAME_BUS_SLOT_HEADER 偏移处）
+     * state 为偶数 2*seq 表示已发布第 seq 帧，奇数表示发布端正在写入。
+     */
+    struct FrameBusSlot {
+        std::atomic<uint64_t> state;
+        int32_t rows;
+        int32_t cols;
+        int32_t type;                    // OpenCV 像素类型（如 CV_8UC1）
+        uint64_t step;                   // 行字节数
+        int64_t captureTimeUs;           // 帧采集时刻（Unix 时间，微秒）
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free
+                  && std::atomic<int32_t>::is_always_lock_free,
+                  "帧总线要求跨进程的无锁原子变量");
+    static_assert(sizeof(FrameBusHeader) <= FRAME_BUS_SLOT_HEADER && sizeof(FrameBusSlot) <= FRAME_BUS_SLOT_HEADER
+                  && sizeof(FrameBusReader) <= FRAME_BUS_SLOT_HEADER,
+                  "帧总线头须在一个缓存行内");
+
+    /**
+     * @brief 第 index 个读端表项
+     */
+    inline FrameBusReader* frameBusReader(unsigned char* base, uint32_t index) {
+        return reinterpret_cast<FrameBusReader*>(base + FRAME_BUS_SLOT_HEADER * (1 + index));
+    }
+
+    /**
+     * @brief 帧总线发布端（单生产者）
+     * 将采集到的帧写入 POSIX 共享内存中的多槽位环，供本机任意数量的进程零拷贝读取
+     * （读端见 FrameBusSource，输入描述为 "shm:<名称>"）。发布端从不等待读端：
+     * 依次选择下一个未被读端引用的槽位写入，全部槽位都被引用时丢弃该帧并计入指标。
+     * 每隔一段帧数（以及槽位耗尽时）检查读端表，已退出进程的表项连同其引用一并清除并计入指标，
+     * 读端异常退出不会永久占住槽位（读端须与发布端在同一 pid 命名空间内）。
+     * 共享内存在第一帧到达时按帧大小创建，析构时标记关闭并删除。仅 POSIX 平台。
+     */
+    class FrameBusWriter {
+    public:
+        /**
+         * @brief 构造函数
+         * @param name 共享内存名称（不以 '/' 开头时自动补上）
+         * @param slotCount 槽位数（须大于各读端同时持有的帧数之和）
+         */
+        FrameBusWriter(const std::string& name, uint32_t slotCount = 16);
+
+        /**
+         * @brief 析构函数（标记关闭、解除映射并删除共享内存）
+         */
+        ~FrameBusWriter();
+
+        FrameBusWriter(const FrameBusWriter&) = delete;
+        FrameBusWriter& operator=(const FrameBusWriter&) = delete;
+
+        /**
+         * @brief 发布一帧（由采集线程调用，不阻塞）
+         * @param frame 图像帧（超出首帧确定的槽位容量时丢弃）
+         * @param captureTime 采集时间
+         * @return 已发布返回 true；共享内存不可用或所有槽位都被引用时返回 false
+         */
+        bool publish(const cv::Mat& frame, Clock::time_point captureTime);
+
+        /**
+         * @brief 共享内存名称
+         */
+        const std::string& name() const { return name_; }
+
+    private:
+        bool create(std::size_t frameBytes);
+        FrameBusSlot* slot(uint32_t index) const;
+        bool pinned(uint32_t index) const;
+        void reclaimReaders();
+
+        std::string name_;
+        uint32_t slotCount_;
+        unsigned char* base_;     // 映射区起始地址
+        std::size_t mappedBytes_;
+        uint32_t next_;           // 下一个候选槽位
+        uint64_t seq_;            // 已发布的帧数
+        uint64_t lastReclaim_;    // 上一次检查读端表时的帧序号
+        bool failed_;             // 共享内存创建失败（不再重试）
+        bool oversized_;          // 已报告过帧尺寸超出槽位容量
+    };
+
+    /**
+     * @brief 规范化共享内存名称（补上开头的 '/'）
+     */
+    std::string frameBusName(const std::string& name);
+
+} // namespace DriveGuard
+
+#endif // FRAME_BUS_H
@@ -0,0 +1,51 @@
+#ifndef FRAME_BUS_SOURCE_H
+#define FRAME_BUS_SOURCE_H
+
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <string>
+#include "FrameSource.h"
+
+namespace DriveGuard {
+
+    struct FrameBusMapping;
+
+    /**
+     * @brief 帧总线输入源（读端，输入描述 "shm:<名称>"）
+     * 每次读取发布端最新的一帧（跳过读取不及的旧帧，与实时摄像头一致），直接以共享内存中的
+     * 槽位构造 cv::Mat 交给流水线，不拷贝；读取时在本读端的表项中记录对槽位的引用，最后一个引用该帧的
+     * cv::Mat 释放时归还，期间发布端不会覆盖该槽位。读端之间互不影响，也从不阻塞发布端。
+     * 读端进程异常退出时其表项由发布端按 pid 清除，占住的槽位随之收回（计入 driveguard_frame_bus_reclaimed_slots_total）。
+     * 仅 POSIX 平台，其他平台 open() 返回 false。
+     */
+    class FrameBusSource : public FrameSource {
+    public:
+        // 构造函数
+        FrameBusSource();
+        // 析构函数
+        ~FrameBusSource() override;
+
+        FrameBusSource(const FrameBusSource&) = delete;
+        FrameBusSource& operator=(const FrameBusSource&) = delete;
+
+        /**
+         * @brief 映射发布端创建的共享内存
+         * @param name 共享内存名称
+         * @return 共享内存不存在或格式不符时返回 false
+         */
+        bool open(const std::string& name);
+
+        bool read(cv::Mat& frame) override;
+        bool isLive() const override;
+        std::string describe() const override;
+        void release() override;
+
+    private:
+        std::shared_ptr<FrameBusMapping> mapping_; // 共享内存映射（未归还的帧持有其引用）
+        std::string name_;
+        uint64_t lastSeq_;                         // 上一次读取的帧序号
+    };
+
+} // namespace DriveGuard
+
+#endif // FRAME_BUS_SOURCE_H
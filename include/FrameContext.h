@@ -0,0 +1,122 @@
+#ifndef FRAME_CONTEXT_H
+#define FRAME_CONTEXT_H
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+namespace DriveGuard {
+
+    // 识别样本的统一尺寸（录入与预测共用）
+    const int FACE_SAMPLE_SIZE = 100;
+
+    /**
+     * @brief 单张人脸的预处理样本
+     * gray/equalized 为帧级图像的视图（不拷贝），normalized 为统一尺寸的灰度人脸，
+     * 首次访问时生成到帧上下文提供的缓冲区中，供识别与录入共用
+     */
+    class FaceSample {
+    public:
+        /**
+         * @brief 构造函数
+         * @param box 人脸框（帧坐标）
+         * @param trackId 人脸轨迹编号
+         * @param frameGray 帧灰度图
+         * @param frameEqualized 帧均衡化灰度图
+         * @param sampleBuffer 统一尺寸人脸的缓冲区（由帧上下文复用，可为空）
+         */
+        FaceSample(const cv::Rect& box, int trackId, const cv::Mat& frameGray, const cv::Mat& frameEqualized,
+                   const cv::Mat& sampleBuffer = cv::Mat());
+
+        /**
+         * @brief 人脸框（帧坐标）
+         */
+        const cv::Rect& box() const;
+
+        /**
+         * @brief 人脸轨迹编号
+         */
+        int trackId() const;
+
+        /**
+         * @brief 灰度人脸区域（帧灰度图的视图）
+         */
+        const cv::Mat& gray() const;
+
+        /**
+         * @brief 均衡化人脸区域（帧均衡化图的视图，供眼部检测使用）
+         */
+        const cv::Mat& equalized() const;
+
+        /**
+         * @brief 统一为 FACE_SAMPLE_SIZE 的灰度人脸（与录入样本一致，供识别使用）
+         */
+        const cv::Mat& normalized();
+
+    private:
+        cv::Rect box_;
+        int trackId_;
+        cv::Mat gray_;
+        cv::Mat equalized_;
+        cv::Mat normalized_;
+        bool hasNormalized_ = false;
+    };
+
+    /**
+     * @brief 帧级预处理上下文
+     * 每帧仅做一次灰度转换与直方图均衡化，由检测器、眼部检测与识别器共享。
+     * 灰度图、均衡化图与各人脸的统一尺寸样本均写入上下文持有的缓冲区，
+     * 上下文随帧数据包回收复用后，帧尺寸不变时不再重新分配
+     */
+    class FrameContext {
+    public:
+        /**
+         * @brief 对新的一帧进行预处理（复用已有缓冲区）
+         * @param frame 输入图像帧（BGR 或灰度）
+         */
+        void prepare(const cv::Mat& frame);
+
+        /**
+         * @brief 原始图像帧
+         */
+        const cv::Mat& frame() const;
+
+        /**
+         * @brief 灰度图（输入为灰度时即为原图）
+         */
+        const cv::Mat& gray() const;
+
+        /**
+         * @brief 直方图均衡化后的灰度图（供人脸检测使用）
+         */
+        const cv::Mat& equalized() const;
+
+        /**
+         * @brief 添加一张人脸样本
+         * @param box 人脸框（帧坐标）
+         * @param trackId 人脸轨迹编号
+         * @return 新添加的人脸样本
+         */
+        FaceSample& addFace(const cv::Rect& box, int trackId);
+
+        /**
+         * @brief 当前帧的人脸样本
+         */
+        std::vector<FaceSample>& faces();
+
+        /**
+         * @brief 释放对帧数据的引用，保留自有缓冲区（数据包归还帧池时调用）
+         */
+        void recycle();
+
+    private:
+        cv::Mat frame_;
+        cv::Mat gray_;
+        cv::Mat equalized_;
+        bool grayIsView_ = false;
+        std::vector<FaceSample> faces_;
+        std::vector<cv::Mat> sampleBuffers_;  // 各人脸统一尺寸样本的缓冲区（按人脸序号复用）
+    };
+
+} // namespace DriveGuard
+
+#endif // FRAME_CONTEXT_H
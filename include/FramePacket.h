@@ -0,0 +1,80 @@
+#ifndef FRAME_PACKET_H
+#define FRAME_PACKET_H
+
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "FaceRecognizer.h"
+#include "DMSController.h"
+#include "FrameContext.h"
+
+namespace DriveGuard {
+
+    // 系统工作模式
+    enum class ModelState {
+        DETECTING, // 检测模式（默认） 0
+        RECORDING, // 录入模式 1
+        RECOGNIZING // 识别模式 2
+    };
+
+    // 流水线使用的时钟（单调时钟，不受系统时间调整影响）
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief 流水线时钟的时间点换算为 Unix 时间（微秒），用于对外输出的时间戳
+     */
+    inline int64_t toUnixMicros(Clock::time_point time) {
+        auto wall = std::chrono::system_clock::now() - (Clock::now() - time);
+        return std::chrono::duration_cast<std::chrono::microseconds>(wall.time_since_epoch()).count();
+    }
+
+    /**
+     * @brief 帧是否为自有的引用计数缓冲区（借用的驱动缓冲区、帧总线槽位带有自定义分配器，外部数据没有引用计数）
+     */
+    inline bool isOwnedFrame(const cv::Mat& frame) {
+        return frame.u != nullptr && frame.allocator == nullptr;
+    }
+
+    /**
+     * @brief 帧缓冲区是否仍被其他持有者引用（如事件记录器尚未编码的帧），此时不能原地写入
+     */
+    inline bool isFrameShared(const cv::Mat& frame) {
+        return frame.u != nullptr && CV_XADD(&frame.u->refcount, 0) > 1;
+    }
+
+    /**
+     * @brief 单张人脸的分析结果
+     */
+    struct FaceResult {
+        cv::Rect box;                                // 人脸框（帧坐标）
+        int trackId = -1;                            // 人脸轨迹编号
+        int label = -1;                              // 识别标签
+        double confidence = 0.0;                     // 识别置信度（越低越可信）
+        bool identified = false;                     // 置信度通过阈值（姓名与角色有效）
+        std::string name = "Unknown";                // 用户名
+        UserRole role = UserRole::UNKNOWN;           // 用户角色
+        std::vector<cv::Rect> eyes;                  // 眼睛框（帧坐标）
+        DriverState driverState = DriverState::NORMAL; // 驾驶员状态（仅驾驶员有效）
+    };
+
+    /**
+     * @brief 流水线中流转的帧数据包
+     * 每帧携带序号与采集时间戳，各阶段按序处理，保证结果有序
+     */
+    struct FramePacket {
+        uint64_t seq = 0;                            // 帧序号（采集阶段单调递增）
+        Clock::time_point captureTime;               // 采集时间戳
+        cv::Mat frame;                               // 原始图像帧
+        FrameContext context;                        // 帧预处理上下文与检测阶段输出的人脸样本
+        std::vector<FaceResult> results;             // 分析阶段输出的结果
+        ModelState state = ModelState::DETECTING;    // 处理该帧时的系统模式
+        int recordingCount = 0;                      // 录入模式下已采集的样本数
+        int countdown = 0;                           // 距开始录入的剩余秒数（0 表示未在倒计时）
+        bool training = false;                       // 后台是否正在训练新模型
+    };
+
+} // namespace DriveGuard
+
+#endif // FRAME_PACKET_H
@@ -0,0 +1,127 @@
+#ifndef FRAME_PIPELINE_H
+#define FRAME_PIPELINE_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "BoundedQueue.h"
+#include "FrameAnalyzer.h"
+#include "FramePacket.h"
+#include "FramePool.h"
+#include "ThreadPool.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 多阶段帧处理流水线
+     * 采集、检测、识别/眼部检测三个阶段各占一个线程，渲染阶段由调用方
+     * （通常为主线程，HighGUI 要求）通过 nextResult() 拉取。
+     * 阶段之间通过有界队列连接，队列满时丢弃最旧的帧；每个阶段单线程
+     * 顺序处理，因此输出的帧序号严格递增。
+     * 多路摄像头时可指定共享线程池：采集仍占一个线程，检测与分析作为一个任务提交到线程池，
+     * 每路同一时刻至多一个任务在执行（帧按序处理，跟踪与 DMS 状态无需加锁），各路之间并行。
+     * 数据包来自每路自己的帧池：调用方显示完结果后通过 recycle() 归还，被丢弃的帧自动归还，
+     * 稳定运行后采集与各阶段复用同一组图像缓冲区。
+     */
+    class FramePipeline {
+    public:
+        // 采集函数：读取一帧，返回 false 表示输入结束
+        using CaptureFn = std::function<bool(cv::Mat&)>;
+
+        /**
+         * @brief 构造函数
+         * @param capture 采集函数
+         * @param analyzer 帧分析器
+         * @param queueCapacity 各阶段队列容量
+         * @param dropOldest 队列满时丢弃最旧帧（实时输入）；为 false 时阻塞上游（离线回放，不丢帧）
+         * @param pool 共享线程池（为空时检测与分析各占一个线程）
+         */
+        FramePipeline(CaptureFn capture, FrameAnalyzer& analyzer, std::size_t queueCapacity = 2,
+                      bool dropOldest = true, ThreadPool* pool = nullptr);
+
+        /**
+         * @brief 析构函数（自动停止流水线）
+         */
+        ~FramePipeline();
+
+        FramePipeline(const FramePipeline&) = delete;
+        FramePipeline& operator=(const FramePipeline&) = delete;
+
+        /**
+         * @brief 启动各阶段线程
+         */
+        void start();
+
+        /**
+         * @brief 停止流水线并等待所有线程退出
+         */
+        void stop();
+
+        /**
+         * @brief 获取下一帧处理结果（阻塞）
+         * @param packet 输出的帧数据包
+         * @return 流水线已结束且无剩余结果时返回 false
+         */
+        bool nextResult(FramePacket& packet);
+
+        /**
+         * @brief 获取下一帧处理结果（非阻塞，供同时轮询多路流水线）
+         * @param packet 输出的帧数据包
+         * @return 暂无结果时返回 false
+         */
+        bool tryNextResult(FramePacket& packet);
+
+        /**
+         * @brief 归还已处理完的数据包（其缓冲区由后续帧复用）
+         * @param packet 不再使用的数据包
+         */
+        void recycle(FramePacket&& packet);
+
+        /**
+         * @brief 流水线已结束且结果已全部取走
+         */
+        bool finished() const;
+
+        /**
+         * @brief 因下游处理不及而被丢弃的帧数
+         */
+        uint64_t droppedFrames() const;
+
+    private:
+        void captureLoop();
+        void detectLoop();
+        void analyzeLoop();
+        void schedule();
+        void processNext();
+        void forward(BoundedQueue<FramePacket>& queue, FramePacket&& packet);
+
+        CaptureFn capture_;
+        FrameAnalyzer& analyzer_;
+        bool dropOldest_;
+        ThreadPool* pool_;
+        FramePool framePool_;
+
+        BoundedQueue<FramePacket> captureQueue_;  // 采集 -> 检测
+        BoundedQueue<FramePacket> detectQueue_;   // 检测 -> 分析
+        BoundedQueue<FramePacket> resultQueue_;   // 分析 -> 渲染
+
+        std::atomic<bool> running_;
+        std::atomic<uint64_t> dropped_;
+        std::thread captureThread_;
+        std::thread detectThread_;
+        std::thread analyzeThread_;
+
+        // 线程池模式：每路至多一个处理任务
+        std::atomic<bool> scheduled_;
+        std::mutex taskMutex_;
+        std::condition_variable taskDone_;
+        std::size_t inFlight_;
+    };
+
+} // namespace DriveGuard
+
+#endif // FRAME_PIPELINE_H
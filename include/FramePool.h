@@ -0,0 +1,58 @@
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "FramePacket.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 帧数据包池
+     * 渲染完成或被丢弃的数据包连同其中的图像缓冲区（原始帧、灰度图、均衡化图、人脸样本）
+     * 与结果容器一起归还，采集阶段取出后原地复用：帧尺寸不变时，稳定运行后流水线不再
+     * 为每帧分配图像与容器内存。原始帧可能仍被事件记录器共享引用（尚未编码），
+     * 取出时跳过这样的数据包，不会覆盖记录器尚未读取的帧。线程安全（采集、检测与渲染线程同时访问）。
+     */
+    class FramePool {
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 最多保留的空闲数据包数（超出的直接释放）
+         */
+        explicit FramePool(std::size_t capacity);
+
+        /**
+         * @brief 取出一个数据包（无空闲时新建；帧缓冲区不被其他持有者引用，可原地写入），序号与模式等字段由调用方重新填写
+         * @param packet 输出的数据包
+         */
+        void acquire(FramePacket& packet);
+
+        /**
+         * @brief 归还数据包（自有缓冲区保留，供下次 acquire 复用；借用的帧数据立即释放）
+         * @param packet 不再使用的数据包
+         */
+        void release(FramePacket&& packet);
+
+        /**
+         * @brief 当前空闲的数据包数
+         */
+        std::size_t idle() const;
+
+        /**
+         * @brief 因无空闲数据包（或空闲数据包的帧均仍被引用）而新建的次数（稳定运行后应不再增长）
+         */
+        uint64_t misses() const;
+
+    private:
+        const std::size_t capacity_;
+        mutable std::mutex mutex_;
+        std::vector<FramePacket> free_;
+        uint64_t misses_;
+    };
+
+} // namespace DriveGuard
+
+#endif // FRAME_POOL_H
@@ -0,0 +1,75 @@
+#ifndef FRAME_SOURCE_H
+#define FRAME_SOURCE_H
+
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <string>
+
+namespace DriveGuard {
+
+    /**
+     * @brief 原始 YUV 像素格式（V4L2 与原始 YUV 文件输入使用）
+     */
+    enum class PixelFormat {
+        GREY, // 8 位灰度
+        NV12, // Y 平面 + UV 交错平面（4:2:0）
+        I420, // Y 平面 + U 平面 + V 平面（4:2:0）
+        YUYV  // Y0 U Y1 V 交错（4:2:2）
+    };
+
+    /**
+     * @brief 帧输入源接口
+     * 各后端统一以 cv::Mat 输出帧：OpenCV 后端输出 BGR 彩色帧；V4L2 与原始 YUV 后端只输出
+     * 亮度（Y 平面，CV_8UC1），检测、识别与眼部检测本就只使用灰度，省去整帧解码为 BGR
+     * 再转回灰度的转换与拷贝。渲染时再将灰度帧转为 BGR。
+     */
+    class FrameSource {
+    public:
+        virtual ~FrameSource() = default;
+
+        /**
+         * @brief 读取下一帧
+         * @param frame 输出图像帧（BGR 或灰度）；已有缓冲区尺寸与类型相符时可被原地覆盖，
+         *              调用方须保证其不再被其他地方引用（流水线传入的是帧池回收的缓冲区）
+         * @return 输入结束或读取失败返回 false
+         */
+        virtual bool read(cv::Mat& frame) = 0;
+
+        /**
+         * @brief 是否为实时输入（实时输入丢弃最旧帧，离线回放逐帧处理）
+         */
+        virtual bool isLive() const = 0;
+
+        /**
+         * @brief 输入源描述（用于日志）
+         */
+        virtual std::string describe() const = 0;
+
+        /**
+         * @brief 释放输入源
+         */
+        virtual void release() = 0;
+
+        /**
+         * @brief 按输入描述创建并打开输入源
+         * @param input 摄像头编号（如 "0"）、视频文件路径、图片目录路径、
+         *              "v4l2:<设备>[,<宽>x<高>][,<格式>]"、"yuv:<文件>,<宽>x<高>,<格式>[,<帧率>]"
+         *              或 "shm:<帧总线名称>"
+         * @return 打开失败返回空指针
+         */
+        static std::unique_ptr<FrameSource> create(const std::string& input);
+
+        /**
+         * @brief 解析像素格式名称（grey/gray、nv12、i420、yuyv，不区分大小写）
+         */
+        static bool parsePixelFormat(const std::string& name, PixelFormat& format);
+
+        /**
+         * @brief 像素格式名称
+         */
+        static const char* pixelFormatName(PixelFormat format);
+    };
+
+} // namespace DriveGuard
+
+#endif // FRAME_SOURCE_H
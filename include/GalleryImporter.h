@@ -0,0 +1,86 @@
+#ifndef GALLERY_IMPORTER_H
+#define GALLERY_IMPORTER_H
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "FaceDetector.h"
+#include "FaceRecognizer.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 批量导入配置
+     */
+    struct ImportConfig {
+        UserRole role = UserRole::DRIVER; // 未按角色分组时所有身份的角色
+        int maxPerIdentity = 0;           // 每个身份最多导入的图片数（按文件名排序取前 N 张），<=0 不限
+        bool cropped = false;             // 图片已是裁剪好的人脸，跳过检测直接统一尺寸
+    };
+
+    /**
+     * @brief 批量导入结果统计
+     */
+    struct ImportReport {
+        std::size_t identities = 0;    // 导入了样本的身份数
+        std::size_t newIdentities = 0; // 其中新分配标签的身份数（其余与已有同名身份合并）
+        std::size_t images = 0;        // 读取的图片数
+        std::size_t samples = 0;       // 写入图库的样本数
+        std::size_t unreadable = 0;    // 无法读取的图片数
+        std::size_t noFace = 0;        // 未检测到人脸的图片数
+    };
+
+    /**
+     * @brief 图库批量导入
+     * 读取按身份分目录存放的人脸图片：<根目录>/<姓名>/ 下的图片，或按角色分组的
+     * <根目录>/driver/<姓名>/ 与 <根目录>/passenger/<姓名>/。每张图片检测人脸、取最大的一张裁剪并
+     * 统一为 FACE_SAMPLE_SIZE 的灰度样本（与现场录入一致），图片读取与检测在多个核心上并行，
+     * 特征提取由 FaceRecognizer::update 并行完成。与已有身份同名的目录追加样本，其余分配新标签。
+     */
+    class GalleryImporter {
+    public:
+        /**
+         * @brief 构造函数
+         * @param detector 人脸检测器（cropped 为 true 时不使用）
+         * @param config 导入配置
+         */
+        GalleryImporter(FaceDetector& detector, const ImportConfig& config);
+
+        /**
+         * @brief 导入目录中的全部身份到识别器（更新图库与身份信息库，不保存文件）
+         * @param root 根目录
+         * @param recognizer 识别器
+         * @param report 输出统计
+         * @return 根目录无法读取或没有任何可用样本时返回 false
+         */
+        bool import(const std::string& root, FaceRecognizer& recognizer, ImportReport& report);
+
+    private:
+        // 待导入的一张图片
+        struct ImageTask {
+            std::string path;
+            std::size_t identity;   // 在 identities 中的下标
+            cv::Mat sample;         // 统一尺寸的灰度人脸（无法读取或未检出人脸时为空）
+            bool readable = false;
+        };
+
+        // 待导入的一个身份
+        struct IdentityTask {
+            std::string name;
+            UserRole role;
+            std::size_t samples = 0;
+        };
+
+        bool collect(const std::string& root, std::vector<IdentityTask>& identities, std::vector<ImageTask>& images) const;
+        void collectIdentity(const std::string& dir, const std::string& name, UserRole role,
+                             std::vector<IdentityTask>& identities, std::vector<ImageTask>& images) const;
+        void prepare(ImageTask& task);
+
+        FaceDetector& detector_;
+        ImportConfig config_;
+    };
+
+} // namespace DriveGuard
+
+#endif // GALLERY_IMPORTER_H
@@ -0,0 +1,131 @@
+#ifndef GALLERY_INDEX_H
+#define GALLERY_INDEX_H
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "GalleryMatrix.h"
+#include "LBPFeatureExtractor.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 图库索引配置
+     */
+    struct GalleryIndexConfig {
+        bool enabled = true;     // 是否启用索引（关闭时始终逐样本匹配）
+        int minIdentities = 64;  // 身份数不少于该值时才走索引检索
+        int prototypes = 3;      // 每个身份压缩成的原型数上限（每个原型至少代表 5 个样本）
+        int lists = 0;           // 倒排列表数，<=0 时取 sqrt(身份数)
+        int probes = 8;          // 查询时探测的倒排列表数（越大召回越高、越慢）
+        int candidates = 8;      // 进入精排的候选身份数（越大召回越高、越慢）
+        int iterations = 8;      // k-means 迭代次数
+    };
+
+    /**
+     * @brief 大规模图库的身份索引（粗排 + 精排）
+     * 1. 降维：每个网格的 LBP 直方图按均匀模式合并（8 邻域时 256 -> 59 维）；
+     * 2. 原型压缩：每个身份的样本在降维空间内以卡方 k-means 聚成少量原型；
+     * 3. 倒排列表：所有原型再聚成 sqrt(身份数) 个列表，查询时只探测最近的 probes 个列表；
+     * 4. 精排：取原型距离最近的 candidates 个身份，用其全部样本的完整直方图计算精确卡方距离。
+     * probes / candidates 取到列表数 / 身份数时退化为精确检索。
+     */
+    class GalleryIndex {
+    public:
+        /**
+         * @brief 检索的中间缓冲区（每个线程一份，复用容量，稳定运行后检索不再分配内存）
+         */
+        struct SearchBuffer {
+            cv::Mat reduced;                          // 降维后的查询直方图
+            std::vector<double> distances;
+            std::vector<std::size_t> order;           // 倒排列表按距离排序
+            std::vector<std::pair<double, int>> ranked; // 探测到的原型（距离, 身份）
+            std::vector<std::size_t> rows;            // 候选身份的图库样本行
+        };
+
+        /**
+         * @brief 构造函数
+         * @param config 索引配置
+         */
+        explicit GalleryIndex(const GalleryIndexConfig& config = GalleryIndexConfig());
+
+        /**
+         * @brief 按图库全部样本重建索引
+         * @param gallery 样本图库
+         * @param params 图库直方图的 LBP 参数
+         */
+        void build(const GalleryMatrix& gallery, const LBPParams& params);
+
+        /**
+         * @brief 增量加入图库中 firstRow 之后新追加的样本
+         * 新样本单独压缩为原型并放入最近的倒排列表；身份数较上次训练翻倍时整体重建。
+         */
+        void add(const GalleryMatrix& gallery, const LBPParams& params, std::size_t firstRow);
+
+        /**
+         * @brief 检索查询直方图
+         * @param gallery 构建索引时使用的样本图库
+         * @param query 1 x cols 的 CV_32F 查询直方图
+         * @param k 返回的标签数
+         * @param threshold 距离阈值（不小于该值的样本被忽略）
+         * @return 按距离升序排列的前 k 个标签（距离为精确卡方距离）
+         */
+        std::vector<GalleryMatch> search(const GalleryMatrix& gallery, const cv::Mat& query, int k, double threshold) const;
+
+        /**
+         * @brief 检索查询直方图（使用调用方的缓冲区，不为每次查询分配内存）
+         * @param buffer 中间缓冲区
+         * @param matches 输出按距离升序排列的前 k 个标签（复用已有容量）
+         */
+        void search(const GalleryMatrix& gallery, const cv::Mat& query, int k, double threshold,
+                    SearchBuffer& buffer, std::vector<GalleryMatch>& matches) const;
+
+        /**
+         * @brief 调整检索召回参数（无需重建）
+         * @param probes 探测的倒排列表数
+         * @param candidates 进入精排的候选身份数
+         */
+        void setSearchParams(int probes, int candidates);
+
+        /**
+         * @brief 索引已启用且身份数达到 minIdentities
+         */
+        bool ready() const;
+
+        /**
+         * @brief 清空索引
+         */
+        void clear();
+
+        const GalleryIndexConfig& config() const;
+        std::size_t identities() const;
+        std::size_t prototypes() const;
+        std::size_t lists() const;
+
+        /**
+         * @brief 原型与列表中心占用的字节数
+         */
+        std::size_t bytes() const;
+
+    private:
+        void setupReduction(const LBPParams& params, int cols, int cellArea);
+        void reduce(const cv::Mat& histogram, cv::Mat& out) const;
+        void addPrototypes(const GalleryMatrix& gallery, const std::vector<std::size_t>& rows, int label, GalleryMatrix& out) const;
+        int nearestList(const cv::Mat& prototype) const;
+
+        GalleryIndexConfig config_;
+        std::vector<int> binMap_;      // LBP 编码 -> 均匀模式分组
+        int bins_;                     // 每个网格的原始直方图维度
+        int reducedBins_;              // 每个网格的降维后维度
+        int cells_;                    // 网格数
+        int cellArea_;                 // 网格像素数（量化步长的倒数）
+        GalleryMatrix centroids_;      // 倒排列表中心（降维空间）
+        std::vector<GalleryMatrix> lists_; // 各列表内的原型（行标签为身份标签）
+        std::unordered_map<int, std::vector<std::size_t>> identityRows_; // 身份 -> 图库样本行
+        std::size_t trainedIdentities_; // 上次训练列表中心时的身份数
+    };
+
+} // namespace DriveGuard
+
+#endif // GALLERY_INDEX_H
@@ -0,0 +1,201 @@
+#ifndef GALLERY_MATRIX_H
+#define GALLERY_MATRIX_H
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "SimdSupport.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 图库存储精度
+     * LBPH 直方图的每个分量均为 计数 * (1 / 网格像素数)，按网格像素数量化为整数计数即可无损存储：
+     * 网格像素数不超过 255 时可用 UINT8，不超过 65535 时可用 UINT16。
+     */
+    enum class GalleryPrecision {
+        FLOAT32,
+        UINT16,
+        UINT8
+    };
+
+    /**
+     * @brief 匹配结果
+     */
+    struct GalleryMatch {
+        int label;        // 标签
+        double distance;  // 卡方距离（HISTCMP_CHISQR_ALT）
+        std::size_t row;  // 取得该距离的图库行
+    };
+
+    /**
+     * @brief 连续存储的人脸直方图图库
+     * 所有样本的直方图按行存放在一块 64 字节对齐的连续内存中（行跨度同样按 64 字节对齐），
+     * 可选量化为 UINT8/UINT16 计数；匹配时一次遍历对所有行计算卡方距离并返回前 k 个标签。
+     * 前若干行可直接引用只读映射的模型文件（mapped），之后追加的行存放在自有内存中。
+     */
+    class GalleryMatrix {
+    public:
+        /**
+         * @brief 构造函数
+         * @param cols 直方图维度
+         * @param precision 存储精度
+         * @param cellArea 网格像素数（量化步长的倒数）
+         * @param kernel 距离计算内核
+         */
+        explicit GalleryMatrix(int cols = 0, GalleryPrecision precision = GalleryPrecision::FLOAT32,
+                               int cellArea = 1, SimdLevel kernel = SimdLevel::AUTO);
+
+        GalleryMatrix(const GalleryMatrix& other);
+        GalleryMatrix& operator=(const GalleryMatrix& other);
+        GalleryMatrix(GalleryMatrix&& other) noexcept;
+        GalleryMatrix& operator=(GalleryMatrix&& other) noexcept;
+        ~GalleryMatrix();
+
+        /**
+         * @brief 以只读映射的内存作为图库的前 rows 行（不拷贝）
+         * @param owner 映射的持有者（图库及其副本存活期间保持映射有效）
+         * @param data 首行地址（64 字节对齐，行跨度为 strideFor(cols, precision)）
+         * @param rows 行数
+         * @param labels 各行标签
+         * @param cols 直方图维度
+         * @param precision 存储精度
+         * @param cellArea 网格像素数
+         * @param kernel 距离计算内核
+         */
+        static GalleryMatrix mapped(std::shared_ptr<const void> owner, const unsigned char* data, std::size_t rows,
+                                    std::vector<int> labels, int cols, GalleryPrecision precision, int cellArea,
+                                    SimdLevel kernel = SimdLevel::AUTO);
+
+        /**
+         * @brief 指定维度与精度下的行跨度（字节，64 字节对齐）
+         */
+        static std::size_t strideFor(int cols, GalleryPrecision precision);
+
+        /**
+         * @brief 根据网格像素数选择能无损存储的最小精度
+         */
+        static GalleryPrecision precisionFor(int cellArea);
+
+        /**
+         * @brief 直方图能否以指定精度无损存储
+         */
+        static bool isLossless(const cv::Mat& histogram, GalleryPrecision precision, int cellArea);
+
+        /**
+         * @brief 追加一行
+         * @param histogram 1 x cols 的 CV_32F 直方图
+         * @param label 标签
+         * @return 维度不匹配返回 false
+         */
+        bool append(const cv::Mat& histogram, int label);
+
+        /**
+         * @brief 追加一行原始存储（与 row() 的格式相同，stride() 字节）
+         */
+        void appendRaw(const unsigned char* data, int label);
+
+        /**
+         * @brief 预留行数
+         */
+        void reserve(std::size_t rows);
+
+        /**
+         * @brief 清空所有行（保留维度与精度）
+         */
+        void clear();
+
+        /**
+         * @brief 以新的精度重建图库
+         */
+        void convert(GalleryPrecision precision);
+
+        /**
+         * @brief 取回某一行的 float 直方图（量化存储时反量化，与原直方图逐位一致）
+         */
+        void histogram(std::size_t row, cv::Mat& out) const;
+
+        /**
+         * @brief 对所有行计算卡方距离
+         * @param query 1 x cols 的 CV_32F 查询直方图
+         * @param out 输出每行的距离
+         */
+        void distances(const cv::Mat& query, std::vector<double>& out) const;
+
+        /**
+         * @brief 对指定行计算卡方距离
+         * @param query 1 x cols 的 CV_32F 查询直方图
+         * @param rows 行号列表
+         * @param out 输出与 rows 一一对应的距离
+         */
+        void distances(const cv::Mat& query, const std::vector<std::size_t>& rows, std::vector<double>& out) const;
+
+        /**
+         * @brief 匹配查询直方图
+         * @param query 1 x cols 的 CV_32F 查询直方图
+         * @param k 返回的标签数（每个标签取其最近的一行）
+         * @param threshold 距离阈值（不小于该值的行被忽略）
+         * @return 按距离升序排列的前 k 个标签
+         */
+        std::vector<GalleryMatch> match(const cv::Mat& query, int k, double threshold) const;
+
+        /**
+         * @brief 匹配查询直方图（使用调用方的缓冲区，不为每次查询分配内存）
+         * @param distances 距离缓冲区（复用容量）
+         * @param matches 输出按距离升序排列的前 k 个标签（复用已有容量）
+         */
+        void match(const cv::Mat& query, int k, double threshold, std::vector<double>& distances,
+                   std::vector<GalleryMatch>& matches) const;
+
+        /**
+         * @brief 最近的一行（结果与 k = 1 的 match 相同，距离写入调用方的缓冲区，不分配内存）
+         * @param query 1 x cols 的 CV_32F 查询直方图
+         * @param threshold 距离阈值（不小于该值的行被忽略）
+         * @param distances 距离缓冲区（复用容量）
+         * @param match 输出最近的一行
+         * @return 存在小于阈值的行时返回 true
+         */
+        bool nearest(const cv::Mat& query, double threshold, std::vector<double>& distances, GalleryMatch& match) const;
+
+        std::size_t rows() const;
+        int cols() const;
+        GalleryPrecision precision() const;
+        int cellArea() const;
+        int label(std::size_t row) const;
+        const std::vector<int>& labels() const;
+
+        /**
+         * @brief 某一行的原始存储（stride() 字节，按存储精度解释）
+         */
+        const unsigned char* row(std::size_t row) const;
+        std::size_t stride() const;
+
+        /**
+         * @brief 图库数据占用的字节数
+         */
+        std::size_t bytes() const;
+
+    private:
+        void quantize(const cv::Mat& histogram, unsigned char* dst) const;
+        void countDistances(const unsigned char* query, const unsigned char* rows, std::size_t count, double* out) const;
+        void grow(std::size_t capacity);
+
+        int cols_;
+        GalleryPrecision precision_;
+        int cellArea_;
+        float step_;               // 量化步长 (float)(1.0 / cellArea)，与 LBPH 归一化一致
+        SimdLevel kernel_;
+        std::size_t stride_;       // 行跨度（字节，64 字节对齐）
+        std::size_t rows_;             // 总行数（映射段 + 自有段）
+        std::size_t capacity_;         // 自有段容量（行）
+        unsigned char* data_;          // 自有段：64 字节对齐的连续存储
+        std::shared_ptr<const void> mapping_; // 映射段的持有者
+        const unsigned char* mapped_;  // 映射段首行
+        std::size_t mappedRows_;       // 映射段行数
+        std::vector<int> labels_;
+    };
+
+} // namespace DriveGuard
+
+#endif // GALLERY_MATRIX_H
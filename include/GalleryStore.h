@@ -0,0 +1,81 @@
+#ifndef GALLERY_STORE_H
+#define GALLERY_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "GalleryMatrix.h"
+#include "LBPFeatureExtractor.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 从二进制模型文件加载的图库
+     */
+    struct GalleryModel {
+        LBPParams params;                // LBP 参数
+        double threshold = 0.0;          // 距离阈值（0 表示未设置）
+        GalleryMatrix gallery;           // 图库（基础段为只读映射，日志段回放到自有内存）
+        std::uint64_t generation = 0;    // 基础段代号（每次整体写出或压缩后加一）
+        std::size_t journalRows = 0;     // 从日志段回放的行数
+    };
+
+    /**
+     * @brief 二进制图库模型文件
+     * 基础段（如 face_rec.dgm）：固定文件头 + 标签数组 + 64 字节对齐的量化直方图行，
+     *   启动时 mmap 后直接作为图库的前段使用，无需解析与拷贝；
+     * 日志段（<基础段>.journal）：录入时只追加新样本记录（每条带 CRC32），加载时校验后回放，
+     *   代号与基础段不一致的日志视为已合并而忽略；
+     * 压缩：把日志合并进新的基础段（先写临时文件再重命名），可在后台线程执行。
+     * 同一进程内的读写由互斥量串行，不同进程之间由 <基础段>.lock 的建议性文件锁串行
+     * （写入独占、读取共享），日志记录不会交错，也不会把其他进程正在写的记录当作不完整截掉；文件按小端序存储。
+     */
+    class GalleryStore {
+    public:
+        /**
+         * @brief 路径是否为二进制模型（扩展名不是 .yml / .yaml / .xml）
+         */
+        static bool isBinaryPath(const std::string& path);
+
+        /**
+         * @brief 日志段路径
+         */
+        static std::string journalPath(const std::string& path);
+
+        /**
+         * @brief 映射基础段并回放日志段
+         * @param path 基础段路径
+         * @param model 输出模型
+         * @return 文件不存在或格式错误返回 false
+         */
+        static bool load(const std::string& path, GalleryModel& model);
+
+        /**
+         * @brief 整体写出基础段并清空日志段
+         * @param path 基础段路径
+         * @param gallery 图库
+         * @param params LBP 参数
+         * @param threshold 距离阈值
+         */
+        static bool save(const std::string& path, const GalleryMatrix& gallery, const LBPParams& params, double threshold);
+
+        /**
+         * @brief 将图库中 firstRow 之后的行追加到日志段（耗时只与新增行数有关）
+         * @return 基础段不存在或维度/精度不一致时返回 false（调用方应整体写出）
+         */
+        static bool append(const std::string& path, const GalleryMatrix& gallery, std::size_t firstRow);
+
+        /**
+         * @brief 日志段行数是否已超过基础段的 1/4（且不少于 256 行），需要压缩
+         */
+        static bool needsCompaction(const std::string& path);
+
+        /**
+         * @brief 将日志段合并进新的基础段
+         */
+        static bool compact(const std::string& path);
+    };
+
+} // namespace DriveGuard
+
+#endif // GALLERY_STORE_H
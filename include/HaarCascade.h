@@ -0,0 +1,121 @@
+#ifndef HAAR_CASCADE_H
+#define HAAR_CASCADE_H
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "SimdSupport.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief Haar 特征中的一个加权矩形（窗口坐标）
+     */
+    struct HaarRect {
+        int x, y, width, height;
+        float weight;             // 权重（不存在的第三个矩形为 0）
+    };
+
+    /**
+     * @brief Haar 特征（2~3 个加权矩形，不支持倾斜特征）
+     */
+    struct HaarFeature {
+        HaarRect rects[3];
+    };
+
+    /**
+     * @brief 单节点弱分类器（特征值 < threshold 时取 left，否则取 right）
+     */
+    struct HaarStump {
+        int featureIdx;
+        float threshold;          // 阈值（相对方差归一化后的特征值）
+        float left;
+        float right;
+    };
+
+    /**
+     * @brief 级联中的一级
+     */
+    struct HaarStage {
+        int ntrees;               // 本级弱分类器数
+        float threshold;          // 本级阈值（已按 OpenCV 的读取方式减去 1e-5）
+    };
+
+    /**
+     * @brief 编译为 C++ 表的 Haar 级联（由构建时的 CascadeCompile 从 XML 模型生成）
+     */
+    struct HaarCascadeData {
+        const char* name;         // 模型名称（日志用）
+        int windowWidth;          // 检测窗口尺寸
+        int windowHeight;
+        const HaarStage* stages;
+        int stageCount;
+        const HaarStump* stumps;  // 所有级的弱分类器按级顺序连续存放
+        int stumpCount;
+        const HaarFeature* features;
+        int featureCount;
+    };
+
+#ifdef DRIVEGUARD_COMPILED_CASCADES
+    namespace cascades {
+        extern const HaarCascadeData FRONTAL_FACE; // models/haarcascade_frontalface_default.xml
+        extern const HaarCascadeData EYE;          // models/haarcascade_eye.xml
+    }
+#endif
+
+    /**
+     * @brief 编译级联的专用检测器
+     * 检测结果与 cv::CascadeClassifier::detectMultiScale 对同一模型的结果一致：
+     * 尺度序列、缩放（INTER_LINEAR_EXACT）、积分图、方差归一化、窗口步长与首级失败跳过、
+     * 浮点运算顺序及 groupRectangles 合并均与 OpenCV 相同。
+     * 不同之处在于：模型是编译期常量，无需解析 XML；每行相邻的窗口按 SIMD 宽度成组逐级判定
+     * （AVX2 每次 8 个窗口，全部被拒绝即结束该组）；缩放、分段并行与候选框合并不经过 OpenCV
+     * （ImageOps、parallelFor 与自有的合并实现），积分图、缩放图与合并用的缓冲区按线程复用，
+     * 人脸与眼睛级联共用同一份（只增不减），检测过程不再分配内存。
+     * 实例无可变状态，可被多个线程并发调用。
+     */
+    class HaarCascade {
+    public:
+        // 窗口判定内核（目前只有 AVX2 向量化版本，其余级别使用逐窗口参考实现）
+        using Kernel = SimdLevel;
+
+        /**
+         * @brief 构造函数
+         * @param data 编译级联表（须在实例生命周期内有效）
+         * @param kernel 窗口判定内核（不可用时退回自动选择）
+         */
+        explicit HaarCascade(const HaarCascadeData& data, Kernel kernel = Kernel::AUTO);
+
+        /**
+         * @brief 多尺度检测（参数含义与 cv::CascadeClassifier::detectMultiScale 相同）
+         * @param image 8 位灰度图（可为 ROI 视图）
+         * @param objects 输出目标矩形框
+         * @param scaleFactor 相邻尺度的缩放比例（>1）
+         * @param minNeighbors 合并时每个目标至少需要的候选框数
+         * @param minSize 最小目标尺寸
+         * @param maxSize 最大目标尺寸（为空则不限制）
+         */
+        void detectMultiScale(const cv::Mat& image, std::vector<cv::Rect>& objects, double scaleFactor,
+                              int minNeighbors, const cv::Size& minSize = cv::Size(),
+                              const cv::Size& maxSize = cv::Size()) const;
+
+        /**
+         * @brief 级联表
+         */
+        const HaarCascadeData& data() const;
+
+        /**
+         * @brief 实际使用的窗口判定内核
+         */
+        Kernel kernel() const;
+
+    private:
+        void selectScales(const cv::Size& imageSize, const cv::Size& minSize, const cv::Size& maxSize,
+                          double scaleFactor, std::vector<float>& allScales, std::vector<float>& scales) const;
+
+        const HaarCascadeData& data_;
+        Kernel kernel_;
+    };
+
+} // namespace DriveGuard
+
+#endif // HAAR_CASCADE_H
@@ -0,0 +1,96 @@
+#ifndef IDENTITY_CACHE_H
+#define IDENTITY_CACHE_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include "FrameContext.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 身份缓存配置
+     */
+    struct IdentityCacheConfig {
+        bool enabled = true;             // 是否复用缓存身份（关闭时仍保留最近一次可信识别的结果，供降载跳过乘客）
+        int refreshInterval = 30;        // 已确认身份的轨迹每 N 帧重新完整识别一次
+        double maxCenterShift = 0.25;    // 人脸中心位移超过人脸宽度的该比例视为跳变
+        double maxSizeChange = 0.25;     // 人脸尺寸变化超过该比例视为跳变
+        double maxAppearanceDiff = 18.0; // 缩略图平均灰度绝对差超过该值视为外观变化
+        int maxIdleFrames = 30;          // 轨迹连续未出现超过该帧数则淘汰缓存
+    };
+
+    /**
+     * @brief 按人脸轨迹缓存的身份识别结果
+     * 轨迹被可信识别后，仅在到达刷新周期、人脸框跳变或缩略图外观明显变化时
+     * 才重新进行完整的 LBPH 预测；其余帧直接复用缓存结果。
+     * 关闭缓存时 lookup() 总是未命中，但仍记录各轨迹最近一次可信识别的结果（不生成缩略图），
+     * 降载跳过乘客时由 peek() 取用。
+     */
+    class IdentityCache {
+    public:
+        /**
+         * @brief 构造函数
+         * @param config 缓存配置
+         */
+        explicit IdentityCache(const IdentityCacheConfig& config);
+
+        /**
+         * @brief 开始新的一帧（推进帧计数并淘汰长期未出现的轨迹）
+         */
+        void advance();
+
+        /**
+         * @brief 查询缓存（关闭缓存时总是未命中）
+         * @param face 人脸样本
+         * @param label 输出标签
+         * @param confidence 输出置信度
+         * @return 缓存命中且仍然有效返回 true
+         */
+        bool lookup(const FaceSample& face, int& label, double& confidence);
+
+        /**
+         * @brief 查询轨迹最近一次可信识别的结果，忽略刷新周期与外观比对（降载时使用，不受 enabled 影响）
+         * @param face 人脸样本
+         * @param label 输出标签
+         * @param confidence 输出置信度
+         * @return 轨迹有缓存且人脸框未跳变返回 true
+         */
+        bool peek(const FaceSample& face, int& label, double& confidence);
+
+        /**
+         * @brief 写入完整识别的结果（仅缓存可信识别的轨迹；关闭缓存时不生成缩略图）
+         * @param face 人脸样本
+         * @param label 识别标签
+         * @param confidence 识别置信度
+         * @param confident 是否为可信识别（置信度低于阈值）
+         */
+        void store(const FaceSample& face, int label, double confidence, bool confident);
+
+        /**
+         * @brief 清空缓存（模型更新后调用）
+         */
+        void clear();
+
+    private:
+        struct Entry {
+            int label;
+            double confidence;
+            cv::Rect box;          // 上次完整识别时的人脸框
+            cv::Mat thumbnail;     // 上次完整识别时的人脸缩略图
+            uint64_t verifiedAt;   // 上次完整识别的帧号
+            uint64_t lastSeen;     // 最近一次出现的帧号
+        };
+
+        bool boxJumped(const cv::Rect& previous, const cv::Rect& current) const;
+        static void makeThumbnail(const FaceSample& face, cv::Mat& thumbnail);
+
+        IdentityCacheConfig config_;
+        std::unordered_map<int, Entry> entries_; // 轨迹编号 -> 缓存项
+        cv::Mat thumbnail_;                      // 本次比对的缩略图（逐帧复用）
+        uint64_t frameIndex_;
+    };
+
+} // namespace DriveGuard
+
+#endif // IDENTITY_CACHE_H
@@ -0,0 +1,99 @@
+#ifndef IDENTITY_STORE_H
+#define IDENTITY_STORE_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace DriveGuard {
+
+    // [新增] 定义用户角色枚举
+    enum class UserRole {
+        DRIVER = 0,    // 驾驶员 (监控疲劳)
+        PASSENGER = 1, // 乘客 (仅识别)
+        UNKNOWN = 99   // 未知
+    };
+
+    /**
+     * @brief 身份信息库（标签 -> 姓名与角色）
+     * 标签由录入与批量导入按顺序分配，以标签为下标的连续数组存放，识别热路径上的
+     * 查询为 O(1) 且返回引用，不复制字符串；另维护姓名 -> 标签的散列索引供导入时合并同名身份。
+     * 文件格式与原有映射表一致（每行 label:name:role），保存时先写临时文件并落盘再原子替换，
+     * 读写失败返回 false 由调用方处理。
+     */
+    class IdentityStore {
+    public:
+        // 单个身份
+        struct Identity {
+            std::string name;
+            UserRole role = UserRole::UNKNOWN;
+            bool valid = false;
+        };
+
+        // 标签上限（超出的映射表行视为损坏并跳过，避免按标签分配过大的数组）
+        static constexpr int MAX_LABEL = 1 << 20;
+
+        /**
+         * @brief 设置（或覆盖）标签对应的身份
+         * @return 标签超出 [0, MAX_LABEL) 时返回 false
+         */
+        bool set(int label, const std::string& name, UserRole role);
+
+        /**
+         * @brief 标签对应的姓名（未登记时为 "Unknown"）
+         */
+        const std::string& name(int label) const;
+
+        /**
+         * @brief 标签对应的角色（未登记时为 UNKNOWN）
+         */
+        UserRole role(int label) const;
+
+        /**
+         * @brief 标签是否已登记
+         */
+        bool contains(int label) const;
+
+        /**
+         * @brief 按姓名查找标签
+         * @return 未找到返回 -1
+         */
+        int find(const std::string& name) const;
+
+        /**
+         * @brief 下一个可用标签（当前最大标签加一）
+         */
+        int nextLabel() const;
+
+        /**
+         * @brief 已登记的身份数
+         */
+        std::size_t size() const;
+
+        /**
+         * @brief 清空
+         */
+        void clear();
+
+        /**
+         * @brief 从映射表文件加载（替换当前内容，格式错误的行跳过并告警）
+         * @return 文件无法打开时返回 false（当前内容不变）
+         */
+        bool load(const std::string& filepath);
+
+        /**
+         * @brief 保存到映射表文件（先写临时文件并落盘再替换，持有 <映射表>.lock 的独占锁）
+         * @return 写入失败返回 false
+         */
+        bool save(const std::string& filepath) const;
+
+    private:
+        std::vector<Identity> identities_;               // 标签 -> 身份
+        std::unordered_map<std::string, int> labelOf_;   // 姓名 -> 标签
+        std::size_t count_ = 0;
+    };
+
+} // namespace DriveGuard
+
+#endif // IDENTITY_STORE_H
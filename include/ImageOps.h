@@ -0,0 +1,50 @@
+#ifndef IMAGE_OPS_H
+#define IMAGE_OPS_H
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+namespace DriveGuard {
+
+    /**
+     * @brief 逐帧调用的 8 位图像运算
+     * 结果与 x86 上对应的 OpenCV 函数逐位一致，但不在内部分配临时缓冲区：
+     * 插值系数与行缓冲区按线程复用（只增不减），输出写入调用方的图像
+     * （尺寸与类型不变时 cv::Mat::create 不重新分配）。
+     */
+
+    /**
+     * @brief BGR 转灰度（同 cv::cvtColor(COLOR_BGR2GRAY)）
+     */
+    void bgrToGray(const cv::Mat& bgr, cv::Mat& gray);
+
+    /**
+     * @brief 直方图均衡化（同 cv::equalizeHist，可原地运算）
+     */
+    void equalizeHistogram(const cv::Mat& src, cv::Mat& dst);
+
+    /**
+     * @brief 双线性缩放 8 位灰度图（同 cv::resize 的 INTER_LINEAR）
+     */
+    void resizeLinear(const cv::Mat& src, cv::Mat& dst, const cv::Size& size);
+
+    /**
+     * @brief 双线性缩放 8 位灰度图（同 cv::resize 的 INTER_LINEAR_EXACT）
+     */
+    void resizeLinearExact(const cv::Mat& src, cv::Mat& dst, const cv::Size& size);
+
+    /**
+     * @brief 区域平均缩小 8 位图像（任意通道数，每个输出像素取其覆盖的输入像素均值，
+     * 用于外观缩略图与录制帧的缩小拷贝，不要求与 OpenCV 一致）
+     */
+    void resizeBox(const cv::Mat& src, cv::Mat& dst, const cv::Size& size);
+
+    /**
+     * @brief 在只增不减的存储上构造指定尺寸的 8 位灰度图像头
+     * 尺寸逐帧变化的中间图像（如缩小后的检测图）以此复用同一块内存；存储扩容后先前返回的图像头失效。
+     */
+    cv::Mat bufferView(std::vector<unsigned char>& storage, const cv::Size& size);
+
+} // namespace DriveGuard
+
+#endif // IMAGE_OPS_H
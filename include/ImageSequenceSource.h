@@ -0,0 +1,40 @@
+#ifndef IMAGE_SEQUENCE_SOURCE_H
+#define IMAGE_SEQUENCE_SOURCE_H
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "FrameSource.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 图片序列目录输入源（按文件名排序逐张读取，用于离线回放）
+     */
+    class ImageSequenceSource : public FrameSource {
+    public:
+        // 构造函数
+        ImageSequenceSource();
+
+        /**
+         * @brief 打开图片序列目录
+         * @param dir 目录路径
+         * @return 目录中有可用图片时返回 true
+         */
+        bool open(const std::string& dir);
+
+        bool read(cv::Mat& frame) override;
+        bool isLive() const override;
+        std::string describe() const override;
+        void release() override;
+
+    private:
+        std::vector<std::string> imageFiles_; // 图片序列（按文件名排序）
+        std::size_t nextImage_;
+        std::string input_;
+    };
+
+} // namespace DriveGuard
+
+#endif // IMAGE_SEQUENCE_SOURCE_H
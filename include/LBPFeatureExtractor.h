@@ -0,0 +1,93 @@
+#ifndef LBP_FEATURE_EXTRACTOR_H
+#define LBP_FEATURE_EXTRACTOR_H
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "SimdSupport.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief LBP 特征参数（与 LBPHFaceRecognizer 的构造参数含义一致）
+     */
+    struct LBPParams {
+        int radius = 1;     // 采样半径
+        int neighbors = 8;  // 邻域采样点数（支持 1~8）
+        int gridX = 8;      // 水平方向网格数
+        int gridY = 8;      // 垂直方向网格数
+    };
+
+    /**
+     * @brief LBP 编码与空间直方图特征提取器
+     * 输出与 cv::face::LBPHFaceRecognizer 内部的 elbp + spatial_histogram 逐位一致的
+     * 1 x (gridX * gridY * 2^neighbors) CV_32F 直方图，可直接与已有模型中的直方图比较。
+     * 编码阶段按 CPU 支持情况分派到 AVX2 / SSE4.1 / NEON 内核或逐像素参考实现。
+     * 内部持有编码缓冲区，非线程安全；多线程请各自持有实例。
+     */
+    class LBPFeatureExtractor {
+    public:
+        // 编码内核（SCALAR 为逐像素参考实现）
+        using Kernel = SimdLevel;
+
+        /**
+         * @brief 构造函数
+         * @param params LBP 参数
+         * @param kernel 编码内核（不可用时退回自动选择）
+         */
+        explicit LBPFeatureExtractor(const LBPParams& params = LBPParams(), Kernel kernel = Kernel::AUTO);
+
+        /**
+         * @brief 计算灰度图的空间直方图特征
+         * @param gray 灰度图（CV_8UC1）
+         * @param histogram 输出直方图（复用已有缓冲区）
+         * @return 参数或输入不受支持时返回 false
+         */
+        bool compute(const cv::Mat& gray, cv::Mat& histogram);
+
+        /**
+         * @brief 当前 LBP 参数
+         */
+        const LBPParams& params() const;
+
+        /**
+         * @brief 直方图维度
+         */
+        int histogramSize() const;
+
+        /**
+         * @brief 单个网格的像素数（直方图各格的计数总和）
+         * @param imageSize 输入图像尺寸
+         */
+        int cellArea(const cv::Size& imageSize) const;
+
+        /**
+         * @brief 实际使用的编码内核
+         */
+        Kernel kernel() const;
+
+        /**
+         * @brief 参数是否受支持
+         */
+        static bool isSupported(const LBPParams& params);
+
+    private:
+        struct Sample {
+            int dx[4];          // 四个插值像素的列偏移
+            int dy[4];          // 四个插值像素的行偏移
+            float weights[4];   // 双线性插值权重
+            bool exact;         // 采样点是否落在整数像素上
+            int exactIndex;     // exact 时实际采样的像素
+        };
+
+        void encode(const cv::Mat& gray);
+        void accumulate(cv::Mat& histogram) const;
+
+        LBPParams params_;
+        Kernel kernel_;
+        std::vector<Sample> samples_;
+        cv::Mat codes_;   // LBP 编码图缓冲区
+    };
+
+} // namespace DriveGuard
+
+#endif // LBP_FEATURE_EXTRACTOR_H
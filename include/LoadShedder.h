@@ -0,0 +1,97 @@
+#ifndef LOAD_SHEDDER_H
+#define LOAD_SHEDDER_H
+
+#include <atomic>
+#include <chrono>
+
+namespace DriveGuard {
+
+    /**
+     * @brief 降载级别（逐级累加，数值越大舍弃的工作越多）
+     */
+    enum class ShedLevel {
+        NONE,             // 不降载
+        SKIP_PASSENGERS,  // 已识别为乘客的轨迹不再重新识别
+        REDUCE_DETECTION, // 另外以降低的分辨率进行全帧人脸检测
+        DROP_FRAMES       // 另外丢弃已超出延迟预算的帧
+    };
+
+    /**
+     * @brief 降载配置
+     */
+    struct LoadShedderConfig {
+        bool enabled = true;          // 是否启用降载
+        int budgetMs = 150;           // 单帧延迟预算（采集到分析完成，毫秒）
+        double smoothing = 0.2;       // 延迟指数滑动平均的系数
+        int escalateFrames = 5;       // 平均延迟连续超出预算该帧数后升一级
+        int recoverFrames = 30;       // 平均延迟连续低于 预算 x recoverRatio 该帧数后降一级
+        double recoverRatio = 0.6;    // 恢复阈值相对预算的比例（与升级阈值之间留出滞回区间）
+        double reducedScale = 0.5;    // REDUCE_DETECTION 级别下全帧检测的缩放比例
+        int maxConsecutiveDrops = 2;  // DROP_FRAMES 级别下最多连续丢弃的帧数（保证驾驶员疲劳判定持续更新）
+    };
+
+    /**
+     * @brief 按延迟预算自适应降载
+     * 分析阶段每帧报告端到端延迟，平均延迟持续超出预算时逐级舍弃工作：
+     * 先跳过乘客的重新识别与眼部检测，再降低全帧检测分辨率，最后丢弃过期帧；
+     * 驾驶员的识别、眼部检测与疲劳判定从不舍弃。负载回落后逐级自动恢复。
+     * 每次降载决定与级别变化都计入指标。
+     * observe() 由分析线程调用，admit() 由检测线程调用，级别可在任意线程读取。
+     */
+    class LoadShedder {
+    public:
+        using TimePoint = std::chrono::steady_clock::time_point;
+
+        /**
+         * @brief 构造函数
+         * @param config 降载配置
+         */
+        explicit LoadShedder(const LoadShedderConfig& config);
+
+        /**
+         * @brief 报告一帧的端到端延迟并调整级别
+         * @param latency 采集到分析完成的耗时
+         */
+        void observe(std::chrono::steady_clock::duration latency);
+
+        /**
+         * @brief 是否处理该帧（DROP_FRAMES 级别下丢弃已超出预算的帧）
+         * @param captureTime 帧采集时间
+         * @param now 当前时间
+         * @return 丢弃时返回 false
+         */
+        bool admit(TimePoint captureTime, TimePoint now);
+
+        /**
+         * @brief 当前级别
+         */
+        ShedLevel level() const;
+
+        /**
+         * @brief 全帧检测的缩放比例（不降载时为 1）
+         */
+        double detectScale() const;
+
+        /**
+         * @brief 是否跳过乘客的重新识别
+         */
+        bool skipPassengers() const;
+
+    private:
+        void setLevel(int level);
+
+        LoadShedderConfig config_;
+        std::atomic<int> level_;
+
+        // 以下状态仅由分析线程访问
+        double averageMs_;
+        int overBudget_;
+        int underBudget_;
+
+        // 以下状态仅由检测线程访问
+        int consecutiveDrops_;
+    };
+
+} // namespace DriveGuard
+
+#endif // LOAD_SHEDDER_H
@@ -0,0 +1,161 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace DriveGuard {
+
+    /**
+     * @brief 计数器类型
+     */
+    enum class Counter {
+        FRAMES,               // 已分析帧数
+        FACES,                // 检测到的人脸总数（与 FRAMES 之比即平均人脸/帧）
+        EYE_MISSES,           // 驾驶员眼部检测未检出次数
+        PREDICTIONS_REJECTED, // 置信度超过阈值（判为陌生人）的预测次数
+        DROPPED_FRAMES,       // 流水线丢弃的帧数
+        DMS_TO_NORMAL,        // DMS 状态切换至 NORMAL 的次数
+        DMS_TO_FATIGUE,       // DMS 状态切换至 FATIGUE 的次数
+        DMS_TO_SLEEPING,      // DMS 状态切换至 SLEEPING 的次数
+        DETECT_FULL,          // 全帧人脸检测次数
+        DETECT_TRACKED,       // 跟踪模式局部搜索次数
+        IDENTITY_CACHE_HITS,  // 复用轨迹缓存身份的次数
+        IDENTITY_CACHE_MISSES,// 完整 LBPH 预测的次数
+        SHED_PASSENGERS,      // 降载：跳过乘客重新识别的次数
+        SHED_REDUCED_DETECT,  // 降载：以降低的分辨率进行全帧检测的次数
+        SHED_FRAMES,          // 降载：丢弃超出延迟预算的帧数
+        SHED_ESCALATIONS,     // 降载级别上升次数
+        SHED_RECOVERIES,      // 降载级别下降（恢复）次数
+        DRIVER_CHECKS,        // 驾驶员疲劳判定次数（降载时从不舍弃）
+        EYES_CASCADE,         // 搜索带内级联眼部检测次数
+        EYES_TRACKED,         // 模板匹配跟踪眼睛的次数
+        EVENTS_RECORDED,      // 写入事件日志的事件数
+        EVENTS_DROPPED,       // 事件环形缓冲区已满而丢弃的事件数
+        EVENT_FRAMES_DROPPED, // 帧环形缓冲区已满而未能保留的帧数
+        ALERT_CLIPS,          // 保存的告警片段数
+        RESULTS_DROPPED,      // 结果流订阅者发送缓冲区满而跳过的帧数
+        FRAME_BUS_DROPPED,    // 帧总线槽位均被读端引用（或帧超出容量）而未发布的帧数
+        FRAME_BUS_RECLAIMED,  // 帧总线从异常退出的读端收回的槽位数
+        COUNT
+    };
+
+    /**
+     * @brief 延迟直方图类型（处理阶段）
+     */
+    enum class Stage {
+        DETECT,        // 人脸检测（全帧扫描或跟踪局部搜索）
+        RECOGNIZE,     // FaceRecognizer::predict
+        EYES,          // FaceDetector::detectEyes
+        FRAME_LATENCY, // 采集到分析完成的端到端延迟
+        ENROLL,        // 后台录入（训练、持久化与模型发布）
+        COUNT
+    };
+
+    /**
+     * @brief 低开销运行时指标
+     * 每个线程写入自己的分片（单写者，relaxed 原子读写，无锁、无共享缓存行竞争），
+     * 导出时汇总所有分片。热路径上一次记录仅为数次 relaxed 原子操作。
+     */
+    class Metrics {
+    public:
+        // 直方图桶上界（微秒），最后一个桶为 +Inf
+        static constexpr std::size_t BUCKET_COUNT = 14;
+
+        /**
+         * @brief 计数器累加
+         */
+        static void increment(Counter counter, uint64_t value = 1);
+
+        /**
+         * @brief 记录一次阶段耗时
+         */
+        static void observe(Stage stage, std::chrono::steady_clock::duration elapsed);
+
+        /**
+         * @brief 读取计数器的汇总值
+         */
+        static uint64_t counterValue(Counter counter);
+
+        /**
+         * @brief 读取阶段累计耗时的汇总值（所有线程之和）
+         */
+        static std::chrono::nanoseconds stageTotal(Stage stage);
+
+        /**
+         * @brief 以 Prometheus 文本格式导出所有指标
+         */
+        static std::string renderPrometheus();
+    };
+
+    /**
+     * @brief 作用域计时器，析构时将耗时记录到对应阶段的直方图
+     */
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Stage stage) : stage_(stage), start_(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer() { Metrics::observe(stage_, std::chrono::steady_clock::now() - start_); }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Stage stage_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    /**
+     * @brief 指标导出器
+     * 后台线程周期性地将指标写入文本文件（先写临时文件再原子替换），
+     * 并可在本地 Unix 域套接字上提供抓取（连接即返回当前指标文本，仅 POSIX 平台）
+     */
+    class MetricsExporter {
+    public:
+        /**
+         * @brief 构造函数
+         * @param filePath 导出文件路径（为空则不写文件）
+         * @param socketPath Unix 域套接字路径（为空则不监听）
+         * @param intervalMs 文件导出周期（毫秒）
+         */
+        MetricsExporter(const std::string& filePath, const std::string& socketPath, int intervalMs = 5000);
+
+        /**
+         * @brief 析构函数（停止后台线程）
+         */
+        ~MetricsExporter();
+
+        MetricsExporter(const MetricsExporter&) = delete;
+        MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+        /**
+         * @brief 启动后台导出线程
+         * @return 套接字创建失败时返回 false（文件导出仍会进行）
+         */
+        bool start();
+
+        /**
+         * @brief 停止后台导出线程，并最后写出一次指标文件
+         */
+        void stop();
+
+    private:
+        void run();
+        void writeFile();
+        bool openSocket();
+        void serveSocket(int timeoutMs);
+
+        std::string filePath_;
+        std::string socketPath_;
+        int intervalMs_;
+        int listenFd_;
+        std::atomic<bool> running_;
+        std::thread thread_;
+    };
+
+} // namespace DriveGuard
+
+#endif // METRICS_H
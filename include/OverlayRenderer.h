@@ -0,0 +1,40 @@
+#ifndef OVERLAY_RENDERER_H
+#define OVERLAY_RENDERER_H
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include "FramePacket.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 叠加层渲染器
+     * 根据分析结果在图像上绘制人脸框、身份、眼睛与状态提示。
+     * 灰度帧的彩色画布与标注文字使用渲染器持有的缓冲区，逐帧复用（仅由渲染线程调用）
+     */
+    class OverlayRenderer {
+    public:
+        /**
+         * @brief 构造函数
+         * @param recordMaxImages 单次录入图片数（用于显示录入进度）
+         */
+        explicit OverlayRenderer(int recordMaxImages);
+
+        /**
+         * @brief 将帧数据包的分析结果绘制到其图像上
+         * @param packet 帧数据包
+         * @return 绘制后的图像（彩色帧为数据包中的原图，灰度帧或仍被事件记录器引用的帧为渲染器的画布，下次绘制前有效）
+         */
+        const cv::Mat& draw(FramePacket& packet);
+
+    private:
+        void putText(cv::Mat& image, const cv::Point& origin, double scale, const cv::Scalar& color, int thickness);
+
+        int recordMaxImages_;
+        cv::Mat canvas_;    // 灰度帧转换后的彩色画布（或仍被事件记录器引用的帧的拷贝）
+        std::string text_;  // 标注文字（复用容量）
+    };
+
+} // namespace DriveGuard
+
+#endif // OVERLAY_RENDERER_H
@@ -0,0 +1,36 @@
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <opencv2/opencv.hpp>
+
+namespace DriveGuard {
+
+    namespace parallel {
+        using RangeFunction = void (*)(const void* body, const cv::Range& range);
+
+        /**
+         * @brief 在常驻工作线程上执行 [0, count) 的并行循环（由 parallelFor 调用）
+         */
+        void run(int count, RangeFunction function, const void* body);
+    }
+
+    /**
+     * @brief 逐帧路径上的并行循环（用法同 cv::parallel_for_，但调度过程不分配内存）
+     * 工作线程在首次并行调用时创建并常驻，线程数取 cv::getNumThreads()（含调用线程）；
+     * 任务以函数指针与上下文指针传递，下标由原子计数器逐个分发，调用线程同时参与执行。
+     * 同一时刻只执行一个并行循环，其他线程或任务体内的嵌套调用在调用线程上串行执行。
+     * 工作线程执行任务体期间沿用调用线程的分配检查标记（见 AllocationExemption.h）。
+     * 任务体不得抛出异常。
+     * @param count 循环次数
+     * @param body 以 cv::Range 为参数的任务体
+     */
+    template <class Body>
+    void parallelFor(int count, const Body& body) {
+        parallel::run(count, [](const void* context, const cv::Range& range) {
+            (*static_cast<const Body*>(context))(range);
+        }, &body);
+    }
+
+} // namespace DriveGuard
+
+#endif // PARALLEL_FOR_H
@@ -0,0 +1,52 @@
+#ifndef RAW_YUV_SOURCE_H
+#define RAW_YUV_SOURCE_H
+
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "FrameSource.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 原始 YUV 文件输入源（逐帧读取亮度平面，可代替摄像头进行测试）
+     * 平面格式（GREY/NV12/I420）只读取 Y 平面并跳过色度；YUYV 读取整帧后抽取亮度。
+     * 指定帧率时按该帧率节拍输出并视为实时输入（与摄像头相同的丢帧策略），
+     * 否则按离线回放逐帧处理。
+     */
+    class RawYuvSource : public FrameSource {
+    public:
+        // 构造函数
+        RawYuvSource();
+
+        /**
+         * @brief 打开原始 YUV 文件
+         * @param path 文件路径
+         * @param size 帧尺寸
+         * @param format 像素格式
+         * @param fps 输出帧率（<=0 表示不限速的离线回放）
+         * @return 打开成功返回 true
+         */
+        bool open(const std::string& path, const cv::Size& size, PixelFormat format, double fps);
+
+        bool read(cv::Mat& frame) override;
+        bool isLive() const override;
+        std::string describe() const override;
+        void release() override;
+
+    private:
+        std::ifstream file_;
+        std::string path_;
+        cv::Size size_;
+        PixelFormat format_;
+        double fps_;
+        std::size_t frameBytes_;      // 整帧字节数
+        std::vector<unsigned char> packed_;   // YUYV 整帧缓冲区（复用）
+        std::chrono::steady_clock::time_point nextFrame_;
+    };
+
+} // namespace DriveGuard
+
+#endif // RAW_YUV_SOURCE_H
@@ -0,0 +1,102 @@
+#ifndef RESULT_STREAM_H
+#define RESULT_STREAM_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "FramePacket.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 结果流帧头（32 字节，按主机字节序发送，其后紧跟 faceCount 条 ResultFace）
+     */
+    struct ResultFrameHeader {
+        uint32_t magic;          // RESULT_STREAM_MAGIC（"DGRS"）
+        uint16_t version;        // RESULT_STREAM_VERSION
+        uint16_t faceCount;      // 本帧人脸数
+        uint64_t seq;            // 帧序号（各路独立递增）
+        int64_t captureTimeUs;   // 帧采集时刻（Unix 时间，微秒）
+        uint32_t latencyUs;      // 采集到发布的延迟（微秒）
+        uint8_t stream;          // 输入路编号（--input 的顺序）
+        uint8_t state;           // ModelState
+        uint16_t reserved;
+    };
+    static_assert(sizeof(ResultFrameHeader) == 32, "ResultFrameHeader 须为 32 字节");
+
+    /**
+     * @brief 结果流中的单张人脸（24 字节）
+     */
+    struct ResultFace {
+        int16_t x, y, width, height; // 人脸框（帧坐标）
+        int32_t trackId;             // 人脸轨迹编号
+        int32_t label;               // 识别标签（-1 为未登记人员）
+        float confidence;            // 识别置信度（越低越可信）
+        uint8_t role;                // UserRole
+        uint8_t driverState;         // DriverState（仅驾驶员有效）
+        uint8_t eyeCount;            // 检出的眼睛数
+        uint8_t reserved;
+    };
+    static_assert(sizeof(ResultFace) == 24, "ResultFace 须为 24 字节");
+
+    constexpr uint32_t RESULT_STREAM_MAGIC = 0x53524744; // "DGRS"（小端）
+    constexpr uint16_t RESULT_STREAM_VERSION = 1;
+
+    /**
+     * @brief 逐帧分析结果流
+     * 在 Unix 域套接字上向任意数量的下游订阅者推送定长二进制结果（帧头 + 人脸数组），
+     * 订阅者只需连接后按帧头中的 faceCount 读取。发布在结果消费线程中同步完成但从不阻塞：
+     * 监听与客户端套接字均为非阻塞，某个订阅者的发送缓冲区满时该帧对其跳过（计入指标），
+     * 只写出半帧的订阅者会被断开，以免破坏消息边界。仅 POSIX 平台。
+     */
+    class ResultStream {
+    public:
+        /**
+         * @brief 构造函数
+         * @param socketPath Unix 域套接字路径
+         */
+        explicit ResultStream(const std::string& socketPath);
+
+        /**
+         * @brief 析构函数（关闭所有连接并删除套接字文件）
+         */
+        ~ResultStream();
+
+        ResultStream(const ResultStream&) = delete;
+        ResultStream& operator=(const ResultStream&) = delete;
+
+        /**
+         * @brief 创建并监听套接字
+         * @return 套接字创建失败或平台不支持时返回 false
+         */
+        bool start();
+
+        /**
+         * @brief 关闭所有连接并删除套接字文件
+         */
+        void stop();
+
+        /**
+         * @brief 接受新的订阅者并发布一帧结果（由结果消费线程调用）
+         * @param stream 输入路编号
+         * @param packet 已分析的帧数据包
+         */
+        void publish(uint8_t stream, const FramePacket& packet);
+
+        /**
+         * @brief 当前订阅者数
+         */
+        std::size_t clients() const { return clients_.size(); }
+
+    private:
+        void acceptClients();
+
+        std::string socketPath_;
+        int listenFd_;
+        std::vector<int> clients_;
+        std::vector<unsigned char> message_; // 逐帧复用的消息缓冲区
+    };
+
+} // namespace DriveGuard
+
+#endif // RESULT_STREAM_H
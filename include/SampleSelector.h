@@ -0,0 +1,84 @@
+#ifndef SAMPLE_SELECTOR_H
+#define SAMPLE_SELECTOR_H
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <vector>
+#include "FrameContext.h"
+#include "LBPFeatureExtractor.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 录入样本筛选配置
+     */
+    struct SampleSelectorConfig {
+        bool enabled = true;             // 关闭时保留全部采集样本（与原录入行为一致）
+        int maxSamples = 10;             // 每次录入最多保留的样本数
+        double minSharpness = 20.0;      // 清晰度下限（统一尺寸人脸的拉普拉斯方差），低于视为模糊
+        double minBrightness = 40.0;     // 平均亮度下限
+        double maxBrightness = 220.0;    // 平均亮度上限
+        double minContrast = 15.0;       // 对比度下限（灰度标准差）
+        int minFaceSize = 60;            // 人脸框边长下限（帧像素）
+        double duplicateDistance = 20.0; // 与已保留样本的卡方距离低于该值视为近似重复（与识别置信度同一尺度）
+    };
+
+    /**
+     * @brief 单张采集样本的质量
+     */
+    struct SampleQuality {
+        double sharpness = 0.0;   // 拉普拉斯方差
+        double brightness = 0.0;  // 平均亮度
+        double contrast = 0.0;    // 灰度标准差
+        int faceSize = 0;         // 人脸框较短边（帧像素）
+        double score = 0.0;       // 综合评分（0~1，越高越好）
+    };
+
+    /**
+     * @brief 录入样本筛选
+     * 采集时按清晰度、曝光与人脸尺寸为每张人脸评分并剔除不合格的样本（assess，分析线程调用，开销为一次
+     * 统一尺寸人脸上的拉普拉斯与均值方差）；采集结束后在后台提取 LBP 直方图，以质量加权的最远点策略
+     * 从候选中选出少量互不重复、姿态与表情差异尽量大的样本（select）。
+     * LBPH 直方图按网格统计，头部转动与表情变化都会拉开距离，因此以特征距离衡量样本间的差异。
+     * 图库越小，之后每次识别的线性扫描越快，模型文件也越小。
+     * 内部持有计算缓冲区，非线程安全；分析线程与录入线程各自持有实例。
+     */
+    class SampleSelector {
+    public:
+        /**
+         * @brief 构造函数
+         * @param config 筛选配置
+         */
+        explicit SampleSelector(const SampleSelectorConfig& config = SampleSelectorConfig());
+
+        /**
+         * @brief 评估一张采集的人脸
+         * @param face 人脸样本
+         * @param quality 输出质量
+         * @return 样本合格时返回 true（筛选关闭时总是返回 true）
+         */
+        bool assess(FaceSample& face, SampleQuality& quality);
+
+        /**
+         * @brief 从采集的样本中选出保留的样本（原地筛选，保留的样本维持采集顺序）
+         * @param images 统一尺寸的灰度人脸样本
+         * @param scores 与 images 一一对应的质量评分
+         * @param params 识别模型的 LBP 参数（与图库距离同一尺度）
+         * @return 剔除的近似重复样本数
+         */
+        std::size_t select(std::vector<cv::Mat>& images, std::vector<double>& scores, const LBPParams& params);
+
+        /**
+         * @brief 筛选配置
+         */
+        const SampleSelectorConfig& config() const;
+
+    private:
+        SampleSelectorConfig config_;
+        cv::Mat laplacian_;                 // assess 的拉普拉斯缓冲区
+        std::vector<cv::Mat> histograms_;   // select 的直方图缓冲区
+    };
+
+} // namespace DriveGuard
+
+#endif // SAMPLE_SELECTOR_H
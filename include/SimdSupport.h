@@ -0,0 +1,35 @@
+#ifndef SIMD_SUPPORT_H
+#define SIMD_SUPPORT_H
+
+namespace DriveGuard {
+
+    /**
+     * @brief SIMD 指令集级别
+     * 各 SIMD 内核位于 src/simd/ 下按文件单独开启编译选项，运行时按 CPU 支持情况分派
+     */
+    enum class SimdLevel {
+        AUTO,    // 按 CPU 支持情况自动选择
+        SCALAR,  // 标量实现
+        SSE41,
+        AVX2,
+        NEON
+    };
+
+    /**
+     * @brief 当前 CPU 与构建配置是否支持指定级别
+     */
+    bool isSimdAvailable(SimdLevel level);
+
+    /**
+     * @brief 解析指令集级别（AUTO 或不可用时返回当前 CPU 上最快的可用级别）
+     */
+    SimdLevel resolveSimdLevel(SimdLevel level);
+
+    /**
+     * @brief 指令集级别名称
+     */
+    const char* simdLevelName(SimdLevel level);
+
+} // namespace DriveGuard
+
+#endif // SIMD_SUPPORT_H
@@ -0,0 +1,77 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace DriveGuard {
+
+    /**
+     * @brief 单生产者单消费者无锁环形缓冲区
+     * 槽位在构造时一次性分配，生产者在槽位中原地写入（可复用槽位内已有的缓冲区），
+     * 消费者原地读取后释放槽位。两端均不加锁、不阻塞：满时 push 直接返回 false。
+     * 生产者与消费者各自至多一个线程同时访问（同一端可以在不同线程间先后交接）。
+     */
+    template <typename T>
+    class SpscRing {
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 槽位数（至少为 1）
+         */
+        explicit SpscRing(std::size_t capacity)
+            : slots_((capacity > 0 ? capacity : 1) + 1), head_(0), tail_(0) {}
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        /**
+         * @brief 生产者：在下一个空闲槽位中写入
+         * @param fill 写入函数，参数为槽位引用
+         * @return 环形缓冲区已满时返回 false（fill 不会被调用）
+         */
+        template <typename Fill>
+        bool push(Fill&& fill) {
+            std::size_t tail = tail_.load(std::memory_order_relaxed);
+            std::size_t next = advance(tail);
+            if (next == head_.load(std::memory_order_acquire)) return false;
+            fill(slots_[tail]);
+            tail_.store(next, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief 消费者：读取最旧的槽位并释放
+         * @param take 读取函数，参数为槽位引用
+         * @return 环形缓冲区为空时返回 false
+         */
+        template <typename Take>
+        bool pop(Take&& take) {
+            std::size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire)) return false;
+            take(slots_[head]);
+            head_.store(advance(head), std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief 是否为空（仅供参考，另一端可能同时改变）
+         */
+        bool empty() const {
+            return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+        }
+
+    private:
+        std::size_t advance(std::size_t index) const {
+            return index + 1 == slots_.size() ? 0 : index + 1;
+        }
+
+        std::vector<T> slots_;                       // 多留一个槽位以区分满与空
+        alignas(64) std::atomic<std::size_t> head_;  // 消费者读取位置
+        alignas(64) std::atomic<std::size_t> tail_;  // 生产者写入位置
+    };
+
+} // namespace DriveGuard
+
+#endif // SPSC_RING_H
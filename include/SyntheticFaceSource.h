@@ -0,0 +1,74 @@
+#ifndef SYNTHETIC_FACE_SOURCE_H
+#define SYNTHETIC_FACE_SOURCE_H
+
+#include <opencv2/opencv.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+#include "FaceDetector.h"
+#include "FrameSource.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 合成画面中一帧人脸的外观
+     */
+    struct SyntheticFrame {
+        bool faceVisible = true; // 是否绘制人脸（false 时只有背景，模拟人脸短暂丢失）
+        bool eyesOpen = true;    // 睁眼或闭眼
+        cv::Point offset;        // 人脸中心相对画面中心的偏移（像素）
+    };
+
+    /**
+     * @brief 合成人脸输入源（用于不依赖录制片段的测试与稳态分配检查）
+     * 在均匀背景上绘制一张正面卡通人脸（脸型、眉毛、眼睛、鼻子与嘴）并做轻度高斯模糊，
+     * models/ 下的正面人脸与眼睛级联能稳定检出：睁眼时在眼部搜索带内检出两只眼睛，闭眼时检不出。
+     * 每帧的外观由脚本按帧序号给出；画布与模糊输出复用缓冲区。
+     */
+    class SyntheticFaceSource : public FrameSource {
+    public:
+        using Script = std::function<SyntheticFrame(long index)>;
+
+        /**
+         * @brief 构造函数
+         * @param frames 帧数
+         * @param script 按帧序号（从 0 开始）给出人脸外观
+         * @param size 画面尺寸
+         * @param faceSize 人脸尺寸（像素，检出的人脸框约为其 1.15 倍）
+         */
+        SyntheticFaceSource(long frames, Script script, cv::Size size = cv::Size(640, 480), int faceSize = 280);
+
+        bool read(cv::Mat& frame) override;
+        bool isLive() const override;
+        std::string describe() const override;
+        void release() override;
+
+        /**
+         * @brief 在 BGR 画面上绘制一张人脸（未模糊）
+         * @param canvas BGR 画面
+         * @param center 人脸中心
+         * @param faceSize 人脸尺寸（像素）
+         * @param eyesOpen 睁眼或闭眼
+         */
+        static void drawFace(cv::Mat& canvas, cv::Point center, int faceSize, bool eyesOpen);
+
+        /**
+         * @brief 采集合成人脸的统一尺寸灰度样本（睁眼与闭眼交替、位置略有偏移），用于在内存中录入
+         * @param detector 人脸检测器
+         * @param count 采集的帧数（检不出唯一人脸的帧跳过）
+         * @return 统一尺寸灰度人脸列表
+         */
+        static std::vector<cv::Mat> enrollmentSamples(FaceDetector& detector, int count);
+
+    private:
+        long frames_;
+        long index_;
+        Script script_;
+        cv::Size size_;
+        int faceSize_;
+        cv::Mat canvas_; // 模糊前的画面
+    };
+
+} // namespace DriveGuard
+
+#endif // SYNTHETIC_FACE_SOURCE_H
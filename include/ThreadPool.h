@@ -0,0 +1,72 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DriveGuard {
+
+    /**
+     * @brief 工作窃取线程池
+     * 每个工作线程持有自己的任务队列：工作线程内提交的任务放入本线程队列，
+     * 外部线程提交的任务轮流分配；线程本地队列为空时从其他线程队列窃取任务。
+     * 多路摄像头的处理任务共享同一个线程池，繁忙的流不会独占核心。
+     */
+    class ThreadPool {
+    public:
+        using Task = std::function<void()>;
+
+        /**
+         * @brief 构造函数
+         * @param threads 工作线程数，0 表示取硬件并发数
+         */
+        explicit ThreadPool(std::size_t threads = 0);
+
+        /**
+         * @brief 析构函数（执行完已提交的任务后停止）
+         */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief 提交任务（线程安全）
+         * @param task 任务（抛出的异常会被记录并忽略）
+         */
+        void submit(Task task);
+
+        /**
+         * @brief 工作线程数
+         */
+        std::size_t size() const;
+
+    private:
+        // 单个工作线程的任务队列
+        struct Worker {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        void run(std::size_t index);
+        bool take(std::size_t index, Task& task);
+
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::vector<std::thread> threads_;
+        std::mutex sleepMutex_;
+        std::condition_variable wake_;
+        std::atomic<std::size_t> pending_;   // 已提交未取走的任务数
+        std::atomic<std::size_t> next_;      // 外部提交的轮转位置
+        std::atomic<bool> stopping_;
+    };
+
+} // namespace DriveGuard
+
+#endif // THREAD_POOL_H
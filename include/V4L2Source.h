@@ -0,0 +1,58 @@
+#ifndef V4L2_SOURCE_H
+#define V4L2_SOURCE_H
+
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <string>
+#include "FrameSource.h"
+
+namespace DriveGuard {
+
+    struct V4L2Device;
+
+    /**
+     * @brief Linux V4L2 mmap 流式采集输入源（只输出亮度平面）
+     * NV12/I420/GREY 的 Y 平面是连续的，直接以驱动缓冲区构造 cv::Mat 交给流水线，不拷贝、不转换；
+     * 缓冲区在最后一个引用该帧的 cv::Mat 释放时自动归还驱动（VIDIOC_QBUF），
+     * 因此缓冲区数须大于流水线中同时存在的帧数。
+     * YUYV 的亮度与色度交错存放，无法零拷贝表示为单通道图像，抽取一次亮度后立即归还缓冲区
+     * （仍比解码为 BGR 再转灰度少一次整帧转换）。
+     * 仅在 Linux 上可用，其他平台 open() 返回 false。
+     */
+    class V4L2Source : public FrameSource {
+    public:
+        // 构造函数
+        V4L2Source();
+
+        // 析构函数
+        ~V4L2Source() override;
+
+        V4L2Source(const V4L2Source&) = delete;
+        V4L2Source& operator=(const V4L2Source&) = delete;
+
+        /**
+         * @brief 打开设备并开始流式采集
+         * @param device 设备路径（如 /dev/video0）
+         * @param size 请求的帧尺寸（为空则使用驱动当前设置）
+         * @param format 请求的像素格式（autoFormat 为 true 时依次尝试 NV12、I420、GREY、YUYV）
+         * @param autoFormat 是否自动选择像素格式
+         * @return 打开成功返回 true
+         */
+        bool open(const std::string& device, const cv::Size& size, PixelFormat format, bool autoFormat);
+
+        bool read(cv::Mat& frame) override;
+        bool isLive() const override;
+        std::string describe() const override;
+        void release() override;
+
+    private:
+        std::shared_ptr<V4L2Device> device_; // 设备与映射的缓冲区（未归还的帧持有其引用）
+        std::string path_;
+        cv::Size size_;
+        PixelFormat format_;
+        std::size_t bytesPerLine_;
+    };
+
+} // namespace DriveGuard
+
+#endif // V4L2_SOURCE_H
@@ -0,0 +1,41 @@
+#ifndef VIDEO_CAPTURE_SOURCE_H
+#define VIDEO_CAPTURE_SOURCE_H
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include "FrameSource.h"
+
+namespace DriveGuard {
+
+    /**
+     * @brief 基于 cv::VideoCapture 的输入源（摄像头或视频文件，输出 BGR 帧）
+     */
+    class VideoCaptureSource : public FrameSource {
+    public:
+        // 构造函数
+        VideoCaptureSource();
+
+        // 析构函数
+        ~VideoCaptureSource() override;
+
+        /**
+         * @brief 打开输入源
+         * @param input 摄像头编号（如 "0"）或视频文件路径
+         * @return 打开成功返回 true
+         */
+        bool open(const std::string& input);
+
+        bool read(cv::Mat& frame) override;
+        bool isLive() const override;
+        std::string describe() const override;
+        void release() override;
+
+    private:
+        cv::VideoCapture cap_;
+        bool isLive_;
+        std::string input_;
+    };
+
+} // namespace DriveGuard
+
+#endif // VIDEO_CAPTURE_SOURCE_H
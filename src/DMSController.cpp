@@ -1,10 +1,24 @@
 #include "DMSController.h"
+#include "Metrics.h"
+#include <algorithm>
 
 namespace DriveGuard {
-    // 构造函数
-    DMSController::DMSController() {
-        NoEyesCount_ = 0;
-        currentState_ = DriverState::NORMAL;
+    namespace {
+        double toMs(std::chrono::steady_clock::duration d) {
+            return std::chrono::duration<double, std::milli>(d).count();
+        }
+    }
+
+    /**
+     * @brief 构造函数
+     * @param config 疲劳判定配置
+     */
+    DMSController::DMSController(const DMSConfig& config)
+        : config_(config), headIndex_(0), observedMs_(0.0), windowClosedMs_(0.0), started_(false),
+          closed_(false), closedMs_(0.0), currentState_(DriverState::NORMAL) {
+        int buckets = std::max(1, config_.perclosBuckets);
+        bucketMs_ = std::max(1.0, (double)config_.perclosWindowMs / buckets);
+        buckets_.resize(buckets);
     }
 
     // 析构函数
@@ -15,30 +29,141 @@ namespace DriveGuard {
     /**
      * @brief 更新驾驶员状态
      * @param getsEyes 是否检测到眼睛
-     * @param fps 当前帧率（用于计算时间）
+     * @param time 该帧的采集时间戳（须单调不减）
      */
-    void DMSController::update(bool getsEyes, double fps) {
-        // 如果检测到眼睛，重置状态
+    void DMSController::update(bool getsEyes, TimePoint time) {
+        DriverState previousState = currentState_;
+
+        // 本次观测代表自上一次观测以来的时长；间隔过长（轨迹丢失、严重丢帧）时 PERCLOS 只计入上限，
+        // 间隔超过轨迹超时才视为观测中断（低头打盹时人脸常短暂丢失，降载也会让观测变稀疏）
+        double countedMs = 0.0;
+        bool interrupted = false;
+        if (!started_) {
+            started_ = true;
+            origin_ = time;
+        } else {
+            double gapMs = std::max(0.0, toMs(time - last_));
+            interrupted = gapMs > config_.trackTimeoutMs;
+            countedMs = std::min(gapMs, (double)config_.maxGapMs);
+        }
+        last_ = std::max(last_, time);
+
+        // 写入滑动窗口
+        advanceTo((long long)(std::max(0.0, toMs(time - origin_)) / bucketMs_));
+        Bucket& head = buckets_[headIndex_ % buckets_.size()];
+        head.observedMs += countedMs;
+        observedMs_ += countedMs;
+        if (!getsEyes) {
+            head.closedMs += countedMs;
+            windowClosedMs_ += countedMs;
+        }
+
+        // 连续闭眼时长：间隔前后都是闭眼时连续计时（跨越间隔），从睁眼转为闭眼时只补计不超过 maxGapMs 的间隔；
+        // 观测中断（超过轨迹超时）后重新起算
         if (getsEyes) {
-            NoEyesCount_ = 0;
+            closed_ = false;
+            closedMs_ = 0.0;
+        } else {
+            if (!closed_ || interrupted) {
+                closed_ = true;
+                closedSince_ = time - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double, std::milli>(countedMs));
+            }
+            closedMs_ = toMs(time - closedSince_);
+        }
+
+        if (closedMs_ >= config_.sleepingMs) {
+            currentState_ = DriverState::SLEEPING;
+        } else if (closedMs_ >= config_.fatigueMs ||
+                   (config_.perclosThreshold > 0.0 && perclos() >= config_.perclosThreshold)) {
+            currentState_ = DriverState::FATIGUE;
+        } else {
             currentState_ = DriverState::NORMAL;
         }
-        // 如果未检测到眼睛，判断当前状态
-        else {
-            NoEyesCount_++;
-            if (NoEyesCount_ >= SLEEPING_THRESHOLD_) {
-                currentState_ = DriverState::SLEEPING;
-            } else if (NoEyesCount_ >= FATIGUE_THRESHOLD_) {
-                currentState_ = DriverState::FATIGUE;
+
+        // 记录状态切换
+        if (currentState_ != previousState) {
+            switch (currentState_) {
+                case DriverState::NORMAL: Metrics::increment(Counter::DMS_TO_NORMAL); break;
+                case DriverState::FATIGUE: Metrics::increment(Counter::DMS_TO_FATIGUE); break;
+                case DriverState::SLEEPING: Metrics::increment(Counter::DMS_TO_SLEEPING); break;
             }
         }
     }
 
+    /**
+     * @brief 将环形缓冲推进到指定桶，移出窗口的桶从累计值中扣除
+     */
+    void DMSController::advanceTo(long long bucketIndex) {
+        if (bucketIndex <= headIndex_) return;
+        long long steps = std::min<long long>(bucketIndex - headIndex_, (long long)buckets_.size());
+        for (long long i = 1; i <= steps; i++) {
+            Bucket& bucket = buckets_[(bucketIndex - steps + i) % buckets_.size()];
+            observedMs_ -= bucket.observedMs;
+            windowClosedMs_ -= bucket.closedMs;
+            bucket = Bucket();
+        }
+        // 消除浮点累计误差
+        observedMs_ = std::max(0.0, observedMs_);
+        windowClosedMs_ = std::max(0.0, windowClosedMs_);
+        headIndex_ = bucketIndex;
+    }
+
     /**
      * @brief 获取当前警告信息
      */
     std::string DMSController::getWarning() {
-        switch (currentState_) {
+        return warningOf(currentState_);
+    }
+
+    /**
+     * @brief 获取状态颜色 (绿/黄/红)
+     */
+    cv::Scalar DMSController::getStatusColor() {
+        return colorOf(currentState_);
+    }
+
+    /**
+     * @brief 是否疲劳或睡眠
+     */
+    bool DMSController::isFatigueOrSleeping() {
+        return currentState_ == DriverState::FATIGUE || currentState_ == DriverState::SLEEPING;
+    }
+
+    /**
+     * @brief 获取当前驾驶员状态
+     */
+    DriverState DMSController::getState() const {
+        return currentState_;
+    }
+
+    /**
+     * @brief 当前连续闭眼时长（毫秒）
+     */
+    double DMSController::closedMs() const {
+        return closedMs_;
+    }
+
+    /**
+     * @brief 滑动窗口内的闭眼时间占比（窗口内观测不足一半时返回 0）
+     */
+    double DMSController::perclos() const {
+        if (observedMs_ <= 0.0 || observedMs_ < config_.perclosWindowMs * 0.5) return 0.0;
+        return std::min(1.0, windowClosedMs_ / observedMs_);
+    }
+
+    /**
+     * @brief 最近一次更新的时间
+     */
+    DMSController::TimePoint DMSController::lastUpdate() const {
+        return last_;
+    }
+
+    /**
+     * @brief 获取指定状态对应的警告信息
+     */
+    const char* DMSController::warningOf(DriverState state) {
+        switch (state) {
             case DriverState::NORMAL: return "Driver(State: NORMAL)";
             case DriverState::FATIGUE: return "Driver(State: FATIGUE!)";
             case DriverState::SLEEPING: return "Driver(State: SLEEPING!!!)";
@@ -47,21 +172,14 @@ namespace DriveGuard {
     }
 
     /**
-     * @brief 获取状态颜色 (绿/黄/红)
+     * @brief 获取指定状态对应的颜色 (绿/黄/红)
      */
-    cv::Scalar DMSController::getStatusColor() {
-        switch (currentState_) {
+    cv::Scalar DMSController::colorOf(DriverState state) {
+        switch (state) {
             case DriverState::NORMAL: return cv::Scalar(0, 255, 0); // 正常：绿色
             case DriverState::FATIGUE: return cv::Scalar(0, 255, 255); // 疲劳：黄色
             case DriverState::SLEEPING: return cv::Scalar(0, 0, 255); // 睡眠：红色
             default: return cv::Scalar(0, 0, 0); // 未知：黑色
         }
     }
-
-    /**
-     * @brief 是否疲劳或睡眠
-     */
-    bool DMSController::isFatigueOrSleeping() {
-        return currentState_ == DriverState::FATIGUE || currentState_ == DriverState::SLEEPING;
-    }
 }
\ No newline at end of file
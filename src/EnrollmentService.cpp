@@ -0,0 +1,145 @@
+#include "EnrollmentService.h"
+#include "GalleryStore.h"
+#include "Metrics.h"
+#include <chrono>
+#include <iostream>
+
+namespace DriveGuard {
+    /**
+     * @brief 构造函数
+     * @param recognizer 初始模型
+     * @param modelPath 识别模型保存路径
+     * @param labelInfoPath ID-Name 映射表保存路径
+     * @param selector 录入样本筛选配置
+     */
+    EnrollmentService::EnrollmentService(std::shared_ptr<FaceRecognizer> recognizer, const std::string& modelPath,
+                                         const std::string& labelInfoPath, const SampleSelectorConfig& selector)
+        : recognizer_(std::move(recognizer)), version_(0), modelPath_(modelPath), labelInfoPath_(labelInfoPath),
+          selector_(selector), hasJob_(false), running_(false), busy_(false) {
+    }
+
+    /**
+     * @brief 析构函数（等待进行中的任务完成后停止后台线程）
+     */
+    EnrollmentService::~EnrollmentService() {
+        stop();
+    }
+
+    /**
+     * @brief 启动后台线程
+     */
+    void EnrollmentService::start() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) return;
+        running_ = true;
+        thread_ = std::thread(&EnrollmentService::run, this);
+    }
+
+    /**
+     * @brief 停止后台线程（已提交的任务会先完成并保存）
+     */
+    void EnrollmentService::stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) return;
+            running_ = false;
+        }
+        cv_.notify_all();
+        if (thread_.joinable()) thread_.join();
+    }
+
+    /**
+     * @brief 当前已发布的模型（线程安全）
+     */
+    std::shared_ptr<FaceRecognizer> EnrollmentService::current() const {
+        return std::atomic_load(&recognizer_);
+    }
+
+    /**
+     * @brief 已发布模型的版本号（每次发布加一）
+     */
+    uint64_t EnrollmentService::version() const {
+        return version_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 提交录入任务（线程安全）
+     * @return 已有任务在排队或训练中时返回 false
+     */
+    bool EnrollmentService::submit(EnrollmentJob job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_ || busy_) return false;
+            job_ = std::move(job);
+            hasJob_ = true;
+            busy_ = true;
+        }
+        cv_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief 是否有任务在排队或训练中
+     */
+    bool EnrollmentService::busy() const {
+        return busy_.load();
+    }
+
+    /**
+     * @brief 后台线程：等待并处理录入任务
+     */
+    void EnrollmentService::run() {
+        while (true) {
+            EnrollmentJob job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return hasJob_ || !running_; });
+                if (!hasJob_) return; // 已停止且没有待处理任务
+                job = std::move(job_);
+                hasJob_ = false;
+            }
+            process(job);
+            busy_ = false;
+        }
+    }
+
+    /**
+     * @brief 在当前模型的副本上训练并保存，然后发布
+     */
+    void EnrollmentService::process(EnrollmentJob& job) {
+        ScopedTimer timer(Stage::ENROLL);
+        auto start = std::chrono::steady_clock::now();
+
+        // 复制当前快照（映射的图库段共享，不拷贝），分析线程继续使用旧快照
+        std::shared_ptr<FaceRecognizer> next = std::make_shared<FaceRecognizer>(*current());
+
+        // 剔除近似重复的样本，保留少量差异较大的样本（图库越小，识别越快）
+        std::size_t captured = job.images.size();
+        std::size_t duplicates = selector_.select(job.images, job.scores, next->params());
+        if (job.images.size() < captured) {
+            std::cout << "[INFO] 录入样本筛选：采集 " << captured << " 张，保留 " << job.images.size()
+                      << " 张（近似重复 " << duplicates << " 张）" << std::endl;
+        }
+
+        std::vector<int> labels(job.images.size(), job.label);
+        next->update(job.images, labels);
+        next->setLabelInfo(job.label, job.name, job.role);
+
+        // 发布前完成持久化：已发布的识别器不再被修改
+        if (!next->appendModel(modelPath_)) {
+            std::cerr << "[WARN] 模型保存失败，新用户仅在本次运行中有效：" << modelPath_ << std::endl;
+        }
+        if (!next->saveLabelInfo(labelInfoPath_)) {
+            std::cerr << "[WARN] 映射表保存失败，新用户仅在本次运行中有效：" << labelInfoPath_ << std::endl;
+        }
+        if (GalleryStore::isBinaryPath(modelPath_) && GalleryStore::needsCompaction(modelPath_)) {
+            GalleryStore::compact(modelPath_);
+        }
+
+        std::atomic_store(&recognizer_, next);
+        version_.fetch_add(1, std::memory_order_acq_rel);
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "[INFO] 用户 " << job.name << " 录入完成，新模型已发布（后台耗时 " << (int)ms << " ms）" << std::endl;
+    }
+}
@@ -0,0 +1,249 @@
+#include "EventRecorder.h"
+#include "ImageOps.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+namespace DriveGuard {
+    namespace {
+        // events.bin 文件头：魔数、版本与单条记录长度
+        const char EVENT_FILE_MAGIC[4] = {'D', 'G', 'E', 'V'};
+        const uint32_t EVENT_FILE_VERSION = 1;
+        // 写线程空闲时的轮询间隔
+        const int IDLE_SLEEP_MS = 5;
+
+        bool isAlert(const EventRecord& record) {
+            return record.type == (uint8_t)EventType::DRIVER_STATE
+                && (record.state == (uint8_t)DriverState::FATIGUE || record.state == (uint8_t)DriverState::SLEEPING);
+        }
+    }
+
+    /**
+     * @brief 构造函数
+     * @param config 记录配置
+     */
+    EventRecorder::EventRecorder(const EventRecorderConfig& config)
+        : config_(config), frames_(config.frameSlots), events_(config.eventSlots), running_(false),
+          clipLastSeq_(0), clipFrames_(0) {
+        jpegParams_ = {cv::IMWRITE_JPEG_QUALITY, std::min(100, std::max(1, config_.jpegQuality))};
+    }
+
+    /**
+     * @brief 析构函数（写完剩余事件与帧后停止后台线程）
+     */
+    EventRecorder::~EventRecorder() {
+        stop();
+    }
+
+    /**
+     * @brief 创建输出目录并启动后台写线程
+     * @return 目录或事件文件无法创建时返回 false
+     */
+    bool EventRecorder::start() {
+        if (running_) return true;
+
+        std::error_code ec;
+        std::filesystem::create_directories(config_.directory, ec);
+        std::string path = (std::filesystem::path(config_.directory) / "events.bin").string();
+        bool fresh = !std::filesystem::exists(path) || std::filesystem::file_size(path, ec) == 0;
+        eventFile_.open(path, std::ios::binary | std::ios::app);
+        if (!eventFile_) {
+            std::cerr << "[ERROR] 无法创建事件日志：" << path << std::endl;
+            return false;
+        }
+        if (fresh) {
+            uint32_t recordSize = sizeof(EventRecord);
+            eventFile_.write(EVENT_FILE_MAGIC, sizeof(EVENT_FILE_MAGIC));
+            eventFile_.write(reinterpret_cast<const char*>(&EVENT_FILE_VERSION), sizeof(EVENT_FILE_VERSION));
+            eventFile_.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize));
+        }
+
+        running_ = true;
+        thread_ = std::thread(&EventRecorder::run, this);
+        std::cout << "[INFO] 事件记录：" << config_.directory << std::endl;
+        return true;
+    }
+
+    /**
+     * @brief 写完剩余事件与帧（含进行中的片段）后停止后台写线程
+     */
+    void EventRecorder::stop() {
+        if (!running_.exchange(false)) return;
+        if (thread_.joinable()) thread_.join();
+    }
+
+    /**
+     * @brief 提交一帧（分析线程调用，不阻塞）
+     * @param packet 已分析的帧数据包
+     */
+    void EventRecorder::recordFrame(const FramePacket& packet) {
+        if (!running_ || packet.frame.empty()) return;
+        // 自有帧只增加引用计数，全分辨率编码留给写线程；借用的缓冲区随数据包归还，只能缩小拷贝
+        bool queued = frames_.push([this, &packet](FrameSlot& slot) {
+            slot.borrowed = !isOwnedFrame(packet.frame);
+            if (slot.borrowed) {
+                cv::Size size(std::max(1, (int)(packet.frame.cols * config_.borrowedScale)),
+                              std::max(1, (int)(packet.frame.rows * config_.borrowedScale)));
+                resizeBox(packet.frame, slot.scaled, size);
+            } else {
+                slot.shared = packet.frame;
+            }
+            slot.seq = packet.seq;
+            slot.time = packet.captureTime;
+        });
+        if (!queued) Metrics::increment(Counter::EVENT_FRAMES_DROPPED);
+    }
+
+    /**
+     * @brief 提交一条事件（分析线程调用，不阻塞）
+     * @param type 事件类型
+     * @param packet 事件所在的帧
+     * @param result 事件对应的人脸结果
+     */
+    void EventRecorder::recordEvent(EventType type, const FramePacket& packet, const FaceResult& result) {
+        if (!running_) return;
+        bool queued = events_.push([&](PendingEvent& event) {
+            EventRecord& record = event.record;
+            record.timeUs = toUnixMicros(packet.captureTime);
+            record.frameSeq = packet.seq;
+            record.type = (uint8_t)type;
+            record.state = type == EventType::DRIVER_STATE ? (uint8_t)result.driverState : (uint8_t)result.role;
+            record.reserved = 0;
+            record.trackId = result.trackId;
+            record.label = type == EventType::UNKNOWN_PERSON ? -1 : result.label;
+            record.confidence = (float)result.confidence;
+            event.time = packet.captureTime;
+        });
+        if (!queued) Metrics::increment(Counter::EVENTS_DROPPED);
+    }
+
+    /**
+     * @brief 后台写线程：取出事件与帧，空闲时短暂休眠；停止时写完剩余内容
+     */
+    void EventRecorder::run() {
+        while (running_) {
+            if (!drain()) std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_SLEEP_MS));
+        }
+        while (drain()) {}
+        closeClip();
+        eventFile_.flush();
+    }
+
+    /**
+     * @brief 先取事件再取帧（告警事件先打开片段，其后的帧即写入片段）
+     * @return 本次取到了事件或帧
+     */
+    bool EventRecorder::drain() {
+        bool any = false;
+        int written = 0;
+        while (events_.pop([this](const PendingEvent& event) { writeEvent(event); })) {
+            any = true;
+            written++;
+        }
+        if (written > 0) eventFile_.flush();
+        while (frames_.pop([this](FrameSlot& slot) { encodeFrame(slot); })) {
+            any = true;
+        }
+        return any;
+    }
+
+    /**
+     * @brief 追加写入一条事件记录；告警事件打开（或延长）片段
+     */
+    void EventRecorder::writeEvent(const PendingEvent& event) {
+        eventFile_.write(reinterpret_cast<const char*>(&event.record), sizeof(EventRecord));
+        Metrics::increment(Counter::EVENTS_RECORDED);
+        if (isAlert(event.record)) openClip(event);
+    }
+
+    /**
+     * @brief 编码一帧并保留最近 preAlertMs 的帧；录制片段期间同时写入片段（编码后释放共享的帧）
+     */
+    void EventRecorder::encodeFrame(FrameSlot& slot) {
+        const auto preAlert = std::chrono::milliseconds(config_.preAlertMs);
+
+        // 复用过期帧的编码缓冲区
+        EncodedFrame frame;
+        if (!history_.empty() && slot.time - history_.front().time > preAlert) {
+            frame = std::move(history_.front());
+            history_.pop_front();
+        }
+        frame.seq = slot.seq;
+        frame.time = slot.time;
+        bool encoded = cv::imencode(".jpg", slot.borrowed ? slot.scaled : slot.shared, frame.jpeg, jpegParams_);
+        slot.shared.release(); // 帧缓冲区交还帧池
+        if (!encoded) return;
+
+        if (!clipDirectory_.empty()) {
+            if (frame.time <= clipUntil_) {
+                writeClipFrame(frame);
+            } else {
+                closeClip();
+            }
+        }
+
+        history_.push_back(std::move(frame));
+        while (!history_.empty() && history_.back().time - history_.front().time > preAlert) {
+            history_.pop_front();
+        }
+    }
+
+    /**
+     * @brief 打开告警片段并写入告警前保留的帧（已在录制时只延长截止时间）
+     */
+    void EventRecorder::openClip(const PendingEvent& event) {
+        auto until = event.time + std::chrono::milliseconds(config_.postAlertMs);
+        if (!clipDirectory_.empty()) {
+            clipUntil_ = std::max(clipUntil_, until);
+            return;
+        }
+
+        const EventRecord& record = event.record;
+        char name[64];
+        std::snprintf(name, sizeof(name), "alert_%06llu_%s", (unsigned long long)record.frameSeq,
+                      record.state == (uint8_t)DriverState::SLEEPING ? "sleeping" : "fatigue");
+        std::filesystem::path dir = std::filesystem::path(config_.directory) / name;
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        if (ec) {
+            std::cerr << "[ERROR] 无法创建告警片段目录：" << dir.string() << std::endl;
+            return;
+        }
+
+        clipDirectory_ = dir.string();
+        clipUntil_ = until;
+        clipLastSeq_ = 0;
+        clipFrames_ = 0;
+        for (const auto& frame : history_) writeClipFrame(frame);
+        Metrics::increment(Counter::ALERT_CLIPS);
+    }
+
+    /**
+     * @brief 结束进行中的片段
+     */
+    void EventRecorder::closeClip() {
+        if (clipDirectory_.empty()) return;
+        std::cout << "[INFO] 已保存告警片段：" << clipDirectory_ << "（" << clipFrames_ << " 帧）" << std::endl;
+        clipDirectory_.clear();
+    }
+
+    /**
+     * @brief 以帧序号命名写入片段目录（文件名按序排列，可作为图片目录输入回放）
+     */
+    void EventRecorder::writeClipFrame(const EncodedFrame& frame) {
+        if (clipFrames_ > 0 && frame.seq <= clipLastSeq_) return;
+        char name[32];
+        std::snprintf(name, sizeof(name), "%012llu.jpg", (unsigned long long)frame.seq);
+        std::ofstream file(std::filesystem::path(clipDirectory_) / name, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(frame.jpeg.data()), (std::streamsize)frame.jpeg.size());
+        if (!file) {
+            std::cerr << "[WARN] 告警片段帧写入失败：" << clipDirectory_ << "/" << name << std::endl;
+            return;
+        }
+        clipLastSeq_ = frame.seq;
+        clipFrames_++;
+    }
+}
@@ -0,0 +1,254 @@
+#include "EyeTracker.h"
+#include "ImageOps.h"
+#include "Metrics.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace DriveGuard {
+    namespace {
+        // 级联眼睛检测的最小尺寸下限（像素）
+        const int MIN_EYE_SIZE = 15;
+        // 模板保存与匹配时的边长（像素）：眼睛按该尺寸比较，匹配代价不随人脸尺寸增长
+        const int MATCH_SIZE = 24;
+
+        cv::Rect toPixels(const cv::Rect2d& relative, const cv::Size& face) {
+            return cv::Rect((int)(relative.x * face.width + 0.5), (int)(relative.y * face.height + 0.5),
+                            (int)(relative.width * face.width + 0.5), (int)(relative.height * face.height + 0.5));
+        }
+
+        cv::Rect2d toRelative(const cv::Rect& box, const cv::Size& face) {
+            return cv::Rect2d((double)box.x / face.width, (double)box.y / face.height,
+                              (double)box.width / face.width, (double)box.height / face.height);
+        }
+
+        /**
+         * @brief 在图像中滑动模板，返回归一化相关系数（与 cv::TM_CCOEFF_NORMED 定义相同）最高的位置
+         * 模板与窗口均为 MATCH_SIZE 量级的小图，按定义以整数累加直接计算；方差为零的窗口得分为 0
+         * @return 最高得分
+         */
+        double bestCorrelation(const cv::Mat& image, const cv::Mat& templ, cv::Point& location) {
+            const int tw = templ.cols;
+            const int th = templ.rows;
+            const double n = (double)tw * th;
+            int64_t sumT = 0;
+            int64_t sumT2 = 0;
+            for (int y = 0; y < th; y++) {
+                const unsigned char* t = templ.ptr<unsigned char>(y);
+                for (int x = 0; x < tw; x++) {
+                    sumT += t[x];
+                    sumT2 += t[x] * t[x];
+                }
+            }
+            const double varT = (double)sumT2 - (double)sumT * sumT / n;
+
+            double best = 0.0;
+            location = cv::Point(0, 0);
+            for (int oy = 0; oy + th <= image.rows; oy++) {
+                for (int ox = 0; ox + tw <= image.cols; ox++) {
+                    int64_t sumI = 0;
+                    int64_t sumI2 = 0;
+                    int64_t sumTI = 0;
+                    for (int y = 0; y < th; y++) {
+                        const unsigned char* t = templ.ptr<unsigned char>(y);
+                        const unsigned char* p = image.ptr<unsigned char>(oy + y) + ox;
+                        int rowI = 0;
+                        int rowI2 = 0;
+                        int rowTI = 0;
+                        for (int x = 0; x < tw; x++) {
+                            rowI += p[x];
+                            rowI2 += p[x] * p[x];
+                            rowTI += p[x] * t[x];
+                        }
+                        sumI += rowI;
+                        sumI2 += rowI2;
+                        sumTI += rowTI;
+                    }
+                    const double varI = (double)sumI2 - (double)sumI * sumI / n;
+                    const double denominator = std::sqrt(varT * varI);
+                    if (!(denominator > 1e-6)) continue;
+                    const double score = ((double)sumTI - (double)sumT * sumI / n) / denominator;
+                    if (score > best) {
+                        best = score;
+                        location = cv::Point(ox, oy);
+                    }
+                }
+            }
+            return best;
+        }
+    }
+
+    /**
+     * @brief 构造函数
+     * @param detector 人脸检测器（提供眼睛级联分类器）
+     * @param config 眼部定位配置
+     */
+    EyeTracker::EyeTracker(FaceDetector& detector, const EyeTrackerConfig& config)
+        : detector_(detector), config_(config), frameIndex_(0) {
+    }
+
+    /**
+     * @brief 开始新的一帧（推进帧计数并丢弃长期未出现的轨迹）
+     */
+    void EyeTracker::advance() {
+        frameIndex_++;
+        for (auto it = states_.begin(); it != states_.end();) {
+            if (frameIndex_ - it->second.lastSeen > (uint64_t)config_.maxIdleFrames) {
+                it = states_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /**
+     * @brief 定位单张人脸的眼睛
+     * @param face 人脸样本
+     * @param eyes 输出的眼睛矩形框列表（相对人脸区域，复用已有容量）
+     */
+    void EyeTracker::detect(const FaceSample& face, std::vector<cv::Rect>& eyes) {
+        if (face.trackId() >= 0) {
+            locate(face, states_[face.trackId()], eyes);
+            return;
+        }
+        if (scratch_.empty()) scratch_.resize(1);
+        scratch_[0].eyeCount = 0;
+        scratch_[0].framesSinceCascade = 0;
+        locate(face, scratch_[0], eyes);
+    }
+
+    /**
+     * @brief 批量定位（多张人脸并行，轨迹编号须各不相同）
+     * @param faces 人脸样本
+     * @param eyes 输出的各人脸眼睛矩形框列表（相对人脸区域），与 faces 一一对应（复用已有容量）
+     */
+    void EyeTracker::detectBatch(const std::vector<const FaceSample*>& faces, std::vector<std::vector<cv::Rect>>& eyes) {
+        // 先串行取出各轨迹的状态（并行阶段不修改映射表）；无轨迹的人脸使用清空的临时状态
+        std::vector<State*>& states = batchStates_;
+        states.assign(faces.size(), nullptr);
+        if (scratch_.size() < faces.size()) scratch_.resize(faces.size());
+        for (std::size_t i = 0; i < faces.size(); i++) {
+            if (faces[i]->trackId() >= 0) {
+                states[i] = &states_[faces[i]->trackId()];
+            } else {
+                scratch_[i].eyeCount = 0;
+                scratch_[i].framesSinceCascade = 0;
+                states[i] = &scratch_[i];
+            }
+        }
+
+        eyes.resize(faces.size());
+        parallelFor((int)faces.size(), [&](const cv::Range& range) {
+            for (int i = range.start; i < range.end; i++) {
+                locate(*faces[i], *states[i], eyes[i]);
+            }
+        });
+    }
+
+    /**
+     * @brief 周期内优先模板跟踪，失败或到期时在几何约束的搜索带内级联检测
+     */
+    void EyeTracker::locate(const FaceSample& face, State& state, std::vector<cv::Rect>& eyes) {
+        ScopedTimer timer(Stage::EYES);
+        state.lastSeen = frameIndex_;
+
+        eyes.clear();
+        bool canTrack = config_.enabled
+                     && state.eyeCount > 0
+                     && state.framesSinceCascade + 1 < config_.redetectInterval;
+        if (canTrack && track(face, state, eyes)) {
+            state.framesSinceCascade++;
+            Metrics::increment(Counter::EYES_TRACKED);
+            return;
+        }
+
+        Metrics::increment(Counter::EYES_CASCADE);
+        cascade(face, state, eyes);
+    }
+
+    /**
+     * @brief 在上次眼睛位置附近做模板匹配（模板与缩放后的搜索窗口均为 MATCH_SIZE 比例）
+     * @return 所有眼睛均匹配成功返回 true（状态中的位置随之更新）
+     */
+    bool EyeTracker::track(const FaceSample& face, State& state, std::vector<cv::Rect>& eyes) {
+        const cv::Mat& roi = face.equalized();
+        cv::Rect bounds(0, 0, roi.cols, roi.rows);
+
+        // 缩放窗口的缓冲区按最大可能尺寸一次分配（外扩后的窗口按模板比例缩放不超过该尺寸）
+        const int capacity = (int)std::ceil(MATCH_SIZE * (1.0 + 2.0 * config_.searchPadding)) + 2;
+        state.window.create(capacity, capacity, CV_8UC1);
+
+        cv::Rect2d updated[MAX_EYES];
+        for (int i = 0; i < state.eyeCount; i++) {
+            const Eye& eye = state.eyes[i];
+            // 人脸框缩放后按当前尺寸推算眼睛位置
+            cv::Rect predicted = toPixels(eye.relative, roi.size());
+            if (predicted.width < 4 || predicted.height < 4) return false;
+
+            int padX = (int)(predicted.width * config_.searchPadding);
+            int padY = (int)(predicted.height * config_.searchPadding);
+            cv::Rect window = cv::Rect(predicted.x - padX, predicted.y - padY,
+                                       predicted.width + 2 * padX, predicted.height + 2 * padY) & bounds;
+            if (window.width < predicted.width || window.height < predicted.height) return false;
+
+            // 搜索窗口按模板与预测框的比例缩放，使预测框恰好缩放为模板尺寸
+            const double fx = (double)MATCH_SIZE / predicted.width;
+            const double fy = (double)MATCH_SIZE / predicted.height;
+            cv::Size scaled(std::min(capacity, std::max(MATCH_SIZE, (int)std::lround(window.width * fx))),
+                            std::min(capacity, std::max(MATCH_SIZE, (int)std::lround(window.height * fy))));
+            cv::Mat scaledWindow = state.window(cv::Rect(cv::Point(0, 0), scaled));
+            resizeLinear(roi(window), scaledWindow, scaled);
+
+            cv::Point location;
+            double best = bestCorrelation(scaledWindow, eye.templ, location);
+            if (best < config_.matchThreshold) return false;
+
+            cv::Rect found(window.x + (int)std::lround(location.x / fx), window.y + (int)std::lround(location.y / fy),
+                           predicted.width, predicted.height);
+            found &= bounds;
+            updated[i] = toRelative(found, roi.size());
+            eyes.push_back(found);
+        }
+
+        // 只更新位置，模板保持为级联检出时的睁眼外观
+        for (int i = 0; i < state.eyeCount; i++) {
+            state.eyes[i].relative = updated[i];
+        }
+        return true;
+    }
+
+    /**
+     * @brief 在人脸上部的搜索带内以人脸宽度推算的尺寸范围运行级联检测，并更新模板
+     */
+    void EyeTracker::cascade(const FaceSample& face, State& state, std::vector<cv::Rect>& eyes) {
+        const cv::Mat& roi = face.equalized();
+        state.framesSinceCascade = 0;
+        if (roi.empty()) {
+            state.eyeCount = 0;
+            return;
+        }
+
+        int top = (int)(roi.rows * config_.bandTop);
+        int bottom = (int)(roi.rows * config_.bandBottom);
+        cv::Rect band(0, top, roi.cols, std::max(0, bottom - top));
+        int minSide = std::max(MIN_EYE_SIZE, (int)(roi.cols * config_.minEyeRatio));
+        int maxSide = std::max(minSide, (int)(roi.cols * config_.maxEyeRatio));
+
+        detector_.detectEyesInRegion(face, band, cv::Size(minSide, minSide), cv::Size(maxSide, maxSide), eyes);
+
+        // 保留最大的两只眼睛，按从左到右排列
+        if (eyes.size() > (std::size_t)MAX_EYES) {
+            std::partial_sort(eyes.begin(), eyes.begin() + MAX_EYES, eyes.end(),
+                              [](const cv::Rect& a, const cv::Rect& b) { return a.area() > b.area(); });
+            eyes.resize(MAX_EYES);
+        }
+        std::sort(eyes.begin(), eyes.end(), [](const cv::Rect& a, const cv::Rect& b) { return a.x < b.x; });
+
+        // 模板缩放为固定尺寸写入已有缓冲区（眼睛大小变化时也不重新分配）
+        state.eyeCount = (int)eyes.size();
+        for (int i = 0; i < state.eyeCount; i++) {
+            state.eyes[i].relative = toRelative(eyes[i], roi.size());
+            resizeLinear(roi(eyes[i]), state.eyes[i].templ, cv::Size(MATCH_SIZE, MATCH_SIZE));
+        }
+    }
+}
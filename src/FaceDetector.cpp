@@ -1,19 +1,67 @@
 #include "FaceDetector.h"
+#include "ImageOps.h"
+#include "Metrics.h"
+#include "ParallelFor.h"
+#include "AllocationExemption.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
 #include <iostream>
+#include <mutex>
+#include <sstream>
 #include <stdexcept>
 
 namespace DriveGuard {
+    namespace {
+        std::atomic<uint64_t> nextInstanceId{1};
+
+        // 存活的检测器实例编号（只在构造、析构与线程首次使用某实例时加锁）
+        std::mutex& liveInstancesMutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        std::vector<uint64_t>& liveInstances() {
+            static std::vector<uint64_t> instances;
+            return instances;
+        }
+    }
+
     /**
      * @brief 构造函数
      * @param faceModelPath 人脸识别模型的路径
      * @param eyeModelPath 眼睛识别模型的路径
+     * @param backend 级联检测后端（使用编译级联时不读取上述模型文件）
      */
-    FaceDetector::FaceDetector(const std::string& modelPath, const std::string& eyeModelPath) : isLoaded_(false), scaleFactor_(1.1), minNeighbors_(5) {
-        
-        // 使用 std::make_unique 创建实例 (C++14特性)
+    FaceDetector::FaceDetector(const std::string& modelPath, const std::string& eyeModelPath, CascadeBackend backend)
+        : instanceId_(nextInstanceId++), backend_(CascadeBackend::OPENCV), isLoaded_(false), scaleFactor_(1.1),
+          minNeighbors_(5) {
+        {
+            std::lock_guard<std::mutex> lock(liveInstancesMutex());
+            liveInstances().push_back(instanceId_);
+        }
+
+        if (backend == CascadeBackend::COMPILED && !hasCompiledCascades()) {
+            std::cerr << "[WARN] 本构建未包含编译级联 (DRIVEGUARD_COMPILED_CASCADES=OFF)，改为读取模型文件" << std::endl;
+        }
+
+#ifdef DRIVEGUARD_COMPILED_CASCADES
+        // 编译级联：模型已在构建时编入程序，无需读取与解析 XML
+        if (backend != CascadeBackend::OPENCV) {
+            backend_ = CascadeBackend::COMPILED;
+            compiledFace_ = std::make_unique<HaarCascade>(cascades::FRONTAL_FACE);
+            compiledEye_ = std::make_unique<HaarCascade>(cascades::EYE);
+            isLoaded_ = true;
+            std::cout << "[INFO] 使用编译级联: " << cascades::FRONTAL_FACE.name << ", " << cascades::EYE.name
+                      << " (" << simdLevelName(compiledFace_->kernel()) << ")" << std::endl;
+            return;
+        }
+#endif
+
+        // 模型文件只读取一次，并在构造线程上解析一次以校验格式
         bool isfaceLoaded = false;
-        classifier_ = std::make_unique<cv::CascadeClassifier>();
-        if (classifier_->load(modelPath)) {
+        if (readFile(modelPath, faceXml_) && parse(faceXml_)) {
             isfaceLoaded = true;
             std::cout << "[INFO] 人脸模型加载成功: " << modelPath << std::endl;
         } else {
@@ -21,10 +69,9 @@ namespace DriveGuard {
             isfaceLoaded = false;
         }
 
-        // 创建眼睛实例
+        // 读取眼睛模型
         bool iseyeLoaded = false;
-        eyeClassifier_ = std::make_unique<cv::CascadeClassifier>();
-        if (eyeClassifier_->load(eyeModelPath)) {
+        if (readFile(eyeModelPath, eyeXml_) && parse(eyeXml_)) {
             iseyeLoaded = true;
             std::cout << "[INFO] 眼睛模型加载成功: " << eyeModelPath << std::endl;
         } else {
@@ -40,7 +87,12 @@ namespace DriveGuard {
      * @brief 析构函数
      */
     FaceDetector::~FaceDetector() {
-        // unique_ptr 会自动释放内存，此处旨在使结构清晰
+        // 其他线程中本实例的分类器副本在这些线程下次创建副本或退出时释放
+        {
+            std::lock_guard<std::mutex> lock(liveInstancesMutex());
+            auto& instances = liveInstances();
+            instances.erase(std::remove(instances.begin(), instances.end(), instanceId_), instances.end());
+        }
         std::cout << "[INFO] 释放 FaceDetector 资源" << std::endl;
     }
 
@@ -52,45 +104,136 @@ namespace DriveGuard {
         return isLoaded_;
     }
 
+    /**
+     * @brief 实际使用的级联检测后端
+     */
+    CascadeBackend FaceDetector::backend() const {
+        return backend_;
+    }
+
+    /**
+     * @brief 构建是否包含编译级联
+     */
+    bool FaceDetector::hasCompiledCascades() {
+#ifdef DRIVEGUARD_COMPILED_CASCADES
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief 解析后端名称（auto、opencv、compiled）
+     */
+    bool FaceDetector::parseBackend(const std::string& name, CascadeBackend& backend) {
+        if (name == "auto") backend = CascadeBackend::AUTO;
+        else if (name == "opencv") backend = CascadeBackend::OPENCV;
+        else if (name == "compiled") backend = CascadeBackend::COMPILED;
+        else return false;
+        return true;
+    }
+
+    /**
+     * @brief 后端名称
+     */
+    const char* FaceDetector::backendName(CascadeBackend backend) {
+        switch (backend) {
+            case CascadeBackend::AUTO: return "auto";
+            case CascadeBackend::OPENCV: return "opencv";
+            case CascadeBackend::COMPILED: return "compiled";
+        }
+        return "unknown";
+    }
+
     /**
      * @brief 检测图像中的人脸
      * @param frame 输入的图像帧
      * @return 检测到的人脸矩形框列表
      */
     std::vector<cv::Rect> FaceDetector::detect(const cv::Mat& frame) {
+        // 如果图像为空，返回空列表
+        if (frame.empty()) {
+            return {};
+        }
+
+        FrameContext context;
+        context.prepare(frame);
         std::vector<cv::Rect> faces;
-        
+        detect(context, faces);
+        return faces;
+    }
+
+    /**
+     * @brief 在已预处理的帧中检测人脸（直接使用帧上下文中的均衡化灰度图）
+     * @param context 帧预处理上下文
+     * @param faces 输出的人脸矩形框列表（帧坐标）
+     * @param scale 检测分辨率相对原帧的比例
+     */
+    void FaceDetector::detect(const FrameContext& context, std::vector<cv::Rect>& faces, double scale) {
+        faces.clear();
+
         // 如果模型未加载或图像为空，返回空列表
-        if (!isLoaded_ || frame.empty()) {
-            return faces;
+        if (!isLoaded_ || context.equalized().empty()) {
+            return;
         }
 
-        cv::Mat gray;
-        // 转换为灰度图以提高检测速度和准确率
-        if (frame.channels() == 3) {
-            cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-        } else {
-            gray = frame;
+        // 降低分辨率时先缩小均衡化图（最小人脸尺寸随之缩小，但不低于级联窗口）；
+        // 缩小图与级联金字塔使用相同的插值，写入按线程复用的缓冲区（只增不减，降载比例变化时不重新分配）
+        const cv::Mat& equalized = context.equalized();
+        thread_local std::vector<unsigned char> scaledBuffer;
+        cv::Mat scaled;
+        cv::Size minSize(30, 30);
+        if (scale > 0.0 && scale < 1.0) {
+            cv::Size size(std::max(1, (int)std::lround(equalized.cols * scale)),
+                          std::max(1, (int)std::lround(equalized.rows * scale)));
+            scaled = bufferView(scaledBuffer, size);
+            resizeLinearExact(equalized, scaled, size);
+            int side = std::max(20, (int)(30 * scale));
+            minSize = cv::Size(side, side);
         }
 
-        // 直方图均衡化，改善对比度
-        cv::equalizeHist(gray, gray);
-
         // 多尺度检测
-        try {
-            classifier_->detectMultiScale(
-                gray, 
-                faces, 
-                scaleFactor_, 
-                minNeighbors_, 
-                0 | cv::CASCADE_SCALE_IMAGE, 
-                cv::Size(30, 30)
-            );
-        } catch (const cv::Exception& e) {
-            std::cerr << "[ERROR] OpenCV Exception: " << e.what() << std::endl;
+        runFaceCascade(scaled.empty() ? equalized : scaled, faces, minSize);
+
+        // 转换回帧坐标
+        if (!scaled.empty()) {
+            for (auto& face : faces) {
+                face = cv::Rect((int)(face.x / scale), (int)(face.y / scale),
+                                (int)(face.width / scale), (int)(face.height / scale))
+                     & cv::Rect(0, 0, context.equalized().cols, context.equalized().rows);
+            }
         }
+    }
 
-        return faces;
+    /**
+     * @brief 仅在指定区域内检测人脸（用于跟踪模式的局部搜索）
+     * @param context 帧预处理上下文
+     * @param region 搜索区域（帧坐标，越界部分自动裁剪）
+     * @param minSize 最小人脸尺寸
+     * @param maxSize 最大人脸尺寸
+     * @param faces 输出的人脸矩形框列表（帧坐标）
+     */
+    void FaceDetector::detectInRegion(const FrameContext& context, const cv::Rect& region, const cv::Size& minSize,
+                                      const cv::Size& maxSize, std::vector<cv::Rect>& faces) {
+        faces.clear();
+
+        const cv::Mat& equalized = context.equalized();
+        if (!isLoaded_ || equalized.empty()) {
+            return;
+        }
+
+        cv::Rect roi = region & cv::Rect(0, 0, equalized.cols, equalized.rows);
+        if (roi.width < minSize.width || roi.height < minSize.height) {
+            return;
+        }
+
+        runFaceCascade(equalized(roi), faces, minSize, maxSize);
+
+        // 转换回帧坐标
+        for (auto& face : faces) {
+            face.x += roi.x;
+            face.y += roi.y;
+        }
     }
 
     /**
@@ -99,11 +242,11 @@ namespace DriveGuard {
      * @return 检测到的眼睛矩形框列表
      */
     std::vector<cv::Rect> FaceDetector::detectEyes(const cv::Mat& faceROI) {
-        std::vector<cv::Rect> eyes;
+        ScopedTimer timer(Stage::EYES);
 
-        // 如果模型未加载或人脸区域为空，返回空列表
-        if (!isLoaded_ || faceROI.empty()) {
-            return eyes;
+        // 如果人脸区域为空，返回空列表
+        if (faceROI.empty()) {
+            return {};
         }
 
         cv::Mat grayROI;
@@ -114,19 +257,187 @@ namespace DriveGuard {
             grayROI = faceROI; // 假设外部已经处理过灰度
         }
 
+        std::vector<cv::Rect> eyes;
+        runEyeCascade(grayROI, eyes);
+        return eyes;
+    }
+
+    /**
+     * @brief 在人脸样本中检测眼睛（直接使用样本的均衡化灰度区域）
+     * @param face 人脸样本
+     * @param eyes 输出的眼睛矩形框列表（相对人脸区域，复用已有容量）
+     */
+    void FaceDetector::detectEyes(const FaceSample& face, std::vector<cv::Rect>& eyes) {
+        ScopedTimer timer(Stage::EYES);
+        runEyeCascade(face.equalized(), eyes);
+    }
+
+    /**
+     * @brief 仅在人脸的指定区域内以给定尺寸范围检测眼睛（用于几何约束的眼部定位）
+     * @param face 人脸样本
+     * @param region 搜索区域（相对人脸区域，越界部分自动裁剪）
+     * @param minSize 最小眼睛尺寸
+     * @param maxSize 最大眼睛尺寸
+     * @param eyes 输出的眼睛矩形框列表（相对人脸区域）
+     */
+    void FaceDetector::detectEyesInRegion(const FaceSample& face, const cv::Rect& region, const cv::Size& minSize,
+                                          const cv::Size& maxSize, std::vector<cv::Rect>& eyes) {
+        eyes.clear();
+        const cv::Mat& equalized = face.equalized();
+        cv::Rect roi = region & cv::Rect(0, 0, equalized.cols, equalized.rows);
+        if (roi.width < minSize.width || roi.height < minSize.height) {
+            return;
+        }
+
+        // 转换回人脸区域坐标
+        runEyeCascade(equalized(roi), eyes, minSize, maxSize);
+        for (auto& eye : eyes) {
+            eye.x += roi.x;
+            eye.y += roi.y;
+        }
+    }
+
+    /**
+     * @brief 批量眼部检测（多张人脸并行检测）
+     * @param faces 人脸样本
+     * @param eyes 输出的各人脸眼睛矩形框列表（相对人脸区域），与 faces 一一对应（复用已有容量）
+     */
+    void FaceDetector::detectEyesBatch(const std::vector<const FaceSample*>& faces,
+                                       std::vector<std::vector<cv::Rect>>& eyes) {
+        // 每个工作线程使用自己的分类器副本，结果按下标写入调用方的容器
+        eyes.resize(faces.size());
+        parallelFor((int)faces.size(), [&](const cv::Range& range) {
+            for (int i = range.start; i < range.end; i++) {
+                detectEyes(*faces[i], eyes[i]);
+            }
+        });
+    }
+
+    /**
+     * @brief 在均衡化灰度图上运行人脸级联分类器
+     */
+    void FaceDetector::runFaceCascade(const cv::Mat& image, std::vector<cv::Rect>& faces, const cv::Size& minSize,
+                                      const cv::Size& maxSize) {
+        try {
+            if (compiledFace_) {
+                compiledFace_->detectMultiScale(image, faces, scaleFactor_, minNeighbors_, minSize, maxSize);
+            } else {
+                faceClassifier().detectMultiScale(
+                    image,
+                    faces,
+                    scaleFactor_,
+                    minNeighbors_,
+                    0 | cv::CASCADE_SCALE_IMAGE,
+                    minSize,
+                    maxSize
+                );
+            }
+        } catch (const cv::Exception& e) {
+            std::cerr << "[ERROR] OpenCV Exception: " << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * @brief 在均衡化灰度人脸区域上运行眼睛级联分类器
+     */
+    void FaceDetector::runEyeCascade(const cv::Mat& grayROI, std::vector<cv::Rect>& eyes, const cv::Size& minSize,
+                                     const cv::Size& maxSize) {
+        eyes.clear();
+
+        // 如果模型未加载或人脸区域为空，返回空列表
+        if (!isLoaded_ || grayROI.empty()) {
+            return;
+        }
+
         try {
             // 眼睛检测通常需要稍微不同的参数，这里 minNeighbors 设大一点以减少误检
-            eyeClassifier_->detectMultiScale(
-                grayROI, eyes, 1.1, 3, 0 | cv::CASCADE_SCALE_IMAGE, cv::Size(15, 15)
-            );
+            if (compiledEye_) {
+                compiledEye_->detectMultiScale(grayROI, eyes, 1.1, 3, minSize, maxSize);
+            } else {
+                eyeClassifier().detectMultiScale(
+                    grayROI, eyes, 1.1, 3, 0 | cv::CASCADE_SCALE_IMAGE, minSize, maxSize
+                );
+            }
         } catch (const cv::Exception& e) {
             std::cerr << "[ERROR] Eye Detection Exception: " << e.what() << std::endl;
         }
+    }
 
-        return eyes;
+    /**
+     * @brief 当前线程为本实例保存的分类器副本
+     * 副本存放在线程局部存储中，查找不加锁；线程退出时随之释放，不随线程更替累积。
+     * 线程首次使用某个实例时顺带丢弃已析构实例的副本（实例编号不复用，不会误用旧模型）。
+     */
+    FaceDetector::Cascades& FaceDetector::localCascades() {
+        thread_local std::vector<std::pair<uint64_t, Cascades>> cascades;
+        for (auto& entry : cascades) {
+            if (entry.first == instanceId_) return entry.second;
+        }
+
+        // 每个线程、每个实例只发生一次
+        AllocationExemption firstUse;
+        {
+            std::lock_guard<std::mutex> lock(liveInstancesMutex());
+            const auto& live = liveInstances();
+            cascades.erase(std::remove_if(cascades.begin(), cascades.end(), [&live](const auto& entry) {
+                return std::find(live.begin(), live.end(), entry.first) == live.end();
+            }), cascades.end());
+        }
+        cascades.emplace_back(instanceId_, Cascades());
+        return cascades.back().second;
     }
 
+    /**
+     * @brief 当前线程的人脸分类器（首次调用时从内存中的模型解析）
+     */
+    cv::CascadeClassifier& FaceDetector::faceClassifier() {
+        Cascades& cascades = localCascades();
+        if (!cascades.face) {
+            AllocationExemption firstUse; // 每个线程解析一次
+            cascades.face = parse(faceXml_);
+        }
+        return *cascades.face;
+    }
 
+    /**
+     * @brief 当前线程的眼睛分类器（首次调用时从内存中的模型解析）
+     */
+    cv::CascadeClassifier& FaceDetector::eyeClassifier() {
+        Cascades& cascades = localCascades();
+        if (!cascades.eye) {
+            AllocationExemption firstUse; // 每个线程解析一次
+            cascades.eye = parse(eyeXml_);
+        }
+        return *cascades.eye;
+    }
+
+    /**
+     * @brief 读取模型文件内容
+     */
+    bool FaceDetector::readFile(const std::string& path, std::string& content) {
+        std::ifstream ifs(path, std::ios::in | std::ios::binary);
+        if (!ifs.is_open()) return false;
+        std::ostringstream oss;
+        oss << ifs.rdbuf();
+        content = oss.str();
+        return !content.empty();
+    }
+
+    /**
+     * @brief 从内存中的 XML 解析级联分类器
+     * @return 解析失败时返回空分类器（detectMultiScale 抛出的异常由调用方记录）
+     */
+    std::unique_ptr<cv::CascadeClassifier> FaceDetector::parse(const std::string& xml) {
+        auto classifier = std::make_unique<cv::CascadeClassifier>();
+        try {
+            cv::FileStorage fs(xml, cv::FileStorage::READ | cv::FileStorage::MEMORY);
+            if (!fs.isOpened() || !classifier->read(fs.getFirstTopLevelNode())) return nullptr;
+        } catch (const cv::Exception& e) {
+            std::cerr << "[ERROR] 级联模型解析失败: " << e.what() << std::endl;
+            return nullptr;
+        }
+        return classifier;
+    }
 
 } // namespace DriveGuard
 
@@ -1,19 +1,48 @@
 #include "FaceRecognizer.h"
+#include "AllocationExemption.h"
+#include "GalleryStore.h"
+#include "Metrics.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cfloat>
 #include <iostream>
-#include <fstream>
+#include <memory>
 
 namespace DriveGuard {
+    namespace {
+        /**
+         * @brief 当前线程的预测缓冲区（特征提取器非线程安全，同一模型可被多个线程并发预测）
+         */
+        struct PredictBuffer {
+            std::unique_ptr<LBPFeatureExtractor> extractor;
+            cv::Mat query;
+            std::vector<double> distances;  // 图库各行的距离
+            GalleryIndex::SearchBuffer search; // 索引检索的中间缓冲区
+            std::vector<GalleryMatch> matches;
+        };
+
+        PredictBuffer& predictBuffer(const LBPParams& params) {
+            thread_local PredictBuffer buffer;
+            const LBPParams* current = buffer.extractor ? &buffer.extractor->params() : nullptr;
+            if (!current || current->radius != params.radius || current->neighbors != params.neighbors
+                || current->gridX != params.gridX || current->gridY != params.gridY) {
+                // 每个线程首次预测（或模型参数变化）时创建一次，之后逐帧复用
+                AllocationExemption firstUse;
+                buffer.extractor = std::make_unique<LBPFeatureExtractor>(params);
+            }
+            return buffer;
+        }
+    }
+
     // 构造函数
-    FaceRecognizer::FaceRecognizer() {
-        // 创建 LBPH 识别器
+    FaceRecognizer::FaceRecognizer() : gallery_(makeGallery(extractor_)), threshold_(DBL_MAX), persistedRows_(0) {
+        // LBPH 默认参数
         // radius=1, neighbors=8, grid_x=8, grid_y=8
         // threshold=DBL_MAX (可以后续设置阈值，超过阈值则返回 -1)
-        model_ = cv::face::LBPHFaceRecognizer::create();
     }
 
     // 析构函数
     FaceRecognizer::~FaceRecognizer() {
-        // cv::Ptr会自动释放内存
     }
 
     // /**
@@ -33,7 +62,7 @@ namespace DriveGuard {
     // }
 
     /**
-     * @brief 更新模型（增量训练）
+     * @brief 更新模型（增量训练，样本特征在多个核心上并行提取）
      * @param images 新的人脸图像列表
      * @param labels 新的人脸标签列表
      */
@@ -43,19 +72,42 @@ namespace DriveGuard {
             return;
         }
 
-        try {
-            std::cout << "[INFO] 开始更新模型，新增样本数：" << images.size() << std::endl;
-            model_->update(images, labels);
-            std::cout << "[INFO] 模型更新完成" << std::endl;
-        } catch (const cv::Exception& e) {
-            std::cerr << "[WARN] 更新失败（可能是首次训练），尝试重新训练: " << e.what() << std::endl;
-            model_->train(images, labels);
+        std::cout << "[INFO] 开始更新模型，新增样本数：" << images.size() << std::endl;
+
+        // 各工作线程使用自己的特征提取器，直方图按下标写回，图库仍按输入顺序追加
+        std::vector<cv::Mat> histograms(images.size());
+        std::vector<unsigned char> extracted(images.size(), 0);
+        cv::parallel_for_(cv::Range(0, (int)images.size()), [&](const cv::Range& range) {
+            PredictBuffer& buffer = predictBuffer(extractor_.params());
+            for (int i = range.start; i < range.end; i++) {
+                extracted[i] = buffer.extractor->compute(images[i], histograms[i]) ? 1 : 0;
+            }
+        });
+
+        std::size_t firstRow = gallery_.rows();
+        gallery_.reserve(firstRow + images.size());
+        for (std::size_t i = 0; i < images.size(); i++) {
+            const cv::Mat& histogram = histograms[i];
+            if (!extracted[i]) {
+                std::cerr << "[WARN] 跳过无法提取特征的样本：" << i << std::endl;
+                continue;
+            }
+
+            // 非统一尺寸的样本无法按当前网格像素数无损量化，退回 float 存储
+            if (!GalleryMatrix::isLossless(histogram, gallery_.precision(), gallery_.cellArea())) {
+                std::cerr << "[WARN] 样本尺寸与 " << FACE_SAMPLE_SIZE << "x" << FACE_SAMPLE_SIZE
+                          << " 不一致，图库改为 float 存储" << std::endl;
+                gallery_.convert(GalleryPrecision::FLOAT32);
+            }
+            gallery_.append(histogram, labels[i]);
         }
+        index_.add(gallery_, extractor_.params(), firstRow);
+        std::cout << "[INFO] 模型更新完成" << std::endl;
     }
 
     /**
      * @brief 预测身份
-     * @param image 人脸图像
+     * @param image 人脸图像（将被转为灰度并缩放至 FACE_SAMPLE_SIZE）
      * @param confidence 置信度
      * @return 预测结果
      */
@@ -71,21 +123,119 @@ namespace DriveGuard {
             gray = image;
         }
 
+        // 与录入样本保持相同尺寸
+        if (gray.cols != FACE_SAMPLE_SIZE || gray.rows != FACE_SAMPLE_SIZE) {
+            cv::resize(gray, gray, cv::Size(FACE_SAMPLE_SIZE, FACE_SAMPLE_SIZE));
+        }
+
+        return predictNormalized(gray, confidence);
+    }
+
+    /**
+     * @brief 预测身份（使用人脸样本中已预处理的统一尺寸灰度图）
+     * @param face 人脸样本
+     * @param confidence 置信度
+     * @return 预测结果
+     */
+    int FaceRecognizer::predict(FaceSample& face, double& confidence) {
+        const cv::Mat& gray = face.normalized();
+        if (gray.empty()) return -1;
+        return predictNormalized(gray, confidence);
+    }
+
+    /**
+     * @brief 批量预测（一帧内的多张人脸并行提取特征与匹配）
+     * @param faces 人脸样本（各不相同）
+     * @param labels 输出预测结果，与 faces 一一对应
+     * @param confidences 输出置信度，与 faces 一一对应
+     */
+    void FaceRecognizer::predictBatch(const std::vector<FaceSample*>& faces, std::vector<int>& labels,
+                                      std::vector<double>& confidences) {
+        labels.assign(faces.size(), -1);
+        confidences.assign(faces.size(), 0.0);
+
+        // 每个工作线程使用自己的特征缓冲区，结果按下标写回，保持输入顺序
+        parallelFor((int)faces.size(), [&](const cv::Range& range) {
+            for (int i = range.start; i < range.end; i++) {
+                labels[i] = predict(*faces[i], confidences[i]);
+            }
+        });
+    }
+
+    /**
+     * @brief 对统一尺寸的灰度人脸进行预测
+     */
+    int FaceRecognizer::predictNormalized(const cv::Mat& gray, double& confidence) {
+        ScopedTimer timer(Stage::RECOGNIZE);
+
         // 初始化标签和置信度
         int label = -1;
         confidence = 0.0;
+        if (gallery_.rows() == 0) return label;
+        PredictBuffer& buffer = predictBuffer(extractor_.params());
+        if (!buffer.extractor->compute(gray, buffer.query)) return label;
 
-        // 预测
-        model_->predict(gray, label, confidence);
+        // 最近邻（卡方距离，与 OpenCV LBPH 相同的度量）；身份数较多时经索引粗排后只精排候选身份
+        if (index_.ready()) {
+            index_.search(gallery_, buffer.query, 1, threshold_, buffer.search, buffer.matches);
+            if (!buffer.matches.empty()) {
+                label = buffer.matches.front().label;
+                confidence = buffer.matches.front().distance;
+            }
+            return label;
+        }
+
+        // 全量比对：距离写入线程缓冲区，不为每次预测分配内存
+        GalleryMatch match;
+        if (gallery_.nearest(buffer.query, threshold_, buffer.distances, match)) {
+            label = match.label;
+            confidence = match.distance;
+        }
         return label;
     }
 
     /**
-     * @brief 保存模型到文件
+     * @brief 保存模型到文件（YAML 与 cv::face::LBPHFaceRecognizer::write 格式一致，其余为二进制格式）
      */
     bool FaceRecognizer::saveModel(const std::string& filepath) {
+        if (GalleryStore::isBinaryPath(filepath)) {
+            if (!GalleryStore::save(filepath, gallery_, extractor_.params(), threshold_ != DBL_MAX ? threshold_ : 0.0)) {
+                std::cerr << "[ERROR] 模型保存失败，无法写入：" << filepath << std::endl;
+                return false;
+            }
+            modelPath_ = filepath;
+            persistedRows_ = gallery_.rows();
+            std::cout << "[INFO] 模型已保存至：" << filepath << std::endl;
+            return true;
+        }
+
         try {
-            model_->write(filepath);
+            cv::FileStorage fs(filepath, cv::FileStorage::WRITE);
+            if (!fs.isOpened()) {
+                std::cerr << "[ERROR] 模型保存失败，无法写入：" << filepath << std::endl;
+                return false;
+            }
+
+            const LBPParams& params = extractor_.params();
+            fs << "opencv_lbphfaces" << "{";
+            fs << "format" << 3;
+            fs << "threshold" << threshold_;
+            fs << "radius" << params.radius;
+            fs << "neighbors" << params.neighbors;
+            fs << "grid_x" << params.gridX;
+            fs << "grid_y" << params.gridY;
+            std::vector<cv::Mat> histograms(gallery_.rows());
+            for (std::size_t i = 0; i < gallery_.rows(); i++) {
+                gallery_.histogram(i, histograms[i]);
+            }
+            fs << "histograms" << histograms;
+            fs << "labels" << cv::Mat(gallery_.labels(), true);
+            fs << "labelsInfo" << "[" << "]";
+            fs << "}";
+            fs.release();
+
+            modelPath_ = filepath;
+            persistedRows_ = gallery_.rows();
             std::cout << "[INFO] 模型已保存至：" << filepath << std::endl; 
             return true;
         } catch (const cv::Exception& e) {
@@ -95,113 +245,230 @@ namespace DriveGuard {
     }
 
     /**
-     * @brief 从文件加载模型
+     * @brief 增量保存：将上次加载/保存之后新增的样本追加到二进制模型的日志段
      */
-    bool FaceRecognizer::loadModel(const std::string& filepath) {
-        try {
-            model_->read(filepath);
-            std::cout << "[INFO] 模型加载成功" << filepath << std::endl;
-            return true;
-        } catch (const cv::Exception& e) {
-            std::cerr << "[ERROR] 模型加载失败" << e.what() << std::endl;
-            return false;
+    bool FaceRecognizer::appendModel(const std::string& filepath) {
+        if (!GalleryStore::isBinaryPath(filepath) || filepath != modelPath_ || persistedRows_ > gallery_.rows()) {
+            return saveModel(filepath);
         }
+        if (persistedRows_ == gallery_.rows()) return true;
+
+        // 基础段缺失或图库精度已改变时追加失败，改为整体写出
+        if (!GalleryStore::append(filepath, gallery_, persistedRows_)) {
+            std::cerr << "[WARN] 模型日志追加失败，改为整体保存：" << filepath << std::endl;
+            return saveModel(filepath);
+        }
+        std::cout << "[INFO] 模型已追加 " << gallery_.rows() - persistedRows_ << " 个样本至："
+                  << GalleryStore::journalPath(filepath) << std::endl;
+        persistedRows_ = gallery_.rows();
+        return true;
     }
 
     /**
-     * @brief 保存 ID-Name 映射表
+     * @brief 从文件加载模型（按扩展名区分 YAML 与二进制格式）
      */
-    void FaceRecognizer::saveLabelInfo(const std::string& filepath) {
-        std::ofstream ofs;
-        ofs.open(filepath, std::ios::out);
-        if (!ofs.is_open()) {
-            std::cerr << "[ERROR] 无法保存映射表到文件：" << filepath << std::endl;
-            exit(-1);
+    bool FaceRecognizer::loadModel(const std::string& filepath) {
+        return GalleryStore::isBinaryPath(filepath) ? loadBinaryModel(filepath) : loadYamlModel(filepath);
+    }
+
+    /**
+     * @brief 加载二进制模型（基础段只读映射，日志段回放）
+     */
+    bool FaceRecognizer::loadBinaryModel(const std::string& filepath) {
+        GalleryModel model;
+        if (!GalleryStore::load(filepath, model)) {
+            std::cerr << "[ERROR] 模型加载失败，无法打开：" << filepath << std::endl;
+            return false;
+        }
+        if (!LBPFeatureExtractor::isSupported(model.params)) {
+            std::cerr << "[ERROR] 模型加载失败，不支持的 LBPH 参数：" << filepath << std::endl;
+            return false;
         }
 
-        for (const auto& [label, name] : labelToName_) {
-            int roleValue = 99;
-            if (labelToRole_.count(label)) roleValue = (int)labelToRole_[label];
-            // label:name:roleValue
-            ofs << label << ":" << name << ":" << roleValue << std::endl; 
+        LBPFeatureExtractor extractor(model.params);
+        if (model.gallery.cols() != extractor.histogramSize()) {
+            std::cerr << "[ERROR] 模型加载失败，直方图维度与 LBPH 参数不匹配：" << filepath << std::endl;
+            return false;
         }
-        ofs.close();
-        std::cout << "[INFO] ID-Name-Role 映射表已保存到：" << filepath << std::endl;
+
+        installModel(std::move(extractor), std::move(model.gallery), model.threshold, filepath);
+        if (model.journalRows > 0) {
+            std::cout << "[INFO] 已回放模型日志：" << model.journalRows << " 个样本" << std::endl;
+        }
+        return true;
     }
 
     /**
-     * @brief 加载 ID-Name 映射表
+     * @brief 加载 YAML 模型（兼容 cv::face::LBPHFaceRecognizer 保存的模型）
      */
-    void FaceRecognizer::loadLabelInfo(const std::string& filepath) {
-        std::ifstream ifs;
-        ifs.open(filepath, std::ios::in);
-        if (!ifs.is_open()) {
-            std::cerr << "[ERROR] 无法从文件：" << filepath << "加载映射表" << std::endl;
-            exit(-1);
-        }
+    bool FaceRecognizer::loadYamlModel(const std::string& filepath) {
+        try {
+            cv::FileStorage fs(filepath, cv::FileStorage::READ);
+            if (!fs.isOpened()) {
+                std::cerr << "[ERROR] 模型加载失败，无法打开：" << filepath << std::endl;
+                return false;
+            }
 
-        std::string line;
-        labelToName_.clear();
-        labelToRole_.clear();
-        while (getline(ifs, line)) {
-            int pos1 = (int)line.find(':');
-            if (pos1 == std::string::npos) continue;
+            cv::FileNode node = fs["opencv_lbphfaces"];
+            if (node.empty()) node = fs.getFirstTopLevelNode();
 
-            int pos2 = (int)line.find(':', pos1 + 1);
-            if (pos2 == std::string::npos) continue;
+            LBPParams params;
+            double threshold = 0.0;
+            node["threshold"] >> threshold; // 旧版本模型可能没有该字段
+            node["radius"] >> params.radius;
+            node["neighbors"] >> params.neighbors;
+            node["grid_x"] >> params.gridX;
+            node["grid_y"] >> params.gridY;
+            if (!LBPFeatureExtractor::isSupported(params)) {
+                std::cerr << "[ERROR] 模型加载失败，不支持的 LBPH 参数：" << filepath << std::endl;
+                return false;
+            }
 
-            try {
-                int label = std::stoi(line.substr(0, pos1));
-                std::string name = line.substr(pos1 + 1, pos2 - pos1 - 1);
-                int roleValue = std::stoi(line.substr(pos2 + 1));
+            std::vector<cv::Mat> histograms;
+            cv::Mat labels;
+            node["histograms"] >> histograms;
+            node["labels"] >> labels;
 
-                // if (!name.empty() && name.back() == '\r') name.pop_back();
-                labelToName_[label] = name;
-                labelToRole_[label] = (UserRole)roleValue;
-            } catch (...) {
-                continue; 
-            };
+            LBPFeatureExtractor extractor(params);
+            bool valid = labels.total() == histograms.size();
+            for (const auto& histogram : histograms) {
+                if (histogram.type() != CV_32FC1 || (int)histogram.total() != extractor.histogramSize()) valid = false;
+            }
+            if (!valid) {
+                std::cerr << "[ERROR] 模型加载失败，直方图与标签不匹配：" << filepath << std::endl;
+                return false;
+            }
+
+            // 全部样本可无损量化时使用紧凑存储，否则退回 float
+            GalleryMatrix gallery = makeGallery(extractor);
+            for (const auto& histogram : histograms) {
+                if (!GalleryMatrix::isLossless(histogram, gallery.precision(), gallery.cellArea())) {
+                    gallery.convert(GalleryPrecision::FLOAT32);
+                    break;
+                }
+            }
+            gallery.reserve(histograms.size());
+            for (std::size_t i = 0; i < histograms.size(); i++) {
+                gallery.append(histograms[i], labels.at<int>((int)i));
+            }
+
+            installModel(std::move(extractor), std::move(gallery), threshold, filepath);
+            return true;
+        } catch (const cv::Exception& e) {
+            std::cerr << "[ERROR] 模型加载失败" << e.what() << std::endl;
+            return false;
         }
+    }
+
+    /**
+     * @brief 替换当前模型并重建索引
+     */
+    void FaceRecognizer::installModel(LBPFeatureExtractor extractor, GalleryMatrix gallery, double threshold,
+                                      const std::string& filepath) {
+        extractor_ = std::move(extractor);
+        gallery_ = std::move(gallery);
+        threshold_ = threshold != 0.0 ? threshold : DBL_MAX;
+        modelPath_ = filepath;
+        persistedRows_ = gallery_.rows();
+        index_.build(gallery_, extractor_.params());
 
-        ifs.close();
-        std::cout << "[INFO] 已从文件：" << filepath << "加载全部用户信息" << std::endl;
+        std::cout << "[INFO] 模型加载成功" << filepath << std::endl;
+        if (index_.ready()) {
+            std::cout << "[INFO] 图库索引：" << index_.identities() << " 个身份，" << index_.prototypes()
+                      << " 个原型，" << index_.lists() << " 个倒排列表" << std::endl;
+        }
+    }
+
+    /**
+     * @brief 保存 ID-Name 映射表
+     * @return 写入失败返回 false
+     */
+    bool FaceRecognizer::saveLabelInfo(const std::string& filepath) {
+        return identities_.save(filepath);
+    }
+
+    /**
+     * @brief 加载 ID-Name 映射表
+     * @return 文件无法打开时返回 false
+     */
+    bool FaceRecognizer::loadLabelInfo(const std::string& filepath) {
+        return identities_.load(filepath);
     }
 
     /**
      * @brief 获取可用标签
      */
     int FaceRecognizer::getAvailableLabel() {
-        if (labelToName_.empty()) return 0;
-        return labelToName_.rbegin()->first + 1;
+        // 映射表缺失或落后于模型时，图库中已有的标签同样不能再分配（否则新身份会与已有样本合并）
+        int label = identities_.nextLabel();
+        for (int existing : gallery_.labels()) label = std::max(label, existing + 1);
+        return label;
     }
 
     /**
      * @brief 添加标签与用户信息的映射
      */
     void FaceRecognizer::setLabelInfo(int label, const std::string& name, UserRole role) {
-        labelToName_[label] = name;
-        labelToRole_[label] = role;
+        if (!identities_.set(label, name, role)) {
+            std::cerr << "[ERROR] 无效的标签：" << label << std::endl;
+        }
     }
 
     /**
      * @brief 获取ID对应的名字
      */
-    std::string FaceRecognizer::getLabelName(int label) {
-        if (labelToName_.count(label)) {
-            return labelToName_[label];
-        }
-
-        return "Unknown";
+    const std::string& FaceRecognizer::getLabelName(int label) const {
+        return identities_.name(label);
     }
 
     /**
      * @brief 获取ID对应的角色
      */
-    UserRole FaceRecognizer::getLabelRole(int label) {
-        if (labelToRole_.count(label)) {
-            return labelToRole_[label];
-        }
+    UserRole FaceRecognizer::getLabelRole(int label) const {
+        return identities_.role(label);
+    }
+
+    /**
+     * @brief 身份信息库
+     */
+    const IdentityStore& FaceRecognizer::identities() const {
+        return identities_;
+    }
+
+    /**
+     * @brief 当前 LBP 参数
+     */
+    const LBPParams& FaceRecognizer::params() const {
+        return extractor_.params();
+    }
+
+    /**
+     * @brief 设置图库索引配置（并按当前图库重建索引）
+     */
+    void FaceRecognizer::setIndexConfig(const GalleryIndexConfig& config) {
+        index_ = GalleryIndex(config);
+        index_.build(gallery_, extractor_.params());
+    }
+
+    /**
+     * @brief 样本直方图图库
+     */
+    const GalleryMatrix& FaceRecognizer::gallery() const {
+        return gallery_;
+    }
 
-        return UserRole::UNKNOWN;
+    /**
+     * @brief 图库索引
+     */
+    const GalleryIndex& FaceRecognizer::index() const {
+        return index_;
+    }
+
+    /**
+     * @brief 按提取器参数创建图库（统一尺寸样本的网格像素数决定量化精度）
+     */
+    GalleryMatrix FaceRecognizer::makeGallery(const LBPFeatureExtractor& extractor) {
+        int cellArea = extractor.cellArea(cv::Size(FACE_SAMPLE_SIZE, FACE_SAMPLE_SIZE));
+        return GalleryMatrix(extractor.histogramSize(), GalleryMatrix::precisionFor(cellArea), cellArea);
     }
 }
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "FaceTracker.h"
+#include "Metrics.h"
+#include <algorithm>
+
+namespace DriveGuard {
+    namespace {
+        // 两个矩形框的交并比
+        double overlapRatio(const cv::Rect& a, const cv::Rect& b) {
+            int inter = (a & b).area();
+            int uni = a.area() + b.area() - inter;
+            return uni > 0 ? (double)inter / uni : 0.0;
+        }
+
+        // 全帧检测结果与已有轨迹关联的最小交并比
+        const double ASSOCIATE_IOU = 0.3;
+        // 判定两条轨迹重复（跟踪到同一张脸）的交并比
+        const double DUPLICATE_IOU = 0.5;
+
+        // 在未关联的轨迹中找与人脸框交并比最高（且超过关联阈值）的一条
+        int bestMatch(const cv::Rect& face, const std::vector<FaceTrack>& tracks, const std::vector<bool>& used) {
+            int best = -1;
+            double bestIou = ASSOCIATE_IOU;
+            for (std::size_t i = 0; i < tracks.size(); i++) {
+                if (used[i]) continue;
+                double iou = overlapRatio(face, tracks[i].box);
+                if (iou > bestIou) {
+                    bestIou = iou;
+                    best = (int)i;
+                }
+            }
+            return best;
+        }
+    }
+
+    /**
+     * @brief 构造函数
+     * @param detector 人脸检测器
+     * @param config 跟踪配置
+     */
+    FaceTracker::FaceTracker(FaceDetector& detector, const TrackerConfig& config)
+        : detector_(detector), config_(config), nextId_(0), framesSinceFull_(0) {
+    }
+
+    /**
+     * @brief 检测（或跟踪）当前帧中的人脸
+     * @param context 帧预处理上下文
+     * @param time 该帧的采集时间戳（须单调不减，用于丢失轨迹的超时）
+     * @param detectScale 全帧检测的分辨率比例（降载时小于 1，局部搜索不受影响）
+     * @return 人脸矩形框列表，与 tracks() 一一对应（下次检测前有效）
+     */
+    const std::vector<cv::Rect>& FaceTracker::detect(const FrameContext& context, TimePoint time, double detectScale) {
+        ScopedTimer timer(Stage::DETECT);
+
+        bool needFull = !config_.enabled
+                     || tracks_.empty()
+                     || framesSinceFull_ + 1 >= config_.redetectInterval;
+
+        // 局部搜索失败（有轨迹丢失）时立即补做全帧检测
+        if (needFull || !trackDetect(context, time)) {
+            fullDetect(context, time, detectScale);
+        } else {
+            framesSinceFull_++;
+        }
+
+        faces_.clear();
+        for (const auto& track : tracks_) {
+            faces_.push_back(track.box);
+        }
+        return faces_;
+    }
+
+    /**
+     * @brief 当前帧的人脸轨迹
+     */
+    const std::vector<FaceTrack>& FaceTracker::tracks() const {
+        return tracks_;
+    }
+
+    /**
+     * @brief 清空轨迹（含丢失的轨迹），下一帧强制全帧检测
+     */
+    void FaceTracker::reset() {
+        tracks_.clear();
+        lost_.clear();
+        framesSinceFull_ = 0;
+    }
+
+    /**
+     * @brief 全帧检测，并按交并比与已有轨迹（其次是丢失未超时的轨迹）关联以保持编号稳定
+     */
+    void FaceTracker::fullDetect(const FrameContext& context, TimePoint time, double scale) {
+        Metrics::increment(Counter::DETECT_FULL);
+        if (scale < 1.0) Metrics::increment(Counter::SHED_REDUCED_DETECT);
+        detector_.detect(context, candidates_, scale);
+
+        std::vector<FaceTrack>& updated = updated_;
+        std::vector<bool>& used = used_;
+        std::vector<bool>& lostUsed = lostUsed_;
+        updated.clear();
+        used.assign(tracks_.size(), false);
+        lostUsed.assign(lost_.size(), false);
+        for (const auto& face : candidates_) {
+            int best = bestMatch(face, tracks_, used);
+            if (best >= 0) {
+                used[best] = true;
+                updated.push_back({tracks_[best].id, face, tracks_[best].age + 1, time});
+                continue;
+            }
+
+            // 短暂丢失的人脸回到原位置附近时沿用原编号（驾驶员的疲劳计时、身份与眼睛状态随之延续）
+            best = bestMatch(face, lost_, lostUsed);
+            if (best >= 0) {
+                lostUsed[best] = true;
+                updated.push_back({lost_[best].id, face, lost_[best].age + 1, time});
+            } else {
+                updated.push_back({nextId_++, face, 1, time});
+            }
+        }
+
+        // 丢失列表：去掉已关联回来的与超时的，再加入本次未关联的轨迹（保留最后位置）
+        const auto timeout = std::chrono::milliseconds(config_.lostTimeoutMs);
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < lost_.size(); i++) {
+            if (!lostUsed[i] && time - lost_[i].lastSeen <= timeout) {
+                lost_[kept++] = lost_[i];
+            }
+        }
+        lost_.resize(kept);
+        for (std::size_t i = 0; i < tracks_.size(); i++) {
+            if (!used[i]) lost_.push_back(tracks_[i]);
+        }
+
+        tracks_.swap(updated);
+        framesSinceFull_ = 0;
+    }
+
+    /**
+     * @brief 在每条轨迹周围的外扩窗口内以窄尺寸范围局部搜索
+     * @return 所有轨迹均被找到返回 true；有轨迹丢失返回 false（轨迹保持不变）
+     */
+    bool FaceTracker::trackDetect(const FrameContext& context, TimePoint time) {
+        Metrics::increment(Counter::DETECT_TRACKED);
+
+        std::vector<FaceTrack>& updated = updated_;
+        std::vector<cv::Rect>& candidates = candidates_;
+        updated.clear();
+        for (const auto& track : tracks_) {
+            const cv::Rect& box = track.box;
+            int padX = (int)(box.width * config_.searchPadding);
+            int padY = (int)(box.height * config_.searchPadding);
+            cv::Rect window(box.x - padX, box.y - padY, box.width + 2 * padX, box.height + 2 * padY);
+            cv::Size minSize((int)(box.width * config_.minScale), (int)(box.height * config_.minScale));
+            cv::Size maxSize((int)(box.width * config_.maxScale), (int)(box.height * config_.maxScale));
+
+            detector_.detectInRegion(context, window, minSize, maxSize, candidates);
+            if (candidates.empty()) {
+                return false;
+            }
+
+            // 选取与上一帧重叠度最高的候选框
+            auto best = std::max_element(candidates.begin(), candidates.end(),
+                [&box](const cv::Rect& a, const cv::Rect& b) { return overlapRatio(a, box) < overlapRatio(b, box); });
+
+            // 两条轨迹收敛到同一张脸时视为跟踪失效
+            for (const auto& other : updated) {
+                if (overlapRatio(other.box, *best) > DUPLICATE_IOU) {
+                    return false;
+                }
+            }
+            updated.push_back({track.id, *best, track.age + 1, time});
+        }
+
+        tracks_.swap(updated);
+        return true;
+    }
+}
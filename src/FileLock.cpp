@@ -0,0 +1,68 @@
+#include "FileLock.h"
+#include <iostream>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace DriveGuard {
+    /**
+     * @brief 构造函数（打开或创建锁文件并加锁）
+     * @param path 锁文件路径
+     * @param mode 加锁模式
+     * @param wait 锁被占用时是否等待（false 时立即返回，locked() 为 false）
+     */
+    FileLock::FileLock(const std::string& path, Mode mode, bool wait) : fd_(-1), locked_(false) {
+#ifndef _WIN32
+        fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            std::cerr << "[WARN] 无法打开锁文件：" << path << "（" << std::strerror(errno) << "）" << std::endl;
+            return;
+        }
+        int operation = (mode == Mode::SHARED ? LOCK_SH : LOCK_EX) | (wait ? 0 : LOCK_NB);
+        int result;
+        do {
+            result = flock(fd_, operation);
+        } while (result != 0 && errno == EINTR);
+        locked_ = result == 0;
+#else
+        (void)path;
+        (void)mode;
+        (void)wait;
+        locked_ = true;
+#endif
+    }
+
+    // 析构函数（释放锁）
+    FileLock::~FileLock() {
+#ifndef _WIN32
+        // 关闭描述符即释放锁；锁文件保留，删除会让等待中的进程锁住已被删除的文件
+        if (fd_ >= 0) close(fd_);
+#endif
+    }
+
+    /**
+     * @brief 是否已持有锁
+     */
+    bool FileLock::locked() const {
+        return locked_;
+    }
+
+    /**
+     * @brief 写入锁的路径（<文件>.lock）
+     */
+    std::string FileLock::lockPath(const std::string& path) {
+        return path + ".lock";
+    }
+
+    /**
+     * @brief 模型所有者锁的路径（<模型>.owner.lock）
+     */
+    std::string FileLock::ownerLockPath(const std::string& modelPath) {
+        return modelPath + ".owner.lock";
+    }
+}
@@ -0,0 +1,341 @@
+#include "FrameAnalyzer.h"
+#include "Metrics.h"
+#include <iostream>
+
+namespace DriveGuard {
+    namespace {
+        /**
+         * @brief 按本帧人脸重置结果（复用数据包中已有结果的姓名与眼睛框容量）
+         */
+        void resetResults(FramePacket& packet) {
+            const std::vector<FaceSample>& samples = packet.context.faces();
+            packet.results.resize(samples.size());
+            for (std::size_t i = 0; i < samples.size(); i++) {
+                FaceResult& result = packet.results[i];
+                result.box = samples[i].box();
+                result.trackId = samples[i].trackId();
+                result.label = -1;
+                result.confidence = 0.0;
+                result.identified = false;
+                result.name = "Unknown";
+                result.role = UserRole::UNKNOWN;
+                result.eyes.clear();
+                result.driverState = DriverState::NORMAL;
+            }
+        }
+
+        /**
+         * @brief 跟踪配置：丢失轨迹的保留时长与疲劳状态的轨迹超时一致
+         * （人脸短暂丢失后回到原编号，疲劳状态尚未被丢弃，连续闭眼计时得以跨越间隔）
+         */
+        TrackerConfig trackerConfig(const AnalyzerConfig& config) {
+            TrackerConfig tracker = config.tracker;
+            tracker.lostTimeoutMs = config.dms.trackTimeoutMs;
+            return tracker;
+        }
+    }
+
+    /**
+     * @brief 构造函数
+     * @param detector 人脸检测器
+     * @param enrollment 录入服务（提供当前识别模型）
+     * @param config 分析配置
+     * @param initialState 初始工作模式
+     * @param recorder 事件记录器（可选，为空时不记录事件与告警片段）
+     */
+    FrameAnalyzer::FrameAnalyzer(FaceDetector& detector, EnrollmentService& enrollment,
+                                 const AnalyzerConfig& config, ModelState initialState,
+                                 EventRecorder* recorder)
+        : detector_(detector), enrollment_(enrollment), config_(config), tracker_(detector, trackerConfig(config)),
+          shedder_(config.shedder), modelVersion_(enrollment.version()), identityCache_(config.identityCache),
+          eyeTracker_(detector, config.eyeTracker), recorder_(recorder), state_(initialState),
+          selector_(config.selector), rejectedCount_(0), userLabel_(-1), userRole_(UserRole::UNKNOWN), recordingCount_(0), countingDown_(false),
+          hasRequest_(false), requestRole_(UserRole::UNKNOWN) {
+        recognizer_ = enrollment_.current();
+    }
+
+    /**
+     * @brief 准入：降载到丢帧级别时，判断该帧是否仍在延迟预算内（由检测阶段在 detect() 之前调用）
+     * @param packet 帧数据包
+     * @return 应丢弃该帧时返回 false
+     */
+    bool FrameAnalyzer::admit(const FramePacket& packet) {
+        return shedder_.admit(packet.captureTime, Clock::now());
+    }
+
+    /**
+     * @brief 检测阶段：在帧中检测人脸
+     * @param packet 帧数据包（写入 faces）
+     */
+    void FrameAnalyzer::detect(FramePacket& packet) {
+        // 每帧仅做一次灰度转换与均衡化，后续阶段共享
+        packet.context.prepare(packet.frame);
+        tracker_.detect(packet.context, packet.captureTime, shedder_.detectScale());
+        for (const auto& track : tracker_.tracks()) {
+            packet.context.addFace(track.box, track.id);
+        }
+    }
+
+    /**
+     * @brief 分析阶段：识别身份、检测眼睛、更新疲劳状态或采集录入样本
+     * @param packet 帧数据包（写入 results 与模式信息）
+     */
+    void FrameAnalyzer::analyze(FramePacket& packet) {
+        // 取当前发布的模型快照；模型更新后缓存的身份不再可信
+        uint64_t version = enrollment_.version();
+        if (version != modelVersion_) {
+            recognizer_ = enrollment_.current();
+            modelVersion_ = version;
+            identityCache_.clear();
+        }
+
+        handleRequest(packet);
+
+        resetResults(packet);
+        packet.state = state_;
+
+        if (state_ == ModelState::RECORDING) {
+            recordFaces(packet);
+        } else if (state_ == ModelState::RECOGNIZING) {
+            recognizeFaces(packet);
+        }
+
+        packet.recordingCount = recordingCount_;
+        packet.countdown = countingDown_
+            ? (int)std::chrono::duration_cast<std::chrono::seconds>(recordStart_ - packet.captureTime + std::chrono::milliseconds(999)).count()
+            : 0;
+        packet.training = enrollment_.busy();
+
+        Metrics::increment(Counter::FRAMES);
+        Metrics::increment(Counter::FACES, packet.context.faces().size());
+        Clock::duration latency = Clock::now() - packet.captureTime;
+        Metrics::observe(Stage::FRAME_LATENCY, latency);
+        shedder_.observe(latency);
+
+        // 帧交给记录器的后台线程编码（环形缓冲区满时丢弃，不阻塞分析线程）
+        if (recorder_) recorder_->recordFrame(packet);
+    }
+
+    /**
+     * @brief 请求进入录入模式（线程安全，倒计时结束后开始采集）
+     * @param name 用户姓名
+     * @param role 用户角色
+     */
+    void FrameAnalyzer::requestRecording(const std::string& name, UserRole role) {
+        std::lock_guard<std::mutex> lock(requestMutex_);
+        requestName_ = name;
+        requestRole_ = role;
+        hasRequest_ = true;
+    }
+
+    /**
+     * @brief 处理主线程提交的录入请求，倒计时结束后切换至录入模式
+     */
+    void FrameAnalyzer::handleRequest(const FramePacket& packet) {
+        {
+            std::lock_guard<std::mutex> lock(requestMutex_);
+            if (hasRequest_) {
+                hasRequest_ = false;
+                if (enrollment_.busy() || state_ == ModelState::RECORDING) {
+                    std::cerr << "[WARN] 上一次录入尚未完成，忽略本次录入请求" << std::endl;
+                } else {
+                    userName_ = requestName_;
+                    userRole_ = requestRole_;
+                    countingDown_ = true;
+                    recordStart_ = packet.captureTime + std::chrono::milliseconds(config_.recordCountdownMs);
+                    std::cout << "[INFO] 请注视摄像头，" << config_.recordCountdownMs / 1000 << " 秒后开始录入……" << std::endl;
+                }
+            }
+        }
+
+        // 倒计时期间照常识别与监测
+        if (countingDown_ && packet.captureTime >= recordStart_) {
+            countingDown_ = false;
+            userLabel_ = recognizer_->getAvailableLabel();
+            recordingCount_ = 0;
+            rejectedCount_ = 0;
+            trainingImages_.clear();
+            trainingScores_.clear();
+            lastSample_ = Clock::time_point();
+            state_ = ModelState::RECORDING;
+            std::cout << "[INFO] 切换至录入模式……" << std::endl;
+        }
+    }
+
+    /**
+     * @brief 录入模式：按采集间隔保存人脸样本，采集完成后提交后台训练
+     */
+    void FrameAnalyzer::recordFaces(FramePacket& packet) {
+        // 按帧时间戳控制采集间隔，避免录入样本过于重复（不阻塞分析线程）
+        if (packet.context.faces().empty() || packet.captureTime - lastSample_ < std::chrono::milliseconds(config_.recordIntervalMs)) return;
+        lastSample_ = packet.captureTime;
+
+        // 使用预处理好的统一尺寸灰度人脸（深拷贝，与帧缓冲区解耦）；模糊、曝光不当或过小的人脸计入进度但不保留
+        for (auto& face : packet.context.faces()) {
+            if (recordingCount_ >= config_.recordMaxImages) break;
+            recordingCount_++;
+            SampleQuality quality;
+            if (!selector_.assess(face, quality)) {
+                rejectedCount_++;
+                continue;
+            }
+            trainingImages_.push_back(face.normalized().clone());
+            trainingScores_.push_back(quality.score);
+        }
+        if (recordingCount_ >= config_.recordMaxImages) finishRecording();
+    }
+
+    /**
+     * @brief 将采集的样本提交后台训练，立即切换回识别模式（新模型发布前沿用旧模型）
+     */
+    void FrameAnalyzer::finishRecording() {
+        state_ = ModelState::RECOGNIZING;
+        if (rejectedCount_ > 0) {
+            std::cout << "[INFO] 剔除 " << rejectedCount_ << " 张不合格样本（模糊、过暗/过亮或人脸过小）" << std::endl;
+        }
+        if (trainingImages_.empty()) {
+            std::cerr << "[ERROR] 采集的样本均不合格，本次录入已取消，请在光线充足处正对摄像头重新录入" << std::endl;
+            trainingScores_.clear();
+            return;
+        }
+
+        EnrollmentJob job;
+        job.images = std::move(trainingImages_);
+        job.scores = std::move(trainingScores_);
+        job.label = userLabel_;
+        job.name = userName_;
+        job.role = userRole_;
+        trainingImages_.clear();
+        trainingScores_.clear();
+
+        if (enrollment_.submit(std::move(job))) {
+            std::cout << "[INFO] 样本采集完成，后台训练中……" << std::endl;
+        } else {
+            std::cerr << "[ERROR] 录入服务不可用，本次录入的样本已丢弃" << std::endl;
+        }
+    }
+
+    /**
+     * @brief 识别模式：识别身份，驾驶员额外进行眼部检测与疲劳判定
+     */
+    void FrameAnalyzer::recognizeFaces(FramePacket& packet) {
+        identityCache_.advance();
+        eyeTracker_.advance();
+        std::vector<FaceSample>& samples = packet.context.faces();
+
+        // 第一步：已确认身份的轨迹复用缓存结果，其余收集起来批量预测
+        std::vector<FaceSample*>& pending = pending_;
+        std::vector<std::size_t>& pendingIndex = pendingIndex_;
+        pending.clear();
+        pendingIndex.clear();
+        for (std::size_t i = 0; i < samples.size(); i++) {
+            FaceSample& sample = samples[i];
+            FaceResult& result = packet.results[i];
+
+            if (identityCache_.lookup(sample, result.label, result.confidence)) {
+                Metrics::increment(Counter::IDENTITY_CACHE_HITS);
+            } else if (shedder_.skipPassengers() && identityCache_.peek(sample, result.label, result.confidence)
+                       && recognizer_->getLabelRole(result.label) == UserRole::PASSENGER) {
+                // 降载：已确认的乘客沿用上次结果，不再重新识别
+                Metrics::increment(Counter::SHED_PASSENGERS);
+            } else {
+                Metrics::increment(Counter::IDENTITY_CACHE_MISSES);
+                pending.push_back(&sample);
+                pendingIndex.push_back(i);
+            }
+        }
+
+        // 第二步：一帧内的人脸并行预测（使用与录入一致的统一尺寸灰度图），结果按输入顺序返回
+        if (!pending.empty()) {
+            std::vector<int>& labels = labels_;
+            std::vector<double>& confidences = confidences_;
+            recognizer_->predictBatch(pending, labels, confidences);
+            for (std::size_t k = 0; k < pending.size(); k++) {
+                FaceResult& result = packet.results[pendingIndex[k]];
+                result.label = labels[k];
+                result.confidence = confidences[k];
+                identityCache_.store(*pending[k], labels[k], confidences[k],
+                                     labels[k] != -1 && confidences[k] < config_.confidenceThreshold);
+            }
+        }
+
+        // 获取人脸名称，收集驾驶员
+        std::vector<const FaceSample*>& drivers = drivers_;
+        std::vector<std::size_t>& driverIndex = driverIndex_;
+        drivers.clear();
+        driverIndex.clear();
+        for (std::size_t i = 0; i < samples.size(); i++) {
+            FaceResult& result = packet.results[i];
+            result.identified = result.label != -1 && result.confidence < config_.confidenceThreshold;
+            if (result.identified) {
+                result.name = recognizer_->getLabelName(result.label);
+                result.role = recognizer_->getLabelRole(result.label);
+            } else {
+                Metrics::increment(Counter::PREDICTIONS_REJECTED);
+            }
+            if (recorder_) reportIdentity(packet, result);
+            if (result.role == UserRole::DRIVER) {
+                drivers.push_back(&samples[i]);
+                driverIndex.push_back(i);
+            }
+        }
+
+        // 第三步：驾驶员并行定位眼睛（搜索带内级联检测或模板跟踪），再按轨迹以帧采集时间判断疲劳程度（多名驾驶员互不影响）
+        std::vector<std::vector<cv::Rect>>& driverEyes = driverEyes_;
+        eyeTracker_.detectBatch(drivers, driverEyes);
+        for (std::size_t k = 0; k < drivers.size(); k++) {
+            FaceResult& result = packet.results[driverIndex[k]];
+            const cv::Rect& face = result.box;
+            for (const auto& eye : driverEyes[k]) {
+                // 计算绝对坐标
+                result.eyes.emplace_back(face.x + eye.x, face.y + eye.y, eye.width, eye.height);
+            }
+
+            if (driverEyes[k].empty()) Metrics::increment(Counter::EYE_MISSES);
+            Metrics::increment(Counter::DRIVER_CHECKS);
+
+            DMSController& dms = driverStates_.try_emplace(result.trackId, config_.dms).first->second;
+            DriverState previous = dms.getState();
+            dms.update(!driverEyes[k].empty(), packet.captureTime);
+            result.driverState = dms.getState();
+            if (recorder_ && result.driverState != previous) {
+                recorder_->recordEvent(EventType::DRIVER_STATE, packet, result);
+            }
+        }
+        pruneDriverStates(packet.captureTime);
+    }
+
+    /**
+     * @brief 丢弃长时间未更新的轨迹的疲劳状态与已记录身份
+     */
+    void FrameAnalyzer::pruneDriverStates(Clock::time_point now) {
+        const auto timeout = std::chrono::milliseconds(config_.dms.trackTimeoutMs);
+        for (auto it = driverStates_.begin(); it != driverStates_.end();) {
+            if (now - it->second.lastUpdate() > timeout) {
+                it = driverStates_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (auto it = reportedIdentities_.begin(); it != reportedIdentities_.end();) {
+            if (now - it->second.seen > timeout) {
+                it = reportedIdentities_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /**
+     * @brief 轨迹首次出现或身份变化时记录身份事件（未通过阈值的记为未登记人员）
+     */
+    void FrameAnalyzer::reportIdentity(const FramePacket& packet, const FaceResult& result) {
+        int label = result.identified ? result.label : -1;
+        auto inserted = reportedIdentities_.try_emplace(result.trackId, ReportedIdentity{label, packet.captureTime});
+        ReportedIdentity& reported = inserted.first->second;
+        reported.seen = packet.captureTime;
+        if (!inserted.second && reported.label == label) return;
+        reported.label = label;
+        recorder_->recordEvent(result.identified ? EventType::IDENTITY : EventType::UNKNOWN_PERSON, packet, result);
+    }
+}
@@ -0,0 +1,212 @@
+#include "FrameBus.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace DriveGuard {
+    namespace {
+        // 定期检查读端表的帧间隔（另在槽位耗尽时立即检查）
+        const uint64_t RECLAIM_INTERVAL = 64;
+    }
+
+    /**
+     * @brief 规范化共享内存名称（补上开头的 '/'）
+     */
+    std::string frameBusName(const std::string& name) {
+        return !name.empty() && name[0] == '/' ? name : "/" + name;
+    }
+
+    /**
+     * @brief 构造函数
+     * @param name 共享内存名称（不以 '/' 开头时自动补上）
+     * @param slotCount 槽位数（须大于各读端同时持有的帧数之和）
+     */
+    FrameBusWriter::FrameBusWriter(const std::string& name, uint32_t slotCount)
+        : name_(frameBusName(name)), slotCount_(std::min(std::max(slotCount, 2u), FRAME_BUS_MAX_SLOTS)),
+          base_(nullptr), mappedBytes_(0), next_(0), seq_(0), lastReclaim_(0), failed_(false), oversized_(false) {
+    }
+
+    /**
+     * @brief 析构函数（标记关闭、解除映射并删除共享内存）
+     */
+    FrameBusWriter::~FrameBusWriter() {
+#ifndef _WIN32
+        if (!base_) return;
+        // 已映射的读端仍可读完手中的帧，随后从 closed 得知输入结束
+        reinterpret_cast<FrameBusHeader*>(base_)->closed.store(1, std::memory_order_release);
+        munmap(base_, mappedBytes_);
+        shm_unlink(name_.c_str());
+#endif
+    }
+
+    /**
+     * @brief 发布一帧（由采集线程调用，不阻塞）
+     * @param frame 图像帧（超出首帧确定的槽位容量时丢弃）
+     * @param captureTime 采集时间
+     * @return 已发布返回 true；共享内存不可用或所有槽位都被引用时返回 false
+     */
+    bool FrameBusWriter::publish(const cv::Mat& frame, Clock::time_point captureTime) {
+        if (frame.empty() || failed_) return false;
+        std::size_t rowBytes = frame.cols * frame.elemSize();
+        std::size_t frameBytes = rowBytes * frame.rows;
+        if (!base_ && !create(frameBytes)) {
+            failed_ = true;
+            return false;
+        }
+
+        FrameBusHeader* header = reinterpret_cast<FrameBusHeader*>(base_);
+        if (frameBytes > header->slotBytes) {
+            if (!oversized_) {
+                std::cerr << "[WARN] 帧总线 " << name_ << "：帧尺寸超出槽位容量，已跳过" << std::endl;
+                oversized_ = true;
+            }
+            Metrics::increment(Counter::FRAME_BUS_DROPPED);
+            return false;
+        }
+
+        uint64_t seq = seq_ + 1;
+        if (seq - lastReclaim_ >= RECLAIM_INTERVAL) reclaimReaders();
+
+        // 选择下一个未被读端引用的槽位：先标记写入中再检查各读端的引用位，
+        // 与读端"先置引用位再检查状态"配对（均为顺序一致），二者至少有一方能看到对方
+        // 全部槽位都被引用时先收回已退出读端的引用，再试一轮
+        for (uint32_t k = 0; k < 2 * slotCount_; k++) {
+            if (k == slotCount_) reclaimReaders();
+            uint32_t index = (next_ + k) % slotCount_;
+            FrameBusSlot* target = slot(index);
+            uint64_t previous = target->state.load(std::memory_order_relaxed);
+            target->state.store(2 * seq + 1);
+            if (pinned(index)) {
+                target->state.store(previous);
+                continue;
+            }
+
+            // 按紧凑行距写入像素数据（V4L2 等带行填充的帧逐行拷贝）
+            unsigned char* data = reinterpret_cast<unsigned char*>(target) + FRAME_BUS_SLOT_HEADER;
+            if (frame.isContinuous()) {
+                std::memcpy(data, frame.data, frameBytes);
+            } else {
+                for (int y = 0; y < frame.rows; y++) std::memcpy(data + y * rowBytes, frame.ptr(y), rowBytes);
+            }
+            target->rows = frame.rows;
+            target->cols = frame.cols;
+            target->type = frame.type();
+            target->step = rowBytes;
+            target->captureTimeUs = toUnixMicros(captureTime);
+            target->state.store(2 * seq, std::memory_order_release);
+            header->latest.store((seq << 8) | index, std::memory_order_release);
+
+            seq_ = seq;
+            next_ = (index + 1) % slotCount_;
+            return true;
+        }
+
+        // 所有槽位都被读端引用：丢弃该帧，不等待
+        Metrics::increment(Counter::FRAME_BUS_DROPPED);
+        return false;
+    }
+
+    /**
+     * @brief 按首帧大小创建并初始化共享内存（已存在的同名共享内存视为上次异常退出的残留，先删除）
+     */
+    bool FrameBusWriter::create(std::size_t frameBytes) {
+#ifndef _WIN32
+        std::size_t slotStride = FRAME_BUS_SLOT_HEADER + ((frameBytes + 63) & ~(std::size_t)63);
+        std::size_t total = FRAME_BUS_SLOTS_OFFSET + slotStride * slotCount_;
+
+        shm_unlink(name_.c_str());
+        int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+        if (fd < 0) {
+            std::cerr << "[ERROR] 无法创建帧总线共享内存：" << name_ << "（" << std::strerror(errno) << "）" << std::endl;
+            return false;
+        }
+        if (ftruncate(fd, (off_t)total) != 0) {
+            std::cerr << "[ERROR] 无法分配帧总线共享内存：" << name_ << "（" << std::strerror(errno) << "）" << std::endl;
+            close(fd);
+            shm_unlink(name_.c_str());
+            return false;
+        }
+        void* mapped = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "[ERROR] 无法映射帧总线共享内存：" << name_ << "（" << std::strerror(errno) << "）" << std::endl;
+            shm_unlink(name_.c_str());
+            return false;
+        }
+
+        // ftruncate 后内容全为零：原子变量与各槽位状态即为初始值，最后写入魔数表示就绪
+        base_ = static_cast<unsigned char*>(mapped);
+        mappedBytes_ = total;
+        FrameBusHeader* header = reinterpret_cast<FrameBusHeader*>(base_);
+        header->version = FRAME_BUS_VERSION;
+        header->slotCount = slotCount_;
+        header->slotBytes = slotStride - FRAME_BUS_SLOT_HEADER;
+        header->slotStride = slotStride;
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = FRAME_BUS_MAGIC;
+
+        std::cout << "[INFO] 帧总线已就绪：" << name_ << "（" << slotCount_ << " 个槽位，每槽 "
+                  << header->slotBytes / 1024 << " KB）" << std::endl;
+        return true;
+#else
+        (void)frameBytes;
+        std::cerr << "[WARN] 当前平台不支持共享内存帧总线" << std::endl;
+        return false;
+#endif
+    }
+
+    /**
+     * @brief 第 index 个槽位的槽位头
+     */
+    FrameBusSlot* FrameBusWriter::slot(uint32_t index) const {
+        const FrameBusHeader* header = reinterpret_cast<const FrameBusHeader*>(base_);
+        return reinterpret_cast<FrameBusSlot*>(base_ + FRAME_BUS_SLOTS_OFFSET + index * header->slotStride);
+    }
+
+    /**
+     * @brief 槽位是否被任一读端引用
+     */
+    bool FrameBusWriter::pinned(uint32_t index) const {
+        uint64_t bit = 1ull << (index % 64);
+        for (uint32_t r = 0; r < FRAME_BUS_MAX_READERS; r++) {
+            if (frameBusReader(base_, r)->pinned[index / 64].load() & bit) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief 清除已退出的读端进程的表项，收回其占住的槽位（计入指标）
+     */
+    void FrameBusWriter::reclaimReaders() {
+        lastReclaim_ = seq_ + 1;
+#ifndef _WIN32
+        for (uint32_t r = 0; r < FRAME_BUS_MAX_READERS; r++) {
+            FrameBusReader* reader = frameBusReader(base_, r);
+            int32_t pid = reader->pid.load(std::memory_order_acquire);
+            if (pid <= 0 || kill(pid, 0) == 0 || errno != ESRCH) continue;
+
+            // 先清引用位再释放表项：表项被新读端占用时不会残留旧引用
+            std::size_t reclaimed = 0;
+            for (auto& word : reader->pinned) {
+                reclaimed += (std::size_t)__builtin_popcountll(word.exchange(0));
+            }
+            int32_t expected = pid;
+            reader->pid.compare_exchange_strong(expected, 0);
+            if (reclaimed > 0) {
+                Metrics::increment(Counter::FRAME_BUS_RECLAIMED, reclaimed);
+                std::cerr << "[WARN] 帧总线 " << name_ << "：读端进程 " << pid << " 已退出，收回其占用的 "
+                          << reclaimed << " 个槽位" << std::endl;
+            }
+        }
+#endif
+    }
+}
@@ -0,0 +1,285 @@
+#include "FrameBusSource.h"
+#include "FrameBus.h"
+#include <iostream>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DriveGuard {
+#ifndef _WIN32
+    namespace {
+        // 等待新帧的超时（毫秒），超时返回空帧由上层跳过
+        const int WAIT_TIMEOUT_MS = 1000;
+        // 无新帧时的轮询间隔（微秒）
+        const int POLL_INTERVAL_US = 500;
+        // 最新帧在引用前被覆盖时的重试次数
+        const int PIN_RETRIES = 4;
+    }
+
+    struct FrameBusMapping;
+
+    /**
+     * @brief 借给流水线的槽位（每个槽位一份，映射时创建，之后反复借出）
+     */
+    struct SlotLease {
+        cv::UMatData data;                        // 包装该槽位的 cv::Mat 引用计数
+        std::shared_ptr<FrameBusMapping> mapping; // 借出期间持有映射，全部归还后才解除映射
+        uint32_t index;                           // 槽位号
+
+        SlotLease(const cv::MatAllocator* allocator, uint32_t slotIndex) : data(allocator), index(slotIndex) {}
+    };
+
+    /**
+     * @brief 共享内存映射
+     * 由输入源与所有未归还的帧共同持有，最后一个持有者释放时解除映射。
+     */
+    struct FrameBusMapping {
+        unsigned char* base = nullptr;
+        std::size_t bytes = 0;
+        FrameBusReader* reader = nullptr;         // 本读端占用的表项
+        std::vector<std::unique_ptr<SlotLease>> leases;
+
+        ~FrameBusMapping() {
+            if (reader) {
+                // 所有帧均已归还：清除残留的引用位后释放表项
+                for (auto& word : reader->pinned) word.store(0);
+                reader->pid.store(0, std::memory_order_release);
+            }
+            if (base) munmap(base, bytes);
+        }
+
+        FrameBusHeader* header() const {
+            return reinterpret_cast<FrameBusHeader*>(base);
+        }
+
+        FrameBusSlot* slot(uint32_t index) const {
+            return reinterpret_cast<FrameBusSlot*>(base + FRAME_BUS_SLOTS_OFFSET + index * header()->slotStride);
+        }
+
+        /**
+         * @brief 在本读端表项中置位槽位引用（顺序一致，与发布端的检查配对）
+         */
+        void pin(uint32_t index) {
+            reader->pinned[index / 64].fetch_or(1ull << (index % 64));
+        }
+
+        /**
+         * @brief 清除槽位引用
+         */
+        void unpin(uint32_t index) {
+            reader->pinned[index / 64].fetch_and(~(1ull << (index % 64)), std::memory_order_release);
+        }
+
+        /**
+         * @brief 占用一个空闲的读端表项
+         */
+        bool claimReader() {
+            int32_t pid = (int32_t)getpid();
+            for (uint32_t r = 0; r < FRAME_BUS_MAX_READERS; r++) {
+                FrameBusReader* entry = frameBusReader(base, r);
+                int32_t expected = 0;
+                if (entry->pid.compare_exchange_strong(expected, pid)) {
+                    reader = entry;
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    namespace {
+        /**
+         * @brief 包装共享内存槽位的 cv::Mat 分配器：最后一个引用释放时归还槽位引用而不是释放内存
+         * （其余分配请求交给 OpenCV 默认分配器）
+         */
+        class SlotAllocator : public cv::MatAllocator {
+        public:
+            cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                                   cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override {
+                return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+            }
+
+            bool allocate(cv::UMatData* data, cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override {
+                return cv::Mat::getStdAllocator()->allocate(data, flags, usageFlags);
+            }
+
+            void deallocate(cv::UMatData* data) const override {
+                if (!data) return;
+                SlotLease* lease = (SlotLease*)data->userdata;
+                // 先取走映射引用：若这是最后一个持有者，映射（连同租约本身）在归还后随之释放
+                std::shared_ptr<FrameBusMapping> mapping = std::move(lease->mapping);
+                mapping->unpin(lease->index);
+            }
+        };
+
+        SlotAllocator& slotAllocator() {
+            static SlotAllocator allocator;
+            return allocator;
+        }
+
+        /**
+         * @brief 以已引用的槽位构造 cv::Mat（不拷贝）
+         */
+        cv::Mat wrapSlot(const std::shared_ptr<FrameBusMapping>& mapping, uint32_t index) {
+            FrameBusSlot* slot = mapping->slot(index);
+            unsigned char* data = reinterpret_cast<unsigned char*>(slot) + FRAME_BUS_SLOT_HEADER;
+            cv::Mat frame(slot->rows, slot->cols, slot->type, data, slot->step);
+            SlotLease& lease = *mapping->leases[index];
+            lease.mapping = mapping;
+            cv::UMatData* u = &lease.data;
+            u->data = u->origdata = data;
+            u->size = slot->step * slot->rows;
+            u->refcount = 1;
+            u->userdata = &lease;
+            frame.u = u;
+            frame.allocator = &slotAllocator();
+            return frame;
+        }
+    }
+#else
+    struct FrameBusMapping {};
+#endif
+
+    // 构造函数
+    FrameBusSource::FrameBusSource() : lastSeq_(0) {
+    }
+
+    // 析构函数
+    FrameBusSource::~FrameBusSource() {
+        release();
+    }
+
+    /**
+     * @brief 映射发布端创建的共享内存
+     * @param name 共享内存名称
+     * @return 共享内存不存在或格式不符时返回 false
+     */
+    bool FrameBusSource::open(const std::string& name) {
+        release();
+        name_ = frameBusName(name);
+#ifndef _WIN32
+        // 引用计数写在共享内存中，读端同样需要写权限
+        int fd = shm_open(name_.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            std::cerr << "[ERROR] 无法打开帧总线：" << name_ << "（" << std::strerror(errno)
+                      << "），请先启动发布端（--frame-bus）" << std::endl;
+            return false;
+        }
+        struct stat info{};
+        if (fstat(fd, &info) != 0 || (std::size_t)info.st_size < FRAME_BUS_SLOTS_OFFSET) {
+            std::cerr << "[ERROR] 帧总线尚未就绪：" << name_ << std::endl;
+            close(fd);
+            return false;
+        }
+        auto mapping = std::make_shared<FrameBusMapping>();
+        void* mapped = mmap(nullptr, (std::size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "[ERROR] 无法映射帧总线：" << name_ << "（" << std::strerror(errno) << "）" << std::endl;
+            return false;
+        }
+        mapping->base = static_cast<unsigned char*>(mapped);
+        mapping->bytes = (std::size_t)info.st_size;
+
+        const FrameBusHeader* header = mapping->header();
+        if (header->magic != FRAME_BUS_MAGIC || header->version != FRAME_BUS_VERSION) {
+            std::cerr << "[ERROR] 帧总线格式不符或尚未就绪：" << name_ << std::endl;
+            return false;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header->slotCount == 0 || header->slotCount > FRAME_BUS_MAX_SLOTS
+            || FRAME_BUS_SLOTS_OFFSET + header->slotStride * header->slotCount > mapping->bytes) {
+            std::cerr << "[ERROR] 帧总线头部损坏：" << name_ << std::endl;
+            return false;
+        }
+        for (uint32_t i = 0; i < header->slotCount; i++) {
+            mapping->leases.push_back(std::make_unique<SlotLease>(&slotAllocator(), i));
+        }
+        if (!mapping->claimReader()) {
+            std::cerr << "[ERROR] 帧总线读端已满（至多 " << FRAME_BUS_MAX_READERS << " 个）：" << name_ << std::endl;
+            return false;
+        }
+
+        // 只读取打开之后发布的帧
+        lastSeq_ = header->latest.load(std::memory_order_acquire) >> 8;
+        mapping_ = mapping;
+        return true;
+#else
+        std::cerr << "[ERROR] 当前平台不支持共享内存帧总线：" << name_ << std::endl;
+        return false;
+#endif
+    }
+
+    /**
+     * @brief 读取发布端最新的一帧
+     * @param frame 输出图像帧（引用共享内存槽位；超时时为空，由上层跳过）
+     * @return 发布端已退出且没有新帧时返回 false
+     */
+    bool FrameBusSource::read(cv::Mat& frame) {
+#ifndef _WIN32
+        if (!mapping_) return false;
+        FrameBusHeader* header = mapping_->header();
+        frame.release();
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(WAIT_TIMEOUT_MS);
+        int retries = 0;
+        while (true) {
+            uint64_t latest = header->latest.load(std::memory_order_acquire);
+            uint64_t seq = latest >> 8;
+            if (seq <= lastSeq_) {
+                if (header->closed.load(std::memory_order_acquire)) return false;
+                if (std::chrono::steady_clock::now() >= deadline) return true;
+                std::this_thread::sleep_for(std::chrono::microseconds(POLL_INTERVAL_US));
+                continue;
+            }
+
+            // 先置引用位再确认槽位仍是该帧（与发布端"先标记写入中再检查引用"配对）
+            uint32_t index = (uint32_t)(latest & 0xff);
+            if (index >= header->slotCount) return false;
+            FrameBusSlot* slot = mapping_->slot(index);
+            mapping_->pin(index);
+            if (slot->state.load() == 2 * seq) {
+                lastSeq_ = seq;
+                frame = wrapSlot(mapping_, index);
+                return true;
+            }
+            // 引用前已被更新的帧覆盖：放弃该槽位，读取更新的帧
+            mapping_->unpin(index);
+            if (++retries >= PIN_RETRIES) return true;
+        }
+#else
+        (void)frame;
+        return false;
+#endif
+    }
+
+    /**
+     * @brief 帧总线为实时输入
+     */
+    bool FrameBusSource::isLive() const {
+        return true;
+    }
+
+    /**
+     * @brief 输入源描述（用于日志）
+     */
+    std::string FrameBusSource::describe() const {
+        return "帧总线 " + name_ + " (共享内存，零拷贝)";
+    }
+
+    /**
+     * @brief 解除映射（仍被流水线引用的帧在释放后解除映射）
+     */
+    void FrameBusSource::release() {
+        mapping_.reset();
+    }
+}
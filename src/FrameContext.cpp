@@ -0,0 +1,138 @@
+#include "FrameContext.h"
+#include "ImageOps.h"
+
+namespace DriveGuard {
+    /**
+     * @brief 构造函数
+     * @param box 人脸框（帧坐标）
+     * @param trackId 人脸轨迹编号
+     * @param frameGray 帧灰度图
+     * @param frameEqualized 帧均衡化灰度图
+     * @param sampleBuffer 统一尺寸人脸的缓冲区（由帧上下文复用，可为空）
+     */
+    FaceSample::FaceSample(const cv::Rect& box, int trackId, const cv::Mat& frameGray, const cv::Mat& frameEqualized,
+                           const cv::Mat& sampleBuffer)
+        : box_(box & cv::Rect(0, 0, frameGray.cols, frameGray.rows)), trackId_(trackId), normalized_(sampleBuffer) {
+        if (!box_.empty()) {
+            gray_ = frameGray(box_);
+            equalized_ = frameEqualized(box_);
+        }
+    }
+
+    /**
+     * @brief 人脸框（帧坐标）
+     */
+    const cv::Rect& FaceSample::box() const {
+        return box_;
+    }
+
+    /**
+     * @brief 人脸轨迹编号
+     */
+    int FaceSample::trackId() const {
+        return trackId_;
+    }
+
+    /**
+     * @brief 灰度人脸区域（帧灰度图的视图）
+     */
+    const cv::Mat& FaceSample::gray() const {
+        return gray_;
+    }
+
+    /**
+     * @brief 均衡化人脸区域（帧均衡化图的视图，供眼部检测使用）
+     */
+    const cv::Mat& FaceSample::equalized() const {
+        return equalized_;
+    }
+
+    /**
+     * @brief 统一为 FACE_SAMPLE_SIZE 的灰度人脸（与录入样本一致，供识别使用）
+     */
+    const cv::Mat& FaceSample::normalized() {
+        if (!hasNormalized_ && !gray_.empty()) {
+            resizeLinear(gray_, normalized_, cv::Size(FACE_SAMPLE_SIZE, FACE_SAMPLE_SIZE));
+            hasNormalized_ = true;
+        }
+        return normalized_;
+    }
+
+    /**
+     * @brief 对新的一帧进行预处理（复用已有缓冲区）
+     * @param frame 输入图像帧（BGR 或灰度）
+     */
+    void FrameContext::prepare(const cv::Mat& frame) {
+        frame_ = frame;
+        faces_.clear();
+
+        // 转换为灰度图以提高检测速度和准确率
+        if (frame.channels() == 3) {
+            // 上一帧为灰度输入时 gray_ 指向该帧数据，不能原地复用
+            if (grayIsView_) gray_.release();
+            bgrToGray(frame, gray_);
+            grayIsView_ = false;
+        } else {
+            gray_ = frame;
+            grayIsView_ = true;
+        }
+
+        // 直方图均衡化，改善对比度（输出到独立缓冲区，不修改原图）
+        equalizeHistogram(gray_, equalized_);
+    }
+
+    /**
+     * @brief 原始图像帧
+     */
+    const cv::Mat& FrameContext::frame() const {
+        return frame_;
+    }
+
+    /**
+     * @brief 灰度图（输入为灰度时即为原图）
+     */
+    const cv::Mat& FrameContext::gray() const {
+        return gray_;
+    }
+
+    /**
+     * @brief 直方图均衡化后的灰度图（供人脸检测使用）
+     */
+    const cv::Mat& FrameContext::equalized() const {
+        return equalized_;
+    }
+
+    /**
+     * @brief 添加一张人脸样本
+     * @param box 人脸框（帧坐标）
+     * @param trackId 人脸轨迹编号
+     * @return 新添加的人脸样本
+     */
+    FaceSample& FrameContext::addFace(const cv::Rect& box, int trackId) {
+        // 样本缓冲区与视图共享数据，resize 写入时尺寸相符即原地覆盖
+        if (sampleBuffers_.size() <= faces_.size()) {
+            sampleBuffers_.emplace_back(FACE_SAMPLE_SIZE, FACE_SAMPLE_SIZE, CV_8UC1);
+        }
+        faces_.emplace_back(box, trackId, gray_, equalized_, sampleBuffers_[faces_.size()]);
+        return faces_.back();
+    }
+
+    /**
+     * @brief 当前帧的人脸样本
+     */
+    std::vector<FaceSample>& FrameContext::faces() {
+        return faces_;
+    }
+
+    /**
+     * @brief 释放对帧数据的引用，保留自有缓冲区（数据包归还帧池时调用）
+     */
+    void FrameContext::recycle() {
+        faces_.clear();
+        frame_.release();
+        if (grayIsView_) {
+            gray_.release();
+            grayIsView_ = false;
+        }
+    }
+}
@@ -0,0 +1,216 @@
+#include "FramePipeline.h"
+#include "Metrics.h"
+#include <iostream>
+#include <utility>
+
+namespace DriveGuard {
+    namespace {
+        // 各队列之外同时存在的数据包数：采集、检测、分析各一个，渲染端一个，另留一个余量
+        const std::size_t FRAME_POOL_SLACK = 5;
+    }
+
+    /**
+     * @brief 构造函数
+     * @param capture 采集函数
+     * @param analyzer 帧分析器
+     * @param queueCapacity 各阶段队列容量
+     * @param dropOldest 队列满时丢弃最旧帧（实时输入）；为 false 时阻塞上游（离线回放，不丢帧）
+     * @param pool 共享线程池（为空时检测与分析各占一个线程）
+     */
+    FramePipeline::FramePipeline(CaptureFn capture, FrameAnalyzer& analyzer, std::size_t queueCapacity,
+                                 bool dropOldest, ThreadPool* pool)
+        : capture_(std::move(capture)), analyzer_(analyzer), dropOldest_(dropOldest), pool_(pool),
+          framePool_(FRAME_POOL_SLACK + 3 * queueCapacity),
+          captureQueue_(queueCapacity), detectQueue_(queueCapacity), resultQueue_(queueCapacity),
+          running_(false), dropped_(0), scheduled_(false), inFlight_(0) {
+    }
+
+    /**
+     * @brief 析构函数（自动停止流水线）
+     */
+    FramePipeline::~FramePipeline() {
+        stop();
+    }
+
+    /**
+     * @brief 启动各阶段线程
+     */
+    void FramePipeline::start() {
+        if (running_.exchange(true)) return;
+
+        captureThread_ = std::thread(&FramePipeline::captureLoop, this);
+        if (pool_) return; // 检测与分析由线程池执行
+        detectThread_ = std::thread(&FramePipeline::detectLoop, this);
+        analyzeThread_ = std::thread(&FramePipeline::analyzeLoop, this);
+    }
+
+    /**
+     * @brief 停止流水线并等待所有线程退出
+     */
+    void FramePipeline::stop() {
+        running_ = false;
+        captureQueue_.close();
+        detectQueue_.close();
+        resultQueue_.close();
+
+        if (captureThread_.joinable()) captureThread_.join();
+        if (detectThread_.joinable()) detectThread_.join();
+        if (analyzeThread_.joinable()) analyzeThread_.join();
+
+        // 等待线程池中本路的任务结束（任务引用了本对象）
+        std::unique_lock<std::mutex> lock(taskMutex_);
+        taskDone_.wait(lock, [this] { return inFlight_ == 0; });
+    }
+
+    /**
+     * @brief 获取下一帧处理结果（阻塞）
+     * @param packet 输出的帧数据包
+     * @return 流水线已结束且无剩余结果时返回 false
+     */
+    bool FramePipeline::nextResult(FramePacket& packet) {
+        return resultQueue_.pop(packet);
+    }
+
+    /**
+     * @brief 获取下一帧处理结果（非阻塞，供同时轮询多路流水线）
+     * @param packet 输出的帧数据包
+     * @return 暂无结果时返回 false
+     */
+    bool FramePipeline::tryNextResult(FramePacket& packet) {
+        return resultQueue_.tryPop(packet);
+    }
+
+    /**
+     * @brief 归还已处理完的数据包（其缓冲区由后续帧复用）
+     * @param packet 不再使用的数据包
+     */
+    void FramePipeline::recycle(FramePacket&& packet) {
+        framePool_.release(std::move(packet));
+    }
+
+    /**
+     * @brief 流水线已结束且结果已全部取走
+     */
+    bool FramePipeline::finished() const {
+        return resultQueue_.finished();
+    }
+
+    /**
+     * @brief 因下游处理不及而被丢弃的帧数
+     */
+    uint64_t FramePipeline::droppedFrames() const {
+        return dropped_.load();
+    }
+
+    /**
+     * @brief 采集阶段：取出帧池中的数据包，读取帧并打上序号与时间戳
+     */
+    void FramePipeline::captureLoop() {
+        uint64_t seq = 0;
+        FramePacket packet;
+        framePool_.acquire(packet);
+        while (running_) {
+            if (!capture_(packet.frame)) {
+                std::cout << "[INFO] 输入结束，采集线程退出" << std::endl;
+                break;
+            }
+            if (packet.frame.empty()) {
+                std::cerr << "[WARN] 捕获到空帧，跳过..." << std::endl;
+                continue;
+            }
+
+            packet.seq = seq++;
+            packet.captureTime = Clock::now();
+            forward(captureQueue_, std::move(packet));
+            if (pool_) schedule();
+            framePool_.acquire(packet);
+        }
+        captureQueue_.close();
+        if (pool_) schedule(); // 由处理任务在取完剩余帧后关闭结果队列
+    }
+
+    /**
+     * @brief 检测阶段：人脸检测
+     */
+    void FramePipeline::detectLoop() {
+        FramePacket packet;
+        while (captureQueue_.pop(packet)) {
+            if (!analyzer_.admit(packet)) { // 降载：丢弃超出延迟预算的帧
+                framePool_.release(std::move(packet));
+                continue;
+            }
+            analyzer_.detect(packet);
+            forward(detectQueue_, std::move(packet));
+        }
+        detectQueue_.close();
+    }
+
+    /**
+     * @brief 分析阶段：身份识别、眼部检测与疲劳判定
+     */
+    void FramePipeline::analyzeLoop() {
+        FramePacket packet;
+        while (detectQueue_.pop(packet)) {
+            analyzer_.analyze(packet);
+            forward(resultQueue_, std::move(packet));
+        }
+        resultQueue_.close();
+    }
+
+    /**
+     * @brief 线程池模式：本路没有处理任务时提交一个
+     */
+    void FramePipeline::schedule() {
+        if (!running_ || scheduled_.exchange(true)) return;
+        {
+            std::lock_guard<std::mutex> lock(taskMutex_);
+            inFlight_++;
+        }
+        pool_->submit([this] { processNext(); });
+    }
+
+    /**
+     * @brief 线程池模式：检测并分析一帧，队列中仍有帧时重新提交（各路轮流占用工作线程）
+     */
+    void FramePipeline::processNext() {
+        FramePacket packet;
+        if (running_ && captureQueue_.tryPop(packet)) {
+            if (analyzer_.admit(packet)) {
+                analyzer_.detect(packet);
+                analyzer_.analyze(packet);
+                forward(resultQueue_, std::move(packet));
+            } else {
+                framePool_.release(std::move(packet));
+            }
+        }
+
+        scheduled_ = false;
+        if (captureQueue_.finished()) {
+            resultQueue_.close(); // 输入结束且全部帧已处理
+        } else if (captureQueue_.size() > 0) {
+            schedule();
+        }
+
+        // 最后一步：stop() 可能在计数归零后立即析构本对象
+        std::lock_guard<std::mutex> lock(taskMutex_);
+        inFlight_--;
+        taskDone_.notify_all();
+    }
+
+    /**
+     * @brief 将帧送入下一阶段队列（按配置丢弃最旧帧或阻塞等待；被丢弃的帧归还帧池）
+     */
+    void FramePipeline::forward(BoundedQueue<FramePacket>& queue, FramePacket&& packet) {
+        if (dropOldest_) {
+            FramePacket evicted;
+            std::size_t dropped = queue.push(std::move(packet), &evicted);
+            if (dropped > 0) {
+                framePool_.release(std::move(evicted));
+                dropped_ += dropped;
+                Metrics::increment(Counter::DROPPED_FRAMES, dropped);
+            }
+        } else {
+            queue.pushWait(std::move(packet));
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#include "FramePool.h"
+#include <utility>
+
+namespace DriveGuard {
+    /**
+     * @brief 构造函数
+     * @param capacity 最多保留的空闲数据包数（超出的直接释放）
+     */
+    FramePool::FramePool(std::size_t capacity) : capacity_(capacity > 0 ? capacity : 1), misses_(0) {
+        free_.reserve(capacity_);
+    }
+
+    /**
+     * @brief 取出一个数据包（无空闲时新建；帧缓冲区不被其他持有者引用，可原地写入），序号与模式等字段由调用方重新填写
+     * @param packet 输出的数据包
+     */
+    void FramePool::acquire(FramePacket& packet) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.empty()) {
+            packet = FramePacket();
+            misses_++;
+            return;
+        }
+
+        // 优先取帧缓冲区已无人引用的数据包；事件记录器尚未编码的帧不能被采集阶段原地覆盖
+        std::size_t pick = free_.size() - 1;
+        while (pick > 0 && isFrameShared(free_[pick].frame)) pick--;
+        if (pick != free_.size() - 1) std::swap(free_[pick], free_.back());
+        packet = std::move(free_.back());
+        free_.pop_back();
+        if (isFrameShared(packet.frame)) {
+            // 全部仍被引用：放弃这一帧缓冲区（由其他持有者释放），采集时重新分配
+            packet.frame.release();
+            misses_++;
+        }
+    }
+
+    /**
+     * @brief 归还数据包（自有缓冲区保留，供下次 acquire 复用；借用的帧数据立即释放）
+     * @param packet 不再使用的数据包
+     */
+    void FramePool::release(FramePacket&& packet) {
+        // 只保留自有的缓冲区：借用的驱动缓冲区或外部数据须立即释放（V4L2 帧在此归还驱动）
+        packet.context.recycle();
+        if (!isOwnedFrame(packet.frame)) packet.frame.release();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.size() < capacity_) free_.push_back(std::move(packet));
+    }
+
+    /**
+     * @brief 当前空闲的数据包数
+     */
+    std::size_t FramePool::idle() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return free_.size();
+    }
+
+    /**
+     * @brief 因无空闲数据包（或空闲数据包的帧均仍被引用）而新建的次数（稳定运行后应不再增长）
+     */
+    uint64_t FramePool::misses() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return misses_;
+    }
+}
@@ -0,0 +1,163 @@
+#include "FrameSource.h"
+#include "FrameBusSource.h"
+#include "ImageSequenceSource.h"
+#include "RawYuvSource.h"
+#include "V4L2Source.h"
+#include "VideoCaptureSource.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace DriveGuard {
+    namespace {
+        // 按逗号拆分输入描述
+        std::vector<std::string> splitFields(const std::string& text) {
+            std::vector<std::string> fields;
+            std::stringstream ss(text);
+            std::string field;
+            while (std::getline(ss, field, ',')) fields.push_back(field);
+            return fields;
+        }
+
+        // 解析 "<宽>x<高>"
+        bool parseSize(const std::string& text, cv::Size& size) {
+            std::size_t sep = text.find_first_of("xX");
+            if (sep == std::string::npos) return false;
+            try {
+                std::size_t used = 0;
+                int width = std::stoi(text.substr(0, sep), &used);
+                if (used != sep) return false;
+                std::string rest = text.substr(sep + 1);
+                int height = std::stoi(rest, &used);
+                if (used != rest.size() || width <= 0 || height <= 0) return false;
+                size = cv::Size(width, height);
+                return true;
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+
+        /**
+         * @brief 创建 V4L2 输入源："v4l2:<设备>[,<宽>x<高>][,<格式>]"
+         */
+        std::unique_ptr<FrameSource> createV4L2(const std::string& spec) {
+            std::vector<std::string> fields = splitFields(spec);
+            if (fields.empty() || fields[0].empty()) {
+                std::cerr << "[ERROR] V4L2 输入缺少设备路径：v4l2:" << spec << std::endl;
+                return nullptr;
+            }
+
+            cv::Size size;
+            PixelFormat format = PixelFormat::GREY;
+            bool autoFormat = true;
+            for (std::size_t i = 1; i < fields.size(); i++) {
+                if (parseSize(fields[i], size)) continue;
+                if (FrameSource::parsePixelFormat(fields[i], format)) {
+                    autoFormat = false;
+                    continue;
+                }
+                std::cerr << "[ERROR] 无法识别的 V4L2 参数：" << fields[i] << std::endl;
+                return nullptr;
+            }
+
+            auto source = std::make_unique<V4L2Source>();
+            if (!source->open(fields[0], size, format, autoFormat)) return nullptr;
+            return source;
+        }
+
+        /**
+         * @brief 创建原始 YUV 文件输入源："yuv:<文件>,<宽>x<高>,<格式>[,<帧率>]"
+         */
+        std::unique_ptr<FrameSource> createRawYuv(const std::string& spec) {
+            std::vector<std::string> fields = splitFields(spec);
+            cv::Size size;
+            PixelFormat format;
+            if (fields.size() < 3 || fields.size() > 4 || !parseSize(fields[1], size)
+                || !FrameSource::parsePixelFormat(fields[2], format)) {
+                std::cerr << "[ERROR] 原始 YUV 输入格式应为 yuv:<文件>,<宽>x<高>,<格式>[,<帧率>]：yuv:"
+                          << spec << std::endl;
+                return nullptr;
+            }
+
+            double fps = 0.0;
+            if (fields.size() == 4) {
+                try {
+                    fps = std::stod(fields[3]);
+                } catch (const std::exception&) {
+                    std::cerr << "[ERROR] 无效的帧率：" << fields[3] << std::endl;
+                    return nullptr;
+                }
+            }
+
+            auto source = std::make_unique<RawYuvSource>();
+            if (!source->open(fields[0], size, format, fps)) return nullptr;
+            return source;
+        }
+    }
+
+    /**
+     * @brief 按输入描述创建并打开输入源
+     * @param input 摄像头编号（如 "0"）、视频文件路径、图片目录路径、
+     *              "v4l2:<设备>[,<宽>x<高>][,<格式>]"、"yuv:<文件>,<宽>x<高>,<格式>[,<帧率>]"
+     *              或 "shm:<帧总线名称>"
+     * @return 打开失败返回空指针
+     */
+    std::unique_ptr<FrameSource> FrameSource::create(const std::string& input) {
+        const std::string v4l2Prefix = "v4l2:";
+        const std::string yuvPrefix = "yuv:";
+        const std::string shmPrefix = "shm:";
+        if (input.compare(0, v4l2Prefix.size(), v4l2Prefix) == 0) {
+            return createV4L2(input.substr(v4l2Prefix.size()));
+        }
+        if (input.compare(0, yuvPrefix.size(), yuvPrefix) == 0) {
+            return createRawYuv(input.substr(yuvPrefix.size()));
+        }
+        if (input.compare(0, shmPrefix.size(), shmPrefix) == 0) {
+            auto source = std::make_unique<FrameBusSource>();
+            if (!source->open(input.substr(shmPrefix.size()))) return nullptr;
+            return source;
+        }
+
+        std::error_code ec;
+        if (std::filesystem::is_directory(input, ec)) {
+            auto source = std::make_unique<ImageSequenceSource>();
+            if (!source->open(input)) return nullptr;
+            return source;
+        }
+
+        auto source = std::make_unique<VideoCaptureSource>();
+        if (!source->open(input)) return nullptr;
+        return source;
+    }
+
+    /**
+     * @brief 解析像素格式名称（grey/gray、nv12、i420、yuyv，不区分大小写）
+     */
+    bool FrameSource::parsePixelFormat(const std::string& name, PixelFormat& format) {
+        std::string lower = name;
+        std::transform(lower.begin(), lower.end(), lower.begin(),
+                       [](unsigned char ch) { return (char)std::tolower(ch); });
+        if (lower == "grey" || lower == "gray") format = PixelFormat::GREY;
+        else if (lower == "nv12") format = PixelFormat::NV12;
+        else if (lower == "i420") format = PixelFormat::I420;
+        else if (lower == "yuyv") format = PixelFormat::YUYV;
+        else return false;
+        return true;
+    }
+
+    /**
+     * @brief 像素格式名称
+     */
+    const char* FrameSource::pixelFormatName(PixelFormat format) {
+        switch (format) {
+            case PixelFormat::GREY: return "GREY";
+            case PixelFormat::NV12: return "NV12";
+            case PixelFormat::I420: return "I420";
+            case PixelFormat::YUYV: return "YUYV";
+        }
+        return "?";
+    }
+}
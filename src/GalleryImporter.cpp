@@ -0,0 +1,198 @@
+#include "GalleryImporter.h"
+#include "FrameContext.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <iostream>
+
+namespace DriveGuard {
+    namespace {
+        /**
+         * @brief 是否为可读取的图片文件（按扩展名，不区分大小写）
+         */
+        bool isImageFile(const std::filesystem::path& path) {
+            std::string ext = path.extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char ch) { return (char)std::tolower(ch); });
+            return ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp" || ext == ".pgm" || ext == ".ppm";
+        }
+
+        /**
+         * @brief 按文件名排序的子目录
+         */
+        std::vector<std::filesystem::path> sortedDirectories(const std::filesystem::path& dir) {
+            std::vector<std::filesystem::path> dirs;
+            std::error_code ec;
+            for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+                if (entry.is_directory(ec)) dirs.push_back(entry.path());
+            }
+            std::sort(dirs.begin(), dirs.end());
+            return dirs;
+        }
+    }
+
+    /**
+     * @brief 构造函数
+     * @param detector 人脸检测器（cropped 为 true 时不使用）
+     * @param config 导入配置
+     */
+    GalleryImporter::GalleryImporter(FaceDetector& detector, const ImportConfig& config)
+        : detector_(detector), config_(config) {
+    }
+
+    /**
+     * @brief 导入目录中的全部身份到识别器（更新图库与身份信息库，不保存文件）
+     * @param root 根目录
+     * @param recognizer 识别器
+     * @param report 输出统计
+     * @return 根目录无法读取或没有任何可用样本时返回 false
+     */
+    bool GalleryImporter::import(const std::string& root, FaceRecognizer& recognizer, ImportReport& report) {
+        report = ImportReport();
+        std::vector<IdentityTask> identities;
+        std::vector<ImageTask> images;
+        if (!collect(root, identities, images)) return false;
+        report.images = images.size();
+        std::cout << "[INFO] 待导入：" << identities.size() << " 个身份，" << images.size() << " 张图片" << std::endl;
+
+        // 读取、检测与裁剪在多个核心上并行（检测器按线程持有级联分类器），结果按下标写回
+        cv::parallel_for_(cv::Range(0, (int)images.size()), [&](const cv::Range& range) {
+            for (int i = range.start; i < range.end; i++) prepare(images[i]);
+        });
+
+        // 统计可用样本，按身份分配标签（同名身份沿用已有标签）
+        for (const auto& task : images) {
+            if (!task.readable) report.unreadable++;
+            else if (task.sample.empty()) report.noFace++;
+            else identities[task.identity].samples++;
+        }
+        std::vector<int> identityLabels(identities.size(), -1);
+        int nextLabel = recognizer.getAvailableLabel();
+        for (std::size_t i = 0; i < identities.size(); i++) {
+            IdentityTask& identity = identities[i];
+            if (identity.samples == 0) {
+                std::cerr << "[WARN] 身份 " << identity.name << " 没有可用的人脸样本，已跳过" << std::endl;
+                continue;
+            }
+            int label = recognizer.identities().find(identity.name);
+            if (label < 0) {
+                label = nextLabel++;
+                report.newIdentities++;
+            }
+            identityLabels[i] = label;
+            recognizer.setLabelInfo(label, identity.name, identity.role);
+            report.identities++;
+        }
+
+        std::vector<cv::Mat> samples;
+        std::vector<int> labels;
+        samples.reserve(images.size());
+        labels.reserve(images.size());
+        for (auto& task : images) {
+            if (task.sample.empty()) continue;
+            samples.push_back(std::move(task.sample));
+            labels.push_back(identityLabels[task.identity]);
+        }
+        report.samples = samples.size();
+        if (samples.empty()) {
+            std::cerr << "[ERROR] 没有可导入的人脸样本：" << root << std::endl;
+            return false;
+        }
+
+        // 特征提取在 update 中并行完成，图库按输入顺序追加
+        recognizer.update(samples, labels);
+        return true;
+    }
+
+    /**
+     * @brief 收集根目录下的身份与图片（按角色分组或平铺）
+     */
+    bool GalleryImporter::collect(const std::string& root, std::vector<IdentityTask>& identities,
+                                  std::vector<ImageTask>& images) const {
+        std::error_code ec;
+        if (!std::filesystem::is_directory(root, ec)) {
+            std::cerr << "[ERROR] 导入目录不存在：" << root << std::endl;
+            return false;
+        }
+
+        std::filesystem::path driverDir = std::filesystem::path(root) / "driver";
+        std::filesystem::path passengerDir = std::filesystem::path(root) / "passenger";
+        bool grouped = std::filesystem::is_directory(driverDir, ec) || std::filesystem::is_directory(passengerDir, ec);
+        if (grouped) {
+            for (const auto& dir : sortedDirectories(driverDir)) {
+                collectIdentity(dir.string(), dir.filename().string(), UserRole::DRIVER, identities, images);
+            }
+            for (const auto& dir : sortedDirectories(passengerDir)) {
+                collectIdentity(dir.string(), dir.filename().string(), UserRole::PASSENGER, identities, images);
+            }
+        } else {
+            for (const auto& dir : sortedDirectories(root)) {
+                collectIdentity(dir.string(), dir.filename().string(), config_.role, identities, images);
+            }
+        }
+
+        if (images.empty()) {
+            std::cerr << "[ERROR] 导入目录中没有找到图片：" << root << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 收集一个身份目录中的图片（按文件名排序，至多 maxPerIdentity 张）
+     */
+    void GalleryImporter::collectIdentity(const std::string& dir, const std::string& name, UserRole role,
+                                          std::vector<IdentityTask>& identities, std::vector<ImageTask>& images) const {
+        // 映射表以冒号分隔，姓名中不能含有换行
+        if (name.empty() || name.find('\n') != std::string::npos) {
+            std::cerr << "[WARN] 跳过无效的身份目录：" << dir << std::endl;
+            return;
+        }
+
+        std::vector<std::string> files;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+            if (entry.is_regular_file(ec) && isImageFile(entry.path())) files.push_back(entry.path().string());
+        }
+        if (files.empty()) return;
+        std::sort(files.begin(), files.end());
+        if (config_.maxPerIdentity > 0 && files.size() > (std::size_t)config_.maxPerIdentity) {
+            files.resize(config_.maxPerIdentity);
+        }
+
+        IdentityTask identity;
+        identity.name = name;
+        identity.role = role;
+        identities.push_back(identity);
+        for (auto& file : files) {
+            ImageTask task;
+            task.path = std::move(file);
+            task.identity = identities.size() - 1;
+            images.push_back(std::move(task));
+        }
+    }
+
+    /**
+     * @brief 读取一张图片并裁剪出统一尺寸的灰度人脸（取面积最大的人脸）
+     */
+    void GalleryImporter::prepare(ImageTask& task) {
+        cv::Mat gray = cv::imread(task.path, cv::IMREAD_GRAYSCALE);
+        if (gray.empty()) return;
+        task.readable = true;
+
+        if (config_.cropped) {
+            cv::resize(gray, task.sample, cv::Size(FACE_SAMPLE_SIZE, FACE_SAMPLE_SIZE));
+            return;
+        }
+
+        FrameContext context;
+        context.prepare(gray);
+        std::vector<cv::Rect> faces;
+        detector_.detect(context, faces);
+        if (faces.empty()) return;
+
+        const cv::Rect& largest = *std::max_element(faces.begin(), faces.end(),
+            [](const cv::Rect& a, const cv::Rect& b) { return a.area() < b.area(); });
+        // 与现场录入相同：原始灰度人脸缩放至统一尺寸（样本缓冲区归本任务所有）
+        task.sample = context.addFace(largest, -1).normalized().clone();
+    }
+}
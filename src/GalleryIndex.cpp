@@ -0,0 +1,389 @@
+#include "GalleryIndex.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <map>
+#include <numeric>
+
+namespace DriveGuard {
+    namespace {
+        // 训练倒排列表中心时每个列表最多使用的原型数（超出部分等间隔抽样）
+        const std::size_t TRAIN_PER_LIST = 32;
+
+        // 每个原型至少代表的样本数（样本较少的身份少聚几类，避免单样本原型与均值原型混杂造成距离偏差）
+        const std::size_t MIN_PROTOTYPE_SAMPLES = 5;
+
+        /**
+         * @brief 卡方距离下的 k-means（最远点初始化，按卡方距离分配、按均值更新）
+         * @param points 待聚类的直方图
+         * @param k 聚类数（超过点数时取点数）
+         * @param iterations 最大迭代次数
+         * @param assignment 输出每个点所属的类
+         * @return 聚类中心（行标签为类号）
+         */
+        GalleryMatrix chiKMeans(const GalleryMatrix& points, int k, int iterations, std::vector<int>& assignment) {
+            const std::size_t n = points.rows();
+            const std::size_t count = std::min<std::size_t>((std::size_t)std::max(k, 1), n);
+            GalleryMatrix centers(points.cols(), points.precision(), points.cellArea());
+            assignment.assign(n, 0);
+            if (n == 0) return centers;
+
+            std::vector<cv::Mat> means(count);
+            std::vector<double> distances;
+            cv::Mat row;
+
+            // 最远点初始化：每次取距已选中心最远的点
+            points.histogram(0, means[0]);
+            std::vector<double> nearest(n, DBL_MAX);
+            for (std::size_t c = 1; c < count; c++) {
+                points.distances(means[c - 1], distances);
+                for (std::size_t i = 0; i < n; i++) nearest[i] = std::min(nearest[i], distances[i]);
+                std::size_t farthest = (std::size_t)(std::max_element(nearest.begin(), nearest.end()) - nearest.begin());
+                points.histogram(farthest, means[c]);
+            }
+
+            std::vector<double> best(n);
+            for (int it = 0; it < std::max(iterations, 1); it++) {
+                // 分配：每个中心对所有点批量计算距离
+                std::fill(best.begin(), best.end(), DBL_MAX);
+                bool changed = it == 0;
+                for (std::size_t c = 0; c < count; c++) {
+                    points.distances(means[c], distances);
+                    for (std::size_t i = 0; i < n; i++) {
+                        if (distances[i] < best[i]) {
+                            best[i] = distances[i];
+                            if (assignment[i] != (int)c) changed = true;
+                            assignment[i] = (int)c;
+                        }
+                    }
+                }
+                if (!changed) break;
+
+                // 更新：各类的均值（空类保留原中心）
+                std::vector<cv::Mat> sums(count);
+                std::vector<int> members(count, 0);
+                for (std::size_t i = 0; i < n; i++) {
+                    points.histogram(i, row);
+                    cv::Mat& sum = sums[assignment[i]];
+                    if (sum.empty()) sum = cv::Mat::zeros(1, points.cols(), CV_32FC1);
+                    sum += row;
+                    members[assignment[i]]++;
+                }
+                for (std::size_t c = 0; c < count; c++) {
+                    if (members[c] > 0) means[c] = sums[c] / members[c];
+                }
+            }
+
+            centers.reserve(count);
+            for (std::size_t c = 0; c < count; c++) centers.append(means[c], (int)c);
+            return centers;
+        }
+
+        // 循环二进制串中 0/1 跳变次数不超过 2 的编码为均匀模式
+        bool isUniform(int code, int neighbors) {
+            int transitions = 0;
+            for (int b = 0; b < neighbors; b++) {
+                int current = (code >> b) & 1;
+                int next = (code >> ((b + 1) % neighbors)) & 1;
+                transitions += current != next;
+            }
+            return transitions <= 2;
+        }
+    }
+
+    /**
+     * @brief 构造函数
+     * @param config 索引配置
+     */
+    GalleryIndex::GalleryIndex(const GalleryIndexConfig& config)
+        : config_(config), bins_(0), reducedBins_(0), cells_(0), cellArea_(1), trainedIdentities_(0) {
+    }
+
+    /**
+     * @brief 按图库全部样本重建索引
+     * @param gallery 样本图库
+     * @param params 图库直方图的 LBP 参数
+     */
+    void GalleryIndex::build(const GalleryMatrix& gallery, const LBPParams& params) {
+        clear();
+        if (!config_.enabled || gallery.rows() == 0) return;
+        setupReduction(params, gallery.cols(), gallery.cellArea());
+
+        // 按身份分组（std::map 保证构建结果与样本顺序无关）
+        std::map<int, std::vector<std::size_t>> groups;
+        for (std::size_t r = 0; r < gallery.rows(); r++) {
+            groups[gallery.label(r)].push_back(r);
+        }
+
+        const int reducedCols = cells_ * reducedBins_;
+        const GalleryPrecision precision = GalleryMatrix::precisionFor(cellArea_);
+        GalleryMatrix prototypes(reducedCols, precision, cellArea_);
+        prototypes.reserve(groups.size() * (std::size_t)std::max(config_.prototypes, 1));
+        for (const auto& [label, rows] : groups) {
+            addPrototypes(gallery, rows, label, prototypes);
+            identityRows_[label] = rows;
+        }
+
+        // 倒排列表中心：在（抽样后的）原型上聚类
+        int listCount = config_.lists > 0 ? config_.lists : (int)std::lround(std::sqrt((double)groups.size()));
+        listCount = (int)std::min<std::size_t>((std::size_t)std::max(listCount, 1), prototypes.rows());
+        const std::size_t trainRows = (std::size_t)listCount * TRAIN_PER_LIST;
+        std::vector<int> assignment;
+        cv::Mat row;
+        if (prototypes.rows() > trainRows) {
+            GalleryMatrix training(reducedCols, precision, cellArea_);
+            training.reserve(trainRows);
+            for (std::size_t i = 0; i < trainRows; i++) {
+                prototypes.histogram(i * prototypes.rows() / trainRows, row);
+                training.append(row, 0);
+            }
+            centroids_ = chiKMeans(training, listCount, config_.iterations, assignment);
+        } else {
+            centroids_ = chiKMeans(prototypes, listCount, config_.iterations, assignment);
+        }
+
+        // 每个原型放入最近的列表
+        lists_.assign(centroids_.rows(), GalleryMatrix(reducedCols, precision, cellArea_));
+        for (std::size_t r = 0; r < prototypes.rows(); r++) {
+            prototypes.histogram(r, row);
+            lists_[nearestList(row)].append(row, prototypes.label(r));
+        }
+        trainedIdentities_ = identityRows_.size();
+    }
+
+    /**
+     * @brief 增量加入图库中 firstRow 之后新追加的样本
+     */
+    void GalleryIndex::add(const GalleryMatrix& gallery, const LBPParams& params, std::size_t firstRow) {
+        if (!config_.enabled || firstRow >= gallery.rows()) return;
+
+        std::map<int, std::vector<std::size_t>> groups;
+        for (std::size_t r = firstRow; r < gallery.rows(); r++) {
+            groups[gallery.label(r)].push_back(r);
+        }
+        std::size_t identities = identityRows_.size();
+        for (const auto& group : groups) {
+            if (!identityRows_.count(group.first)) identities++;
+        }
+
+        // 尚未构建、参数变化或身份数翻倍（列表数已偏离 sqrt(身份数)）时整体重建
+        if (lists_.empty() || gallery.cols() != cells_ * bins_ || bins_ != (1 << params.neighbors)
+            || identities >= 2 * trainedIdentities_) {
+            build(gallery, params);
+            return;
+        }
+
+        GalleryMatrix prototypes(cells_ * reducedBins_, GalleryMatrix::precisionFor(cellArea_), cellArea_);
+        for (const auto& [label, rows] : groups) {
+            addPrototypes(gallery, rows, label, prototypes);
+            std::vector<std::size_t>& existing = identityRows_[label];
+            existing.insert(existing.end(), rows.begin(), rows.end());
+        }
+        cv::Mat row;
+        for (std::size_t r = 0; r < prototypes.rows(); r++) {
+            prototypes.histogram(r, row);
+            lists_[nearestList(row)].append(row, prototypes.label(r));
+        }
+    }
+
+    /**
+     * @brief 检索查询直方图
+     * @param gallery 构建索引时使用的样本图库
+     * @param query 1 x cols 的 CV_32F 查询直方图
+     * @param k 返回的标签数
+     * @param threshold 距离阈值（不小于该值的样本被忽略）
+     * @return 按距离升序排列的前 k 个标签（距离为精确卡方距离）
+     */
+    std::vector<GalleryMatch> GalleryIndex::search(const GalleryMatrix& gallery, const cv::Mat& query, int k, double threshold) const {
+        SearchBuffer buffer;
+        std::vector<GalleryMatch> matches;
+        search(gallery, query, k, threshold, buffer, matches);
+        return matches;
+    }
+
+    /**
+     * @brief 检索查询直方图（使用调用方的缓冲区，不为每次查询分配内存）
+     * @param buffer 中间缓冲区
+     * @param matches 输出按距离升序排列的前 k 个标签（复用已有容量）
+     */
+    void GalleryIndex::search(const GalleryMatrix& gallery, const cv::Mat& query, int k, double threshold,
+                              SearchBuffer& buffer, std::vector<GalleryMatch>& matches) const {
+        matches.clear();
+        if (lists_.empty() || k <= 0 || query.type() != CV_32FC1 || (int)query.total() != gallery.cols()) return;
+
+        const cv::Mat& reduced = buffer.reduced;
+        reduce(query, buffer.reduced);
+        std::vector<double>& distances = buffer.distances;
+
+        // 1. 最近的 probes 个倒排列表
+        centroids_.distances(reduced, distances);
+        std::vector<std::size_t>& order = buffer.order;
+        order.resize(distances.size());
+        std::iota(order.begin(), order.end(), 0);
+        const std::size_t probes = std::min<std::size_t>((std::size_t)std::max(config_.probes, 1), order.size());
+        std::partial_sort(order.begin(), order.begin() + probes, order.end(),
+            [&distances](std::size_t a, std::size_t b) { return distances[a] < distances[b]; });
+
+        // 2. 探测列表内每个身份的最近原型（按身份排序后每个身份只保留距离最小的一项）
+        std::vector<std::pair<double, int>>& ranked = buffer.ranked;
+        ranked.clear();
+        for (std::size_t p = 0; p < probes; p++) {
+            const GalleryMatrix& list = lists_[order[p]];
+            list.distances(reduced, distances);
+            for (std::size_t r = 0; r < list.rows(); r++) {
+                ranked.emplace_back(distances[r], list.label(r));
+            }
+        }
+        std::sort(ranked.begin(), ranked.end(), [](const std::pair<double, int>& a, const std::pair<double, int>& b) {
+            return a.second < b.second || (a.second == b.second && a.first < b.first);
+        });
+        ranked.erase(std::unique(ranked.begin(), ranked.end(),
+            [](const std::pair<double, int>& a, const std::pair<double, int>& b) { return a.second == b.second; }), ranked.end());
+
+        // 3. 原型距离最近的 candidates 个身份
+        const std::size_t candidates = std::min<std::size_t>((std::size_t)std::max(config_.candidates, k), ranked.size());
+        std::partial_sort(ranked.begin(), ranked.begin() + candidates, ranked.end());
+
+        // 4. 候选身份的全部样本精确计算卡方距离
+        std::vector<std::size_t>& rows = buffer.rows;
+        rows.clear();
+        for (std::size_t c = 0; c < candidates; c++) {
+            const std::vector<std::size_t>& identity = identityRows_.at(ranked[c].second);
+            rows.insert(rows.end(), identity.begin(), identity.end());
+        }
+        gallery.distances(query, rows, distances);
+
+        // 每个身份取其最近的一行（距离相同时取行号较小者）
+        for (std::size_t i = 0; i < rows.size(); i++) {
+            if (distances[i] < threshold) matches.push_back({gallery.label(rows[i]), distances[i], rows[i]});
+        }
+        auto closer = [](const GalleryMatch& a, const GalleryMatch& b) {
+            return a.distance < b.distance || (a.distance == b.distance && a.row < b.row);
+        };
+        std::sort(matches.begin(), matches.end(), [&closer](const GalleryMatch& a, const GalleryMatch& b) {
+            return a.label < b.label || (a.label == b.label && closer(a, b));
+        });
+        matches.erase(std::unique(matches.begin(), matches.end(),
+            [](const GalleryMatch& a, const GalleryMatch& b) { return a.label == b.label; }), matches.end());
+        const std::size_t count = std::min<std::size_t>((std::size_t)k, matches.size());
+        std::partial_sort(matches.begin(), matches.begin() + count, matches.end(), closer);
+        matches.resize(count);
+    }
+
+    /**
+     * @brief 调整检索召回参数（无需重建）
+     */
+    void GalleryIndex::setSearchParams(int probes, int candidates) {
+        config_.probes = probes;
+        config_.candidates = candidates;
+    }
+
+    /**
+     * @brief 索引已启用且身份数达到 minIdentities
+     */
+    bool GalleryIndex::ready() const {
+        return config_.enabled && !lists_.empty() && identityRows_.size() >= (std::size_t)std::max(config_.minIdentities, 1);
+    }
+
+    /**
+     * @brief 清空索引
+     */
+    void GalleryIndex::clear() {
+        centroids_ = GalleryMatrix();
+        lists_.clear();
+        identityRows_.clear();
+        trainedIdentities_ = 0;
+    }
+
+    const GalleryIndexConfig& GalleryIndex::config() const {
+        return config_;
+    }
+
+    std::size_t GalleryIndex::identities() const {
+        return identityRows_.size();
+    }
+
+    std::size_t GalleryIndex::prototypes() const {
+        std::size_t count = 0;
+        for (const auto& list : lists_) count += list.rows();
+        return count;
+    }
+
+    std::size_t GalleryIndex::lists() const {
+        return lists_.size();
+    }
+
+    /**
+     * @brief 原型与列表中心占用的字节数
+     */
+    std::size_t GalleryIndex::bytes() const {
+        std::size_t total = centroids_.bytes();
+        for (const auto& list : lists_) total += list.bytes();
+        return total;
+    }
+
+    /**
+     * @brief 按邻域点数建立均匀模式映射（均匀模式各占一维，其余编码合并为一维）
+     */
+    void GalleryIndex::setupReduction(const LBPParams& params, int cols, int cellArea) {
+        bins_ = 1 << params.neighbors;
+        binMap_.assign(bins_, 0);
+        int uniform = 0;
+        for (int code = 0; code < bins_; code++) {
+            if (isUniform(code, params.neighbors)) binMap_[code] = uniform++;
+        }
+        for (int code = 0; code < bins_; code++) {
+            if (!isUniform(code, params.neighbors)) binMap_[code] = uniform;
+        }
+        reducedBins_ = uniform + 1;
+        cells_ = cols / bins_;
+        cellArea_ = cellArea;
+    }
+
+    /**
+     * @brief 将完整直方图降维为均匀模式直方图
+     */
+    void GalleryIndex::reduce(const cv::Mat& histogram, cv::Mat& out) const {
+        out.create(1, cells_ * reducedBins_, CV_32FC1); // 尺寸不变时复用已有缓冲区
+        out.setTo(0);
+        const float* src = histogram.ptr<float>(0);
+        float* dst = out.ptr<float>(0);
+        for (int c = 0; c < cells_; c++) {
+            for (int b = 0; b < bins_; b++) {
+                dst[c * reducedBins_ + binMap_[b]] += src[c * bins_ + b];
+            }
+        }
+    }
+
+    /**
+     * @brief 将某个身份的若干样本压缩为原型并追加到 out
+     */
+    void GalleryIndex::addPrototypes(const GalleryMatrix& gallery, const std::vector<std::size_t>& rows, int label, GalleryMatrix& out) const {
+        GalleryMatrix points(cells_ * reducedBins_, GalleryMatrix::precisionFor(cellArea_), cellArea_);
+        points.reserve(rows.size());
+        cv::Mat histogram, reduced;
+        for (std::size_t r : rows) {
+            gallery.histogram(r, histogram);
+            reduce(histogram, reduced);
+            points.append(reduced, label);
+        }
+
+        const int count = (int)std::min<std::size_t>((std::size_t)std::max(config_.prototypes, 1),
+                                                     std::max<std::size_t>(rows.size() / MIN_PROTOTYPE_SAMPLES, 1));
+        std::vector<int> assignment;
+        GalleryMatrix centers = chiKMeans(points, count, config_.iterations, assignment);
+        for (std::size_t c = 0; c < centers.rows(); c++) {
+            centers.histogram(c, histogram);
+            out.append(histogram, label);
+        }
+    }
+
+    /**
+     * @brief 距原型最近的倒排列表
+     */
+    int GalleryIndex::nearestList(const cv::Mat& prototype) const {
+        std::vector<double> distances;
+        centroids_.distances(prototype, distances);
+        return (int)(std::min_element(distances.begin(), distances.end()) - distances.begin());
+    }
+}
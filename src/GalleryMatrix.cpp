@@ -0,0 +1,483 @@
+#include "GalleryMatrix.h"
+#include "simd/ChiSquareKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace DriveGuard {
+    namespace {
+        // 行跨度与缓冲区对齐字节数（缓存行）
+        const std::size_t ALIGNMENT = 64;
+
+        std::size_t alignUp(std::size_t bytes) {
+            return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        }
+
+        int maxCount(GalleryPrecision precision) {
+            switch (precision) {
+                case GalleryPrecision::UINT8: return 255;
+                case GalleryPrecision::UINT16: return 65535;
+                default: return 0;
+            }
+        }
+
+        /**
+         * @brief 当前线程的量化查询缓冲区（容量只增不减）
+         */
+        unsigned char* quantizedBuffer(std::size_t bytes) {
+            thread_local std::vector<unsigned char> buffer;
+            if (buffer.size() < bytes) buffer.resize(bytes);
+            return buffer.data();
+        }
+
+        std::size_t elementSize(GalleryPrecision precision) {
+            switch (precision) {
+                case GalleryPrecision::UINT8: return sizeof(uint8_t);
+                case GalleryPrecision::UINT16: return sizeof(uint16_t);
+                default: return sizeof(float);
+            }
+        }
+
+        // 计数域距离：分派到对应精度与指令集的内核
+        template <typename T>
+        void dispatchDistances(SimdLevel kernel, const T* query, const T* rows, std::size_t stride,
+                            std::size_t rowCount, int cols, double* out) {
+            switch (kernel) {
+#if defined(DRIVEGUARD_SIMD_X86)
+                case SimdLevel::AVX2:
+                    chi::distancesAVX2(query, rows, stride, rowCount, cols, out);
+                    return;
+                case SimdLevel::SSE41:
+                    chi::distancesSSE41(query, rows, stride, rowCount, cols, out);
+                    return;
+#endif
+#if defined(DRIVEGUARD_SIMD_NEON)
+                case SimdLevel::NEON:
+                    chi::distancesNEON(query, rows, stride, rowCount, cols, out);
+                    return;
+#endif
+                default:
+                    chi::distancesScalar(query, rows, stride, rowCount, cols, out);
+                    return;
+            }
+        }
+    }
+
+    /**
+     * @brief 构造函数
+     * @param cols 直方图维度
+     * @param precision 存储精度
+     * @param cellArea 网格像素数（量化步长的倒数）
+     * @param kernel 距离计算内核
+     */
+    GalleryMatrix::GalleryMatrix(int cols, GalleryPrecision precision, int cellArea, SimdLevel kernel)
+        : cols_(cols), precision_(precision), cellArea_(std::max(cellArea, 1)),
+          step_(static_cast<float>(1.0 / std::max(cellArea, 1))), kernel_(resolveSimdLevel(kernel)),
+          stride_(strideFor(cols, precision)), rows_(0), capacity_(0), data_(nullptr), mapped_(nullptr), mappedRows_(0) {
+    }
+
+    GalleryMatrix::GalleryMatrix(const GalleryMatrix& other)
+        : cols_(other.cols_), precision_(other.precision_), cellArea_(other.cellArea_), step_(other.step_),
+          kernel_(other.kernel_), stride_(other.stride_), rows_(other.mappedRows_), capacity_(0), data_(nullptr),
+          mapping_(other.mapping_), mapped_(other.mapped_), mappedRows_(other.mappedRows_), labels_(other.labels_) {
+        // 映射段只读，副本共享；自有段深拷贝
+        const std::size_t owned = other.rows_ - other.mappedRows_;
+        grow(owned);
+        if (owned > 0) std::memcpy(data_, other.data_, owned * stride_);
+        rows_ = other.rows_;
+    }
+
+    GalleryMatrix& GalleryMatrix::operator=(const GalleryMatrix& other) {
+        if (this != &other) {
+            GalleryMatrix copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    GalleryMatrix::GalleryMatrix(GalleryMatrix&& other) noexcept
+        : cols_(other.cols_), precision_(other.precision_), cellArea_(other.cellArea_), step_(other.step_),
+          kernel_(other.kernel_), stride_(other.stride_), rows_(other.rows_), capacity_(other.capacity_),
+          data_(other.data_), mapping_(std::move(other.mapping_)), mapped_(other.mapped_), mappedRows_(other.mappedRows_),
+          labels_(std::move(other.labels_)) {
+        other.rows_ = 0;
+        other.capacity_ = 0;
+        other.data_ = nullptr;
+        other.mapped_ = nullptr;
+        other.mappedRows_ = 0;
+    }
+
+    GalleryMatrix& GalleryMatrix::operator=(GalleryMatrix&& other) noexcept {
+        if (this != &other) {
+            if (data_) cv::fastFree(data_);
+            cols_ = other.cols_;
+            precision_ = other.precision_;
+            cellArea_ = other.cellArea_;
+            step_ = other.step_;
+            kernel_ = other.kernel_;
+            stride_ = other.stride_;
+            rows_ = other.rows_;
+            capacity_ = other.capacity_;
+            data_ = other.data_;
+            mapping_ = std::move(other.mapping_);
+            mapped_ = other.mapped_;
+            mappedRows_ = other.mappedRows_;
+            labels_ = std::move(other.labels_);
+            other.rows_ = 0;
+            other.capacity_ = 0;
+            other.data_ = nullptr;
+            other.mapped_ = nullptr;
+            other.mappedRows_ = 0;
+        }
+        return *this;
+    }
+
+    GalleryMatrix::~GalleryMatrix() {
+        if (data_) cv::fastFree(data_);
+    }
+
+    /**
+     * @brief 以只读映射的内存作为图库的前 rows 行（不拷贝）
+     */
+    GalleryMatrix GalleryMatrix::mapped(std::shared_ptr<const void> owner, const unsigned char* data, std::size_t rows,
+                                        std::vector<int> labels, int cols, GalleryPrecision precision, int cellArea,
+                                        SimdLevel kernel) {
+        GalleryMatrix gallery(cols, precision, cellArea, kernel);
+        gallery.mapping_ = std::move(owner);
+        gallery.mapped_ = data;
+        gallery.mappedRows_ = rows;
+        gallery.rows_ = rows;
+        gallery.labels_ = std::move(labels);
+        gallery.labels_.resize(rows);
+        return gallery;
+    }
+
+    /**
+     * @brief 指定维度与精度下的行跨度（字节，64 字节对齐）
+     */
+    std::size_t GalleryMatrix::strideFor(int cols, GalleryPrecision precision) {
+        return alignUp((std::size_t)std::max(cols, 0) * elementSize(precision));
+    }
+
+    /**
+     * @brief 根据网格像素数选择能无损存储的最小精度
+     */
+    GalleryPrecision GalleryMatrix::precisionFor(int cellArea) {
+        if (cellArea >= 1 && cellArea <= 255) return GalleryPrecision::UINT8;
+        if (cellArea >= 1 && cellArea <= 65535) return GalleryPrecision::UINT16;
+        return GalleryPrecision::FLOAT32;
+    }
+
+    /**
+     * @brief 直方图能否以指定精度无损存储
+     */
+    bool GalleryMatrix::isLossless(const cv::Mat& histogram, GalleryPrecision precision, int cellArea) {
+        if (precision == GalleryPrecision::FLOAT32) return true;
+        if (histogram.type() != CV_32FC1 || !histogram.isContinuous() || cellArea < 1) return false;
+
+        const float step = static_cast<float>(1.0 / cellArea);
+        const int limit = maxCount(precision);
+        const float* values = histogram.ptr<float>(0);
+        for (std::size_t j = 0; j < histogram.total(); j++) {
+            long count = std::lround(values[j] * cellArea);
+            if (count < 0 || count > limit || static_cast<float>(count) * step != values[j]) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 追加一行
+     * @param histogram 1 x cols 的 CV_32F 直方图
+     * @param label 标签
+     * @return 维度不匹配返回 false
+     */
+    bool GalleryMatrix::append(const cv::Mat& histogram, int label) {
+        if (histogram.type() != CV_32FC1 || (int)histogram.total() != cols_ || !histogram.isContinuous()) {
+            return false;
+        }
+
+        if (rows_ - mappedRows_ == capacity_) grow(std::max<std::size_t>(16, capacity_ * 2));
+        unsigned char* dst = data_ + (rows_ - mappedRows_) * stride_;
+        if (precision_ == GalleryPrecision::FLOAT32) {
+            std::memcpy(dst, histogram.ptr<float>(0), (std::size_t)cols_ * sizeof(float));
+        } else {
+            quantize(histogram, dst);
+        }
+        rows_++;
+        labels_.push_back(label);
+        return true;
+    }
+
+    /**
+     * @brief 追加一行原始存储（与 row() 的格式相同，stride() 字节）
+     */
+    void GalleryMatrix::appendRaw(const unsigned char* data, int label) {
+        if (rows_ - mappedRows_ == capacity_) grow(std::max<std::size_t>(16, capacity_ * 2));
+        std::memcpy(data_ + (rows_ - mappedRows_) * stride_, data, stride_);
+        rows_++;
+        labels_.push_back(label);
+    }
+
+    /**
+     * @brief 预留行数
+     */
+    void GalleryMatrix::reserve(std::size_t rows) {
+        if (rows > mappedRows_ + capacity_) grow(rows - mappedRows_);
+        labels_.reserve(rows);
+    }
+
+    /**
+     * @brief 清空所有行（保留维度与精度）
+     */
+    void GalleryMatrix::clear() {
+        rows_ = 0;
+        mapping_.reset();
+        mapped_ = nullptr;
+        mappedRows_ = 0;
+        labels_.clear();
+    }
+
+    /**
+     * @brief 以新的精度重建图库
+     */
+    void GalleryMatrix::convert(GalleryPrecision precision) {
+        if (precision == precision_) return;
+
+        GalleryMatrix converted(cols_, precision, cellArea_, kernel_);
+        converted.reserve(rows_);
+        cv::Mat row;
+        for (std::size_t r = 0; r < rows_; r++) {
+            histogram(r, row);
+            converted.append(row, labels_[r]);
+        }
+        *this = std::move(converted);
+    }
+
+    /**
+     * @brief 取回某一行的 float 直方图（量化存储时反量化，与原直方图逐位一致）
+     */
+    void GalleryMatrix::histogram(std::size_t row, cv::Mat& out) const {
+        out.create(1, cols_, CV_32FC1);
+        float* dst = out.ptr<float>(0);
+        const unsigned char* src = this->row(row);
+        switch (precision_) {
+            case GalleryPrecision::UINT8:
+                for (int j = 0; j < cols_; j++) dst[j] = static_cast<float>(src[j]) * step_;
+                break;
+            case GalleryPrecision::UINT16: {
+                const uint16_t* counts = reinterpret_cast<const uint16_t*>(src);
+                for (int j = 0; j < cols_; j++) dst[j] = static_cast<float>(counts[j]) * step_;
+                break;
+            }
+            default:
+                std::memcpy(dst, src, (std::size_t)cols_ * sizeof(float));
+                break;
+        }
+    }
+
+    /**
+     * @brief 对所有行计算卡方距离
+     * @param query 1 x cols 的 CV_32F 查询直方图
+     * @param out 输出每行的距离
+     */
+    void GalleryMatrix::distances(const cv::Mat& query, std::vector<double>& out) const {
+        out.resize(rows_);
+        if (rows_ == 0) return;
+
+        if (precision_ == GalleryPrecision::FLOAT32) {
+            // 未量化时与 OpenCV LBPH 完全相同的距离计算
+            for (std::size_t r = 0; r < rows_; r++) {
+                cv::Mat values(1, cols_, CV_32FC1, const_cast<unsigned char*>(row(r)));
+                out[r] = cv::compareHist(values, query, cv::HISTCMP_CHISQR_ALT);
+            }
+            return;
+        }
+
+        // 查询同样量化为计数，计数域距离乘以 2 * 量化步长即为 HISTCMP_CHISQR_ALT 距离
+        unsigned char* quantized = quantizedBuffer(stride_);
+        quantize(query, quantized);
+        if (mappedRows_ > 0) countDistances(quantized, mapped_, mappedRows_, out.data());
+        if (rows_ > mappedRows_) countDistances(quantized, data_, rows_ - mappedRows_, out.data() + mappedRows_);
+        const double scale = 2.0 * step_;
+        for (auto& distance : out) distance *= scale;
+    }
+
+    /**
+     * @brief 对指定行计算卡方距离
+     * @param query 1 x cols 的 CV_32F 查询直方图
+     * @param rows 行号列表
+     * @param out 输出与 rows 一一对应的距离
+     */
+    void GalleryMatrix::distances(const cv::Mat& query, const std::vector<std::size_t>& rows, std::vector<double>& out) const {
+        out.resize(rows.size());
+        if (rows.empty()) return;
+
+        if (precision_ == GalleryPrecision::FLOAT32) {
+            for (std::size_t i = 0; i < rows.size(); i++) {
+                cv::Mat values(1, cols_, CV_32FC1, const_cast<unsigned char*>(row(rows[i])));
+                out[i] = cv::compareHist(values, query, cv::HISTCMP_CHISQR_ALT);
+            }
+            return;
+        }
+
+        unsigned char* quantized = quantizedBuffer(stride_);
+        quantize(query, quantized);
+        for (std::size_t i = 0; i < rows.size(); i++) {
+            countDistances(quantized, row(rows[i]), 1, &out[i]);
+        }
+        const double scale = 2.0 * step_;
+        for (auto& distance : out) distance *= scale;
+    }
+
+    /**
+     * @brief 匹配查询直方图
+     * @param query 1 x cols 的 CV_32F 查询直方图
+     * @param k 返回的标签数（每个标签取其最近的一行）
+     * @param threshold 距离阈值（不小于该值的行被忽略）
+     * @return 按距离升序排列的前 k 个标签
+     */
+    std::vector<GalleryMatch> GalleryMatrix::match(const cv::Mat& query, int k, double threshold) const {
+        std::vector<double> distances;
+        std::vector<GalleryMatch> matches;
+        match(query, k, threshold, distances, matches);
+        return matches;
+    }
+
+    /**
+     * @brief 匹配查询直方图（使用调用方的缓冲区，不为每次查询分配内存）
+     * @param distances 距离缓冲区（复用容量）
+     * @param matches 输出按距离升序排列的前 k 个标签（复用已有容量）
+     */
+    void GalleryMatrix::match(const cv::Mat& query, int k, double threshold, std::vector<double>& distances,
+                              std::vector<GalleryMatch>& matches) const {
+        matches.clear();
+        if (rows_ == 0 || k <= 0 || query.type() != CV_32FC1 || (int)query.total() != cols_) return;
+        this->distances(query, distances);
+
+        // 每个标签保留最近的一行（按标签排序后去重；距离相同时取靠前的行，与 LBPH 一致）
+        for (std::size_t r = 0; r < rows_; r++) {
+            if (distances[r] < threshold) matches.push_back({labels_[r], distances[r], r});
+        }
+        auto closer = [](const GalleryMatch& a, const GalleryMatch& b) {
+            return a.distance < b.distance || (a.distance == b.distance && a.row < b.row);
+        };
+        std::sort(matches.begin(), matches.end(), [&closer](const GalleryMatch& a, const GalleryMatch& b) {
+            return a.label < b.label || (a.label == b.label && closer(a, b));
+        });
+        matches.erase(std::unique(matches.begin(), matches.end(),
+            [](const GalleryMatch& a, const GalleryMatch& b) { return a.label == b.label; }), matches.end());
+        const std::size_t count = std::min<std::size_t>((std::size_t)k, matches.size());
+        std::partial_sort(matches.begin(), matches.begin() + count, matches.end(), closer);
+        matches.resize(count);
+    }
+
+    /**
+     * @brief 最近的一行（结果与 k = 1 的 match 相同，距离写入调用方的缓冲区，不分配内存）
+     * @param query 1 x cols 的 CV_32F 查询直方图
+     * @param threshold 距离阈值（不小于该值的行被忽略）
+     * @param distances 距离缓冲区（复用容量）
+     * @param match 输出最近的一行
+     * @return 存在小于阈值的行时返回 true
+     */
+    bool GalleryMatrix::nearest(const cv::Mat& query, double threshold, std::vector<double>& distances,
+                                GalleryMatch& match) const {
+        if (rows_ == 0 || query.type() != CV_32FC1 || (int)query.total() != cols_) return false;
+        this->distances(query, distances);
+
+        // 距离相同时取靠前的行（与 match 的排序规则一致）
+        std::size_t best = rows_;
+        for (std::size_t r = 0; r < rows_; r++) {
+            if (!(distances[r] < threshold)) continue;
+            if (best == rows_ || distances[r] < distances[best]) best = r;
+        }
+        if (best == rows_) return false;
+        match = {labels_[best], distances[best], best};
+        return true;
+    }
+
+    std::size_t GalleryMatrix::rows() const {
+        return rows_;
+    }
+
+    int GalleryMatrix::cols() const {
+        return cols_;
+    }
+
+    GalleryPrecision GalleryMatrix::precision() const {
+        return precision_;
+    }
+
+    int GalleryMatrix::cellArea() const {
+        return cellArea_;
+    }
+
+    int GalleryMatrix::label(std::size_t row) const {
+        return labels_[row];
+    }
+
+    const std::vector<int>& GalleryMatrix::labels() const {
+        return labels_;
+    }
+
+    /**
+     * @brief 某一行的原始存储（stride() 字节，按存储精度解释）
+     */
+    const unsigned char* GalleryMatrix::row(std::size_t row) const {
+        return row < mappedRows_ ? mapped_ + row * stride_ : data_ + (row - mappedRows_) * stride_;
+    }
+
+    std::size_t GalleryMatrix::stride() const {
+        return stride_;
+    }
+
+    /**
+     * @brief 图库数据占用的字节数
+     */
+    std::size_t GalleryMatrix::bytes() const {
+        return rows_ * stride_;
+    }
+
+    /**
+     * @brief 将 float 直方图量化为计数（四舍五入并截断到存储精度范围）
+     */
+    void GalleryMatrix::quantize(const cv::Mat& histogram, unsigned char* dst) const {
+        const float* values = histogram.ptr<float>(0);
+        const long limit = maxCount(precision_);
+        if (precision_ == GalleryPrecision::UINT8) {
+            for (int j = 0; j < cols_; j++) {
+                dst[j] = (unsigned char)std::min(std::max(std::lround(values[j] * cellArea_), 0L), limit);
+            }
+        } else {
+            uint16_t* counts = reinterpret_cast<uint16_t*>(dst);
+            for (int j = 0; j < cols_; j++) {
+                counts[j] = (uint16_t)std::min(std::max(std::lround(values[j] * cellArea_), 0L), limit);
+            }
+        }
+    }
+
+    /**
+     * @brief 对连续的 count 行计算计数域距离（查询已量化）
+     */
+    void GalleryMatrix::countDistances(const unsigned char* query, const unsigned char* rows, std::size_t count, double* out) const {
+        if (precision_ == GalleryPrecision::UINT8) {
+            dispatchDistances(kernel_, query, rows, stride_, count, cols_, out);
+        } else {
+            dispatchDistances(kernel_, reinterpret_cast<const uint16_t*>(query), reinterpret_cast<const uint16_t*>(rows),
+                              stride_ / sizeof(uint16_t), count, cols_, out);
+        }
+    }
+
+    /**
+     * @brief 扩容（cv::fastMalloc 按 64 字节对齐分配）
+     */
+    void GalleryMatrix::grow(std::size_t capacity) {
+        if (capacity <= capacity_) return;
+        unsigned char* data = static_cast<unsigned char*>(cv::fastMalloc(std::max<std::size_t>(capacity * stride_, ALIGNMENT)));
+        if (data_) {
+            std::memcpy(data, data_, (rows_ - mappedRows_) * stride_);
+            cv::fastFree(data_);
+        }
+        data_ = data;
+        capacity_ = capacity;
+    }
+}
@@ -0,0 +1,411 @@
+#include "GalleryStore.h"
+#include "FileLock.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DriveGuard {
+    namespace {
+        const char BASE_MAGIC[8] = {'D', 'G', 'G', 'A', 'L', 'L', 'R', 'Y'};
+        const char JOURNAL_MAGIC[8] = {'D', 'G', 'J', 'O', 'U', 'R', 'N', 'L'};
+        const uint32_t FORMAT_VERSION = 1;
+        const std::size_t DATA_ALIGNMENT = 64;   // 直方图行的起始偏移对齐（与 GalleryMatrix 行跨度一致）
+        const std::size_t COMPACT_MIN_ROWS = 256; // 日志少于该行数时不压缩
+
+        /**
+         * @brief 基础段文件头
+         */
+        struct BaseHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t headerSize;
+            uint64_t generation;
+            int32_t radius;
+            int32_t neighbors;
+            int32_t gridX;
+            int32_t gridY;
+            int32_t cols;
+            int32_t precision;      // GalleryPrecision
+            int32_t cellArea;
+            int32_t reserved;
+            uint64_t rows;
+            uint64_t stride;        // 行跨度（字节）
+            uint64_t labelsOffset;  // int32 标签数组的偏移
+            uint64_t dataOffset;    // 第一行的偏移（64 字节对齐）
+            double threshold;
+        };
+
+        /**
+         * @brief 日志段文件头（代号、维度与精度须与基础段一致）
+         */
+        struct JournalHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t headerSize;
+            uint64_t generation;
+            int32_t cols;
+            int32_t precision;
+            uint64_t stride;
+        };
+
+        /**
+         * @brief 日志记录头，其后紧跟 stride 字节的行数据
+         */
+        struct RecordHeader {
+            int32_t label;
+            uint32_t crc;           // 标签与行数据的 CRC32
+        };
+
+        std::mutex& storeMutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        uint32_t crc32(const unsigned char* data, std::size_t size, uint32_t crc) {
+            static const std::array<uint32_t, 256> table = [] {
+                std::array<uint32_t, 256> t{};
+                for (uint32_t i = 0; i < 256; i++) {
+                    uint32_t c = i;
+                    for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    t[i] = c;
+                }
+                return t;
+            }();
+            crc = ~crc;
+            for (std::size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            return ~crc;
+        }
+
+        uint32_t recordCrc(int32_t label, const unsigned char* row, std::size_t stride) {
+            uint32_t crc = crc32(reinterpret_cast<const unsigned char*>(&label), sizeof(label), 0);
+            return crc32(row, stride, crc);
+        }
+
+        std::size_t alignUp(std::size_t bytes) {
+            return (bytes + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+        }
+
+        bool isPrecision(int32_t value) {
+            return value == (int32_t)GalleryPrecision::FLOAT32 || value == (int32_t)GalleryPrecision::UINT16
+                || value == (int32_t)GalleryPrecision::UINT8;
+        }
+
+        bool validHeader(const BaseHeader& header) {
+            return std::memcmp(header.magic, BASE_MAGIC, sizeof(BASE_MAGIC)) == 0 && header.version == FORMAT_VERSION
+                && header.headerSize == sizeof(BaseHeader) && header.cols > 0 && isPrecision(header.precision)
+                && header.stride == GalleryMatrix::strideFor(header.cols, (GalleryPrecision)header.precision);
+        }
+
+        bool matches(const JournalHeader& journal, const BaseHeader& base) {
+            return std::memcmp(journal.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) == 0 && journal.version == FORMAT_VERSION
+                && journal.headerSize == sizeof(JournalHeader) && journal.generation == base.generation
+                && journal.cols == base.cols && journal.precision == base.precision && journal.stride == base.stride;
+        }
+
+        bool readHeader(const std::string& path, BaseHeader& header) {
+            std::FILE* file = std::fopen(path.c_str(), "rb");
+            if (!file) return false;
+            bool ok = std::fread(&header, sizeof(header), 1, file) == 1 && validHeader(header);
+            std::fclose(file);
+            return ok;
+        }
+
+        /**
+         * @brief 刷新用户态缓冲并落盘
+         */
+        bool syncFile(std::FILE* file) {
+            if (std::fflush(file) != 0) return false;
+#ifndef _WIN32
+            if (fsync(fileno(file)) != 0) return false;
+#endif
+            return true;
+        }
+
+        /**
+         * @brief 只读映射整个文件（无 mmap 的平台一次性读入对齐内存，同样无需解析）
+         */
+        std::shared_ptr<const void> mapFile(const std::string& path, std::size_t& size) {
+#ifndef _WIN32
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) return nullptr;
+            struct stat st;
+            if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+                close(fd);
+                return nullptr;
+            }
+            size = (std::size_t)st.st_size;
+            void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (data == MAP_FAILED) return nullptr;
+            const std::size_t length = size;
+            return std::shared_ptr<const void>(data, [length](const void* p) { munmap(const_cast<void*>(p), length); });
+#else
+            std::FILE* file = std::fopen(path.c_str(), "rb");
+            if (!file) return nullptr;
+            std::fseek(file, 0, SEEK_END);
+            long length = std::ftell(file);
+            std::fseek(file, 0, SEEK_SET);
+            if (length <= 0) {
+                std::fclose(file);
+                return nullptr;
+            }
+            size = (std::size_t)length;
+            void* data = cv::fastMalloc(size);
+            bool ok = std::fread(data, 1, size, file) == size;
+            std::fclose(file);
+            if (!ok) {
+                cv::fastFree(data);
+                return nullptr;
+            }
+            return std::shared_ptr<const void>(data, [](const void* p) { cv::fastFree(const_cast<void*>(p)); });
+#endif
+        }
+
+        /**
+         * @brief 新建（清空）日志段，仅写文件头
+         */
+        bool resetJournal(const std::string& path, const BaseHeader& base) {
+            std::FILE* file = std::fopen(GalleryStore::journalPath(path).c_str(), "wb");
+            if (!file) return false;
+            JournalHeader header{};
+            std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+            header.version = FORMAT_VERSION;
+            header.headerSize = sizeof(JournalHeader);
+            header.generation = base.generation;
+            header.cols = base.cols;
+            header.precision = base.precision;
+            header.stride = base.stride;
+            bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 && syncFile(file);
+            std::fclose(file);
+            return ok;
+        }
+
+        bool loadLocked(const std::string& path, GalleryModel& model) {
+            std::size_t size = 0;
+            std::shared_ptr<const void> mapping = mapFile(path, size);
+            if (!mapping) return false;
+
+            const unsigned char* base = static_cast<const unsigned char*>(mapping.get());
+            BaseHeader header;
+            if (size < sizeof(header)) {
+                std::cerr << "[ERROR] 模型文件不完整：" << path << std::endl;
+                return false;
+            }
+            std::memcpy(&header, base, sizeof(header));
+            // 先校验偏移再用除法比较行数，损坏的文件头不会因乘法或加法溢出而通过检查
+            if (!validHeader(header) || header.dataOffset % DATA_ALIGNMENT != 0
+                || header.labelsOffset < sizeof(BaseHeader) || header.labelsOffset > size
+                || header.rows > (size - header.labelsOffset) / sizeof(int32_t)
+                || header.dataOffset > size || header.rows > (size - header.dataOffset) / header.stride) {
+                std::cerr << "[ERROR] 模型文件格式错误：" << path << std::endl;
+                return false;
+            }
+
+            std::vector<int> labels(header.rows);
+            if (header.rows > 0) std::memcpy(labels.data(), base + header.labelsOffset, header.rows * sizeof(int32_t));
+            const GalleryPrecision precision = (GalleryPrecision)header.precision;
+            model.params.radius = header.radius;
+            model.params.neighbors = header.neighbors;
+            model.params.gridX = header.gridX;
+            model.params.gridY = header.gridY;
+            model.threshold = header.threshold;
+            model.generation = header.generation;
+            model.journalRows = 0;
+            model.gallery = GalleryMatrix::mapped(mapping, base + header.dataOffset, header.rows, std::move(labels),
+                                                  header.cols, precision, header.cellArea);
+
+            // 回放日志段（遇到不完整或校验失败的记录即停止）
+            std::FILE* file = std::fopen(GalleryStore::journalPath(path).c_str(), "rb");
+            if (!file) return true;
+            JournalHeader journal;
+            if (std::fread(&journal, sizeof(journal), 1, file) == 1 && matches(journal, header)) {
+                std::vector<unsigned char> row(header.stride);
+                RecordHeader record;
+                while (std::fread(&record, sizeof(record), 1, file) == 1) {
+                    if (std::fread(row.data(), 1, row.size(), file) != row.size()
+                        || recordCrc(record.label, row.data(), row.size()) != record.crc) {
+                        std::cerr << "[WARN] 模型日志末尾记录损坏，已忽略：" << GalleryStore::journalPath(path) << std::endl;
+                        break;
+                    }
+                    model.gallery.appendRaw(row.data(), record.label);
+                    model.journalRows++;
+                }
+            }
+            std::fclose(file);
+            return true;
+        }
+
+        bool saveLocked(const std::string& path, const GalleryMatrix& gallery, const LBPParams& params, double threshold) {
+            BaseHeader previous;
+            BaseHeader header{};
+            std::memcpy(header.magic, BASE_MAGIC, sizeof(BASE_MAGIC));
+            header.version = FORMAT_VERSION;
+            header.headerSize = sizeof(BaseHeader);
+            header.generation = readHeader(path, previous) ? previous.generation + 1 : 1;
+            header.radius = params.radius;
+            header.neighbors = params.neighbors;
+            header.gridX = params.gridX;
+            header.gridY = params.gridY;
+            header.cols = gallery.cols();
+            header.precision = (int32_t)gallery.precision();
+            header.cellArea = gallery.cellArea();
+            header.rows = gallery.rows();
+            header.stride = gallery.stride();
+            header.labelsOffset = sizeof(BaseHeader);
+            header.dataOffset = alignUp(header.labelsOffset + header.rows * sizeof(int32_t));
+            header.threshold = threshold;
+
+            // 先写临时文件再重命名：已映射旧文件的进程不受影响，中途失败也不会损坏原模型
+            const std::string tmpPath = path + ".tmp";
+            std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+            if (!file) return false;
+
+            std::vector<int32_t> labels(gallery.labels().begin(), gallery.labels().end());
+            std::vector<unsigned char> padding(header.dataOffset - header.labelsOffset - labels.size() * sizeof(int32_t), 0);
+            bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+                && std::fwrite(labels.data(), sizeof(int32_t), labels.size(), file) == labels.size()
+                && std::fwrite(padding.data(), 1, padding.size(), file) == padding.size();
+            for (std::size_t r = 0; ok && r < gallery.rows(); r++) {
+                ok = std::fwrite(gallery.row(r), 1, gallery.stride(), file) == gallery.stride();
+            }
+            ok = ok && syncFile(file);
+            std::fclose(file);
+            if (!ok) {
+                std::remove(tmpPath.c_str());
+                return false;
+            }
+
+#ifdef _WIN32
+            std::remove(path.c_str());
+#endif
+            if (std::rename(tmpPath.c_str(), path.c_str()) != 0) return false;
+
+            // 新基础段已包含全部行，日志段以新代号重建（若此处中断，旧代号的日志在加载时被忽略）
+            return resetJournal(path, header);
+        }
+    }
+
+    /**
+     * @brief 路径是否为二进制模型（扩展名不是 .yml / .yaml / .xml）
+     */
+    bool GalleryStore::isBinaryPath(const std::string& path) {
+        std::string extension = std::filesystem::path(path).extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+        return extension != ".yml" && extension != ".yaml" && extension != ".xml";
+    }
+
+    /**
+     * @brief 日志段路径
+     */
+    std::string GalleryStore::journalPath(const std::string& path) {
+        return path + ".journal";
+    }
+
+    /**
+     * @brief 映射基础段并回放日志段
+     */
+    bool GalleryStore::load(const std::string& path, GalleryModel& model) {
+        std::lock_guard<std::mutex> lock(storeMutex());
+        FileLock fileLock(FileLock::lockPath(path), FileLock::Mode::SHARED);
+        return loadLocked(path, model);
+    }
+
+    /**
+     * @brief 整体写出基础段并清空日志段
+     */
+    bool GalleryStore::save(const std::string& path, const GalleryMatrix& gallery, const LBPParams& params, double threshold) {
+        std::lock_guard<std::mutex> lock(storeMutex());
+        FileLock fileLock(FileLock::lockPath(path));
+        return saveLocked(path, gallery, params, threshold);
+    }
+
+    /**
+     * @brief 将图库中 firstRow 之后的行追加到日志段
+     */
+    bool GalleryStore::append(const std::string& path, const GalleryMatrix& gallery, std::size_t firstRow) {
+        std::lock_guard<std::mutex> lock(storeMutex());
+        FileLock fileLock(FileLock::lockPath(path));
+        BaseHeader header;
+        if (!readHeader(path, header) || header.cols != gallery.cols() || header.precision != (int32_t)gallery.precision()
+            || header.stride != gallery.stride()) {
+            return false;
+        }
+
+        // 日志缺失或代号不符时重建；末尾不完整的记录（上次写入中断）截掉
+        const std::string journal = journalPath(path);
+        const std::size_t recordSize = sizeof(RecordHeader) + header.stride;
+        std::FILE* file = std::fopen(journal.c_str(), "rb");
+        JournalHeader existing;
+        bool valid = file && std::fread(&existing, sizeof(existing), 1, file) == 1 && matches(existing, header);
+        if (file) std::fclose(file);
+        if (!valid) {
+            if (!resetJournal(path, header)) return false;
+        } else {
+            std::error_code error;
+            std::uintmax_t size = std::filesystem::file_size(journal, error);
+            if (error) return false;
+            std::uintmax_t complete = sizeof(JournalHeader) + (size - sizeof(JournalHeader)) / recordSize * recordSize;
+            if (complete != size) std::filesystem::resize_file(journal, complete, error);
+            if (error) return false;
+        }
+
+        file = std::fopen(journal.c_str(), "ab");
+        if (!file) return false;
+        bool ok = true;
+        for (std::size_t r = firstRow; ok && r < gallery.rows(); r++) {
+            RecordHeader record{gallery.label(r), recordCrc(gallery.label(r), gallery.row(r), gallery.stride())};
+            ok = std::fwrite(&record, sizeof(record), 1, file) == 1
+                && std::fwrite(gallery.row(r), 1, gallery.stride(), file) == gallery.stride();
+        }
+        ok = ok && syncFile(file);
+        std::fclose(file);
+        return ok;
+    }
+
+    /**
+     * @brief 日志段行数是否已超过基础段的 1/4（且不少于 256 行），需要压缩
+     */
+    bool GalleryStore::needsCompaction(const std::string& path) {
+        std::lock_guard<std::mutex> lock(storeMutex());
+        FileLock fileLock(FileLock::lockPath(path), FileLock::Mode::SHARED);
+        BaseHeader header;
+        if (!readHeader(path, header)) return false;
+
+        std::error_code error;
+        std::uintmax_t size = std::filesystem::file_size(journalPath(path), error);
+        if (error || size < sizeof(JournalHeader)) return false;
+        std::size_t rows = (std::size_t)((size - sizeof(JournalHeader)) / (sizeof(RecordHeader) + header.stride));
+        return rows >= std::max<std::size_t>(COMPACT_MIN_ROWS, header.rows / 4);
+    }
+
+    /**
+     * @brief 将日志段合并进新的基础段
+     */
+    bool GalleryStore::compact(const std::string& path) {
+        std::lock_guard<std::mutex> lock(storeMutex());
+        FileLock fileLock(FileLock::lockPath(path));
+        GalleryModel model;
+        if (!loadLocked(path, model)) return false;
+        if (model.journalRows == 0) return true;
+
+        if (!saveLocked(path, model.gallery, model.params, model.threshold)) {
+            std::cerr << "[ERROR] 模型日志合并失败：" << path << std::endl;
+            return false;
+        }
+        std::cout << "[INFO] 模型日志已合并：" << model.journalRows << " 行，共 " << model.gallery.rows() << " 行" << std::endl;
+        return true;
+    }
+}
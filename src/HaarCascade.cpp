@@ -0,0 +1,349 @@
+#include "HaarCascade.h"
+#include "ImageOps.h"
+#include "ParallelFor.h"
+#include "simd/HaarKernels.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace DriveGuard {
+    namespace {
+        // 与 detectMultiScale 相同的候选框合并阈值
+        const double GROUP_EPS = 0.2;
+        // 单层扫描的最大并行分段数
+        const int MAX_STRIPES = 32;
+
+        /**
+         * @brief 换算到某一积分图行跨度的特征偏移（每个线程、每个级联一份）
+         */
+        struct ScaledCascade {
+            const HaarCascadeData* data = nullptr;
+            int stride = 0;
+            std::vector<haar::OptFeature> features;
+            haar::Cascade cascade{};
+        };
+
+        /**
+         * @brief 每个线程的检测缓冲区
+         * 积分图缓冲区的行跨度与行数只增不减，人脸与眼睛级联共用同一份，
+         * 因此交替检测时特征偏移不会反复重算，稳定后检测过程不再分配内存。
+         */
+        struct Workspace {
+            std::vector<unsigned char> resized;              // 当前层缩放后的图像
+            std::vector<int> sum;                            // 当前层积分图
+            std::vector<int> sqsum;                          // 当前层平方积分图
+            int stride = 0;                                  // 积分图行跨度（元素）
+            int rows = 0;                                    // 积分图缓冲区行数
+            std::vector<ScaledCascade> cascades;
+            std::vector<std::vector<cv::Point>> stripeHits;  // 各并行分段通过的窗口
+            std::vector<float> allScales;                    // 尺度序列（复用容量）
+            std::vector<float> scales;
+            std::vector<int> parent;                         // 候选框合并：并查集
+            std::vector<int> label;                          // 候选框合并：各根节点的类别号
+            std::vector<int> count;                          // 候选框合并：各类别的候选框数
+            std::vector<cv::Rect> sums;                      // 候选框合并：各类别的坐标和与均值
+        };
+
+        Workspace& workspace() {
+            thread_local Workspace ws;
+            return ws;
+        }
+
+        /**
+         * @brief 确保积分图缓冲区能容纳 size 大小的图像
+         */
+        void reserve(Workspace& ws, const cv::Size& size) {
+            int stride = std::max(ws.stride, (int)cv::alignSize(size.width + 1, 16));
+            int rows = std::max(ws.rows, size.height + 1);
+            if (stride == ws.stride && rows == ws.rows) return;
+            ws.stride = stride;
+            ws.rows = rows;
+            ws.sum.assign((std::size_t)stride * rows, 0);
+            ws.sqsum.assign((std::size_t)stride * rows, 0);
+        }
+
+        /**
+         * @brief 当前行跨度下的级联（行跨度变化时重算特征偏移）
+         */
+        const haar::Cascade& scaledCascade(Workspace& ws, const HaarCascadeData& data) {
+            ScaledCascade* scaled = nullptr;
+            for (auto& entry : ws.cascades) {
+                if (entry.data == &data) scaled = &entry;
+            }
+            if (!scaled) {
+                ws.cascades.emplace_back();
+                scaled = &ws.cascades.back();
+                scaled->data = &data;
+                scaled->features.resize(data.featureCount);
+            }
+            if (scaled->stride == ws.stride) return scaled->cascade;
+
+            scaled->stride = ws.stride;
+            for (int i = 0; i < data.featureCount; i++) {
+                haar::OptFeature& f = scaled->features[i];
+                for (int r = 0; r < 3; r++) {
+                    haar::rectOffsets(data.features[i].rects[r], ws.stride, f.ofs[r]);
+                    f.weight[r] = data.features[i].rects[r].weight;
+                }
+            }
+            HaarRect norm{1, 1, data.windowWidth - 2, data.windowHeight - 2, 0.0f};
+            haar::rectOffsets(norm, ws.stride, scaled->cascade.normOfs);
+            scaled->cascade.normArea = (double)norm.width * norm.height;
+            scaled->cascade.stages = data.stages;
+            scaled->cascade.stageCount = data.stageCount;
+            scaled->cascade.stumps = data.stumps;
+            scaled->cascade.features = scaled->features.data();
+            return scaled->cascade;
+        }
+
+        /**
+         * @brief 计算积分图与平方积分图（平方和按 32 位回绕，与 OpenCV 级联检测相同）
+         */
+        void integral(const cv::Mat& image, int* sum, int* sqsum, int stride) {
+            std::fill(sum, sum + image.cols + 1, 0);
+            std::fill(sqsum, sqsum + image.cols + 1, 0);
+            for (int y = 0; y < image.rows; y++) {
+                const unsigned char* src = image.ptr<unsigned char>(y);
+                const int* prevSum = sum + (std::ptrdiff_t)y * stride;
+                const int* prevSq = sqsum + (std::ptrdiff_t)y * stride;
+                int* rowSum = sum + (std::ptrdiff_t)(y + 1) * stride;
+                int* rowSq = sqsum + (std::ptrdiff_t)(y + 1) * stride;
+                rowSum[0] = 0;
+                rowSq[0] = 0;
+                int s = 0;
+                unsigned q = 0;
+                for (int x = 0; x < image.cols; x++) {
+                    int v = src[x];
+                    s += v;
+                    q += (unsigned)(v * v);
+                    rowSum[x + 1] = prevSum[x + 1] + s;
+                    rowSq[x + 1] = (int)((unsigned)prevSq[x + 1] + q);
+                }
+            }
+        }
+
+        int findRoot(std::vector<int>& parent, int i) {
+            while (parent[i] != i) {
+                parent[i] = parent[parent[i]];
+                i = parent[i];
+            }
+            return i;
+        }
+
+        /**
+         * @brief 两个候选框是否相似（与 cv::SimilarRects 相同）
+         */
+        bool similar(const cv::Rect& a, const cv::Rect& b, double eps) {
+            double delta = eps * (std::min(a.width, b.width) + std::min(a.height, b.height)) * 0.5;
+            return std::abs(a.x - b.x) <= delta && std::abs(a.y - b.y) <= delta &&
+                   std::abs(a.x + a.width - b.x - b.width) <= delta &&
+                   std::abs(a.y + a.height - b.y - b.height) <= delta;
+        }
+
+        /**
+         * @brief 合并候选框（结果与 cv::groupRectangles(rects, threshold, eps) 相同，中间结果使用线程缓冲区）
+         * 相似的候选框归为一类（类别按首次出现的顺序编号），取坐标均值；候选框数不超过 threshold 的类别丢弃，
+         * 落在候选框更多的另一类内部的类别也丢弃
+         */
+        void groupRectangles(Workspace& ws, std::vector<cv::Rect>& rects, int threshold, double eps) {
+            if (threshold <= 0 || rects.empty()) return;
+            const int n = (int)rects.size();
+
+            std::vector<int>& parent = ws.parent;
+            parent.resize(n);
+            for (int i = 0; i < n; i++) parent[i] = i;
+            for (int i = 0; i < n; i++) {
+                for (int j = i + 1; j < n; j++) {
+                    if (!similar(rects[i], rects[j], eps)) continue;
+                    int a = findRoot(parent, i);
+                    int b = findRoot(parent, j);
+                    if (a != b) parent[std::max(a, b)] = std::min(a, b);
+                }
+            }
+
+            std::vector<int>& label = ws.label;
+            std::vector<int>& count = ws.count;
+            std::vector<cv::Rect>& sums = ws.sums;
+            label.assign(n, -1);
+            count.clear();
+            sums.clear();
+            for (int i = 0; i < n; i++) {
+                int root = findRoot(parent, i);
+                if (label[root] < 0) {
+                    label[root] = (int)count.size();
+                    count.push_back(0);
+                    sums.emplace_back(0, 0, 0, 0);
+                }
+                cv::Rect& sum = sums[label[root]];
+                sum.x += rects[i].x;
+                sum.y += rects[i].y;
+                sum.width += rects[i].width;
+                sum.height += rects[i].height;
+                count[label[root]]++;
+            }
+
+            const int classes = (int)count.size();
+            for (int c = 0; c < classes; c++) {
+                float s = 1.f / count[c];
+                cv::Rect& r = sums[c];
+                r = cv::Rect((int)std::nearbyint(r.x * s), (int)std::nearbyint(r.y * s),
+                             (int)std::nearbyint(r.width * s), (int)std::nearbyint(r.height * s));
+            }
+
+            rects.clear();
+            for (int i = 0; i < classes; i++) {
+                const cv::Rect& r1 = sums[i];
+                const int n1 = count[i];
+                if (n1 <= threshold) continue;
+                bool inside = false;
+                for (int j = 0; j < classes && !inside; j++) {
+                    const int n2 = count[j];
+                    if (j == i || n2 <= threshold) continue;
+                    const cv::Rect& r2 = sums[j];
+                    int dx = (int)std::nearbyint(r2.width * eps);
+                    int dy = (int)std::nearbyint(r2.height * eps);
+                    inside = r1.x >= r2.x - dx && r1.y >= r2.y - dy &&
+                             r1.x + r1.width <= r2.x + r2.width + dx &&
+                             r1.y + r1.height <= r2.y + r2.height + dy &&
+                             (n2 > std::max(3, n1) || n1 < 3);
+                }
+                if (!inside) rects.push_back(r1);
+            }
+        }
+    }
+
+    /**
+     * @brief 构造函数
+     * @param data 编译级联表（须在实例生命周期内有效）
+     * @param kernel 窗口判定内核（不可用时退回自动选择）
+     */
+    HaarCascade::HaarCascade(const HaarCascadeData& data, Kernel kernel) : data_(data) {
+        kernel_ = resolveSimdLevel(kernel);
+        if (kernel_ != Kernel::AVX2) kernel_ = Kernel::SCALAR;
+    }
+
+    /**
+     * @brief 多尺度检测（参数含义与 cv::CascadeClassifier::detectMultiScale 相同）
+     */
+    void HaarCascade::detectMultiScale(const cv::Mat& image, std::vector<cv::Rect>& objects, double scaleFactor,
+                                       int minNeighbors, const cv::Size& minSize, const cv::Size& maxSize) const {
+        objects.clear();
+        if (image.empty() || image.type() != CV_8UC1 || scaleFactor <= 1.0) return;
+
+        const cv::Size window(data_.windowWidth, data_.windowHeight);
+        const cv::Size imageSize = image.size();
+        if (imageSize.width < window.width || imageSize.height < window.height) return;
+
+        // 缓冲区按最大的一层准备，之后各层复用
+        Workspace& ws = workspace();
+        std::vector<float>& scales = ws.scales;
+        selectScales(imageSize, minSize, maxSize.width == 0 || maxSize.height == 0 ? imageSize : maxSize,
+                     scaleFactor, ws.allScales, scales);
+        if (scales.empty()) return;
+
+        reserve(ws, cv::Size(cvRound(imageSize.width / scales[0]), cvRound(imageSize.height / scales[0])));
+        const haar::Cascade& cascade = scaledCascade(ws, data_);
+
+        for (float scale : scales) {
+            // 与 OpenCV 相同：先缩放整幅图像再计算积分图（缩放比例为 1 时直接使用原图）
+            cv::Size scaled(cvRound(imageSize.width / scale), cvRound(imageSize.height / scale));
+            // 各层共用同一块缩放缓冲区（按第一层分配，之后的层更小）
+            if (scaled != imageSize) {
+                cv::Mat level = bufferView(ws.resized, scaled);
+                resizeLinearExact(image, level, scaled);
+                integral(level, ws.sum.data(), ws.sqsum.data(), ws.stride);
+            } else {
+                integral(image, ws.sum.data(), ws.sqsum.data(), ws.stride);
+            }
+
+            const int step = scale >= 2 ? 1 : 2;
+            const haar::Level scan{ws.sum.data(), ws.sqsum.data(), ws.stride, scaled.width + 1 - window.width, step};
+            const int rows = (scaled.height + 1 - window.height + step - 1) / step;
+            if (scan.width <= 0 || rows <= 0) continue;
+
+            // 按行分段并行扫描，各分段结果按段序合并（结果顺序与线程数无关）
+            const int stripes = std::max(1, std::min(rows / 4, MAX_STRIPES));
+            if ((int)ws.stripeHits.size() < stripes) ws.stripeHits.resize(stripes);
+            const Kernel kernel = kernel_;
+            auto scanStripes = [&](const cv::Range& range) {
+                for (int i = range.start; i < range.end; i++) {
+                    std::vector<cv::Point>& hits = ws.stripeHits[i];
+                    hits.clear();
+                    for (int r = rows * i / stripes; r < rows * (i + 1) / stripes; r++) {
+#if defined(DRIVEGUARD_SIMD_X86)
+                        if (kernel == Kernel::AVX2) {
+                            haar::scanRowAVX2(cascade, scan, r * step, hits);
+                            continue;
+                        }
+#endif
+                        haar::scanRowScalar(cascade, scan, r * step, hits);
+                    }
+                }
+            };
+            parallelFor(stripes, scanStripes);
+
+            // 转换回原图坐标
+            const cv::Size winSize(cvRound(window.width * scale), cvRound(window.height * scale));
+            for (int i = 0; i < stripes; i++) {
+                for (const auto& hit : ws.stripeHits[i]) {
+                    objects.emplace_back(cvRound(hit.x * scale), cvRound(hit.y * scale), winSize.width, winSize.height);
+                }
+            }
+        }
+
+        groupRectangles(ws, objects, minNeighbors, GROUP_EPS);
+    }
+
+    /**
+     * @brief 级联表
+     */
+    const HaarCascadeData& HaarCascade::data() const {
+        return data_;
+    }
+
+    /**
+     * @brief 实际使用的窗口判定内核
+     */
+    HaarCascade::Kernel HaarCascade::kernel() const {
+        return kernel_;
+    }
+
+    /**
+     * @brief 尺度序列（与 detectMultiScaleNoGrouping 一致：先列出窗口不超过图像的全部尺度，
+     * 再按最小/最大尺寸筛选；最小与最大尺寸相同且没有恰好匹配的尺度时取最接近的一个）
+     */
+    void HaarCascade::selectScales(const cv::Size& imageSize, const cv::Size& minSize, const cv::Size& maxSize,
+                                   double scaleFactor, std::vector<float>& allScales, std::vector<float>& scales) const {
+        const cv::Size window(data_.windowWidth, data_.windowHeight);
+        allScales.clear();
+        scales.clear();
+        for (double factor = 1; ; factor *= scaleFactor) {
+            cv::Size windowSize(cvRound(window.width * factor), cvRound(window.height * factor));
+            if (windowSize.width > imageSize.width || windowSize.height > imageSize.height) break;
+            allScales.push_back((float)factor);
+        }
+
+        for (float scale : allScales) {
+            cv::Size windowSize(cvRound(window.width * scale), cvRound(window.height * scale));
+            if (windowSize.width > maxSize.width || windowSize.height > maxSize.height) break;
+            if (windowSize.width < minSize.width || windowSize.height < minSize.height) continue;
+            scales.push_back(scale);
+        }
+
+        if (scales.empty() && !allScales.empty() && minSize == maxSize) {
+            float minDistance = FLT_MAX;
+            float bestScale = 0;
+            for (float scale : allScales) {
+                cv::Size windowSize(cvRound(window.width * scale), cvRound(window.height * scale));
+                float dw = (float)(minSize.width - windowSize.width);
+                float dh = (float)(minSize.height - windowSize.height);
+                float distance = std::sqrt(dw * dw + dh * dh);
+                if (distance < minDistance) {
+                    minDistance = distance;
+                    bestScale = scale;
+                }
+            }
+            scales.push_back(bestScale);
+        }
+    }
+}
@@ -0,0 +1,153 @@
+#include "IdentityCache.h"
+#include "ImageOps.h"
+#include <cmath>
+#include <cstdlib>
+
+namespace DriveGuard {
+    namespace {
+        // 外观比对缩略图尺寸
+        const int THUMBNAIL_SIZE = 16;
+
+        /**
+         * @brief 两张同尺寸缩略图的平均逐像素绝对差
+         */
+        double meanAbsDiff(const cv::Mat& a, const cv::Mat& b) {
+            int sum = 0;
+            for (int y = 0; y < a.rows; y++) {
+                const unsigned char* pa = a.ptr<unsigned char>(y);
+                const unsigned char* pb = b.ptr<unsigned char>(y);
+                for (int x = 0; x < a.cols; x++) sum += std::abs(pa[x] - pb[x]);
+            }
+            return (double)sum / a.total();
+        }
+    }
+
+    /**
+     * @brief 构造函数
+     * @param config 缓存配置
+     */
+    IdentityCache::IdentityCache(const IdentityCacheConfig& config) : config_(config), frameIndex_(0) {
+    }
+
+    /**
+     * @brief 开始新的一帧（推进帧计数并淘汰长期未出现的轨迹）
+     */
+    void IdentityCache::advance() {
+        frameIndex_++;
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            if (frameIndex_ - it->second.lastSeen > (uint64_t)config_.maxIdleFrames) {
+                it = entries_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /**
+     * @brief 查询缓存（关闭缓存时总是未命中）
+     * @param face 人脸样本
+     * @param label 输出标签
+     * @param confidence 输出置信度
+     * @return 缓存命中且仍然有效返回 true
+     */
+    bool IdentityCache::lookup(const FaceSample& face, int& label, double& confidence) {
+        if (!config_.enabled || face.trackId() < 0) return false;
+
+        auto it = entries_.find(face.trackId());
+        if (it == entries_.end()) return false;
+
+        Entry& entry = it->second;
+        entry.lastSeen = frameIndex_;
+
+        // 到达刷新周期
+        if (frameIndex_ - entry.verifiedAt >= (uint64_t)config_.refreshInterval) return false;
+
+        // 人脸框跳变
+        if (boxJumped(entry.box, face.box())) return false;
+
+        // 外观明显变化（例如换人坐入同一位置而轨迹未断）
+        makeThumbnail(face, thumbnail_);
+        if (thumbnail_.empty() || thumbnail_.size() != entry.thumbnail.size()) return false;
+        double diff = meanAbsDiff(thumbnail_, entry.thumbnail);
+        if (diff > config_.maxAppearanceDiff) return false;
+
+        label = entry.label;
+        confidence = entry.confidence;
+        return true;
+    }
+
+    /**
+     * @brief 查询轨迹最近一次可信识别的结果，忽略刷新周期与外观比对（降载时使用，不受 enabled 影响）
+     * @param face 人脸样本
+     * @param label 输出标签
+     * @param confidence 输出置信度
+     * @return 轨迹有缓存且人脸框未跳变返回 true
+     */
+    bool IdentityCache::peek(const FaceSample& face, int& label, double& confidence) {
+        if (face.trackId() < 0) return false;
+
+        auto it = entries_.find(face.trackId());
+        if (it == entries_.end() || boxJumped(it->second.box, face.box())) return false;
+
+        it->second.lastSeen = frameIndex_;
+        label = it->second.label;
+        confidence = it->second.confidence;
+        return true;
+    }
+
+    /**
+     * @brief 写入完整识别的结果（仅缓存可信识别的轨迹；关闭缓存时不生成缩略图）
+     * @param face 人脸样本
+     * @param label 识别标签
+     * @param confidence 识别置信度
+     * @param confident 是否为可信识别（置信度低于阈值）
+     */
+    void IdentityCache::store(const FaceSample& face, int label, double confidence, bool confident) {
+        if (face.trackId() < 0) return;
+
+        if (!confident) {
+            entries_.erase(face.trackId());
+            return;
+        }
+
+        Entry& entry = entries_[face.trackId()];
+        entry.label = label;
+        entry.confidence = confidence;
+        entry.box = face.box();
+        // 缩略图只用于 lookup() 的外观比对，降载时的 peek() 不需要
+        if (config_.enabled) makeThumbnail(face, entry.thumbnail);
+        entry.verifiedAt = frameIndex_;
+        entry.lastSeen = frameIndex_;
+    }
+
+    /**
+     * @brief 清空缓存（模型更新后调用）
+     */
+    void IdentityCache::clear() {
+        entries_.clear();
+    }
+
+    /**
+     * @brief 判断人脸框相对上次完整识别是否发生跳变
+     */
+    bool IdentityCache::boxJumped(const cv::Rect& previous, const cv::Rect& current) const {
+        double dx = (current.x + current.width * 0.5) - (previous.x + previous.width * 0.5);
+        double dy = (current.y + current.height * 0.5) - (previous.y + previous.height * 0.5);
+        double shift = std::sqrt(dx * dx + dy * dy);
+        if (shift > config_.maxCenterShift * previous.width) return true;
+
+        double sizeChange = std::abs(current.width - previous.width) / (double)previous.width;
+        return sizeChange > config_.maxSizeChange;
+    }
+
+    /**
+     * @brief 生成用于外观比对的人脸缩略图
+     */
+    void IdentityCache::makeThumbnail(const FaceSample& face, cv::Mat& thumbnail) {
+        if (face.gray().empty()) {
+            thumbnail.release();
+            return;
+        }
+        resizeBox(face.gray(), thumbnail, cv::Size(THUMBNAIL_SIZE, THUMBNAIL_SIZE));
+    }
+}
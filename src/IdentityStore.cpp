@@ -0,0 +1,189 @@
+#include "IdentityStore.h"
+#include "FileLock.h"
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace DriveGuard {
+    namespace {
+        /**
+         * @brief 解析整数字段（整段都须为数字，不抛异常）
+         */
+        bool parseInt(const std::string& text, std::size_t begin, std::size_t end, int& value) {
+            if (begin >= end) return false;
+            const char* first = text.data() + begin;
+            const char* last = text.data() + end;
+            auto result = std::from_chars(first, last, value);
+            return result.ec == std::errc() && result.ptr == last;
+        }
+
+        bool isKnownRole(int value) {
+            return value == (int)UserRole::DRIVER || value == (int)UserRole::PASSENGER || value == (int)UserRole::UNKNOWN;
+        }
+    }
+
+    /**
+     * @brief 设置（或覆盖）标签对应的身份
+     * @return 标签超出 [0, MAX_LABEL) 时返回 false
+     */
+    bool IdentityStore::set(int label, const std::string& name, UserRole role) {
+        if (label < 0 || label >= MAX_LABEL) return false;
+        if ((std::size_t)label >= identities_.size()) identities_.resize(label + 1);
+
+        Identity& identity = identities_[label];
+        if (identity.valid) {
+            auto it = labelOf_.find(identity.name);
+            if (it != labelOf_.end() && it->second == label) labelOf_.erase(it);
+        } else {
+            count_++;
+        }
+        identity.name = name;
+        identity.role = role;
+        identity.valid = true;
+        labelOf_[name] = label;
+        return true;
+    }
+
+    /**
+     * @brief 标签对应的姓名（未登记时为 "Unknown"）
+     */
+    const std::string& IdentityStore::name(int label) const {
+        static const std::string unknown = "Unknown";
+        return contains(label) ? identities_[label].name : unknown;
+    }
+
+    /**
+     * @brief 标签对应的角色（未登记时为 UNKNOWN）
+     */
+    UserRole IdentityStore::role(int label) const {
+        return contains(label) ? identities_[label].role : UserRole::UNKNOWN;
+    }
+
+    /**
+     * @brief 标签是否已登记
+     */
+    bool IdentityStore::contains(int label) const {
+        return label >= 0 && (std::size_t)label < identities_.size() && identities_[label].valid;
+    }
+
+    /**
+     * @brief 按姓名查找标签
+     * @return 未找到返回 -1
+     */
+    int IdentityStore::find(const std::string& name) const {
+        auto it = labelOf_.find(name);
+        return it != labelOf_.end() ? it->second : -1;
+    }
+
+    /**
+     * @brief 下一个可用标签（当前最大标签加一）
+     */
+    int IdentityStore::nextLabel() const {
+        for (std::size_t i = identities_.size(); i > 0; i--) {
+            if (identities_[i - 1].valid) return (int)i;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief 已登记的身份数
+     */
+    std::size_t IdentityStore::size() const {
+        return count_;
+    }
+
+    /**
+     * @brief 清空
+     */
+    void IdentityStore::clear() {
+        identities_.clear();
+        labelOf_.clear();
+        count_ = 0;
+    }
+
+    /**
+     * @brief 从映射表文件加载（替换当前内容，格式错误的行跳过并告警）
+     * @return 文件无法打开时返回 false（当前内容不变）
+     */
+    bool IdentityStore::load(const std::string& filepath) {
+        std::ifstream ifs(filepath, std::ios::in);
+        if (!ifs.is_open()) {
+            std::cerr << "[ERROR] 无法从文件：" << filepath << "加载映射表" << std::endl;
+            return false;
+        }
+
+        clear();
+        std::string line;
+        int lineNo = 0;
+        int skipped = 0;
+        while (std::getline(ifs, line)) {
+            lineNo++;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) continue;
+
+            // label:name:role（姓名取首尾两个冒号之间的内容，允许其中含有冒号）
+            std::size_t first = line.find(':');
+            std::size_t last = line.rfind(':');
+            int label = -1;
+            int roleValue = 0;
+            if (first == std::string::npos || last == first || !parseInt(line, 0, first, label)
+                || !parseInt(line, last + 1, line.size(), roleValue) || !isKnownRole(roleValue)
+                || !set(label, line.substr(first + 1, last - first - 1), (UserRole)roleValue)) {
+                std::cerr << "[WARN] 映射表第 " << lineNo << " 行格式错误，已跳过：" << line << std::endl;
+                skipped++;
+            }
+        }
+
+        std::cout << "[INFO] 已从文件：" << filepath << "加载 " << count_ << " 个用户信息";
+        if (skipped > 0) std::cout << "（跳过 " << skipped << " 行）";
+        std::cout << std::endl;
+        return true;
+    }
+
+    /**
+     * @brief 保存到映射表文件（先写临时文件并落盘再替换，持有 <映射表>.lock 的独占锁）
+     * @return 写入失败返回 false
+     */
+    bool IdentityStore::save(const std::string& filepath) const {
+        std::string text;
+        for (std::size_t label = 0; label < identities_.size(); label++) {
+            const Identity& identity = identities_[label];
+            if (!identity.valid) continue;
+            // label:name:roleValue
+            text += std::to_string(label) + ":" + identity.name + ":" + std::to_string((int)identity.role) + "\n";
+        }
+
+        FileLock lock(FileLock::lockPath(filepath));
+        std::string tmpPath = filepath + ".tmp";
+        std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+        if (!file) {
+            std::cerr << "[ERROR] 无法保存映射表到文件：" << tmpPath << std::endl;
+            return false;
+        }
+        bool ok = std::fwrite(text.data(), 1, text.size(), file) == text.size() && std::fflush(file) == 0;
+#ifndef _WIN32
+        ok = ok && fsync(fileno(file)) == 0;
+#endif
+        ok = std::fclose(file) == 0 && ok;
+        if (!ok) {
+            std::cerr << "[ERROR] 映射表写入失败：" << tmpPath << std::endl;
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+#ifdef _WIN32
+        // Windows 的 rename 不能覆盖已有文件；POSIX 上 rename 原子替换，中途崩溃不会丢失原映射表
+        std::remove(filepath.c_str());
+#endif
+        if (std::rename(tmpPath.c_str(), filepath.c_str()) != 0) {
+            std::cerr << "[ERROR] 无法更新映射表：" << filepath << std::endl;
+            return false;
+        }
+        std::cout << "[INFO] ID-Name-Role 映射表已保存到：" << filepath << std::endl;
+        return true;
+    }
+}
@@ -0,0 +1,303 @@
+#include "ImageOps.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace DriveGuard {
+    namespace {
+        // INTER_LINEAR 的定点系数位数（与 OpenCV 的 INTER_RESIZE_COEF_BITS 相同）
+        const int LINEAR_COEF_BITS = 11;
+        const float LINEAR_COEF_SCALE = (float)(1 << LINEAR_COEF_BITS);
+        // INTER_LINEAR_EXACT 的定点系数位数
+        const int EXACT_COEF_BITS = 8;
+
+        /**
+         * @brief 每个线程的插值系数与行缓冲区（只增不减）
+         */
+        struct ResizeBuffer {
+            std::vector<int> xofs;
+            std::vector<int> yofs;
+            std::vector<int> xcoef;       // 每个输出列两个系数
+            std::vector<int> ycoef;       // 每个输出行两个系数
+            std::vector<int> rows[2];     // INTER_LINEAR 的水平插值结果
+            std::vector<uint16_t> lines[2]; // INTER_LINEAR_EXACT 的水平插值结果
+        };
+
+        ResizeBuffer& resizeBuffer() {
+            thread_local ResizeBuffer buffer;
+            return buffer;
+        }
+
+        template <class T>
+        T* grow(std::vector<T>& buffer, std::size_t size) {
+            if (buffer.size() < size) buffer.resize(size);
+            return buffer.data();
+        }
+
+        int roundEven(float value) {
+            return (int)std::nearbyint(value);
+        }
+
+        int roundEven(double value) {
+            return (int)std::nearbyint(value);
+        }
+
+        /**
+         * @brief INTER_LINEAR 的插值系数（与 cv::resize 相同：坐标按单精度计算，
+         * 水平方向越界时夹到边缘像素，垂直方向只夹取源行、不修改系数）
+         */
+        void linearCoeffs(int srcSize, int dstSize, bool clampCoeffs, int* ofs, int* coef) {
+            const double scale = 1.0 / ((double)dstSize / srcSize);
+            for (int d = 0; d < dstSize; d++) {
+                float f = (float)((d + 0.5) * scale - 0.5);
+                int s = (int)std::floor(f);
+                f -= (float)s;
+                if (clampCoeffs && s < 0) {
+                    f = 0.f;
+                    s = 0;
+                }
+                if (clampCoeffs && s >= srcSize - 1) {
+                    f = 0.f;
+                    s = srcSize - 1;
+                }
+                ofs[d] = s;
+                coef[2 * d] = roundEven((1.f - f) * LINEAR_COEF_SCALE);
+                coef[2 * d + 1] = roundEven(f * LINEAR_COEF_SCALE);
+            }
+        }
+
+        /**
+         * @brief INTER_LINEAR_EXACT 的插值系数（与 cv::resize 相同：坐标按双精度计算，
+         * [minOfs, maxOfs) 之外的输出取边缘像素）
+         */
+        void exactCoeffs(int srcSize, int dstSize, int* ofs, int* coef, int& minOfs, int& maxOfs) {
+            const double scale = 1.0 / ((double)dstSize / srcSize);
+            const int one = 1 << EXACT_COEF_BITS;
+            minOfs = 0;
+            maxOfs = dstSize;
+            for (int d = 0; d < dstSize; d++) {
+                double f = scale * (d + 0.5) - 0.5;
+                int i = (int)std::floor(f);
+                ofs[d] = 0;
+                coef[2 * d] = one;
+                coef[2 * d + 1] = 0;
+                if (i >= 0 && srcSize > 1) {
+                    if (i < srcSize - 1) {
+                        int c1 = roundEven((f - i) * one);
+                        ofs[d] = i;
+                        coef[2 * d] = std::max(0, one - c1);
+                        coef[2 * d + 1] = c1;
+                    } else {
+                        ofs[d] = srcSize - 1;
+                        maxOfs = std::min(maxOfs, d);
+                    }
+                } else {
+                    minOfs = std::max(minOfs, d + 1);
+                }
+            }
+        }
+
+        unsigned char saturate(int value) {
+            return (unsigned char)std::min(255, std::max(0, value));
+        }
+    }
+
+    /**
+     * @brief BGR 转灰度（同 cv::cvtColor(COLOR_BGR2GRAY)）
+     */
+    void bgrToGray(const cv::Mat& bgr, cv::Mat& gray) {
+        CV_Assert(bgr.type() == CV_8UC3);
+        gray.create(bgr.size(), CV_8UC1);
+        // 与 OpenCV 相同的 15 位定点系数（0.114、0.587、0.299）
+        for (int y = 0; y < bgr.rows; y++) {
+            const unsigned char* src = bgr.ptr<unsigned char>(y);
+            unsigned char* dst = gray.ptr<unsigned char>(y);
+            for (int x = 0; x < bgr.cols; x++, src += 3) {
+                dst[x] = (unsigned char)((src[0] * 3735 + src[1] * 19235 + src[2] * 9798 + (1 << 14)) >> 15);
+            }
+        }
+    }
+
+    /**
+     * @brief 直方图均衡化（同 cv::equalizeHist，可原地运算）
+     */
+    void equalizeHistogram(const cv::Mat& src, cv::Mat& dst) {
+        CV_Assert(src.type() == CV_8UC1);
+        if (dst.data != src.data) dst.create(src.size(), CV_8UC1);
+        if (src.empty()) return;
+
+        int hist[256] = {0};
+        for (int y = 0; y < src.rows; y++) {
+            const unsigned char* row = src.ptr<unsigned char>(y);
+            for (int x = 0; x < src.cols; x++) hist[row[x]]++;
+        }
+
+        // 首个非空灰度级映射为 0，其余按累计直方图线性拉伸（单精度比例，与 OpenCV 相同）
+        unsigned char lut[256];
+        const int total = (int)src.total();
+        int i = 0;
+        while (!hist[i]) ++i;
+        if (hist[i] == total) {
+            std::fill(lut, lut + 256, (unsigned char)i);
+        } else {
+            const float scale = 255.f / (float)(total - hist[i]);
+            int sum = 0;
+            std::fill(lut, lut + i + 1, (unsigned char)0);
+            for (i++; i < 256; i++) {
+                sum += hist[i];
+                lut[i] = saturate(roundEven((float)sum * scale));
+            }
+        }
+
+        for (int y = 0; y < src.rows; y++) {
+            const unsigned char* in = src.ptr<unsigned char>(y);
+            unsigned char* out = dst.ptr<unsigned char>(y);
+            for (int x = 0; x < src.cols; x++) out[x] = lut[in[x]];
+        }
+    }
+
+    /**
+     * @brief 双线性缩放 8 位灰度图（同 cv::resize 的 INTER_LINEAR）
+     */
+    void resizeLinear(const cv::Mat& src, cv::Mat& dst, const cv::Size& size) {
+        CV_Assert(src.type() == CV_8UC1 && !src.empty() && size.width > 0 && size.height > 0);
+        CV_Assert(dst.data != src.data);
+        dst.create(size, CV_8UC1);
+
+        ResizeBuffer& buffer = resizeBuffer();
+        const int dw = size.width;
+        const int dh = size.height;
+        int* xofs = grow(buffer.xofs, dw);
+        int* xcoef = grow(buffer.xcoef, 2 * dw);
+        int* yofs = grow(buffer.yofs, dh);
+        int* ycoef = grow(buffer.ycoef, 2 * dh);
+        linearCoeffs(src.cols, dw, true, xofs, xcoef);
+        linearCoeffs(src.rows, dh, false, yofs, ycoef);
+
+        int* rows[2] = {grow(buffer.rows[0], dw), grow(buffer.rows[1], dw)};
+        int cached[2] = {-1, -1};
+        auto hline = [&](int sy, int* out) {
+            const unsigned char* s = src.ptr<unsigned char>(sy);
+            for (int x = 0; x < dw; x++) {
+                int sx = xofs[x];
+                int sx1 = std::min(sx + 1, src.cols - 1);
+                out[x] = s[sx] * xcoef[2 * x] + s[sx1] * xcoef[2 * x + 1];
+            }
+        };
+
+        for (int y = 0; y < dh; y++) {
+            int sy0 = std::min(std::max(yofs[y], 0), src.rows - 1);
+            int sy1 = std::min(std::max(yofs[y] + 1, 0), src.rows - 1);
+            // 相邻输出行常共用源行，水平插值结果按源行缓存
+            if (sy0 == cached[1] && sy0 != cached[0]) {
+                std::swap(rows[0], rows[1]);
+                std::swap(cached[0], cached[1]);
+            }
+            if (sy0 != cached[0]) {
+                hline(sy0, rows[0]);
+                cached[0] = sy0;
+            }
+            if (sy1 != cached[1]) {
+                hline(sy1, rows[1]);
+                cached[1] = sy1;
+            }
+            const int* s0 = rows[0];
+            const int* s1 = rows[1];
+
+            // 与 OpenCV 向量化实现相同的舍入：两行分别右移后相加
+            const int b0 = ycoef[2 * y];
+            const int b1 = ycoef[2 * y + 1];
+            unsigned char* d = dst.ptr<unsigned char>(y);
+            for (int x = 0; x < dw; x++) {
+                int v = ((b0 * (s0[x] >> 4)) >> 16) + ((b1 * (s1[x] >> 4)) >> 16);
+                d[x] = saturate((v + 2) >> 2);
+            }
+        }
+    }
+
+    /**
+     * @brief 双线性缩放 8 位灰度图（同 cv::resize 的 INTER_LINEAR_EXACT）
+     */
+    void resizeLinearExact(const cv::Mat& src, cv::Mat& dst, const cv::Size& size) {
+        CV_Assert(src.type() == CV_8UC1 && !src.empty() && size.width > 0 && size.height > 0);
+        CV_Assert(dst.data != src.data);
+        dst.create(size, CV_8UC1);
+
+        ResizeBuffer& buffer = resizeBuffer();
+        const int dw = size.width;
+        const int dh = size.height;
+        int* xofs = grow(buffer.xofs, dw);
+        int* xcoef = grow(buffer.xcoef, 2 * dw);
+        int* yofs = grow(buffer.yofs, dh);
+        int* ycoef = grow(buffer.ycoef, 2 * dh);
+        int minX, maxX, minY, maxY;
+        exactCoeffs(src.cols, dw, xofs, xcoef, minX, maxX);
+        exactCoeffs(src.rows, dh, yofs, ycoef, minY, maxY);
+
+        uint16_t* lines[2] = {grow(buffer.lines[0], dw), grow(buffer.lines[1], dw)};
+        auto hline = [&](int sy, uint16_t* out) {
+            const unsigned char* s = src.ptr<unsigned char>(sy);
+            int x = 0;
+            for (; x < minX; x++) out[x] = (uint16_t)(s[0] << EXACT_COEF_BITS);
+            for (; x < maxX; x++) {
+                const unsigned char* p = s + xofs[x];
+                out[x] = (uint16_t)(xcoef[2 * x] * p[0] + xcoef[2 * x + 1] * p[1]);
+            }
+            for (; x < dw; x++) out[x] = (uint16_t)(s[xofs[dw - 1]] << EXACT_COEF_BITS);
+        };
+
+        for (int y = 0; y < dh; y++) {
+            unsigned char* d = dst.ptr<unsigned char>(y);
+            if (y < minY || y >= maxY) {
+                // 上下边缘之外的行直接取首行或末行
+                hline(y < minY ? 0 : src.rows - 1, lines[0]);
+                for (int x = 0; x < dw; x++) d[x] = saturate((lines[0][x] + 128) >> 8);
+                continue;
+            }
+            hline(yofs[y], lines[0]);
+            hline(yofs[y] + 1, lines[1]);
+            const uint32_t b0 = (uint32_t)ycoef[2 * y];
+            const uint32_t b1 = (uint32_t)ycoef[2 * y + 1];
+            for (int x = 0; x < dw; x++) {
+                uint32_t v = lines[0][x] * b0 + lines[1][x] * b1;
+                d[x] = (unsigned char)std::min<uint32_t>(255, (v + 32768) >> 16);
+            }
+        }
+    }
+
+    /**
+     * @brief 区域平均缩小 8 位图像（任意通道数，用于外观缩略图与录制帧的缩小拷贝）
+     */
+    void resizeBox(const cv::Mat& src, cv::Mat& dst, const cv::Size& size) {
+        CV_Assert(src.depth() == CV_8U && !src.empty() && size.width > 0 && size.height > 0);
+        CV_Assert(dst.data != src.data);
+        const int cn = src.channels();
+        dst.create(size, src.type());
+
+        for (int y = 0; y < size.height; y++) {
+            int y0 = y * src.rows / size.height;
+            int y1 = std::max(y0 + 1, (y + 1) * src.rows / size.height);
+            unsigned char* d = dst.ptr<unsigned char>(y);
+            for (int x = 0; x < size.width; x++) {
+                int x0 = x * src.cols / size.width;
+                int x1 = std::max(x0 + 1, (x + 1) * src.cols / size.width);
+                int area = (y1 - y0) * (x1 - x0);
+                for (int c = 0; c < cn; c++) {
+                    int sum = 0;
+                    for (int sy = y0; sy < y1; sy++) {
+                        const unsigned char* s = src.ptr<unsigned char>(sy);
+                        for (int sx = x0; sx < x1; sx++) sum += s[sx * cn + c];
+                    }
+                    d[x * cn + c] = (unsigned char)((sum + area / 2) / area);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 在只增不减的存储上构造指定尺寸的 8 位灰度图像头
+     */
+    cv::Mat bufferView(std::vector<unsigned char>& storage, const cv::Size& size) {
+        return cv::Mat(size, CV_8UC1, grow(storage, (std::size_t)size.area()));
+    }
+}
@@ -0,0 +1,76 @@
+#include "ImageSequenceSource.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <iostream>
+
+namespace DriveGuard {
+    // 构造函数
+    ImageSequenceSource::ImageSequenceSource() : nextImage_(0) {
+    }
+
+    /**
+     * @brief 打开图片序列目录，按文件名排序
+     * @param dir 目录路径
+     * @return 目录中有可用图片时返回 true
+     */
+    bool ImageSequenceSource::open(const std::string& dir) {
+        static const std::vector<std::string> kExtensions = {".png", ".jpg", ".jpeg", ".bmp"};
+
+        release();
+        input_ = dir;
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            if (!entry.is_regular_file()) continue;
+            std::string ext = entry.path().extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(),
+                           [](unsigned char ch) { return (char)std::tolower(ch); });
+            if (std::find(kExtensions.begin(), kExtensions.end(), ext) != kExtensions.end()) {
+                imageFiles_.push_back(entry.path().string());
+            }
+        }
+
+        if (imageFiles_.empty()) {
+            std::cerr << "[ERROR] 目录中没有可用的图片：" << dir << std::endl;
+            return false;
+        }
+
+        std::sort(imageFiles_.begin(), imageFiles_.end());
+        return true;
+    }
+
+    /**
+     * @brief 读取下一张图片（无法读取的图片跳过）
+     * @param frame 输出图像帧
+     * @return 序列结束返回 false
+     */
+    bool ImageSequenceSource::read(cv::Mat& frame) {
+        while (nextImage_ < imageFiles_.size()) {
+            frame = cv::imread(imageFiles_[nextImage_++], cv::IMREAD_COLOR);
+            if (!frame.empty()) return true;
+            std::cerr << "[WARN] 无法读取图片：" << imageFiles_[nextImage_ - 1] << std::endl;
+        }
+        return false;
+    }
+
+    /**
+     * @brief 图片序列为离线输入
+     */
+    bool ImageSequenceSource::isLive() const {
+        return false;
+    }
+
+    /**
+     * @brief 输入源描述（用于日志）
+     */
+    std::string ImageSequenceSource::describe() const {
+        return "图片序列 " + input_ + " (" + std::to_string(imageFiles_.size()) + " 帧)";
+    }
+
+    /**
+     * @brief 释放输入源
+     */
+    void ImageSequenceSource::release() {
+        imageFiles_.clear();
+        nextImage_ = 0;
+    }
+}
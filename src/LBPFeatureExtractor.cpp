@@ -0,0 +1,201 @@
+#include "LBPFeatureExtractor.h"
+#include "simd/LBPKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace DriveGuard {
+    namespace {
+        // 判定为整数采样点时，其余插值权重的上限（远小于 FLT_EPSILON / 255，不影响插值结果）
+        const float NEGLIGIBLE_WEIGHT = 1e-12f;
+    }
+
+    /**
+     * @brief 构造函数
+     * @param params LBP 参数
+     * @param kernel 编码内核（不可用时退回自动选择）
+     */
+    LBPFeatureExtractor::LBPFeatureExtractor(const LBPParams& params, Kernel kernel)
+        : params_(params), kernel_(resolveSimdLevel(kernel)) {
+        if (!isSupported(params_)) return;
+
+        // 采样点位置与插值权重的计算方式与 OpenCV elbp_ 完全一致（先以 double 计算再截断为 float）
+        for (int n = 0; n < params_.neighbors; n++) {
+            float x = static_cast<float>(params_.radius * std::cos(2.0 * CV_PI * n / static_cast<float>(params_.neighbors)));
+            float y = static_cast<float>(-params_.radius * std::sin(2.0 * CV_PI * n / static_cast<float>(params_.neighbors)));
+            int fx = static_cast<int>(std::floor(x));
+            int fy = static_cast<int>(std::floor(y));
+            int cx = static_cast<int>(std::ceil(x));
+            int cy = static_cast<int>(std::ceil(y));
+            float ty = y - fy;
+            float tx = x - fx;
+
+            Sample sample;
+            sample.weights[0] = (1 - tx) * (1 - ty);
+            sample.weights[1] =      tx  * (1 - ty);
+            sample.weights[2] = (1 - tx) *      ty;
+            sample.weights[3] =      tx  *      ty;
+            int dx[4] = {fx, cx, fx, cx};
+            int dy[4] = {fy, fy, cy, cy};
+
+            // 某一权重为 1 且其余可忽略时，插值结果恰为该像素值
+            sample.exact = false;
+            sample.exactIndex = 0;
+            for (int k = 0; k < 4; k++) {
+                sample.dx[k] = dx[k];
+                sample.dy[k] = dy[k];
+                if (sample.weights[k] != 1.0f) continue;
+
+                bool negligible = true;
+                for (int other = 0; other < 4; other++) {
+                    if (other != k && sample.weights[other] >= NEGLIGIBLE_WEIGHT) negligible = false;
+                }
+                if (negligible) {
+                    sample.exact = true;
+                    sample.exactIndex = k;
+                }
+            }
+            samples_.push_back(sample);
+        }
+    }
+
+    /**
+     * @brief 计算灰度图的空间直方图特征
+     * @param gray 灰度图（CV_8UC1）
+     * @param histogram 输出直方图（复用已有缓冲区）
+     * @return 参数或输入不受支持时返回 false
+     */
+    bool LBPFeatureExtractor::compute(const cv::Mat& gray, cv::Mat& histogram) {
+        if (!isSupported(params_)) {
+            std::cerr << "[ERROR] 不支持的 LBP 参数：radius=" << params_.radius
+                      << " neighbors=" << params_.neighbors << std::endl;
+            return false;
+        }
+        if (gray.empty() || gray.type() != CV_8UC1) {
+            std::cerr << "[ERROR] LBP 特征提取需要单通道 8 位灰度图" << std::endl;
+            return false;
+        }
+
+        int codeRows = gray.rows - 2 * params_.radius;
+        int codeCols = gray.cols - 2 * params_.radius;
+        if (codeRows < params_.gridY || codeCols < params_.gridX) {
+            std::cerr << "[ERROR] 图像尺寸过小，无法划分 LBP 网格" << std::endl;
+            return false;
+        }
+
+        encode(gray);
+        accumulate(histogram);
+        return true;
+    }
+
+    /**
+     * @brief 当前 LBP 参数
+     */
+    const LBPParams& LBPFeatureExtractor::params() const {
+        return params_;
+    }
+
+    /**
+     * @brief 直方图维度
+     */
+    int LBPFeatureExtractor::histogramSize() const {
+        return params_.gridX * params_.gridY * (1 << params_.neighbors);
+    }
+
+    /**
+     * @brief 单个网格的像素数（直方图各格的计数总和）
+     * @param imageSize 输入图像尺寸
+     */
+    int LBPFeatureExtractor::cellArea(const cv::Size& imageSize) const {
+        int cellWidth = (imageSize.width - 2 * params_.radius) / params_.gridX;
+        int cellHeight = (imageSize.height - 2 * params_.radius) / params_.gridY;
+        return cellWidth * cellHeight;
+    }
+
+    /**
+     * @brief 实际使用的编码内核
+     */
+    LBPFeatureExtractor::Kernel LBPFeatureExtractor::kernel() const {
+        return kernel_;
+    }
+
+    /**
+     * @brief 参数是否受支持
+     */
+    bool LBPFeatureExtractor::isSupported(const LBPParams& params) {
+        return params.radius >= 1 && params.neighbors >= 1 && params.neighbors <= 8
+            && params.gridX >= 1 && params.gridY >= 1;
+    }
+
+    /**
+     * @brief 计算 LBP 编码图（尺寸为 (rows-2r) x (cols-2r)）
+     */
+    void LBPFeatureExtractor::encode(const cv::Mat& gray) {
+        codes_.create(gray.rows - 2 * params_.radius, gray.cols - 2 * params_.radius, CV_8UC1);
+
+        // 将行列偏移换算为当前图像的字节偏移
+        lbp::Neighbor neighbors[8];
+        for (int n = 0; n < params_.neighbors; n++) {
+            const Sample& sample = samples_[n];
+            for (int k = 0; k < 4; k++) {
+                neighbors[n].offsets[k] = (std::ptrdiff_t)sample.dy[k] * (std::ptrdiff_t)gray.step + sample.dx[k];
+                neighbors[n].weights[k] = sample.weights[k];
+            }
+            neighbors[n].exact = sample.exact;
+            neighbors[n].exactIndex = sample.exactIndex;
+        }
+
+        lbp::CodeImage image{gray.ptr<unsigned char>(0), gray.step, gray.rows, gray.cols, params_.radius,
+                             codes_.ptr<unsigned char>(0), codes_.step};
+        switch (kernel_) {
+#if defined(DRIVEGUARD_SIMD_X86)
+            case Kernel::AVX2:
+                lbp::encodeAVX2(image, neighbors, params_.neighbors);
+                break;
+            case Kernel::SSE41:
+                lbp::encodeSSE41(image, neighbors, params_.neighbors);
+                break;
+#endif
+#if defined(DRIVEGUARD_SIMD_NEON)
+            case Kernel::NEON:
+                lbp::encodeNEON(image, neighbors, params_.neighbors);
+                break;
+#endif
+            default:
+                lbp::encodeScalar(image, neighbors, params_.neighbors);
+                break;
+        }
+    }
+
+    /**
+     * @brief 按网格统计编码直方图并归一化
+     * 与 OpenCV spatial_histogram 一致：网格尺寸为编码图尺寸整除网格数（余下的边缘不参与统计），
+     * 每格计数乘以 (float)(1.0 / 像素数)。
+     */
+    void LBPFeatureExtractor::accumulate(cv::Mat& histogram) const {
+        const int bins = 1 << params_.neighbors;
+        const int cellWidth = codes_.cols / params_.gridX;
+        const int cellHeight = codes_.rows / params_.gridY;
+        const float scale = static_cast<float>(1.0 / (cellWidth * cellHeight));
+
+        histogram.create(1, histogramSize(), CV_32FC1);
+        float* out = histogram.ptr<float>(0);
+
+        unsigned counts[256];
+        for (int gy = 0; gy < params_.gridY; gy++) {
+            for (int gx = 0; gx < params_.gridX; gx++) {
+                std::fill(counts, counts + bins, 0u);
+                for (int i = gy * cellHeight; i < (gy + 1) * cellHeight; i++) {
+                    const unsigned char* row = codes_.ptr<unsigned char>(i) + gx * cellWidth;
+                    for (int j = 0; j < cellWidth; j++) {
+                        counts[row[j]]++;
+                    }
+                }
+                for (int b = 0; b < bins; b++) {
+                    out[b] = static_cast<float>(counts[b]) * scale;
+                }
+                out += bins;
+            }
+        }
+    }
+}
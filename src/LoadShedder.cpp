@@ -0,0 +1,107 @@
+#include "LoadShedder.h"
+#include "Metrics.h"
+#include <iostream>
+
+namespace DriveGuard {
+    namespace {
+        const char* levelName(ShedLevel level) {
+            switch (level) {
+                case ShedLevel::NONE: return "NONE";
+                case ShedLevel::SKIP_PASSENGERS: return "SKIP_PASSENGERS";
+                case ShedLevel::REDUCE_DETECTION: return "REDUCE_DETECTION";
+                case ShedLevel::DROP_FRAMES: return "DROP_FRAMES";
+                default: return "UNKNOWN";
+            }
+        }
+    }
+
+    /**
+     * @brief 构造函数
+     * @param config 降载配置
+     */
+    LoadShedder::LoadShedder(const LoadShedderConfig& config)
+        : config_(config), level_((int)ShedLevel::NONE), averageMs_(0.0), overBudget_(0), underBudget_(0),
+          consecutiveDrops_(0) {
+    }
+
+    /**
+     * @brief 报告一帧的端到端延迟并调整级别
+     * @param latency 采集到分析完成的耗时
+     */
+    void LoadShedder::observe(std::chrono::steady_clock::duration latency) {
+        if (!config_.enabled) return;
+
+        double ms = std::chrono::duration<double, std::milli>(latency).count();
+        averageMs_ += config_.smoothing * (ms - averageMs_);
+
+        // 滞回：超出预算与低于恢复阈值都需持续若干帧才调整，两者之间保持不变
+        int level = level_.load(std::memory_order_relaxed);
+        if (averageMs_ > config_.budgetMs) {
+            underBudget_ = 0;
+            if (++overBudget_ >= config_.escalateFrames && level < (int)ShedLevel::DROP_FRAMES) {
+                overBudget_ = 0;
+                setLevel(level + 1);
+                Metrics::increment(Counter::SHED_ESCALATIONS);
+            }
+        } else if (averageMs_ < config_.budgetMs * config_.recoverRatio) {
+            overBudget_ = 0;
+            if (++underBudget_ >= config_.recoverFrames && level > (int)ShedLevel::NONE) {
+                underBudget_ = 0;
+                setLevel(level - 1);
+                Metrics::increment(Counter::SHED_RECOVERIES);
+            }
+        } else {
+            overBudget_ = 0;
+            underBudget_ = 0;
+        }
+    }
+
+    /**
+     * @brief 是否处理该帧（DROP_FRAMES 级别下丢弃已超出预算的帧）
+     * @param captureTime 帧采集时间
+     * @param now 当前时间
+     * @return 丢弃时返回 false
+     */
+    bool LoadShedder::admit(TimePoint captureTime, TimePoint now) {
+        if (level() < ShedLevel::DROP_FRAMES
+            || now - captureTime <= std::chrono::milliseconds(config_.budgetMs)
+            || consecutiveDrops_ >= config_.maxConsecutiveDrops) {
+            consecutiveDrops_ = 0;
+            return true;
+        }
+        consecutiveDrops_++;
+        Metrics::increment(Counter::SHED_FRAMES);
+        return false;
+    }
+
+    /**
+     * @brief 当前级别
+     */
+    ShedLevel LoadShedder::level() const {
+        return (ShedLevel)level_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 全帧检测的缩放比例（不降载时为 1）
+     */
+    double LoadShedder::detectScale() const {
+        return level() >= ShedLevel::REDUCE_DETECTION ? config_.reducedScale : 1.0;
+    }
+
+    /**
+     * @brief 是否跳过乘客的重新识别
+     */
+    bool LoadShedder::skipPassengers() const {
+        return level() >= ShedLevel::SKIP_PASSENGERS;
+    }
+
+    /**
+     * @brief 切换级别并记录日志
+     */
+    void LoadShedder::setLevel(int level) {
+        ShedLevel previous = this->level();
+        level_.store(level, std::memory_order_relaxed);
+        std::cout << "[INFO] 降载级别 " << levelName(previous) << " -> " << levelName((ShedLevel)level)
+                  << "（平均延迟 " << (int)averageMs_ << " ms，预算 " << config_.budgetMs << " ms）" << std::endl;
+    }
+}
@@ -0,0 +1,372 @@
+#include "Metrics.h"
+#include "AllocationExemption.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace DriveGuard {
+    namespace {
+        constexpr std::size_t COUNTER_COUNT = (std::size_t)Counter::COUNT;
+#ifndef _WIN32
+        // 单次抓取的发送时限（毫秒）：连接后不读取的客户端最多占用导出线程这么久
+        constexpr int SOCKET_SEND_TIMEOUT_MS = 500;
+#ifdef MSG_NOSIGNAL
+        const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+        const int SEND_FLAGS = 0; // macOS：以 SO_NOSIGPIPE 避免 SIGPIPE
+#endif
+#endif
+        constexpr std::size_t STAGE_COUNT = (std::size_t)Stage::COUNT;
+
+        // 直方图桶上界（微秒），最后一个桶为 +Inf
+        constexpr uint64_t BUCKET_BOUNDS_US[Metrics::BUCKET_COUNT - 1] = {
+            50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000
+        };
+
+        // 计数器名称与标签（Prometheus 格式）
+        struct CounterInfo {
+            const char* name;
+            const char* labels;
+        };
+        const CounterInfo COUNTER_INFO[COUNTER_COUNT] = {
+            {"driveguard_frames_total", ""},
+            {"driveguard_faces_total", ""},
+            {"driveguard_eye_misses_total", ""},
+            {"driveguard_predictions_rejected_total", ""},
+            {"driveguard_dropped_frames_total", ""},
+            {"driveguard_dms_transitions_total", "to=\"normal\""},
+            {"driveguard_dms_transitions_total", "to=\"fatigue\""},
+            {"driveguard_dms_transitions_total", "to=\"sleeping\""},
+            {"driveguard_detections_total", "mode=\"full\""},
+            {"driveguard_detections_total", "mode=\"tracked\""},
+            {"driveguard_identity_lookups_total", "result=\"cached\""},
+            {"driveguard_identity_lookups_total", "result=\"predicted\""},
+            {"driveguard_shed_total", "action=\"skip_passenger\""},
+            {"driveguard_shed_total", "action=\"reduce_detection\""},
+            {"driveguard_shed_total", "action=\"drop_frame\""},
+            {"driveguard_shed_level_changes_total", "direction=\"up\""},
+            {"driveguard_shed_level_changes_total", "direction=\"down\""},
+            {"driveguard_driver_checks_total", ""},
+            {"driveguard_eye_searches_total", "mode=\"cascade\""},
+            {"driveguard_eye_searches_total", "mode=\"tracked\""},
+            {"driveguard_events_total", "result=\"recorded\""},
+            {"driveguard_events_total", "result=\"dropped\""},
+            {"driveguard_event_frames_dropped_total", ""},
+            {"driveguard_alert_clips_total", ""},
+            {"driveguard_results_dropped_total", ""},
+            {"driveguard_frame_bus_dropped_total", ""},
+            {"driveguard_frame_bus_reclaimed_slots_total", ""},
+        };
+
+        const char* STAGE_NAMES[STAGE_COUNT] = {"detect", "recognize", "eyes", "frame_latency", "enroll"};
+
+        /**
+         * @brief 单个线程的指标分片（仅所属线程写入）
+         */
+        struct alignas(64) MetricsShard {
+            std::atomic<uint64_t> counters[COUNTER_COUNT] = {};
+            std::atomic<uint64_t> buckets[STAGE_COUNT][Metrics::BUCKET_COUNT] = {};
+            std::atomic<uint64_t> sumNs[STAGE_COUNT] = {};
+            std::atomic<uint64_t> count[STAGE_COUNT] = {};
+        };
+
+        // 单写者累加：无需读-改-写原子指令
+        inline void addRelaxed(std::atomic<uint64_t>& target, uint64_t value) {
+            target.store(target.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        // 分片注册表（仅在线程首次记录指标时加锁）
+        std::mutex& registryMutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        std::vector<std::unique_ptr<MetricsShard>>& registry() {
+            static std::vector<std::unique_ptr<MetricsShard>> shards;
+            return shards;
+        }
+
+        MetricsShard& localShard() {
+            // 分片在线程退出后保留，其计数仍计入汇总
+            thread_local MetricsShard* shard = [] {
+                AllocationExemption firstUse; // 每个线程首次记录指标时注册一次
+                std::lock_guard<std::mutex> lock(registryMutex());
+                registry().push_back(std::make_unique<MetricsShard>());
+                return registry().back().get();
+            }();
+            return *shard;
+        }
+    }
+
+    /**
+     * @brief 计数器累加
+     */
+    void Metrics::increment(Counter counter, uint64_t value) {
+        addRelaxed(localShard().counters[(std::size_t)counter], value);
+    }
+
+    /**
+     * @brief 记录一次阶段耗时
+     */
+    void Metrics::observe(Stage stage, std::chrono::steady_clock::duration elapsed) {
+        MetricsShard& shard = localShard();
+        std::size_t s = (std::size_t)stage;
+        uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        uint64_t us = ns / 1000;
+
+        std::size_t bucket = 0;
+        while (bucket < BUCKET_COUNT - 1 && us > BUCKET_BOUNDS_US[bucket]) bucket++;
+
+        addRelaxed(shard.buckets[s][bucket], 1);
+        addRelaxed(shard.sumNs[s], ns);
+        addRelaxed(shard.count[s], 1);
+    }
+
+    /**
+     * @brief 读取计数器的汇总值
+     */
+    uint64_t Metrics::counterValue(Counter counter) {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        uint64_t total = 0;
+        for (const auto& shard : registry()) {
+            total += shard->counters[(std::size_t)counter].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    /**
+     * @brief 读取阶段累计耗时的汇总值（所有线程之和）
+     */
+    std::chrono::nanoseconds Metrics::stageTotal(Stage stage) {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        uint64_t total = 0;
+        for (const auto& shard : registry()) {
+            total += shard->sumNs[(std::size_t)stage].load(std::memory_order_relaxed);
+        }
+        return std::chrono::nanoseconds((int64_t)total);
+    }
+
+    /**
+     * @brief 以 Prometheus 文本格式导出所有指标
+     */
+    std::string Metrics::renderPrometheus() {
+        uint64_t counters[COUNTER_COUNT] = {};
+        uint64_t buckets[STAGE_COUNT][BUCKET_COUNT] = {};
+        uint64_t sumNs[STAGE_COUNT] = {};
+        uint64_t count[STAGE_COUNT] = {};
+
+        {
+            std::lock_guard<std::mutex> lock(registryMutex());
+            for (const auto& shard : registry()) {
+                for (std::size_t c = 0; c < COUNTER_COUNT; c++) {
+                    counters[c] += shard->counters[c].load(std::memory_order_relaxed);
+                }
+                for (std::size_t s = 0; s < STAGE_COUNT; s++) {
+                    for (std::size_t b = 0; b < BUCKET_COUNT; b++) {
+                        buckets[s][b] += shard->buckets[s][b].load(std::memory_order_relaxed);
+                    }
+                    sumNs[s] += shard->sumNs[s].load(std::memory_order_relaxed);
+                    count[s] += shard->count[s].load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        std::ostringstream oss;
+        const char* lastName = "";
+        for (std::size_t c = 0; c < COUNTER_COUNT; c++) {
+            const CounterInfo& info = COUNTER_INFO[c];
+            if (std::string(info.name) != lastName) {
+                oss << "# TYPE " << info.name << " counter\n";
+                lastName = info.name;
+            }
+            oss << info.name;
+            if (info.labels[0] != '\0') oss << "{" << info.labels << "}";
+            oss << " " << counters[c] << "\n";
+        }
+
+        oss << "# TYPE driveguard_stage_latency_seconds histogram\n";
+        for (std::size_t s = 0; s < STAGE_COUNT; s++) {
+            uint64_t cumulative = 0;
+            for (std::size_t b = 0; b < BUCKET_COUNT; b++) {
+                cumulative += buckets[s][b];
+                oss << "driveguard_stage_latency_seconds_bucket{stage=\"" << STAGE_NAMES[s] << "\",le=\"";
+                if (b < BUCKET_COUNT - 1) oss << BUCKET_BOUNDS_US[b] / 1e6;
+                else oss << "+Inf";
+                oss << "\"} " << cumulative << "\n";
+            }
+            oss << "driveguard_stage_latency_seconds_sum{stage=\"" << STAGE_NAMES[s] << "\"} " << sumNs[s] / 1e9 << "\n";
+            oss << "driveguard_stage_latency_seconds_count{stage=\"" << STAGE_NAMES[s] << "\"} " << count[s] << "\n";
+        }
+        return oss.str();
+    }
+
+    /**
+     * @brief 构造函数
+     * @param filePath 导出文件路径（为空则不写文件）
+     * @param socketPath Unix 域套接字路径（为空则不监听）
+     * @param intervalMs 文件导出周期（毫秒）
+     */
+    MetricsExporter::MetricsExporter(const std::string& filePath, const std::string& socketPath, int intervalMs)
+        : filePath_(filePath), socketPath_(socketPath), intervalMs_(intervalMs > 0 ? intervalMs : 1000),
+          listenFd_(-1), running_(false) {
+    }
+
+    /**
+     * @brief 析构函数（停止后台线程）
+     */
+    MetricsExporter::~MetricsExporter() {
+        stop();
+    }
+
+    /**
+     * @brief 启动后台导出线程
+     * @return 套接字创建失败时返回 false（文件导出仍会进行）
+     */
+    bool MetricsExporter::start() {
+        if (running_.exchange(true)) return true;
+
+        bool ok = true;
+        if (!socketPath_.empty()) ok = openSocket();
+        thread_ = std::thread(&MetricsExporter::run, this);
+        return ok;
+    }
+
+    /**
+     * @brief 停止后台导出线程，并最后写出一次指标文件
+     */
+    void MetricsExporter::stop() {
+        if (!running_.exchange(false)) return;
+        if (thread_.joinable()) thread_.join();
+        writeFile();
+
+#ifndef _WIN32
+        if (listenFd_ >= 0) {
+            close(listenFd_);
+            unlink(socketPath_.c_str());
+            listenFd_ = -1;
+        }
+#endif
+    }
+
+    /**
+     * @brief 后台线程：周期性写文件，其余时间等待套接字抓取请求
+     */
+    void MetricsExporter::run() {
+        const int sliceMs = 200; // 等待分片，保证 stop() 能及时返回
+        auto nextWrite = std::chrono::steady_clock::now() + std::chrono::milliseconds(intervalMs_);
+        while (running_) {
+            serveSocket(sliceMs);
+            if (std::chrono::steady_clock::now() >= nextWrite) {
+                writeFile();
+                nextWrite += std::chrono::milliseconds(intervalMs_);
+            }
+        }
+    }
+
+    /**
+     * @brief 写出指标文件（先写临时文件再重命名，读者不会看到半份内容）
+     */
+    void MetricsExporter::writeFile() {
+        if (filePath_.empty()) return;
+
+        std::string tmpPath = filePath_ + ".tmp";
+        {
+            std::ofstream ofs(tmpPath, std::ios::out | std::ios::trunc);
+            if (!ofs.is_open()) {
+                std::cerr << "[WARN] 无法写入指标文件：" << tmpPath << std::endl;
+                return;
+            }
+            ofs << Metrics::renderPrometheus();
+        }
+#ifdef _WIN32
+        // Windows 的 rename 不能覆盖已有文件；POSIX 上 rename 原子替换，抓取方始终能读到完整文件
+        std::remove(filePath_.c_str());
+#endif
+        if (std::rename(tmpPath.c_str(), filePath_.c_str()) != 0) {
+            std::cerr << "[WARN] 无法更新指标文件：" << filePath_ << std::endl;
+        }
+    }
+
+    /**
+     * @brief 创建并监听 Unix 域套接字
+     */
+    bool MetricsExporter::openSocket() {
+#ifndef _WIN32
+        sockaddr_un addr{};
+        if (socketPath_.size() >= sizeof(addr.sun_path)) {
+            std::cerr << "[ERROR] 指标套接字路径过长：" << socketPath_ << std::endl;
+            return false;
+        }
+
+        listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd_ < 0) {
+            std::cerr << "[ERROR] 无法创建指标套接字" << std::endl;
+            return false;
+        }
+
+        addr.sun_family = AF_UNIX;
+        socketPath_.copy(addr.sun_path, socketPath_.size());
+        unlink(socketPath_.c_str());
+        if (bind(listenFd_, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listenFd_, 4) != 0) {
+            std::cerr << "[ERROR] 无法监听指标套接字：" << socketPath_ << std::endl;
+            close(listenFd_);
+            listenFd_ = -1;
+            return false;
+        }
+        std::cout << "[INFO] 指标套接字已就绪：" << socketPath_ << std::endl;
+        return true;
+#else
+        std::cerr << "[WARN] 当前平台不支持 Unix 域套接字导出" << std::endl;
+        return false;
+#endif
+    }
+
+    /**
+     * @brief 等待并响应套接字抓取请求（无套接字时仅休眠）
+     */
+    void MetricsExporter::serveSocket(int timeoutMs) {
+#ifndef _WIN32
+        if (listenFd_ >= 0) {
+            pollfd pfd{listenFd_, POLLIN, 0};
+            if (poll(&pfd, 1, timeoutMs) > 0 && (pfd.revents & POLLIN)) {
+                int client = accept(listenFd_, nullptr, nullptr);
+                if (client >= 0) {
+                    // 客户端中途断开不得触发 SIGPIPE；不读取的客户端在发送时限后放弃，不阻塞导出线程
+#ifdef SO_NOSIGPIPE
+                    int on = 1;
+                    setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+                    timeval timeout{};
+                    timeout.tv_sec = SOCKET_SEND_TIMEOUT_MS / 1000;
+                    timeout.tv_usec = (SOCKET_SEND_TIMEOUT_MS % 1000) * 1000;
+                    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+                    std::string text = Metrics::renderPrometheus();
+                    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SOCKET_SEND_TIMEOUT_MS);
+                    std::size_t sent = 0;
+                    while (sent < text.size() && std::chrono::steady_clock::now() < deadline) {
+                        ssize_t n = send(client, text.data() + sent, text.size() - sent, SEND_FLAGS);
+                        if (n <= 0) break;
+                        sent += (std::size_t)n;
+                    }
+                    close(client);
+                }
+            }
+            return;
+        }
+#endif
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+    }
+}
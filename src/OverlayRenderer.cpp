@@ -0,0 +1,114 @@
+#include "OverlayRenderer.h"
+#include <cstdio>
+
+namespace DriveGuard {
+    /**
+     * @brief 构造函数
+     * @param recordMaxImages 单次录入图片数（用于显示录入进度）
+     */
+    OverlayRenderer::OverlayRenderer(int recordMaxImages) : recordMaxImages_(recordMaxImages) {
+    }
+
+    /**
+     * @brief 将帧数据包的分析结果绘制到其图像上
+     * @param packet 帧数据包
+     * @return 绘制后的图像（彩色帧为数据包中的原图，灰度帧或仍被事件记录器引用的帧为渲染器的画布，下次绘制前有效）
+     */
+    const cv::Mat& OverlayRenderer::draw(FramePacket& packet) {
+        // 亮度输入源输出灰度帧，转为 BGR 画布后才能绘制彩色标注（不改动数据包中的帧，其缓冲区随数据包复用）
+        cv::Mat* target = &packet.frame;
+        if (packet.frame.channels() == 1) {
+            cv::cvtColor(packet.frame, canvas_, cv::COLOR_GRAY2BGR);
+            target = &canvas_;
+        } else if (isFrameShared(packet.frame)) {
+            // 事件记录器尚未编码该帧（共享引用），标注画在拷贝上，录制的帧不带叠加层
+            packet.frame.copyTo(canvas_);
+            target = &canvas_;
+        }
+        cv::Mat& frame = *target;
+
+        for (const auto& result : packet.results) {
+            const cv::Rect& face = result.box;
+            cv::Scalar borderColor(0, 255, 0); // 人脸边框默认为绿色
+
+            // ===============================
+            // 分支：录入模式
+            // ===============================
+            if (packet.state == ModelState::RECORDING) {
+                borderColor = cv::Scalar(255, 0, 0); // 录入模式：人脸边框为蓝色
+
+                // 打印录入进度
+                char progress[32];
+                std::snprintf(progress, sizeof(progress), "Sample:%d/%d", packet.recordingCount, recordMaxImages_);
+                text_ = progress;
+                putText(frame, cv::Point(face.x, face.y - 20), 0.7, cv::Scalar(255, 0, 0), 2);
+            }
+            // ===============================
+            // 分支：识别模式
+            // ===============================
+            else if (packet.state == ModelState::RECOGNIZING) {
+                if (result.role == UserRole::DRIVER) {
+                    // 绘制眼睛边框
+                    for (const auto& eye : result.eyes) {
+                        cv::rectangle(frame, eye, cv::Scalar(255, 0, 0), 1);
+                    }
+
+                    // 显示驾驶员状态
+                    borderColor = DMSController::colorOf(result.driverState); // 将人脸边框设置为对应的警告颜色
+                    text_ = DMSController::warningOf(result.driverState);
+                    putText(frame, cv::Point(face.x, face.y + face.height + 30), 0.8, borderColor, 2);
+                }
+                else if (result.role == UserRole::PASSENGER) {
+                    borderColor = cv::Scalar(0, 255, 0); // 乘客边框为绿色
+                    text_ = "Passenger";
+                    putText(frame, cv::Point(face.x, face.y + face.height + 20), 0.6, cv::Scalar(0, 255, 0), 2);
+                }
+                // 如果是未知人员
+                else {
+                    borderColor = cv::Scalar(0, 0, 255); // 未知人员边框为红色
+                    text_ = "Unknown";
+                    putText(frame, cv::Point(face.x, face.y + face.height + 20), 0.6, cv::Scalar(0, 0, 255), 2);
+                }
+
+                // 绘制标签
+                char confidence[32];
+                std::snprintf(confidence, sizeof(confidence), " (confidence: %d)", (int)result.confidence);
+                text_ = result.name;
+                text_ += confidence;
+                putText(frame, cv::Point(face.x, face.y - 5), 0.6, borderColor, 2);
+            }
+
+            // 绘制人脸框
+            cv::rectangle(frame, face, borderColor, 2);
+        }
+
+        // 屏幕状态提示
+        if (packet.state == ModelState::DETECTING) {
+            text_ = "System Ready. Press 'R' to Register Driver.";
+            putText(frame, cv::Point(10, 30), 0.6, cv::Scalar(255, 255, 255), 1);
+        } else if (packet.state == ModelState::RECOGNIZING) {
+            text_ = "DMS Monitoring Active";
+            putText(frame, cv::Point(10, 30), 0.6, cv::Scalar(0, 255, 0), 2);
+        }
+
+        // 录入倒计时与后台训练提示（不影响监测）
+        if (packet.countdown > 0) {
+            char countdown[64];
+            std::snprintf(countdown, sizeof(countdown), "Recording in %ds, look at the camera", packet.countdown);
+            text_ = countdown;
+            putText(frame, cv::Point(10, 55), 0.6, cv::Scalar(255, 0, 0), 2);
+        } else if (packet.training) {
+            text_ = "Training new model...";
+            putText(frame, cv::Point(10, 55), 0.6, cv::Scalar(0, 0, 255), 2);
+        }
+        return frame;
+    }
+
+    /**
+     * @brief 以 text_ 为内容绘制一行文字
+     */
+    void OverlayRenderer::putText(cv::Mat& image, const cv::Point& origin, double scale, const cv::Scalar& color,
+                                  int thickness) {
+        cv::putText(image, text_, origin, cv::FONT_HERSHEY_SIMPLEX, scale, color, thickness);
+    }
+}
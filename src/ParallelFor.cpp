@@ -0,0 +1,147 @@
+#include "ParallelFor.h"
+#include "AllocationExemption.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DriveGuard {
+    namespace {
+        // 当前线程是否正在执行并行任务体（嵌套调用串行执行）
+        thread_local bool insideJob = false;
+
+        /**
+         * @brief 常驻工作线程（进程内唯一，首次并行调用时创建）
+         */
+        class WorkerPool {
+        public:
+            static WorkerPool& instance() {
+                static WorkerPool pool;
+                return pool;
+            }
+
+            ~WorkerPool() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stopping_ = true;
+                }
+                wake_.notify_all();
+                for (auto& thread : threads_) {
+                    if (thread.joinable()) thread.join();
+                }
+            }
+
+            void run(int count, parallel::RangeFunction function, const void* body) {
+                std::unique_lock<std::mutex> job(jobMutex_, std::try_to_lock);
+                if (!job.owns_lock() || !start()) {
+                    function(body, cv::Range(0, count));
+                    return;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    function_ = function;
+                    body_ = body;
+                    count_ = count;
+                    next_.store(0, std::memory_order_relaxed);
+                    tracked_ = allocationTracked;
+                    exempt_ = allocationExempt;
+                    pending_ = threads_.size();
+                    generation_++;
+                }
+                wake_.notify_all();
+
+                execute();
+
+                std::unique_lock<std::mutex> lock(mutex_);
+                done_.wait(lock, [this] { return pending_ == 0; });
+            }
+
+        private:
+            /**
+             * @brief 按 cv::getNumThreads() 创建工作线程（只在首次调用时创建；单线程配置下返回 false）
+             */
+            bool start() {
+                if (!threads_.empty()) return true;
+                if (started_) return false;
+                started_ = true;
+                int workers = cv::getNumThreads() - 1;
+                if (workers <= 0) return false;
+
+                // 一次性的线程创建，之后的并行循环不再分配
+                AllocationExemption startup;
+                threads_.reserve(workers);
+                for (int i = 0; i < workers; i++) {
+                    threads_.emplace_back(&WorkerPool::work, this);
+                }
+                return true;
+            }
+
+            void work() {
+                uint64_t seen = 0;
+                for (;;) {
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+                        if (stopping_) return;
+                        seen = generation_;
+                    }
+
+                    allocationTracked = tracked_;
+                    allocationExempt = exempt_;
+                    execute();
+                    allocationTracked = false;
+                    allocationExempt = false;
+
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (--pending_ == 0) done_.notify_one();
+                }
+            }
+
+            /**
+             * @brief 逐个领取下标执行任务体，直到全部领完
+             */
+            void execute() {
+                insideJob = true;
+                for (int i = next_.fetch_add(1); i < count_; i = next_.fetch_add(1)) {
+                    function_(body_, cv::Range(i, i + 1));
+                }
+                insideJob = false;
+            }
+
+            std::mutex jobMutex_;              // 同一时刻只执行一个并行循环
+            std::mutex mutex_;
+            std::condition_variable wake_;
+            std::condition_variable done_;
+            std::vector<std::thread> threads_;
+            bool started_ = false;
+            bool stopping_ = false;
+            uint64_t generation_ = 0;          // 每次并行循环加一，唤醒工作线程
+            std::size_t pending_ = 0;          // 尚未完成本次循环的工作线程数
+
+            // 当前循环（generation_ 变化前由 mutex_ 发布）
+            parallel::RangeFunction function_ = nullptr;
+            const void* body_ = nullptr;
+            int count_ = 0;
+            std::atomic<int> next_{0};
+            bool tracked_ = false;
+            bool exempt_ = false;
+        };
+    }
+
+    namespace parallel {
+        /**
+         * @brief 在常驻工作线程上执行 [0, count) 的并行循环
+         */
+        void run(int count, RangeFunction function, const void* body) {
+            if (count <= 0) return;
+            if (count == 1 || insideJob) {
+                function(body, cv::Range(0, count));
+                return;
+            }
+            WorkerPool::instance().run(count, function, body);
+        }
+    }
+}
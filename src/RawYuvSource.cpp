@@ -0,0 +1,102 @@
+#include "RawYuvSource.h"
+#include <iostream>
+#include <thread>
+
+namespace DriveGuard {
+    // 构造函数
+    RawYuvSource::RawYuvSource() : format_(PixelFormat::GREY), fps_(0.0), frameBytes_(0) {
+    }
+
+    /**
+     * @brief 打开原始 YUV 文件
+     * @param path 文件路径
+     * @param size 帧尺寸
+     * @param format 像素格式
+     * @param fps 输出帧率（<=0 表示不限速的离线回放）
+     * @return 打开成功返回 true
+     */
+    bool RawYuvSource::open(const std::string& path, const cv::Size& size, PixelFormat format, double fps) {
+        release();
+        if (size.width <= 0 || size.height <= 0 || size.width % 2 != 0 || size.height % 2 != 0) {
+            std::cerr << "[ERROR] 原始 YUV 帧尺寸无效（宽高须为正偶数）：" << size.width << "x" << size.height << std::endl;
+            return false;
+        }
+
+        file_.open(path, std::ios::in | std::ios::binary);
+        if (!file_.is_open()) {
+            std::cerr << "[ERROR] 无法打开原始 YUV 文件：" << path << std::endl;
+            return false;
+        }
+
+        path_ = path;
+        size_ = size;
+        format_ = format;
+        fps_ = fps;
+        std::size_t luma = (std::size_t)size.area();
+        switch (format) {
+            case PixelFormat::GREY: frameBytes_ = luma; break;
+            case PixelFormat::NV12:
+            case PixelFormat::I420: frameBytes_ = luma * 3 / 2; break;
+            case PixelFormat::YUYV: frameBytes_ = luma * 2; break;
+        }
+        nextFrame_ = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    /**
+     * @brief 读取下一帧的亮度平面
+     * @param frame 输出灰度帧（CV_8UC1）
+     * @return 文件结束返回 false
+     */
+    bool RawYuvSource::read(cv::Mat& frame) {
+        if (!file_.is_open()) return false;
+
+        // 按帧率节拍输出，模拟摄像头
+        if (fps_ > 0.0) {
+            std::this_thread::sleep_until(nextFrame_);
+            nextFrame_ += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / fps_));
+        }
+
+        // 尺寸相符时复用调用方的缓冲区（流水线传入帧池回收的缓冲区，不再被其他阶段引用）
+        if (frame.u == nullptr || frame.allocator != nullptr || !frame.isContinuous()) frame.release();
+        frame.create(size_, CV_8UC1);
+        if (format_ == PixelFormat::YUYV) {
+            packed_.resize(frameBytes_);
+            if (!file_.read((char*)packed_.data(), (std::streamsize)frameBytes_)) return false;
+            cv::Mat packed(size_, CV_8UC2, packed_.data());
+            cv::extractChannel(packed, frame, 0);
+        } else {
+            std::size_t lumaBytes = frame.total();
+            if (!file_.read((char*)frame.data, (std::streamsize)lumaBytes)) return false;
+            // 跳过色度平面
+            if (frameBytes_ > lumaBytes) file_.seekg((std::streamoff)(frameBytes_ - lumaBytes), std::ios::cur);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 指定帧率时视为实时输入
+     */
+    bool RawYuvSource::isLive() const {
+        return fps_ > 0.0;
+    }
+
+    /**
+     * @brief 输入源描述（用于日志）
+     */
+    std::string RawYuvSource::describe() const {
+        std::string description = "原始 YUV 文件 " + path_ + " (" + std::to_string(size_.width) + "x"
+                                + std::to_string(size_.height) + " " + FrameSource::pixelFormatName(format_);
+        if (fps_ > 0.0) description += " @" + std::to_string((int)fps_) + "fps";
+        return description + ")";
+    }
+
+    /**
+     * @brief 释放输入源
+     */
+    void RawYuvSource::release() {
+        if (file_.is_open()) file_.close();
+        packed_.clear();
+    }
+}
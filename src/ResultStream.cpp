@@ -0,0 +1,190 @@
+#include "ResultStream.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace DriveGuard {
+    namespace {
+#ifndef _WIN32
+#ifdef MSG_NOSIGNAL
+        const int SEND_FLAGS = MSG_DONTWAIT | MSG_NOSIGNAL;
+#else
+        const int SEND_FLAGS = MSG_DONTWAIT; // macOS：以 SO_NOSIGPIPE 避免 SIGPIPE
+#endif
+
+        bool setNonBlocking(int fd) {
+            int flags = fcntl(fd, F_GETFL, 0);
+            return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+        }
+#endif
+
+        int16_t clampCoord(int value) {
+            return (int16_t)std::min(32767, std::max(-32768, value));
+        }
+    }
+
+    /**
+     * @brief 构造函数
+     * @param socketPath Unix 域套接字路径
+     */
+    ResultStream::ResultStream(const std::string& socketPath) : socketPath_(socketPath), listenFd_(-1) {
+    }
+
+    /**
+     * @brief 析构函数（关闭所有连接并删除套接字文件）
+     */
+    ResultStream::~ResultStream() {
+        stop();
+    }
+
+    /**
+     * @brief 创建并监听套接字
+     * @return 套接字创建失败或平台不支持时返回 false
+     */
+    bool ResultStream::start() {
+#ifndef _WIN32
+        if (listenFd_ >= 0) return true;
+
+        sockaddr_un addr{};
+        if (socketPath_.size() >= sizeof(addr.sun_path)) {
+            std::cerr << "[ERROR] 结果流套接字路径过长：" << socketPath_ << std::endl;
+            return false;
+        }
+
+        listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd_ < 0) {
+            std::cerr << "[ERROR] 无法创建结果流套接字" << std::endl;
+            return false;
+        }
+
+        addr.sun_family = AF_UNIX;
+        socketPath_.copy(addr.sun_path, socketPath_.size());
+        unlink(socketPath_.c_str());
+        if (bind(listenFd_, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listenFd_, 8) != 0
+            || !setNonBlocking(listenFd_)) {
+            std::cerr << "[ERROR] 无法监听结果流套接字：" << socketPath_ << std::endl;
+            close(listenFd_);
+            listenFd_ = -1;
+            return false;
+        }
+        std::cout << "[INFO] 结果流套接字已就绪：" << socketPath_ << std::endl;
+        return true;
+#else
+        std::cerr << "[WARN] 当前平台不支持 Unix 域套接字结果流" << std::endl;
+        return false;
+#endif
+    }
+
+    /**
+     * @brief 关闭所有连接并删除套接字文件
+     */
+    void ResultStream::stop() {
+#ifndef _WIN32
+        for (int client : clients_) close(client);
+        clients_.clear();
+        if (listenFd_ >= 0) {
+            close(listenFd_);
+            unlink(socketPath_.c_str());
+            listenFd_ = -1;
+        }
+#endif
+    }
+
+    /**
+     * @brief 接受新的订阅者并发布一帧结果（由结果消费线程调用）
+     * @param stream 输入路编号
+     * @param packet 已分析的帧数据包
+     */
+    void ResultStream::publish(uint8_t stream, const FramePacket& packet) {
+#ifndef _WIN32
+        if (listenFd_ < 0) return;
+        acceptClients();
+        if (clients_.empty()) return;
+
+        // 组装消息：帧头 + 人脸数组（缓冲区逐帧复用）
+        std::size_t faceCount = std::min<std::size_t>(packet.results.size(), UINT16_MAX);
+        message_.resize(sizeof(ResultFrameHeader) + faceCount * sizeof(ResultFace));
+
+        ResultFrameHeader header{};
+        header.magic = RESULT_STREAM_MAGIC;
+        header.version = RESULT_STREAM_VERSION;
+        header.faceCount = (uint16_t)faceCount;
+        header.seq = packet.seq;
+        header.captureTimeUs = toUnixMicros(packet.captureTime);
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - packet.captureTime).count();
+        header.latencyUs = (uint32_t)std::min<int64_t>(std::max<int64_t>(latency, 0), UINT32_MAX);
+        header.stream = stream;
+        header.state = (uint8_t)packet.state;
+        std::memcpy(message_.data(), &header, sizeof(header));
+
+        unsigned char* out = message_.data() + sizeof(ResultFrameHeader);
+        for (std::size_t i = 0; i < faceCount; i++) {
+            const FaceResult& result = packet.results[i];
+            ResultFace face{};
+            face.x = clampCoord(result.box.x);
+            face.y = clampCoord(result.box.y);
+            face.width = clampCoord(result.box.width);
+            face.height = clampCoord(result.box.height);
+            face.trackId = result.trackId;
+            face.label = result.identified ? result.label : -1;
+            face.confidence = (float)result.confidence;
+            face.role = (uint8_t)result.role;
+            face.driverState = (uint8_t)result.driverState;
+            face.eyeCount = (uint8_t)std::min<std::size_t>(result.eyes.size(), UINT8_MAX);
+            std::memcpy(out + i * sizeof(ResultFace), &face, sizeof(face));
+        }
+
+        // 非阻塞发送：发送缓冲区满则该帧对此订阅者跳过；只写出部分或连接已断开则关闭
+        for (std::size_t i = 0; i < clients_.size();) {
+            ssize_t n = send(clients_[i], message_.data(), message_.size(), SEND_FLAGS);
+            if (n == (ssize_t)message_.size()) {
+                i++;
+                continue;
+            }
+            Metrics::increment(Counter::RESULTS_DROPPED);
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                i++;
+                continue;
+            }
+            close(clients_[i]);
+            clients_[i] = clients_.back();
+            clients_.pop_back();
+            std::cout << "[INFO] 结果流订阅者已断开，剩余 " << clients_.size() << " 个" << std::endl;
+        }
+#else
+        (void)stream;
+        (void)packet;
+#endif
+    }
+
+    /**
+     * @brief 接受所有等待中的连接（监听套接字非阻塞，无新连接时立即返回）
+     */
+    void ResultStream::acceptClients() {
+#ifndef _WIN32
+        while (true) {
+            int client = accept(listenFd_, nullptr, nullptr);
+            if (client < 0) return;
+            if (!setNonBlocking(client)) {
+                close(client);
+                continue;
+            }
+#ifdef SO_NOSIGPIPE
+            int on = 1;
+            setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+            clients_.push_back(client);
+            std::cout << "[INFO] 结果流新订阅者，共 " << clients_.size() << " 个" << std::endl;
+        }
+#endif
+    }
+}
@@ -0,0 +1,121 @@
+#include "SampleSelector.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace DriveGuard {
+    /**
+     * @brief 构造函数
+     * @param config 筛选配置
+     */
+    SampleSelector::SampleSelector(const SampleSelectorConfig& config) : config_(config) {
+    }
+
+    /**
+     * @brief 评估一张采集的人脸
+     * @param face 人脸样本
+     * @param quality 输出质量
+     * @return 样本合格时返回 true（筛选关闭时总是返回 true）
+     */
+    bool SampleSelector::assess(FaceSample& face, SampleQuality& quality) {
+        quality = SampleQuality();
+        quality.faceSize = std::min(face.box().width, face.box().height);
+        if (!config_.enabled) {
+            quality.score = 1.0;
+            return true;
+        }
+
+        // 在统一尺寸的人脸上计算，不同距离的人脸之间可比
+        const cv::Mat& sample = face.normalized();
+        cv::Scalar mean, stddev;
+        cv::meanStdDev(sample, mean, stddev);
+        quality.brightness = mean[0];
+        quality.contrast = stddev[0];
+        cv::Laplacian(sample, laplacian_, CV_16S);
+        cv::meanStdDev(laplacian_, mean, stddev);
+        quality.sharpness = stddev[0] * stddev[0];
+
+        if (quality.sharpness < config_.minSharpness || quality.brightness < config_.minBrightness
+            || quality.brightness > config_.maxBrightness || quality.contrast < config_.minContrast
+            || quality.faceSize < config_.minFaceSize) {
+            return false;
+        }
+
+        // 各项在达到下限的数倍后不再加分，清晰度权重最高（模糊样本会拉低整个身份的匹配距离）
+        double sharpness = std::min(quality.sharpness / (4.0 * std::max(config_.minSharpness, 1.0)), 1.0);
+        double exposure = 1.0 - std::min(std::abs(quality.brightness - 128.0) / 128.0, 1.0);
+        double contrast = std::min(quality.contrast / 64.0, 1.0);
+        double size = std::min(quality.faceSize / (2.0 * std::max(config_.minFaceSize, 1)), 1.0);
+        quality.score = 0.4 * sharpness + 0.2 * exposure + 0.2 * contrast + 0.2 * size;
+        return true;
+    }
+
+    /**
+     * @brief 从采集的样本中选出保留的样本（原地筛选，保留的样本维持采集顺序）
+     * @param images 统一尺寸的灰度人脸样本
+     * @param scores 与 images 一一对应的质量评分
+     * @param params 识别模型的 LBP 参数（与图库距离同一尺度）
+     * @return 剔除的近似重复样本数
+     */
+    std::size_t SampleSelector::select(std::vector<cv::Mat>& images, std::vector<double>& scores, const LBPParams& params) {
+        std::size_t count = images.size();
+        if (!config_.enabled || count <= 1 || scores.size() != count) return 0;
+
+        LBPFeatureExtractor extractor(params);
+        histograms_.resize(count);
+        for (std::size_t i = 0; i < count; i++) {
+            if (!extractor.compute(images[i], histograms_[i])) return 0;
+        }
+
+        // 先取评分最高的样本，之后每次取 评分 x 与已选样本的最近距离 最大者（质量加权的最远点采样），
+        // 与已选样本过近的视为近似重复，不再参与选择
+        std::vector<double> nearest(count, DBL_MAX);
+        std::vector<bool> chosen(count, false);
+        std::size_t limit = config_.maxSamples > 0 ? (std::size_t)config_.maxSamples : count;
+        std::size_t next = (std::size_t)(std::max_element(scores.begin(), scores.end()) - scores.begin());
+        std::size_t selected = 0;
+        while (true) {
+            chosen[next] = true;
+            selected++;
+            if (selected >= limit) break;
+
+            const cv::Mat& last = histograms_[next];
+            double bestGain = -1.0;
+            for (std::size_t i = 0; i < count; i++) {
+                if (chosen[i]) continue;
+                nearest[i] = std::min(nearest[i], cv::compareHist(histograms_[i], last, cv::HISTCMP_CHISQR_ALT));
+                if (nearest[i] < config_.duplicateDistance) continue;
+                double gain = scores[i] * nearest[i];
+                if (gain > bestGain) {
+                    bestGain = gain;
+                    next = i;
+                }
+            }
+            if (bestGain < 0.0) break;
+        }
+
+        std::size_t duplicates = 0;
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            if (!chosen[i]) {
+                if (nearest[i] < config_.duplicateDistance) duplicates++;
+                continue;
+            }
+            if (kept != i) {
+                images[kept] = std::move(images[i]);
+                scores[kept] = scores[i];
+            }
+            kept++;
+        }
+        images.resize(kept);
+        scores.resize(kept);
+        return duplicates;
+    }
+
+    /**
+     * @brief 筛选配置
+     */
+    const SampleSelectorConfig& SampleSelector::config() const {
+        return config_;
+    }
+}
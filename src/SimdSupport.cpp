@@ -0,0 +1,53 @@
+#include "SimdSupport.h"
+#include "simd/SimdConfig.h"
+#include <opencv2/opencv.hpp>
+
+namespace DriveGuard {
+    /**
+     * @brief 当前 CPU 与构建配置是否支持指定级别
+     */
+    bool isSimdAvailable(SimdLevel level) {
+        switch (level) {
+            case SimdLevel::AUTO:
+            case SimdLevel::SCALAR:
+                return true;
+#if defined(DRIVEGUARD_SIMD_X86)
+            case SimdLevel::SSE41:
+                return cv::checkHardwareSupport(CV_CPU_SSE4_1);
+            case SimdLevel::AVX2:
+                return cv::checkHardwareSupport(CV_CPU_AVX2);
+#endif
+#if defined(DRIVEGUARD_SIMD_NEON)
+            case SimdLevel::NEON:
+                return true;
+#endif
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @brief 解析指令集级别（AUTO 或不可用时返回当前 CPU 上最快的可用级别）
+     */
+    SimdLevel resolveSimdLevel(SimdLevel level) {
+        if (level != SimdLevel::AUTO && isSimdAvailable(level)) return level;
+        if (isSimdAvailable(SimdLevel::AVX2)) return SimdLevel::AVX2;
+        if (isSimdAvailable(SimdLevel::SSE41)) return SimdLevel::SSE41;
+        if (isSimdAvailable(SimdLevel::NEON)) return SimdLevel::NEON;
+        return SimdLevel::SCALAR;
+    }
+
+    /**
+     * @brief 指令集级别名称
+     */
+    const char* simdLevelName(SimdLevel level) {
+        switch (level) {
+            case SimdLevel::AUTO: return "auto";
+            case SimdLevel::SCALAR: return "scalar";
+            case SimdLevel::SSE41: return "sse4.1";
+            case SimdLevel::AVX2: return "avx2";
+            case SimdLevel::NEON: return "neon";
+        }
+        return "unknown";
+    }
+}
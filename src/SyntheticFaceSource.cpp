@@ -0,0 +1,128 @@
+#include "SyntheticFaceSource.h"
+#include <algorithm>
+
+namespace DriveGuard {
+    namespace {
+        // 背景灰度
+        const int BACKGROUND = 90;
+        // 模糊的标准差（去掉绘制的锐利边缘，接近摄像头画面）
+        const double BLUR_SIGMA = 1.5;
+    }
+
+    /**
+     * @brief 构造函数
+     * @param frames 帧数
+     * @param script 按帧序号（从 0 开始）给出人脸外观
+     * @param size 画面尺寸
+     * @param faceSize 人脸尺寸（像素，检出的人脸框约为其 1.15 倍）
+     */
+    SyntheticFaceSource::SyntheticFaceSource(long frames, Script script, cv::Size size, int faceSize)
+        : frames_(frames), index_(0), script_(std::move(script)), size_(size), faceSize_(faceSize) {
+    }
+
+    /**
+     * @brief 按脚本绘制下一帧
+     * @param frame 输出 BGR 图像帧（尺寸不变时原地覆盖）
+     * @return 帧数用完返回 false
+     */
+    bool SyntheticFaceSource::read(cv::Mat& frame) {
+        if (index_ >= frames_) return false;
+        SyntheticFrame appearance = script_ ? script_(index_) : SyntheticFrame();
+        index_++;
+
+        canvas_.create(size_, CV_8UC3);
+        canvas_.setTo(cv::Scalar::all(BACKGROUND));
+        if (appearance.faceVisible) {
+            cv::Point center(size_.width / 2 + appearance.offset.x, size_.height / 2 + appearance.offset.y);
+            drawFace(canvas_, center, faceSize_, appearance.eyesOpen);
+        }
+        cv::GaussianBlur(canvas_, frame, cv::Size(), BLUR_SIGMA);
+        return true;
+    }
+
+    /**
+     * @brief 合成画面为离线输入（逐帧处理）
+     */
+    bool SyntheticFaceSource::isLive() const {
+        return false;
+    }
+
+    /**
+     * @brief 输入源描述
+     */
+    std::string SyntheticFaceSource::describe() const {
+        return "synthetic:" + std::to_string(frames_) + "@" + std::to_string(size_.width) + "x" + std::to_string(size_.height);
+    }
+
+    /**
+     * @brief 结束输入
+     */
+    void SyntheticFaceSource::release() {
+        index_ = frames_;
+    }
+
+    /**
+     * @brief 在 BGR 画面上绘制一张人脸（各部位比例按级联检出的稳定性选取）
+     * @param canvas BGR 画面
+     * @param center 人脸中心
+     * @param faceSize 人脸尺寸（像素）
+     * @param eyesOpen 睁眼或闭眼
+     */
+    void SyntheticFaceSource::drawFace(cv::Mat& canvas, cv::Point center, int faceSize, bool eyesOpen) {
+        const double s = faceSize;
+        auto px = [s](double ratio) { return (int)(s * ratio); };
+        const int stroke = std::max(1, px(0.012));
+
+        // 脸型
+        cv::ellipse(canvas, center, cv::Size(px(0.40), px(0.52)), 0, 0, 360, cv::Scalar(150, 170, 200), cv::FILLED);
+
+        for (int side : {-1, 1}) {
+            cv::Point eye(center.x + side * px(0.18), center.y - px(0.08));
+            // 眉毛
+            cv::ellipse(canvas, cv::Point(eye.x, eye.y - px(0.09)), cv::Size(px(0.10), px(0.025)),
+                        0, 180, 360, cv::Scalar(40, 40, 60), cv::FILLED);
+            if (eyesOpen) {
+                // 眼白、瞳孔与上眼睑
+                cv::ellipse(canvas, eye, cv::Size(px(0.085), px(0.045)), 0, 0, 360, cv::Scalar(235, 235, 235), cv::FILLED);
+                cv::circle(canvas, eye, px(0.038), cv::Scalar(40, 30, 30), cv::FILLED);
+                cv::ellipse(canvas, eye, cv::Size(px(0.085), px(0.045)), 0, 180, 360, cv::Scalar(50, 50, 70), stroke);
+            } else {
+                // 闭合的眼睑
+                cv::ellipse(canvas, eye, cv::Size(px(0.085), px(0.02)), 0, 0, 180, cv::Scalar(70, 70, 90), stroke);
+            }
+        }
+
+        // 鼻子与嘴
+        cv::ellipse(canvas, cv::Point(center.x, center.y + px(0.12)), cv::Size(px(0.05), px(0.03)),
+                    0, 0, 360, cv::Scalar(110, 125, 160), cv::FILLED);
+        cv::ellipse(canvas, cv::Point(center.x, center.y + px(0.30)), cv::Size(px(0.13), px(0.035)),
+                    0, 0, 360, cv::Scalar(70, 70, 140), cv::FILLED);
+    }
+
+    /**
+     * @brief 采集合成人脸的统一尺寸灰度样本（睁眼与闭眼交替、位置略有偏移），用于在内存中录入
+     * @param detector 人脸检测器
+     * @param count 采集的帧数（检不出唯一人脸的帧跳过）
+     * @return 统一尺寸灰度人脸列表
+     */
+    std::vector<cv::Mat> SyntheticFaceSource::enrollmentSamples(FaceDetector& detector, int count) {
+        SyntheticFaceSource source(count, [](long index) {
+            SyntheticFrame appearance;
+            appearance.eyesOpen = index % 2 == 0;
+            appearance.offset = cv::Point((int)(index % 5) * 4 - 8, (int)(index % 3) * 4 - 4);
+            return appearance;
+        });
+
+        std::vector<cv::Mat> samples;
+        FrameContext context;
+        cv::Mat frame;
+        std::vector<cv::Rect> faces;
+        while (source.read(frame)) {
+            context.prepare(frame);
+            detector.detect(context, faces);
+            if (faces.size() != 1) continue;
+            samples.push_back(context.addFace(faces[0], -1).normalized().clone());
+        }
+        return samples;
+    }
+}
@@ -0,0 +1,110 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+namespace DriveGuard {
+    namespace {
+        // 当前线程所属的线程池与工作线程序号（非工作线程为 nullptr）
+        thread_local const ThreadPool* currentPool = nullptr;
+        thread_local std::size_t currentIndex = 0;
+    }
+
+    /**
+     * @brief 构造函数
+     * @param threads 工作线程数，0 表示取硬件并发数
+     */
+    ThreadPool::ThreadPool(std::size_t threads) : pending_(0), next_(0), stopping_(false) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for (std::size_t i = 0; i < threads; i++) {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+        for (std::size_t i = 0; i < threads; i++) {
+            threads_.emplace_back(&ThreadPool::run, this, i);
+        }
+    }
+
+    /**
+     * @brief 析构函数（执行完已提交的任务后停止）
+     */
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& thread : threads_) {
+            if (thread.joinable()) thread.join();
+        }
+    }
+
+    /**
+     * @brief 提交任务（线程安全）
+     * @param task 任务（抛出的异常会被记录并忽略）
+     */
+    void ThreadPool::submit(Task task) {
+        // 工作线程内提交的任务留在本线程队列（数据仍在缓存中），外部提交轮流分配
+        // 先计数再入队，保证取走任务时计数不会下溢
+        std::size_t index = currentPool == this ? currentIndex : next_.fetch_add(1) % workers_.size();
+        pending_++;
+        {
+            std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+            workers_[index]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+        }
+        wake_.notify_one();
+    }
+
+    /**
+     * @brief 工作线程数
+     */
+    std::size_t ThreadPool::size() const {
+        return workers_.size();
+    }
+
+    /**
+     * @brief 工作线程：优先执行本线程队列的任务，为空时窃取，均无任务时休眠
+     */
+    void ThreadPool::run(std::size_t index) {
+        currentPool = this;
+        currentIndex = index;
+
+        Task task;
+        while (true) {
+            if (take(index, task)) {
+                pending_--;
+                try {
+                    task();
+                } catch (const std::exception& e) {
+                    std::cerr << "[ERROR] 线程池任务异常：" << e.what() << std::endl;
+                } catch (...) {
+                    std::cerr << "[ERROR] 线程池任务异常" << std::endl;
+                }
+                task = nullptr;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wake_.wait(lock, [this] { return pending_ > 0 || stopping_; });
+            if (stopping_ && pending_ == 0) return;
+        }
+    }
+
+    /**
+     * @brief 取任务：先取本线程队列头部，再依次从其他线程队列头部窃取
+     */
+    bool ThreadPool::take(std::size_t index, Task& task) {
+        for (std::size_t i = 0; i < workers_.size(); i++) {
+            Worker& worker = *workers_[(index + i) % workers_.size()];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (!worker.tasks.empty()) {
+                task = std::move(worker.tasks.front());
+                worker.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+}
@@ -0,0 +1,349 @@
+#include "V4L2Source.h"
+#include <iostream>
+
+#ifdef __linux__
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <linux/videodev2.h>
+#endif
+
+namespace DriveGuard {
+#ifdef __linux__
+    namespace {
+        // 驱动缓冲区数（须大于流水线中同时存在的帧数：各阶段队列容量之和加上正在处理与显示的帧）
+        const unsigned int BUFFER_COUNT = 12;
+        // 等待新帧的超时（毫秒），超时返回空帧由上层跳过
+        const int POLL_TIMEOUT_MS = 1000;
+
+        int xioctl(int fd, unsigned long request, void* arg) {
+            int result;
+            do {
+                result = ioctl(fd, request, arg);
+            } while (result == -1 && errno == EINTR);
+            return result;
+        }
+
+        uint32_t fourccOf(PixelFormat format) {
+            switch (format) {
+                case PixelFormat::GREY: return V4L2_PIX_FMT_GREY;
+                case PixelFormat::NV12: return V4L2_PIX_FMT_NV12;
+                case PixelFormat::I420: return V4L2_PIX_FMT_YUV420;
+                case PixelFormat::YUYV: return V4L2_PIX_FMT_YUYV;
+            }
+            return V4L2_PIX_FMT_GREY;
+        }
+    }
+
+    struct V4L2Device;
+
+    /**
+     * @brief 借给流水线的驱动缓冲区（每个缓冲区一份，打开设备时创建，之后反复借出，取帧时不再分配内存）
+     */
+    struct BufferLease {
+        cv::UMatData data;                   // 包装该缓冲区的 cv::Mat 引用计数
+        std::shared_ptr<V4L2Device> device;  // 借出期间持有设备，全部归还后设备才可关闭
+        unsigned int index;
+
+        BufferLease(const cv::MatAllocator* allocator, unsigned int bufferIndex) : data(allocator), index(bufferIndex) {}
+    };
+
+    /**
+     * @brief 设备句柄与映射的驱动缓冲区
+     * 由输入源与所有未归还的帧共同持有，最后一个持有者释放时解除映射并关闭设备。
+     */
+    struct V4L2Device {
+        int fd = -1;
+        std::vector<std::pair<void*, std::size_t>> buffers;
+        std::vector<std::unique_ptr<BufferLease>> leases;
+        std::atomic<bool> streaming{false};
+
+        ~V4L2Device() {
+            for (auto& buffer : buffers) munmap(buffer.first, buffer.second);
+            if (fd >= 0) close(fd);
+        }
+
+        /**
+         * @brief 将缓冲区归还驱动（停止采集后不再归还）
+         */
+        void requeue(unsigned int index) {
+            if (!streaming) return;
+            v4l2_buffer buf{};
+            buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            buf.memory = V4L2_MEMORY_MMAP;
+            buf.index = index;
+            if (xioctl(fd, VIDIOC_QBUF, &buf) < 0) {
+                std::cerr << "[WARN] V4L2 缓冲区归还失败：" << std::strerror(errno) << std::endl;
+            }
+        }
+    };
+
+    namespace {
+        /**
+         * @brief 包装驱动缓冲区的 cv::Mat 分配器：最后一个引用释放时归还缓冲区而不是释放内存
+         * （其余分配请求交给 OpenCV 默认分配器）
+         */
+        class LeaseAllocator : public cv::MatAllocator {
+        public:
+            cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                                   cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override {
+                return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+            }
+
+            bool allocate(cv::UMatData* data, cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override {
+                return cv::Mat::getStdAllocator()->allocate(data, flags, usageFlags);
+            }
+
+            void deallocate(cv::UMatData* data) const override {
+                if (!data) return;
+                BufferLease* lease = (BufferLease*)data->userdata;
+                // 先取走设备引用：若这是最后一个持有者，设备（连同租约本身）在归还后随之释放
+                std::shared_ptr<V4L2Device> device = std::move(lease->device);
+                device->requeue(lease->index);
+            }
+        };
+
+        LeaseAllocator& leaseAllocator() {
+            static LeaseAllocator allocator;
+            return allocator;
+        }
+
+        /**
+         * @brief 以驱动缓冲区中的亮度平面构造 cv::Mat（不拷贝）
+         */
+        cv::Mat wrapBuffer(const std::shared_ptr<V4L2Device>& device, unsigned int index, unsigned char* data,
+                           const cv::Size& size, std::size_t step) {
+            cv::Mat frame(size, CV_8UC1, data, step);
+            BufferLease& lease = *device->leases[index];
+            lease.device = device;
+            cv::UMatData* u = &lease.data;
+            u->data = u->origdata = data;
+            u->size = step * size.height;
+            u->refcount = 1;
+            u->userdata = &lease;
+            frame.u = u;
+            frame.allocator = &leaseAllocator();
+            return frame;
+        }
+    }
+#else
+    struct V4L2Device {};
+#endif
+
+    // 构造函数
+    V4L2Source::V4L2Source() : format_(PixelFormat::GREY), bytesPerLine_(0) {
+    }
+
+    // 析构函数
+    V4L2Source::~V4L2Source() {
+        release();
+    }
+
+    /**
+     * @brief 打开设备并开始流式采集
+     * @param device 设备路径（如 /dev/video0）
+     * @param size 请求的帧尺寸（为空则使用驱动当前设置）
+     * @param format 请求的像素格式（autoFormat 为 true 时依次尝试 NV12、I420、GREY、YUYV）
+     * @param autoFormat 是否自动选择像素格式
+     * @return 打开成功返回 true
+     */
+    bool V4L2Source::open(const std::string& device, const cv::Size& size, PixelFormat format, bool autoFormat) {
+        release();
+#ifdef __linux__
+        auto dev = std::make_shared<V4L2Device>();
+        dev->fd = ::open(device.c_str(), O_RDWR | O_NONBLOCK);
+        if (dev->fd < 0) {
+            std::cerr << "[ERROR] 无法打开 V4L2 设备：" << device << "（" << std::strerror(errno) << "）" << std::endl;
+            return false;
+        }
+
+        v4l2_capability capability{};
+        if (xioctl(dev->fd, VIDIOC_QUERYCAP, &capability) < 0) {
+            std::cerr << "[ERROR] 不是 V4L2 设备：" << device << std::endl;
+            return false;
+        }
+        uint32_t caps = (capability.capabilities & V4L2_CAP_DEVICE_CAPS) ? capability.device_caps : capability.capabilities;
+        if (!(caps & V4L2_CAP_VIDEO_CAPTURE) || !(caps & V4L2_CAP_STREAMING)) {
+            std::cerr << "[ERROR] V4L2 设备不支持视频采集或流式 I/O：" << device << std::endl;
+            return false;
+        }
+
+        // 选择像素格式（只接受 Y 平面可直接使用的格式）
+        std::vector<PixelFormat> candidates = autoFormat
+            ? std::vector<PixelFormat>{PixelFormat::NV12, PixelFormat::I420, PixelFormat::GREY, PixelFormat::YUYV}
+            : std::vector<PixelFormat>{format};
+        v4l2_format fmt{};
+        bool selected = false;
+        for (PixelFormat candidate : candidates) {
+            fmt = v4l2_format{};
+            fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            if (xioctl(dev->fd, VIDIOC_G_FMT, &fmt) < 0) break;
+            if (size.width > 0 && size.height > 0) {
+                fmt.fmt.pix.width = size.width;
+                fmt.fmt.pix.height = size.height;
+            }
+            fmt.fmt.pix.pixelformat = fourccOf(candidate);
+            fmt.fmt.pix.field = V4L2_FIELD_NONE;
+            if (xioctl(dev->fd, VIDIOC_S_FMT, &fmt) == 0 && fmt.fmt.pix.pixelformat == fourccOf(candidate)) {
+                format_ = candidate;
+                selected = true;
+                break;
+            }
+        }
+        if (!selected) {
+            std::cerr << "[ERROR] V4L2 设备不支持所需的像素格式：" << device << std::endl;
+            return false;
+        }
+
+        size_ = cv::Size((int)fmt.fmt.pix.width, (int)fmt.fmt.pix.height);
+        std::size_t minLine = (std::size_t)size_.width * (format_ == PixelFormat::YUYV ? 2 : 1);
+        bytesPerLine_ = std::max<std::size_t>(fmt.fmt.pix.bytesperline, minLine);
+        if (size.width > 0 && size.height > 0 && size_ != size) {
+            std::cout << "[WARN] V4L2 设备不支持 " << size.width << "x" << size.height
+                      << "，已改用 " << size_.width << "x" << size_.height << std::endl;
+        }
+
+        // 申请并映射驱动缓冲区
+        v4l2_requestbuffers request{};
+        request.count = BUFFER_COUNT;
+        request.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        request.memory = V4L2_MEMORY_MMAP;
+        if (xioctl(dev->fd, VIDIOC_REQBUFS, &request) < 0 || request.count < 2) {
+            std::cerr << "[ERROR] V4L2 缓冲区申请失败：" << device << std::endl;
+            return false;
+        }
+        for (unsigned int i = 0; i < request.count; i++) {
+            v4l2_buffer buf{};
+            buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            buf.memory = V4L2_MEMORY_MMAP;
+            buf.index = i;
+            if (xioctl(dev->fd, VIDIOC_QUERYBUF, &buf) < 0) {
+                std::cerr << "[ERROR] V4L2 缓冲区查询失败：" << std::strerror(errno) << std::endl;
+                return false;
+            }
+            void* data = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, dev->fd, buf.m.offset);
+            if (data == MAP_FAILED) {
+                std::cerr << "[ERROR] V4L2 缓冲区映射失败：" << std::strerror(errno) << std::endl;
+                return false;
+            }
+            dev->buffers.emplace_back(data, buf.length);
+            dev->leases.push_back(std::make_unique<BufferLease>(&leaseAllocator(), i));
+        }
+        if (dev->buffers.size() < BUFFER_COUNT) {
+            std::cout << "[WARN] V4L2 驱动只分配了 " << dev->buffers.size() << " 个缓冲区，可能出现丢帧" << std::endl;
+        }
+
+        // 全部入队后开始采集
+        dev->streaming = true;
+        for (unsigned int i = 0; i < dev->buffers.size(); i++) dev->requeue(i);
+        v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        if (xioctl(dev->fd, VIDIOC_STREAMON, &type) < 0) {
+            std::cerr << "[ERROR] V4L2 无法开始采集：" << std::strerror(errno) << std::endl;
+            dev->streaming = false;
+            return false;
+        }
+
+        device_ = dev;
+        path_ = device;
+        return true;
+#else
+        (void)size;
+        (void)format;
+        (void)autoFormat;
+        std::cerr << "[ERROR] 当前平台不支持 V4L2 输入：" << device << std::endl;
+        return false;
+#endif
+    }
+
+    /**
+     * @brief 读取下一帧的亮度平面
+     * @param frame 输出灰度帧（CV_8UC1；超时或驱动报告错误帧时为空，由上层跳过）
+     * @return 设备出错返回 false
+     */
+    bool V4L2Source::read(cv::Mat& frame) {
+#ifdef __linux__
+        if (!device_) return false;
+
+        pollfd pfd{device_->fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, POLL_TIMEOUT_MS);
+        if (ready < 0 && errno != EINTR) {
+            std::cerr << "[ERROR] V4L2 等待帧失败：" << std::strerror(errno) << std::endl;
+            return false;
+        }
+        if (ready <= 0) {
+            frame.release();
+            return true;
+        }
+
+        v4l2_buffer buf{};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        if (xioctl(device_->fd, VIDIOC_DQBUF, &buf) < 0) {
+            frame.release();
+            if (errno == EAGAIN) return true;
+            std::cerr << "[ERROR] V4L2 取帧失败：" << std::strerror(errno) << std::endl;
+            return false;
+        }
+        if (buf.flags & V4L2_BUF_FLAG_ERROR) {
+            device_->requeue(buf.index);
+            frame.release();
+            return true;
+        }
+
+        unsigned char* data = (unsigned char*)device_->buffers[buf.index].first;
+        if (format_ == PixelFormat::YUYV) {
+            // 亮度与色度交错：抽取一次亮度后立即归还缓冲区（尺寸相符时复用调用方的缓冲区）
+            cv::Mat packed(size_, CV_8UC2, data, bytesPerLine_);
+            if (frame.u == nullptr || frame.allocator != nullptr) frame.release();
+            cv::extractChannel(packed, frame, 0);
+            device_->requeue(buf.index);
+        } else {
+            // Y 平面位于缓冲区起始处：直接交给流水线，最后一个引用释放时归还
+            frame.release();
+            frame = wrapBuffer(device_, buf.index, data, size_, bytesPerLine_);
+        }
+        return true;
+#else
+        (void)frame;
+        return false;
+#endif
+    }
+
+    /**
+     * @brief V4L2 设备为实时输入
+     */
+    bool V4L2Source::isLive() const {
+        return true;
+    }
+
+    /**
+     * @brief 输入源描述（用于日志）
+     */
+    std::string V4L2Source::describe() const {
+        return "V4L2 设备 " + path_ + " (" + std::to_string(size_.width) + "x" + std::to_string(size_.height) + " "
+             + FrameSource::pixelFormatName(format_)
+             + (format_ == PixelFormat::YUYV ? "，抽取亮度)" : "，零拷贝)");
+    }
+
+    /**
+     * @brief 停止采集并释放设备（仍被流水线引用的帧在释放后解除映射）
+     */
+    void V4L2Source::release() {
+#ifdef __linux__
+        if (device_) {
+            device_->streaming = false;
+            v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            xioctl(device_->fd, VIDIOC_STREAMOFF, &type);
+        }
+#endif
+        device_.reset();
+    }
+}
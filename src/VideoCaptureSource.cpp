@@ -0,0 +1,81 @@
+#include "VideoCaptureSource.h"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+
+namespace DriveGuard {
+    // 构造函数
+    VideoCaptureSource::VideoCaptureSource() : isLive_(false) {
+    }
+
+    // 析构函数
+    VideoCaptureSource::~VideoCaptureSource() {
+        release();
+    }
+
+    /**
+     * @brief 打开输入源
+     * @param input 摄像头编号（如 "0"）或视频文件路径
+     * @return 打开成功返回 true
+     */
+    bool VideoCaptureSource::open(const std::string& input) {
+        release();
+        input_ = input;
+
+        // 纯数字视为摄像头编号
+        bool isIndex = !input.empty() && std::all_of(input.begin(), input.end(),
+                                                    [](unsigned char ch) { return std::isdigit(ch) != 0; });
+        if (isIndex) {
+            if (!cap_.open(std::stoi(input))) {
+                std::cerr << "[ERROR] 无法打开摄像头：" << input << std::endl;
+                return false;
+            }
+            // 设置摄像头分辨率 (可选)
+            cap_.set(cv::CAP_PROP_FRAME_WIDTH, 640);
+            cap_.set(cv::CAP_PROP_FRAME_HEIGHT, 480);
+            isLive_ = true;
+            return true;
+        }
+
+        if (!cap_.open(input)) {
+            std::cerr << "[ERROR] 无法打开视频文件：" << input << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 读取下一帧
+     * @param frame 输出图像帧
+     * @return 输入结束或读取失败返回 false
+     */
+    bool VideoCaptureSource::read(cv::Mat& frame) {
+        if (!cap_.isOpened()) return false;
+        cap_ >> frame;
+
+        // 摄像头偶发空帧交由上层跳过；文件输入读到空帧即表示结束
+        return isLive_ || !frame.empty();
+    }
+
+    /**
+     * @brief 是否为实时摄像头输入
+     */
+    bool VideoCaptureSource::isLive() const {
+        return isLive_;
+    }
+
+    /**
+     * @brief 输入源描述（用于日志）
+     */
+    std::string VideoCaptureSource::describe() const {
+        return isLive_ ? "摄像头 " + input_ : "视频文件 " + input_;
+    }
+
+    /**
+     * @brief 释放输入源
+     */
+    void VideoCaptureSource::release() {
+        if (cap_.isOpened()) cap_.release();
+        isLive_ = false;
+    }
+}
@@ -1,253 +1,440 @@
+#include <algorithm>
 #include <iostream>
 #include <opencv2/opencv.hpp>
 #include <vector>
 #include <thread>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include "EnrollmentService.h"
+#include "EventRecorder.h"
 #include "FaceDetector.h"
 #include "FaceRecognizer.h"
+#include "FileLock.h"
 #include "DMSController.h"
+#include "FrameAnalyzer.h"
+#include "FrameBus.h"
+#include "FramePipeline.h"
+#include "FrameSource.h"
+#include "Metrics.h"
+#include "OverlayRenderer.h"
+#include "ResultStream.h"
+#include "ThreadPool.h"
 
 // 配置常量
 const std::string WINDOW_NAME = "DriveGuard - DMS";
 const std::string MODEL_PATH = "../models/haarcascade_frontalface_default.xml"; // 人脸级联器模型
 const std::string EYE_MODEL_PATH = "../models/haarcascade_eye.xml"; // 眼睛级联器模型
-const std::string REC_MODEL_PATH = "../models/face_rec.yml"; // 人脸识别模型
+const std::string REC_MODEL_PATH = "../models/face_rec.dgm"; // 人脸识别模型（二进制图库）
+const std::string LEGACY_REC_MODEL_PATH = "../models/face_rec.yml"; // 旧版 YAML 模型（首次启动时自动转换）
 const std::string LABEL_TO_NAME_TXT = "../models/label_to_name.txt"; // ID-Name 映射表
 
 // 录入参数配置
-const int RECORD_MAX_IMAGES = 30; // 单次录入图片数
+const int RECORD_MAX_IMAGES = 30; // 单次录入采集的图片数
+const int RECORD_KEEP_IMAGES = 10; // 筛选后每次录入保留的样本数（剔除模糊与近似重复的样本）
 const int RECORD_INTERVAL_MS = 100; // 每次采集间隔（毫秒） 
+const int RECORD_COUNTDOWN_MS = 5000; // 输入用户信息后到开始采集的倒计时（毫秒）
 const double CONFIDENCE_THRESHOLD = 80.0; // 置信度阈值（低于该值即通过）（越低越严格）
 
-// 状态机
-enum class ModelState {
-    DETECTING, // 检测模式（默认） 0
-    RECORDING, // 录入模式 1
-    RECOGNIZING // 识别模式 2
+// 流水线参数配置
+const std::size_t PIPELINE_QUEUE_CAPACITY = 2; // 各阶段队列容量（满时丢弃最旧帧）
+const int TRACK_REDETECT_INTERVAL = 10; // 跟踪模式下全帧检测周期（帧）
+const int EYE_REDETECT_INTERVAL = 5; // 眼部级联检测周期（帧），其余帧以模板匹配跟踪
+const int IDENTITY_REFRESH_INTERVAL = 30; // 已确认身份的轨迹重新完整识别的周期（帧）
+const int LATENCY_BUDGET_MS = 150; // 单帧延迟预算（毫秒），持续超出时自适应降载
+const int INDEX_PROBES = 8; // 大规模图库检索时探测的倒排列表数（越大召回越高）
+
+using DriveGuard::ModelState;
+
+/**
+ * @brief 一路摄像头：输入源、各自的分析器（跟踪/身份缓存/DMS 状态）、事件记录器与流水线
+ * 检测器、识别模型与线程池各路共享。
+ */
+struct CameraStream {
+    std::string window;
+    std::unique_ptr<DriveGuard::FrameSource> source;
+    std::unique_ptr<DriveGuard::FrameBusWriter> bus;     // 可选，采集到的帧同时发布到共享内存
+    std::unique_ptr<DriveGuard::EventRecorder> recorder; // 可选，先于分析器构造、后于分析器析构
+    std::unique_ptr<DriveGuard::FrameAnalyzer> analyzer;
+    std::unique_ptr<DriveGuard::FramePipeline> pipeline;
+    DriveGuard::FramePacket latest; // 界面模式下待显示的最新结果
+    bool hasLatest = false;
+    uint64_t processed = 0;
 };
 
+/**
+ * @brief 控制台输入的录入信息（由独立线程读取，渲染循环每帧轮询）
+ */
+struct EnrollmentPrompt {
+    std::mutex mutex;
+    bool done = false;
+    std::string name;
+    DriveGuard::UserRole role = DriveGuard::UserRole::UNKNOWN;
+};
+
+/**
+ * @brief 在独立线程中读取新用户的姓名与角色，避免 std::cin 阻塞渲染与监测
+ * 线程只访问共享的 EnrollmentPrompt，程序退出时无需等待其结束。
+ */
+static std::shared_ptr<EnrollmentPrompt> promptEnrollment() {
+    auto prompt = std::make_shared<EnrollmentPrompt>();
+    std::thread([prompt] {
+        std::cout << "请输入新用户姓名：（英文）" << std::endl;
+        std::string newName;
+        std::cin >> newName;
+
+        std::cout << "请选择用户角色：" << std::endl;
+        std::cout << "1. 驾驶员" << std::endl;
+        std::cout << "2. 乘客" << std::endl;
+        DriveGuard::UserRole newRole;
+        int roleChoice = 0;
+        std::cin >> roleChoice;
+        if (roleChoice == 1) newRole = DriveGuard::UserRole::DRIVER;
+        else if (roleChoice == 2) newRole = DriveGuard::UserRole::PASSENGER;
+        else newRole = DriveGuard::UserRole::UNKNOWN;
+
+        std::lock_guard<std::mutex> lock(prompt->mutex);
+        prompt->name = newName;
+        prompt->role = newRole;
+        prompt->done = true;
+    }).detach();
+    return prompt;
+}
+
+/**
+ * @brief 打印命令行用法
+ */
+static void printUsage(const char* program) {
+    std::cout << "用法: " << program << " [--input <摄像头编号|视频文件|图片目录>]... [--headless] [--result-socket <路径>] [指标选项] [事件选项]" << std::endl;
+    std::cout << "  --input                 输入源，默认为摄像头 0；可重复指定以同时处理多路摄像头（第一路用于录入）" << std::endl;
+    std::cout << "                          亮度直采：v4l2:<设备>[,<宽>x<高>][,<格式>] 或 yuv:<文件>,<宽>x<高>,<格式>[,<帧率>]" << std::endl;
+    std::cout << "                          （格式：grey/nv12/i420/yuyv）" << std::endl;
+    std::cout << "                          帧总线：shm:<名称>（读取另一进程以 --frame-bus 发布的帧，零拷贝）" << std::endl;
+    std::cout << "  --threads <N>           多路输入时共享线程池的线程数，默认为 CPU 核心数" << std::endl;
+    std::cout << "  --headless              无界面模式，不绘制叠加层、不显示窗口、不响应按键" << std::endl;
+    std::cout << "  --frame-bus <名称>       将采集到的帧发布到 POSIX 共享内存，供本机其他进程以 shm:<名称> 读取" << std::endl;
+    std::cout << "  --result-socket <路径>   在 Unix 域套接字上推送逐帧分析结果（人脸框/身份/角色/置信度/驾驶员状态/时间戳）" << std::endl;
+    std::cout << "  --track-interval <N>    每 N 帧全帧检测一次，其余帧仅局部跟踪；<=1 关闭跟踪，默认 " << TRACK_REDETECT_INTERVAL << std::endl;
+    std::cout << "  --eye-track-interval <N> 每 N 帧级联检测一次眼睛，其余帧模板跟踪；<=1 每帧检测，默认 " << EYE_REDETECT_INTERVAL << std::endl;
+    std::cout << "  --identity-refresh <N>  已识别的轨迹每 N 帧重新识别一次；<=1 每帧识别，默认 " << IDENTITY_REFRESH_INTERVAL << std::endl;
+    std::cout << "  --latency-budget <ms>   实时输入的单帧延迟预算，持续超出时依次跳过乘客识别、降低检测分辨率、丢弃过期帧；<=0 关闭，默认 " << LATENCY_BUDGET_MS << std::endl;
+    std::cout << "  --cascade <后端>        级联检测后端：auto、opencv（读取 XML 模型）、compiled（编译级联），默认 auto" << std::endl;
+    std::cout << "  --index-probes <N>      身份较多时图库索引探测的倒排列表数；<=0 关闭索引，默认 " << INDEX_PROBES << std::endl;
+    std::cout << "  --metrics-file <路径>    周期性导出 Prometheus 文本格式指标" << std::endl;
+    std::cout << "  --metrics-socket <路径>  在 Unix 域套接字上提供指标抓取" << std::endl;
+    std::cout << "  --metrics-interval <ms> 指标文件导出周期，默认 5000" << std::endl;
+    std::cout << "  --events-dir <目录>      记录疲劳状态、身份变化与未登记人员事件（events.bin），并保存告警前后的帧片段" << std::endl;
+    std::cout << "  --pre-alert-ms <ms>     告警片段保留的告警前时长，默认 5000" << std::endl;
+    std::cout << "  --post-alert-ms <ms>    告警片段在告警后继续录制的时长，默认 3000" << std::endl;
+}
+
 int main(int argc, char* argv[]) {
     std::cout << "===========================================" << std::endl;
     std::cout << "            驾驶员监控系统 - DMS            " << std::endl;
     std::cout << "===========================================" << std::endl;
 
-    // 打开摄像头 (0 通常是默认摄像头)
-    cv::VideoCapture cap(0);
-    if (!cap.isOpened()) {
-        std::cerr << "[FATAL] 无法打开摄像头!" << std::endl;
-        return -1;
+    // 解析命令行参数
+    std::vector<std::string> inputs;
+    std::size_t threads = 0;
+    bool headless = false;
+    int trackInterval = TRACK_REDETECT_INTERVAL;
+    int eyeTrackInterval = EYE_REDETECT_INTERVAL;
+    int identityRefresh = IDENTITY_REFRESH_INTERVAL;
+    int latencyBudget = LATENCY_BUDGET_MS;
+    int indexProbes = INDEX_PROBES;
+    DriveGuard::CascadeBackend cascadeBackend = DriveGuard::CascadeBackend::AUTO;
+    std::string metricsFile;
+    std::string metricsSocket;
+    std::string resultSocket;
+    std::string frameBus;
+    int metricsIntervalMs = 5000;
+    DriveGuard::EventRecorderConfig eventConfig;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--input" && i + 1 < argc) {
+            inputs.push_back(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = (std::size_t)std::max(0, std::stoi(argv[++i]));
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--track-interval" && i + 1 < argc) {
+            trackInterval = std::stoi(argv[++i]);
+        } else if (arg == "--eye-track-interval" && i + 1 < argc) {
+            eyeTrackInterval = std::stoi(argv[++i]);
+        } else if (arg == "--identity-refresh" && i + 1 < argc) {
+            identityRefresh = std::stoi(argv[++i]);
+        } else if (arg == "--latency-budget" && i + 1 < argc) {
+            latencyBudget = std::stoi(argv[++i]);
+        } else if (arg == "--index-probes" && i + 1 < argc) {
+            indexProbes = std::stoi(argv[++i]);
+        } else if (arg == "--cascade" && i + 1 < argc && DriveGuard::FaceDetector::parseBackend(argv[i + 1], cascadeBackend)) {
+            i++;
+        } else if (arg == "--frame-bus" && i + 1 < argc) {
+            frameBus = argv[++i];
+        } else if (arg == "--result-socket" && i + 1 < argc) {
+            resultSocket = argv[++i];
+        } else if (arg == "--metrics-file" && i + 1 < argc) {
+            metricsFile = argv[++i];
+        } else if (arg == "--metrics-socket" && i + 1 < argc) {
+            metricsSocket = argv[++i];
+        } else if (arg == "--metrics-interval" && i + 1 < argc) {
+            metricsIntervalMs = std::stoi(argv[++i]);
+        } else if (arg == "--events-dir" && i + 1 < argc) {
+            eventConfig.directory = argv[++i];
+        } else if (arg == "--pre-alert-ms" && i + 1 < argc) {
+            eventConfig.preAlertMs = std::max(0, std::stoi(argv[++i]));
+        } else if (arg == "--post-alert-ms" && i + 1 < argc) {
+            eventConfig.postAlertMs = std::max(0, std::stoi(argv[++i]));
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : -1;
+        }
+    }
+
+    if (inputs.empty()) inputs.push_back("0"); // 0 通常是默认摄像头
+
+    // 打开输入源
+    std::vector<std::unique_ptr<CameraStream>> streams;
+    for (const auto& input : inputs) {
+        auto stream = std::make_unique<CameraStream>();
+        stream->source = DriveGuard::FrameSource::create(input);
+        if (!stream->source) {
+            std::cerr << "[FATAL] 无法打开输入源: " << input << std::endl;
+            return -1;
+        }
+        stream->window = inputs.size() > 1 ? WINDOW_NAME + " [" + input + "]" : WINDOW_NAME;
+        std::cout << "[INFO] 输入源：" << stream->source->describe() << std::endl;
+        streams.push_back(std::move(stream));
     }
-    
-    // 设置摄像头分辨率 (可选)
-    cap.set(cv::CAP_PROP_FRAME_WIDTH, 640);
-    cap.set(cv::CAP_PROP_FRAME_HEIGHT, 480);
 
     // 初始化检测器
-    DriveGuard::FaceDetector detector(MODEL_PATH, EYE_MODEL_PATH);
+    DriveGuard::FaceDetector detector(MODEL_PATH, EYE_MODEL_PATH, cascadeBackend);
     if (!detector.isModelLoaded()) {
         std::cerr << "[FATAL] 初始化检测器失败，程序退出" << std::endl;
         std::cerr << "请确保 '" << MODEL_PATH << "' 和 '" << EYE_MODEL_PATH << "' 文件存在" << std::endl;
         return -1;
     }
 
+    // 运行期间独占识别模型与映射表：GalleryImport 等工具同时修改会使内存中的身份信息过期，分配重复的标签
+    DriveGuard::FileLock modelOwner(DriveGuard::FileLock::ownerLockPath(REC_MODEL_PATH),
+                                    DriveGuard::FileLock::Mode::EXCLUSIVE, false);
+    if (!modelOwner.locked()) {
+        std::cerr << "[FATAL] 识别模型正被其他进程使用（另一个 DriveGuard 或 GalleryImport），程序退出" << std::endl;
+        return -1;
+    }
+
     // 初始化识别器
-    DriveGuard::FaceRecognizer recognizer;
+    auto recognizer = std::make_shared<DriveGuard::FaceRecognizer>();
+    DriveGuard::GalleryIndexConfig indexConfig;
+    indexConfig.enabled = indexProbes > 0;
+    indexConfig.probes = indexProbes;
+    recognizer->setIndexConfig(indexConfig);
     ModelState currentState = ModelState::DETECTING;
-    if (recognizer.loadModel(REC_MODEL_PATH)) {
-        recognizer.loadLabelInfo(LABEL_TO_NAME_TXT);
+    bool hasModel = false;
+    if (std::filesystem::exists(REC_MODEL_PATH)) {
+        hasModel = recognizer->loadModel(REC_MODEL_PATH);
+    } else if (std::filesystem::exists(LEGACY_REC_MODEL_PATH) && recognizer->loadModel(LEGACY_REC_MODEL_PATH)) {
+        // 旧版 YAML 模型转换为二进制格式，之后启动直接映射
+        hasModel = true;
+        if (recognizer->saveModel(REC_MODEL_PATH)) {
+            std::cout << "[INFO] 已将 " << LEGACY_REC_MODEL_PATH << " 转换为 " << REC_MODEL_PATH << std::endl;
+        }
+    }
+    if (hasModel) {
+        if (!recognizer->loadLabelInfo(LABEL_TO_NAME_TXT)) {
+            std::cerr << "[WARN] 映射表不可用，识别结果将显示为 Unknown" << std::endl;
+        }
         currentState = ModelState::RECOGNIZING;
     } else {
         std::cout << "[INFO] 未找到人脸识别模型，如果您为驾驶员，请录入自身的脸部照片……" << std::endl;
     }
-    // 录入模式参数
-    std::vector<cv::Mat> trainingImages;
-    std::vector<int> trainingLabels;
-    std::string userName;
-    int userLabel;
-    DriveGuard::UserRole userRole;
-    int recordingCount = 0;
-
-    // 初始化DMS控制器
-    DriveGuard::DMSController dms;
-
-    // 捕获镜头帧
-    cv::Mat frame;
-    std::cout << "[INFO] 系统就绪。按 'Q/q' 退出，按 'R/r' 进入录入模式。" << std::endl;
 
-    // 主循环
-    while (true) {
-        // 捕获帧
-        cap >> frame;
-        if (frame.empty()) {
-            std::cerr << "[WARN] 捕获到空帧，跳过..." << std::endl;
-            continue;
-        }
+    // 录入样本筛选：采集时剔除不合格样本，训练前剔除近似重复样本
+    DriveGuard::SampleSelectorConfig selectorConfig;
+    selectorConfig.maxSamples = RECORD_KEEP_IMAGES;
+
+    // 后台录入服务：训练与保存在独立线程完成，新模型原子发布
+    DriveGuard::EnrollmentService enrollment(recognizer, REC_MODEL_PATH, LABEL_TO_NAME_TXT, selectorConfig);
+    enrollment.start();
+
+    // 初始化帧分析器
+    DriveGuard::AnalyzerConfig config;
+    config.recordMaxImages = RECORD_MAX_IMAGES;
+    config.recordIntervalMs = RECORD_INTERVAL_MS;
+    config.recordCountdownMs = RECORD_COUNTDOWN_MS;
+    config.confidenceThreshold = CONFIDENCE_THRESHOLD;
+    config.selector = selectorConfig;
+    config.tracker.enabled = trackInterval > 1;
+    config.tracker.redetectInterval = trackInterval;
+    config.eyeTracker.enabled = eyeTrackInterval > 1;
+    config.eyeTracker.redetectInterval = eyeTrackInterval;
+    config.identityCache.enabled = identityRefresh > 1;
+    config.identityCache.refreshInterval = identityRefresh;
+    config.shedder.budgetMs = latencyBudget;
+
+    // 逐帧结果推送给下游（在结果消费线程中发布，从不阻塞）
+    DriveGuard::ResultStream results(resultSocket);
+    if (!resultSocket.empty()) results.start();
+
+    // 启动指标导出
+    DriveGuard::MetricsExporter metricsExporter(metricsFile, metricsSocket, metricsIntervalMs);
+    if (!metricsFile.empty() || !metricsSocket.empty()) {
+        metricsExporter.start();
+    }
 
-        // 处理帧（人脸检测）
-        // 利用 auto 自动推导类型 (C++11)
-        auto faces = detector.detect(frame);
-
-        // 绘制结果
-        for (const auto& face : faces) {
-            cv::Scalar borderColor(0, 255, 0); // 人脸边框默认为绿色
-
-            // ===============================
-            // 分支：录入模式
-            // ===============================
-            if (currentState == ModelState::RECORDING) {
-                borderColor = cv::Scalar(255, 0, 0); // 录入模式：人脸边框为蓝色
-
-                if (recordingCount < RECORD_MAX_IMAGES) {
-                    // 截取人脸区域（深拷贝）
-                    cv::Mat faceROI = frame(face).clone();
-
-                    // 预处理：转灰度并统一大小 (LBPH 需要)
-                    cv::Mat gray;
-                    if (faceROI.channels() == 3) cv::cvtColor(faceROI, gray, cv::COLOR_BGR2GRAY);
-                    else gray = faceROI;
-                    cv::resize(gray, gray, cv::Size(100, 100));
-
-                    trainingImages.push_back(gray);
-                    trainingLabels.push_back(userLabel);
-                    recordingCount++;
-                    
-                    // 打印录入进度
-                    std::string progress = "Sample:" 
-                                        + std::to_string(recordingCount)
-                                        + "/"
-                                        + std::to_string(RECORD_MAX_IMAGES);
-                    cv:putText(frame, progress, cv::Point(face.x, face.y - 20),
-                    cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(255, 0, 0), 2);
-
-                    // 稍作延迟，避免录入样本过于重复（注意此处阻塞时间不要太久）
-                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
-                } else { // 样本录入完成，开始训练
-                    // 录入完成，开始训练
-                    cv::putText(frame, "Training...", cv::Point(20, 50), cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 0, 255), 2);
-                    cv::imshow(WINDOW_NAME, frame);
-                    cv::waitKey(10); // 处理键盘输入（等待10ms）
-                    
-                    recognizer.update(trainingImages, trainingLabels);
-                    if (recognizer.saveModel(REC_MODEL_PATH)) {
-                        
-                    }
-                    recognizer.setLabelInfo(userLabel, userName, userRole);
-                    recognizer.saveLabelInfo(LABEL_TO_NAME_TXT);
-
-                    currentState = ModelState::RECOGNIZING;
-                    std::cout << "[INFO] 录入、训练完成，模型已保存" << std::endl;
-                }
+    // 启动流水线：单路时采集、检测、识别各占一个线程；多路时各路采集线程独立，
+    // 检测与识别提交到共享的工作窃取线程池。主线程负责渲染与交互
+    // 实时摄像头丢弃最旧帧以保证低延迟；离线回放则逐帧处理，保证结果可复现
+    std::unique_ptr<DriveGuard::ThreadPool> pool;
+    if (streams.size() > 1) {
+        pool = std::make_unique<DriveGuard::ThreadPool>(threads);
+        std::cout << "[INFO] " << streams.size() << " 路输入共享 " << pool->size() << " 个工作线程" << std::endl;
+    }
+    for (std::size_t i = 0; i < streams.size(); i++) {
+        CameraStream* stream = streams[i].get();
+
+        // 事件与告警片段由各路独立的后台线程写入（多路时分目录保存）
+        if (!eventConfig.directory.empty()) {
+            DriveGuard::EventRecorderConfig streamEvents = eventConfig;
+            if (streams.size() > 1) {
+                streamEvents.directory = (std::filesystem::path(eventConfig.directory) / ("stream" + std::to_string(i))).string();
             }
-            // ===============================
-            // 分支：识别模式
-            // ===============================
-            else if (currentState == ModelState::RECOGNIZING) {
-                // 预测人脸
-                cv::Mat faceROI = frame(face);
-                double confidence = 0.0;
-                int label = recognizer.predict(faceROI, confidence);
-
-                // 获取人脸名称
-                std::string name = "Unknown";
-                DriveGuard::UserRole role = DriveGuard::UserRole::UNKNOWN;
-                if (label != -1 && confidence < CONFIDENCE_THRESHOLD) {
-                    name = recognizer.getLabelName(label);
-                    role = recognizer.getLabelRole(label);
-                }
+            stream->recorder = std::make_unique<DriveGuard::EventRecorder>(streamEvents);
+            if (!stream->recorder->start()) stream->recorder.reset();
+        }
 
-                // 如果是驾驶员，检测眼睛并判断疲劳程度
-                if (role == DriveGuard::UserRole::DRIVER) {
-                    auto driverEyes = detector.detectEyes(faceROI);
-                    for (const auto& eye : driverEyes) {
-                        // 计算绝对坐标，绘制眼睛边框
-                        cv::Rect eyeRect(face.x + eye.x, face.y + eye.y, eye.width, eye.height);
-                        cv::rectangle(frame, eyeRect, cv::Scalar(255, 0, 0), 1);
-                    }
-
-                    // 显示驾驶员状态
-                    dms.update(!driverEyes.empty(), 10.0); // 判断驾驶员当前状态
-                    std::string warning = dms.getWarning(); // 获取当前警告信息
-                    borderColor = dms.getStatusColor(); // 将人脸边框设置为对应的警告颜色
-                    cv::putText(frame, warning, cv::Point(face.x, face.y + face.height + 30),
-                        cv::FONT_HERSHEY_SIMPLEX, 0.8, borderColor, 2);
-                }
-                else if (role == DriveGuard::UserRole::PASSENGER) {
-                    borderColor = cv::Scalar(0, 255, 0); // 乘客边框为绿色
-                    cv::putText(frame, "Passenger", cv::Point(face.x, face.y + face.height + 20),
-                                cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(0, 255, 0), 2);
-                }
+        // 降载仅用于实时输入；离线回放逐帧处理，保证结果可复现
+        DriveGuard::AnalyzerConfig streamConfig = config;
+        streamConfig.shedder.enabled = latencyBudget > 0 && stream->source->isLive();
+        stream->analyzer = std::make_unique<DriveGuard::FrameAnalyzer>(detector, enrollment, streamConfig, currentState,
+                                                                        stream->recorder.get());
+        // 帧总线：采集阶段每读到一帧即发布（多路时按名称加编号区分），不等待任何读端
+        if (!frameBus.empty()) {
+            std::string busName = streams.size() > 1 ? frameBus + std::to_string(i) : frameBus;
+            stream->bus = std::make_unique<DriveGuard::FrameBusWriter>(busName);
+        }
 
-                // 如果是未知人员
-                else {
-                    borderColor = cv::Scalar(0, 0, 255); // 未知人员边框为红色
-                    cv::putText(frame, "Unknown", cv::Point(face.x, face.y + face.height + 20),
-                                cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(0, 0, 255), 2);
-                }
+        DriveGuard::FrameSource& source = *stream->source;
+        DriveGuard::FrameBusWriter* bus = stream->bus.get();
+        stream->pipeline = std::make_unique<DriveGuard::FramePipeline>([&source, bus](cv::Mat& frame) {
+            if (!source.read(frame)) return false;
+            if (bus) bus->publish(frame, DriveGuard::Clock::now());
+            return true;
+        }, *stream->analyzer, PIPELINE_QUEUE_CAPACITY, source.isLive(), pool.get());
+        stream->pipeline->start();
+    }
 
-                // 绘制标签
-                std::string labelText = name + " (confidence: " + std::to_string((int)confidence) + ")";
-                cv::putText(frame, labelText, cv::Point(face.x, face.y - 5),
-                            cv::FONT_HERSHEY_SIMPLEX, 0.6, borderColor, 2);
+    // 停止所有流水线（先于线程池析构），写完剩余事件与告警片段，并等待进行中的录入保存完成
+    auto shutdown = [&]() {
+        uint64_t dropped = 0;
+        for (auto& stream : streams) {
+            stream->pipeline->stop();
+            dropped += stream->pipeline->droppedFrames();
+        }
+        pool.reset();
+        results.stop();
+        for (auto& stream : streams) {
+            if (stream->recorder) stream->recorder->stop();
+        }
+        enrollment.stop();
+        for (auto& stream : streams) stream->source->release();
+        return dropped;
+    };
+
+    // 无界面模式：不做任何绘制，结果仅发布到结果流
+    if (headless) {
+        std::cout << "[INFO] 系统就绪（无界面模式）。" << std::endl;
+        DriveGuard::FramePacket packet;
+        auto startTime = DriveGuard::Clock::now();
+        std::size_t active = streams.size();
+        while (active > 0) {
+            bool any = false;
+            active = 0;
+            for (std::size_t i = 0; i < streams.size(); i++) {
+                CameraStream* stream = streams[i].get();
+                while (stream->pipeline->tryNextResult(packet)) {
+                    results.publish((uint8_t)i, packet);
+                    stream->processed++;
+                    any = true;
+                    stream->pipeline->recycle(std::move(packet));
+                }
+                if (!stream->pipeline->finished()) active++;
             }
-
-            // 绘制人脸框
-            cv::rectangle(frame, face, borderColor, 2);
+            if (!any) std::this_thread::sleep_for(std::chrono::milliseconds(2));
         }
+        double seconds = std::chrono::duration<double>(DriveGuard::Clock::now() - startTime).count();
+
+        uint64_t dropped = shutdown();
+        uint64_t processed = 0;
+        for (auto& stream : streams) processed += stream->processed;
+        std::cout << "[INFO] 处理帧数：" << processed
+                  << "，丢弃帧数：" << dropped
+                  << "，平均帧率：" << (seconds > 0 ? processed / seconds : 0.0) << " fps" << std::endl;
+        std::cout << "[INFO] 程序正常退出。" << std::endl;
+        return 0;
+    }
 
-        // 屏幕状态提示
-        if (currentState == ModelState::DETECTING) {
-            cv::putText(frame, "System Ready. Press 'R' to Register Driver.", cv::Point(10, 30), 
-                       cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(255, 255, 255), 1);
-        } else if (currentState == ModelState::RECOGNIZING) {
-            cv::putText(frame, "DMS Monitoring Active", cv::Point(10, 30), 
-                       cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(0, 255, 0), 2);
-        }
+    std::cout << "[INFO] 系统就绪。按 'Q/q' 退出，按 'R/r' 进入录入模式。" << std::endl;
 
-        cv::imshow(WINDOW_NAME, frame);
+    // 主循环（渲染阶段）：轮询各路结果，任何一路都不会阻塞其他路的显示
+    // 每个结果都发布到结果流，但每路每轮只绘制最新的一帧（更早的帧显示前即被覆盖，不必绘制）
+    DriveGuard::OverlayRenderer renderer(RECORD_MAX_IMAGES);
+    DriveGuard::FramePacket packet;
+    std::shared_ptr<EnrollmentPrompt> prompt; // 正在等待控制台输入的录入信息
+    bool quit = false;
+    while (!quit) {
+        bool any = false;
+        bool active = false;
+        for (std::size_t i = 0; i < streams.size(); i++) {
+            CameraStream* stream = streams[i].get();
+            while (stream->pipeline->tryNextResult(packet)) {
+                results.publish((uint8_t)i, packet);
+                if (stream->hasLatest) stream->pipeline->recycle(std::move(stream->latest));
+                std::swap(stream->latest, packet);
+                stream->hasLatest = true;
+            }
+            if (stream->hasLatest) {
+                // 绘制结果（显示后数据包归还帧池）
+                cv::imshow(stream->window, renderer.draw(stream->latest));
+                stream->pipeline->recycle(std::move(stream->latest));
+                stream->hasLatest = false;
+                any = true;
+            }
+            if (!stream->pipeline->finished()) active = true;
+        }
+        if (!active) break;
+
+        // 控制台输入完成后提交录入请求（倒计时与标签分配在第一路的分析任务中完成）
+        if (prompt) {
+            bool done = false;
+            {
+                std::lock_guard<std::mutex> lock(prompt->mutex);
+                done = prompt->done;
+                if (done && prompt->name.empty()) std::cerr << "[WARN] 用户姓名为空，已取消录入" << std::endl;
+                else if (done) streams.front()->analyzer->requestRecording(prompt->name, prompt->role);
+            }
+            if (done) prompt.reset();
+        }
 
-        // 处理键盘输入 (等待10ms)
-        char c = (char)cv::waitKey(10);
+        // 处理键盘输入（有新帧时只让出 1ms 刷新窗口，不再以固定等待限制帧率；否则短暂等待后继续轮询）
+        char c = (char)cv::waitKey(any ? 1 : 2);
         if (c == 27 || c == 'q' || c == 'Q') {
-            break;
+            quit = true;
         }
         else if (c == 'r' || c == 'R') {
-            std::cout << "请输入新用户姓名：（英文）" << std::endl;
-            std::string newName;
-            std::cin >> newName;
-
-            std::cout << "请选择用户角色：" << std::endl;
-            std::cout << "1. 驾驶员" << std::endl;
-            std::cout << "2. 乘客" << std::endl;
-            DriveGuard::UserRole newRole;
-            int roleChoice;
-            std::cin >> roleChoice;
-            if (roleChoice == 1) newRole = DriveGuard::UserRole::DRIVER;
-            else if (roleChoice == 2) newRole = DriveGuard::UserRole::PASSENGER;
-            else newRole = DriveGuard::UserRole::UNKNOWN;
-            
-            int newLabel = recognizer.getAvailableLabel();
-
-            std::cout << "请注视摄像头，即将开始录入……" << std::endl;
-            for (int i = 5; i > 0; i--) {
-                std::cout << i << "秒后开始录入……" << std::endl;
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-            }
-
-            userName = newName;
-            userLabel = newLabel;
-            userRole = newRole;
-
-            currentState = ModelState::RECORDING;
-            std::cout << "[INFO] 切换至录入模式……" << std::endl;
+            if (prompt) std::cout << "[INFO] 请先在控制台完成上一次的用户信息输入" << std::endl;
+            else prompt = promptEnrollment();
         }
     }
 
+    uint64_t dropped = shutdown();
+    std::cout << "[INFO] 丢弃帧数：" << dropped << std::endl;
+
     // 5. 资源清理
     // VideoCapture 和 Mat 会在析构时自动释放，
     // 但手动 release 是个好习惯，或者 explicitly destroy windows
-    cap.release();
     cv::destroyAllWindows();
 
     std::cout << "[INFO] 程序正常退出。" << std::endl;
     return 0;
-}
\ No newline at end of file
+}
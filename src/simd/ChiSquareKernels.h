@@ -0,0 +1,68 @@
+#ifndef CHI_SQUARE_KERNELS_H
+#define CHI_SQUARE_KERNELS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "SimdConfig.h"
+
+// 量化直方图的卡方距离内核（GalleryMatrix 内部使用）
+// 在计数域计算 sum((q - r)^2 / (q + r))（q + r == 0 的分量为 0），
+// 调用方再乘以 2 / 网格像素数 还原为 HISTCMP_CHISQR_ALT 距离。
+// 以 BLOCK 个分量为一组用 float 累加，组间以 double 累加，保证长向量上的精度。
+
+namespace DriveGuard {
+    namespace chi {
+
+        const int BLOCK = 256;
+
+        /**
+         * @brief 单行标量实现（亦作为各内核的尾部处理）
+         */
+        template <typename T>
+        inline double distanceScalar(const T* query, const T* row, int cols) {
+            double result = 0.0;
+            for (int start = 0; start < cols; start += BLOCK) {
+                const int end = std::min(start + BLOCK, cols);
+                float block = 0.0f;
+                for (int j = start; j < end; j++) {
+                    float d = (float)query[j] - (float)row[j];
+                    float s = (float)query[j] + (float)row[j];
+                    block += d * d / std::max(s, 1.0f);
+                }
+                result += block;
+            }
+            return result;
+        }
+
+        /**
+         * @brief 逐行标量实现
+         * @param query 量化后的查询直方图
+         * @param rows 图库首行
+         * @param stride 图库行跨度（元素数）
+         * @param rowCount 行数
+         * @param cols 直方图维度
+         * @param out 输出每行的计数域距离
+         */
+        template <typename T>
+        inline void distancesScalar(const T* query, const T* rows, std::size_t stride, std::size_t rowCount, int cols, double* out) {
+            for (std::size_t r = 0; r < rowCount; r++) {
+                out[r] = distanceScalar(query, rows + r * stride, cols);
+            }
+        }
+
+#if defined(DRIVEGUARD_SIMD_X86)
+        void distancesSSE41(const uint8_t* query, const uint8_t* rows, std::size_t stride, std::size_t rowCount, int cols, double* out);
+        void distancesSSE41(const uint16_t* query, const uint16_t* rows, std::size_t stride, std::size_t rowCount, int cols, double* out);
+        void distancesAVX2(const uint8_t* query, const uint8_t* rows, std::size_t stride, std::size_t rowCount, int cols, double* out);
+        void distancesAVX2(const uint16_t* query, const uint16_t* rows, std::size_t stride, std::size_t rowCount, int cols, double* out);
+#endif
+#if defined(DRIVEGUARD_SIMD_NEON)
+        void distancesNEON(const uint8_t* query, const uint8_t* rows, std::size_t stride, std::size_t rowCount, int cols, double* out);
+        void distancesNEON(const uint16_t* query, const uint16_t* rows, std::size_t stride, std::size_t rowCount, int cols, double* out);
+#endif
+
+    } // namespace chi
+} // namespace DriveGuard
+
+#endif // CHI_SQUARE_KERNELS_H
@@ -0,0 +1,69 @@
+#include "ChiSquareKernels.h"
+
+#if defined(DRIVEGUARD_SIMD_X86)
+#include <immintrin.h>
+
+namespace DriveGuard {
+    namespace chi {
+        namespace {
+            // 加载 8 个计数并转换为 float
+            inline __m256 load8(const uint8_t* p) {
+                return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+            }
+
+            inline __m256 load8(const uint16_t* p) {
+                return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+            }
+
+            inline float horizontalSum(__m256 v) {
+                __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+                sum = _mm_hadd_ps(sum, sum);
+                sum = _mm_hadd_ps(sum, sum);
+                return _mm_cvtss_f32(sum);
+            }
+
+            inline __m256 term(__m256 a, __m256 b, __m256 one) {
+                __m256 d = _mm256_sub_ps(a, b);
+                return _mm256_div_ps(_mm256_mul_ps(d, d), _mm256_max_ps(_mm256_add_ps(a, b), one));
+            }
+
+            template <typename T>
+            double distance(const T* query, const T* row, int cols) {
+                const __m256 one = _mm256_set1_ps(1.0f);
+                double result = 0.0;
+                int start = 0;
+                for (; start + BLOCK <= cols; start += BLOCK) {
+                    __m256 acc0 = _mm256_setzero_ps();
+                    __m256 acc1 = _mm256_setzero_ps();
+                    for (int j = start; j < start + BLOCK; j += 16) {
+                        acc0 = _mm256_add_ps(acc0, term(load8(query + j), load8(row + j), one));
+                        acc1 = _mm256_add_ps(acc1, term(load8(query + j + 8), load8(row + j + 8), one));
+                    }
+                    result += horizontalSum(_mm256_add_ps(acc0, acc1));
+                }
+                if (start < cols) result += distanceScalar(query + start, row + start, cols - start);
+                return result;
+            }
+
+            template <typename T>
+            void distances(const T* query, const T* rows, std::size_t stride, std::size_t rowCount, int cols, double* out) {
+                for (std::size_t r = 0; r < rowCount; r++) {
+                    out[r] = distance(query, rows + r * stride, cols);
+                }
+            }
+        }
+
+        /**
+         * @brief AVX2 卡方距离内核：每次处理 16 个分量
+         */
+        void distancesAVX2(const uint8_t* query, const uint8_t* rows, std::size_t stride, std::size_t rowCount, int cols, double* out) {
+            distances(query, rows, stride, rowCount, cols, out);
+        }
+
+        void distancesAVX2(const uint16_t* query, const uint16_t* rows, std::size_t stride, std::size_t rowCount, int cols, double* out) {
+            distances(query, rows, stride, rowCount, cols, out);
+        }
+    }
+}
+
+#endif
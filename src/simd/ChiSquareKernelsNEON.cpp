@@ -0,0 +1,69 @@
+#include "ChiSquareKernels.h"
+
+#if defined(DRIVEGUARD_SIMD_NEON)
+#include <arm_neon.h>
+
+namespace DriveGuard {
+    namespace chi {
+        namespace {
+            // 加载 8 个计数并转换为 2 x (4 x float32)
+            inline void load8(const uint8_t* p, float32x4_t& lo, float32x4_t& hi) {
+                uint16x8_t w = vmovl_u8(vld1_u8(p));
+                lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(w)));
+                hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(w)));
+            }
+
+            inline void load8(const uint16_t* p, float32x4_t& lo, float32x4_t& hi) {
+                uint16x8_t w = vld1q_u16(p);
+                lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(w)));
+                hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(w)));
+            }
+
+            inline float32x4_t term(float32x4_t a, float32x4_t b, float32x4_t one) {
+                float32x4_t d = vsubq_f32(a, b);
+                return vdivq_f32(vmulq_f32(d, d), vmaxq_f32(vaddq_f32(a, b), one));
+            }
+
+            template <typename T>
+            double distance(const T* query, const T* row, int cols) {
+                const float32x4_t one = vdupq_n_f32(1.0f);
+                double result = 0.0;
+                int start = 0;
+                for (; start + BLOCK <= cols; start += BLOCK) {
+                    float32x4_t acc0 = vdupq_n_f32(0.0f);
+                    float32x4_t acc1 = vdupq_n_f32(0.0f);
+                    for (int j = start; j < start + BLOCK; j += 8) {
+                        float32x4_t qLo, qHi, rLo, rHi;
+                        load8(query + j, qLo, qHi);
+                        load8(row + j, rLo, rHi);
+                        acc0 = vaddq_f32(acc0, term(qLo, rLo, one));
+                        acc1 = vaddq_f32(acc1, term(qHi, rHi, one));
+                    }
+                    result += vaddvq_f32(vaddq_f32(acc0, acc1));
+                }
+                if (start < cols) result += distanceScalar(query + start, row + start, cols - start);
+                return result;
+            }
+
+            template <typename T>
+            void distances(const T* query, const T* rows, std::size_t stride, std::size_t rowCount, int cols, double* out) {
+                for (std::size_t r = 0; r < rowCount; r++) {
+                    out[r] = distance(query, rows + r * stride, cols);
+                }
+            }
+        }
+
+        /**
+         * @brief NEON 卡方距离内核：每次处理 8 个分量
+         */
+        void distancesNEON(const uint8_t* query, const uint8_t* rows, std::size_t stride, std::size_t rowCount, int cols, double* out) {
+            distances(query, rows, stride, rowCount, cols, out);
+        }
+
+        void distancesNEON(const uint16_t* query, const uint16_t* rows, std::size_t stride, std::size_t rowCount, int cols, double* out) {
+            distances(query, rows, stride, rowCount, cols, out);
+        }
+    }
+}
+
+#endif
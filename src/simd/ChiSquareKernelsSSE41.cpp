@@ -0,0 +1,71 @@
+#include "ChiSquareKernels.h"
+
+#if defined(DRIVEGUARD_SIMD_X86)
+#include <smmintrin.h>
+#include <cstring>
+
+namespace DriveGuard {
+    namespace chi {
+        namespace {
+            // 加载 4 个计数并转换为 float
+            inline __m128 load4(const uint8_t* p) {
+                int v;
+                std::memcpy(&v, p, sizeof(v));
+                return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(v)));
+            }
+
+            inline __m128 load4(const uint16_t* p) {
+                return _mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+            }
+
+            inline float horizontalSum(__m128 v) {
+                v = _mm_hadd_ps(v, v);
+                v = _mm_hadd_ps(v, v);
+                return _mm_cvtss_f32(v);
+            }
+
+            inline __m128 term(__m128 a, __m128 b, __m128 one) {
+                __m128 d = _mm_sub_ps(a, b);
+                return _mm_div_ps(_mm_mul_ps(d, d), _mm_max_ps(_mm_add_ps(a, b), one));
+            }
+
+            template <typename T>
+            double distance(const T* query, const T* row, int cols) {
+                const __m128 one = _mm_set1_ps(1.0f);
+                double result = 0.0;
+                int start = 0;
+                for (; start + BLOCK <= cols; start += BLOCK) {
+                    __m128 acc0 = _mm_setzero_ps();
+                    __m128 acc1 = _mm_setzero_ps();
+                    for (int j = start; j < start + BLOCK; j += 8) {
+                        acc0 = _mm_add_ps(acc0, term(load4(query + j), load4(row + j), one));
+                        acc1 = _mm_add_ps(acc1, term(load4(query + j + 4), load4(row + j + 4), one));
+                    }
+                    result += horizontalSum(_mm_add_ps(acc0, acc1));
+                }
+                if (start < cols) result += distanceScalar(query + start, row + start, cols - start);
+                return result;
+            }
+
+            template <typename T>
+            void distances(const T* query, const T* rows, std::size_t stride, std::size_t rowCount, int cols, double* out) {
+                for (std::size_t r = 0; r < rowCount; r++) {
+                    out[r] = distance(query, rows + r * stride, cols);
+                }
+            }
+        }
+
+        /**
+         * @brief SSE4.1 卡方距离内核：每次处理 8 个分量
+         */
+        void distancesSSE41(const uint8_t* query, const uint8_t* rows, std::size_t stride, std::size_t rowCount, int cols, double* out) {
+            distances(query, rows, stride, rowCount, cols, out);
+        }
+
+        void distancesSSE41(const uint16_t* query, const uint16_t* rows, std::size_t stride, std::size_t rowCount, int cols, double* out) {
+            distances(query, rows, stride, rowCount, cols, out);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef HAAR_KERNELS_H
+#define HAAR_KERNELS_H
+
+#include <opencv2/opencv.hpp>
+#include <cmath>
+#include <vector>
+#include "HaarCascade.h"
+#include "SimdConfig.h"
+
+// Haar 级联窗口判定内核（HaarCascade 内部使用）
+// 各指令集版本位于独立的源文件中，按文件单独开启编译选项，运行时按 CPU 支持情况分派。
+
+namespace DriveGuard {
+    namespace haar {
+
+        /**
+         * @brief 按积分图行跨度换算后的特征（与 OpenCV HaarEvaluator::OptFeature 相同）
+         */
+        struct OptFeature {
+            int ofs[3][4];     // 各矩形四角相对窗口左上角的偏移（元素）：左上、右上、左下、右下
+            float weight[3];   // 矩形权重（第三个矩形不存在时为 0）
+        };
+
+        /**
+         * @brief 换算到当前积分图行跨度的级联
+         */
+        struct Cascade {
+            const HaarStage* stages;
+            int stageCount;
+            const HaarStump* stumps;
+            const OptFeature* features;
+            int normOfs[4];    // 方差归一化区域（窗口内缩 1 像素）四角的偏移
+            double normArea;   // 方差归一化区域面积
+        };
+
+        /**
+         * @brief 单个金字塔层的扫描范围
+         */
+        struct Level {
+            const int* sum;    // 积分图（首行首列为 0）
+            const int* sqsum;  // 平方积分图（按 32 位回绕存储，窗口内的差值仍然精确）
+            int stride;        // 行跨度（元素）
+            int width;         // 窗口左上角横坐标的取值范围 [0, width)
+            int step;          // 窗口步长
+        };
+
+        // 窗口判定结果：>0 通过全部级；0 未通过第一级（下一个窗口跳过）；<0 方差过小或在后续级被拒绝
+        const int WINDOW_PASSED = 1;
+        const int WINDOW_FLAT = -1;
+
+        /**
+         * @brief 将矩形换算为积分图四角偏移
+         */
+        inline void rectOffsets(const HaarRect& rect, int stride, int ofs[4]) {
+            ofs[0] = rect.y * stride + rect.x;
+            ofs[1] = rect.y * stride + rect.x + rect.width;
+            ofs[2] = (rect.y + rect.height) * stride + rect.x;
+            ofs[3] = (rect.y + rect.height) * stride + rect.x + rect.width;
+        }
+
+        inline int rectSum(const int* p, const int ofs[4]) {
+            return p[ofs[0]] - p[ofs[1]] - p[ofs[2]] + p[ofs[3]];
+        }
+
+        /**
+         * @brief 方差归一化因子（与 HaarEvaluator::setWindow 一致）
+         * @return 方差过小（近乎平坦的窗口）时返回 false
+         */
+        inline bool normFactor(const Cascade& cascade, const int* sum, const int* sqsum, float& factor) {
+            int valsum = rectSum(sum, cascade.normOfs);
+            unsigned valsqsum = (unsigned)sqsum[cascade.normOfs[0]] - (unsigned)sqsum[cascade.normOfs[1]]
+                              - (unsigned)sqsum[cascade.normOfs[2]] + (unsigned)sqsum[cascade.normOfs[3]];
+            double nf = cascade.normArea * valsqsum - (double)valsum * valsum;
+            if (nf <= 0.) return false;
+            factor = (float)(1. / std::sqrt(nf));
+            return cascade.normArea * factor < 1e-1;
+        }
+
+        /**
+         * @brief 单个窗口的逐级判定（与 OpenCV predictOrderedStump 相同的浮点运算顺序，作为参考实现）
+         */
+        inline int evaluateWindow(const Cascade& cascade, const int* sum, const int* sqsum) {
+            float factor;
+            if (!normFactor(cascade, sum, sqsum, factor)) return WINDOW_FLAT;
+
+            const HaarStump* stump = cascade.stumps;
+            for (int s = 0; s < cascade.stageCount; s++) {
+                const HaarStage& stage = cascade.stages[s];
+                double tmp = 0;
+                for (int i = 0; i < stage.ntrees; i++, stump++) {
+                    const OptFeature& f = cascade.features[stump->featureIdx];
+                    float ret = f.weight[0] * rectSum(sum, f.ofs[0]) + f.weight[1] * rectSum(sum, f.ofs[1]);
+                    if (f.weight[2] != 0.0f) ret += f.weight[2] * rectSum(sum, f.ofs[2]);
+                    float value = ret * factor;
+                    tmp += value < stump->threshold ? stump->left : stump->right;
+                }
+                if (tmp < stage.threshold) return -s;
+            }
+            return WINDOW_PASSED;
+        }
+
+        /**
+         * @brief 逐窗口扫描一行（首级失败时跳过下一个窗口，与 OpenCV 相同）
+         * @param hits 通过全部级的窗口左上角（追加）
+         */
+        inline void scanRowScalar(const Cascade& cascade, const Level& level, int y, std::vector<cv::Point>& hits) {
+            const int* sum = level.sum + (std::ptrdiff_t)y * level.stride;
+            const int* sqsum = level.sqsum + (std::ptrdiff_t)y * level.stride;
+            for (int x = 0; x < level.width; x += level.step) {
+                int result = evaluateWindow(cascade, sum + x, sqsum + x);
+                if (result > 0) hits.emplace_back(x, y);
+                if (result == 0) x += level.step;
+            }
+        }
+
+#if defined(DRIVEGUARD_SIMD_X86)
+        void scanRowAVX2(const Cascade& cascade, const Level& level, int y, std::vector<cv::Point>& hits);
+#endif
+
+    } // namespace haar
+} // namespace DriveGuard
+
+#endif // HAAR_KERNELS_H
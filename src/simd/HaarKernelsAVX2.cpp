@@ -0,0 +1,119 @@
+#include "HaarKernels.h"
+
+#if defined(DRIVEGUARD_SIMD_X86)
+#include <immintrin.h>
+#include <algorithm>
+
+namespace DriveGuard {
+    namespace haar {
+        namespace {
+            const int LANES = 8;
+
+            // 8 个窗口同一矩形的像素和（idx 为各窗口相对首个窗口的偏移）
+            inline __m256i rectSum8(const int* p, const int ofs[4], __m256i idx) {
+                __m256i a = _mm256_i32gather_epi32(p + ofs[0], idx, 4);
+                __m256i b = _mm256_i32gather_epi32(p + ofs[1], idx, 4);
+                __m256i c = _mm256_i32gather_epi32(p + ofs[2], idx, 4);
+                __m256i d = _mm256_i32gather_epi32(p + ofs[3], idx, 4);
+                return _mm256_add_epi32(_mm256_sub_epi32(_mm256_sub_epi32(a, b), c), d);
+            }
+
+            // 4 个窗口的方差归一化因子，返回有效窗口的位掩码
+            inline int normFactor4(__m128i valsum, __m128i valsqsum, double area, __m128& factor) {
+                const __m256d areaV = _mm256_set1_pd(area);
+                __m256d s = _mm256_cvtepi32_pd(valsum);
+                __m256d q = _mm256_cvtepi32_pd(valsqsum); // 窗口平方和远小于 2^31，按有符号转换即可
+                __m256d nf = _mm256_sub_pd(_mm256_mul_pd(areaV, q), _mm256_mul_pd(s, s));
+                __m256d positive = _mm256_cmp_pd(nf, _mm256_setzero_pd(), _CMP_GT_OQ);
+                factor = _mm256_cvtpd_ps(_mm256_div_pd(_mm256_set1_pd(1.), _mm256_sqrt_pd(nf)));
+                __m256d textured = _mm256_cmp_pd(_mm256_mul_pd(areaV, _mm256_cvtps_pd(factor)), _mm256_set1_pd(1e-1), _CMP_LT_OQ);
+                return _mm256_movemask_pd(_mm256_and_pd(positive, textured));
+            }
+
+            /**
+             * @brief 8 个相邻窗口成组逐级判定
+             * 每个弱分类器对 8 个窗口同时求特征值：乘加按 (w0*s0 + w1*s1) + w2*s2 的顺序分别计算（不使用 FMA），
+             * 阶段累加按 double 进行，与参考实现逐位一致。某一级后全部窗口都被拒绝即结束。
+             * @param valid 参与判定的窗口位掩码（行尾不足 8 个时）
+             */
+            void evaluate8(const Cascade& cascade, const int* sum, const int* sqsum, __m256i idx, int valid,
+                           int results[LANES]) {
+                __m256i valsum = rectSum8(sum, cascade.normOfs, idx);
+                __m256i valsqsum = rectSum8(sqsum, cascade.normOfs, idx);
+                __m128 factorLo, factorHi;
+                int textured = normFactor4(_mm256_castsi256_si128(valsum), _mm256_castsi256_si128(valsqsum),
+                                           cascade.normArea, factorLo)
+                             | normFactor4(_mm256_extracti128_si256(valsum, 1), _mm256_extracti128_si256(valsqsum, 1),
+                                           cascade.normArea, factorHi) << 4;
+                const __m256 factor = _mm256_set_m128(factorHi, factorLo);
+
+                int alive = valid & textured;
+                for (int k = 0; k < LANES; k++) results[k] = (alive >> k) & 1 ? WINDOW_PASSED : WINDOW_FLAT;
+
+                const HaarStump* stump = cascade.stumps;
+                for (int s = 0; s < cascade.stageCount && alive; s++) {
+                    const HaarStage& stage = cascade.stages[s];
+                    __m256d tmpLo = _mm256_setzero_pd();
+                    __m256d tmpHi = _mm256_setzero_pd();
+                    for (int i = 0; i < stage.ntrees; i++, stump++) {
+                        const OptFeature& f = cascade.features[stump->featureIdx];
+                        __m256 ret = _mm256_mul_ps(_mm256_set1_ps(f.weight[0]), _mm256_cvtepi32_ps(rectSum8(sum, f.ofs[0], idx)));
+                        ret = _mm256_add_ps(ret, _mm256_mul_ps(_mm256_set1_ps(f.weight[1]), _mm256_cvtepi32_ps(rectSum8(sum, f.ofs[1], idx))));
+                        if (f.weight[2] != 0.0f) {
+                            ret = _mm256_add_ps(ret, _mm256_mul_ps(_mm256_set1_ps(f.weight[2]), _mm256_cvtepi32_ps(rectSum8(sum, f.ofs[2], idx))));
+                        }
+                        __m256 value = _mm256_mul_ps(ret, factor);
+                        __m256 less = _mm256_cmp_ps(value, _mm256_set1_ps(stump->threshold), _CMP_LT_OQ);
+                        __m256 leaf = _mm256_blendv_ps(_mm256_set1_ps(stump->right), _mm256_set1_ps(stump->left), less);
+                        tmpLo = _mm256_add_pd(tmpLo, _mm256_cvtps_pd(_mm256_castps256_ps128(leaf)));
+                        tmpHi = _mm256_add_pd(tmpHi, _mm256_cvtps_pd(_mm256_extractf128_ps(leaf, 1)));
+                    }
+
+                    const __m256d threshold = _mm256_set1_pd((double)stage.threshold);
+                    int rejected = _mm256_movemask_pd(_mm256_cmp_pd(tmpLo, threshold, _CMP_LT_OQ))
+                                 | _mm256_movemask_pd(_mm256_cmp_pd(tmpHi, threshold, _CMP_LT_OQ)) << 4;
+                    rejected &= alive;
+                    for (int k = 0; k < LANES; k++) {
+                        if ((rejected >> k) & 1) results[k] = -s;
+                    }
+                    alive &= ~rejected;
+                }
+            }
+        }
+
+        /**
+         * @brief AVX2 扫描内核：每次判定一行中 8 个相邻窗口（x, x+step, ..., x+7*step）
+         * 成组判定后再按顺序应用首级失败跳过规则，被跳过窗口的判定结果直接丢弃，输出与逐窗口扫描相同。
+         */
+        void scanRowAVX2(const Cascade& cascade, const Level& level, int y, std::vector<cv::Point>& hits) {
+            const int* sum = level.sum + (std::ptrdiff_t)y * level.stride;
+            const int* sqsum = level.sqsum + (std::ptrdiff_t)y * level.stride;
+            const int positions = (level.width + level.step - 1) / level.step;
+            const __m256i laneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            const __m256i laneOffset = _mm256_mullo_epi32(laneIndex, _mm256_set1_epi32(level.step));
+
+            int results[LANES];
+            bool skip = false;
+            for (int first = 0; first < positions; first += LANES) {
+                const int lanes = std::min(LANES, positions - first);
+                const int x0 = first * level.step;
+
+                // 行尾不足 8 个窗口时，多余的通道重复读取首个窗口（结果丢弃）
+                __m256i inRange = _mm256_cmpgt_epi32(_mm256_set1_epi32(lanes), laneIndex);
+                __m256i idx = _mm256_and_si256(laneOffset, inRange);
+                evaluate8(cascade, sum + x0, sqsum + x0, idx, (1 << lanes) - 1, results);
+
+                for (int k = 0; k < lanes; k++) {
+                    if (skip) {
+                        skip = false;
+                        continue;
+                    }
+                    if (results[k] > 0) hits.emplace_back(x0 + k * level.step, y);
+                    skip = results[k] == 0;
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef LBP_KERNELS_H
+#define LBP_KERNELS_H
+
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include "SimdConfig.h"
+
+// LBP 编码内核（LBPFeatureExtractor 内部使用）
+// 各指令集版本位于独立的源文件中，按文件单独开启编译选项，运行时按 CPU 支持情况分派。
+
+namespace DriveGuard {
+    namespace lbp {
+
+        /**
+         * @brief 单个邻域采样点
+         * 插值权重与采样位置与 OpenCV elbp_ 的计算方式完全一致；
+         * 采样点恰好落在整数像素上（exact）时，插值结果等于该像素值，可直接整数比较。
+         */
+        struct Neighbor {
+            std::ptrdiff_t offsets[4]; // 四个插值像素相对中心像素的字节偏移：(fy,fx) (fy,cx) (cy,fx) (cy,cx)
+            float weights[4];          // 对应的双线性插值权重 w1..w4
+            bool exact;                // 采样点是否落在整数像素上
+            int exactIndex;            // exact 时实际采样的像素（offsets 下标）
+        };
+
+        /**
+         * @brief 编码内核的输入输出描述
+         */
+        struct CodeImage {
+            const unsigned char* src;  // 输入灰度图首行
+            std::size_t srcStep;       // 输入行跨度（字节）
+            int rows;                  // 输入行数
+            int cols;                  // 输入列数
+            int radius;                // LBP 半径
+            unsigned char* dst;        // 输出编码图（(rows-2r) x (cols-2r)）
+            std::size_t dstStep;       // 输出行跨度（字节）
+        };
+
+        /**
+         * @brief 单个像素的 LBP 编码（与 OpenCV elbp_ 相同的浮点运算顺序，作为参考实现与各内核的尾部处理）
+         * @param center 中心像素地址
+         * @param neighbors 邻域采样点
+         * @param count 邻域点数（不超过 8）
+         */
+        inline unsigned char encodePixel(const unsigned char* center, const Neighbor* neighbors, int count) {
+            const unsigned char c = *center;
+            unsigned code = 0;
+            for (int n = 0; n < count; n++) {
+                const Neighbor& nb = neighbors[n];
+                float t = static_cast<float>(nb.weights[0] * center[nb.offsets[0]] + nb.weights[1] * center[nb.offsets[1]]
+                                           + nb.weights[2] * center[nb.offsets[2]] + nb.weights[3] * center[nb.offsets[3]]);
+                code |= (unsigned)((t > c) || (std::abs(t - c) < FLT_EPSILON)) << n;
+            }
+            return (unsigned char)code;
+        }
+
+        /**
+         * @brief 逐像素参考实现
+         */
+        inline void encodeScalar(const CodeImage& image, const Neighbor* neighbors, int count) {
+            const int outRows = image.rows - 2 * image.radius;
+            const int outCols = image.cols - 2 * image.radius;
+            for (int i = 0; i < outRows; i++) {
+                const unsigned char* center = image.src + (i + image.radius) * image.srcStep + image.radius;
+                unsigned char* out = image.dst + i * image.dstStep;
+                for (int j = 0; j < outCols; j++) {
+                    out[j] = encodePixel(center + j, neighbors, count);
+                }
+            }
+        }
+
+#if defined(DRIVEGUARD_SIMD_X86)
+        void encodeSSE41(const CodeImage& image, const Neighbor* neighbors, int count);
+        void encodeAVX2(const CodeImage& image, const Neighbor* neighbors, int count);
+#endif
+#if defined(DRIVEGUARD_SIMD_NEON)
+        void encodeNEON(const CodeImage& image, const Neighbor* neighbors, int count);
+#endif
+
+    } // namespace lbp
+} // namespace DriveGuard
+
+#endif // LBP_KERNELS_H
@@ -0,0 +1,69 @@
+#include "LBPKernels.h"
+
+#if defined(DRIVEGUARD_SIMD_X86)
+#include <immintrin.h>
+#include <cstring>
+
+namespace DriveGuard {
+    namespace lbp {
+        namespace {
+            // 加载 8 个像素并扩展为 8 x int32
+            inline __m256i load8(const unsigned char* p) {
+                return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+            }
+        }
+
+        /**
+         * @brief AVX2 编码内核：每次处理 8 个像素
+         * 插值采样点按 ((w1*a + w2*b) + w3*c) + w4*d 的顺序分别乘加（不使用 FMA），
+         * 与参考实现逐位一致；整数采样点直接做 a >= c 的整数比较。
+         */
+        void encodeAVX2(const CodeImage& image, const Neighbor* neighbors, int count) {
+            const int outRows = image.rows - 2 * image.radius;
+            const int outCols = image.cols - 2 * image.radius;
+            const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+            const __m256 epsilon = _mm256_set1_ps(FLT_EPSILON);
+
+            for (int i = 0; i < outRows; i++) {
+                const unsigned char* center = image.src + (i + image.radius) * image.srcStep + image.radius;
+                unsigned char* out = image.dst + i * image.dstStep;
+
+                int j = 0;
+                for (; j + 8 <= outCols; j += 8) {
+                    const unsigned char* p = center + j;
+                    const __m256i ci = load8(p);
+                    const __m256 cf = _mm256_cvtepi32_ps(ci);
+                    __m256i code = _mm256_setzero_si256();
+
+                    for (int n = 0; n < count; n++) {
+                        const Neighbor& nb = neighbors[n];
+                        const __m256i bit = _mm256_set1_epi32(1 << n);
+                        if (nb.exact) {
+                            // a >= c  <=>  !(c > a)
+                            __m256i a = load8(p + nb.offsets[nb.exactIndex]);
+                            code = _mm256_or_si256(code, _mm256_andnot_si256(_mm256_cmpgt_epi32(ci, a), bit));
+                        } else {
+                            __m256 t = _mm256_mul_ps(_mm256_set1_ps(nb.weights[0]), _mm256_cvtepi32_ps(load8(p + nb.offsets[0])));
+                            t = _mm256_add_ps(t, _mm256_mul_ps(_mm256_set1_ps(nb.weights[1]), _mm256_cvtepi32_ps(load8(p + nb.offsets[1]))));
+                            t = _mm256_add_ps(t, _mm256_mul_ps(_mm256_set1_ps(nb.weights[2]), _mm256_cvtepi32_ps(load8(p + nb.offsets[2]))));
+                            t = _mm256_add_ps(t, _mm256_mul_ps(_mm256_set1_ps(nb.weights[3]), _mm256_cvtepi32_ps(load8(p + nb.offsets[3]))));
+                            __m256 greater = _mm256_cmp_ps(t, cf, _CMP_GT_OQ);
+                            __m256 close = _mm256_cmp_ps(_mm256_and_ps(_mm256_sub_ps(t, cf), absMask), epsilon, _CMP_LT_OQ);
+                            code = _mm256_or_si256(code, _mm256_and_si256(_mm256_castps_si256(_mm256_or_ps(greater, close)), bit));
+                        }
+                    }
+
+                    // 8 x int32 -> 8 x uint8
+                    __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(code), _mm256_extracti128_si256(code, 1));
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + j), _mm_packus_epi16(packed, packed));
+                }
+
+                for (; j < outCols; j++) {
+                    out[j] = encodePixel(center + j, neighbors, count);
+                }
+            }
+        }
+    }
+}
+
+#endif
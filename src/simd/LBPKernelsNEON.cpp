@@ -0,0 +1,83 @@
+#include "LBPKernels.h"
+
+#if defined(DRIVEGUARD_SIMD_NEON)
+#include <arm_neon.h>
+
+namespace DriveGuard {
+    namespace lbp {
+        namespace {
+            // 8 x uint8 -> 2 x (4 x float32)
+            inline void widen8(uint8x8_t v, float32x4_t& lo, float32x4_t& hi) {
+                uint16x8_t w = vmovl_u8(v);
+                lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(w)));
+                hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(w)));
+            }
+
+            // 单独的乘法与加法（vmlaq_f32 在部分编译器上会被融合为 FMA）
+            inline void interpolate(const unsigned char* p, const Neighbor& nb, float32x4_t& lo, float32x4_t& hi) {
+                for (int k = 0; k < 4; k++) {
+                    float32x4_t aLo, aHi;
+                    widen8(vld1_u8(p + nb.offsets[k]), aLo, aHi);
+                    const float32x4_t w = vdupq_n_f32(nb.weights[k]);
+                    if (k == 0) {
+                        lo = vmulq_f32(w, aLo);
+                        hi = vmulq_f32(w, aHi);
+                    } else {
+                        lo = vaddq_f32(lo, vmulq_f32(w, aLo));
+                        hi = vaddq_f32(hi, vmulq_f32(w, aHi));
+                    }
+                }
+            }
+
+            inline uint16x4_t matchMask(float32x4_t t, float32x4_t c, float32x4_t epsilon) {
+                uint32x4_t greater = vcgtq_f32(t, c);
+                uint32x4_t close = vcltq_f32(vabsq_f32(vsubq_f32(t, c)), epsilon);
+                return vmovn_u32(vorrq_u32(greater, close));
+            }
+        }
+
+        /**
+         * @brief NEON 编码内核：每次处理 8 个像素（运算顺序同 x86 内核）
+         */
+        void encodeNEON(const CodeImage& image, const Neighbor* neighbors, int count) {
+            const int outRows = image.rows - 2 * image.radius;
+            const int outCols = image.cols - 2 * image.radius;
+            const float32x4_t epsilon = vdupq_n_f32(FLT_EPSILON);
+
+            for (int i = 0; i < outRows; i++) {
+                const unsigned char* center = image.src + (i + image.radius) * image.srcStep + image.radius;
+                unsigned char* out = image.dst + i * image.dstStep;
+
+                int j = 0;
+                for (; j + 8 <= outCols; j += 8) {
+                    const unsigned char* p = center + j;
+                    const uint8x8_t c8 = vld1_u8(p);
+                    float32x4_t cLo, cHi;
+                    widen8(c8, cLo, cHi);
+                    uint8x8_t code = vdup_n_u8(0);
+
+                    for (int n = 0; n < count; n++) {
+                        const Neighbor& nb = neighbors[n];
+                        const uint8x8_t bit = vdup_n_u8((uint8_t)(1u << n));
+                        uint8x8_t mask;
+                        if (nb.exact) {
+                            mask = vcge_u8(vld1_u8(p + nb.offsets[nb.exactIndex]), c8);
+                        } else {
+                            float32x4_t tLo, tHi;
+                            interpolate(p, nb, tLo, tHi);
+                            mask = vmovn_u16(vcombine_u16(matchMask(tLo, cLo, epsilon), matchMask(tHi, cHi, epsilon)));
+                        }
+                        code = vorr_u8(code, vand_u8(mask, bit));
+                    }
+                    vst1_u8(out + j, code);
+                }
+
+                for (; j < outCols; j++) {
+                    out[j] = encodePixel(center + j, neighbors, count);
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,69 @@
+#include "LBPKernels.h"
+
+#if defined(DRIVEGUARD_SIMD_X86)
+#include <smmintrin.h>
+#include <cstring>
+
+namespace DriveGuard {
+    namespace lbp {
+        namespace {
+            // 加载 4 个像素并扩展为 4 x int32
+            inline __m128i load4(const unsigned char* p) {
+                int v;
+                std::memcpy(&v, p, sizeof(v));
+                return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(v));
+            }
+        }
+
+        /**
+         * @brief SSE4.1 编码内核：每次处理 4 个像素（运算顺序同 AVX2 内核）
+         */
+        void encodeSSE41(const CodeImage& image, const Neighbor* neighbors, int count) {
+            const int outRows = image.rows - 2 * image.radius;
+            const int outCols = image.cols - 2 * image.radius;
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+            const __m128 epsilon = _mm_set1_ps(FLT_EPSILON);
+
+            for (int i = 0; i < outRows; i++) {
+                const unsigned char* center = image.src + (i + image.radius) * image.srcStep + image.radius;
+                unsigned char* out = image.dst + i * image.dstStep;
+
+                int j = 0;
+                for (; j + 4 <= outCols; j += 4) {
+                    const unsigned char* p = center + j;
+                    const __m128i ci = load4(p);
+                    const __m128 cf = _mm_cvtepi32_ps(ci);
+                    __m128i code = _mm_setzero_si128();
+
+                    for (int n = 0; n < count; n++) {
+                        const Neighbor& nb = neighbors[n];
+                        const __m128i bit = _mm_set1_epi32(1 << n);
+                        if (nb.exact) {
+                            __m128i a = load4(p + nb.offsets[nb.exactIndex]);
+                            code = _mm_or_si128(code, _mm_andnot_si128(_mm_cmpgt_epi32(ci, a), bit));
+                        } else {
+                            __m128 t = _mm_mul_ps(_mm_set1_ps(nb.weights[0]), _mm_cvtepi32_ps(load4(p + nb.offsets[0])));
+                            t = _mm_add_ps(t, _mm_mul_ps(_mm_set1_ps(nb.weights[1]), _mm_cvtepi32_ps(load4(p + nb.offsets[1]))));
+                            t = _mm_add_ps(t, _mm_mul_ps(_mm_set1_ps(nb.weights[2]), _mm_cvtepi32_ps(load4(p + nb.offsets[2]))));
+                            t = _mm_add_ps(t, _mm_mul_ps(_mm_set1_ps(nb.weights[3]), _mm_cvtepi32_ps(load4(p + nb.offsets[3]))));
+                            __m128 greater = _mm_cmpgt_ps(t, cf);
+                            __m128 close = _mm_cmplt_ps(_mm_and_ps(_mm_sub_ps(t, cf), absMask), epsilon);
+                            code = _mm_or_si128(code, _mm_and_si128(_mm_castps_si128(_mm_or_ps(greater, close)), bit));
+                        }
+                    }
+
+                    // 4 x int32 -> 4 x uint8
+                    __m128i packed = _mm_packus_epi32(code, code);
+                    int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(packed, packed));
+                    std::memcpy(out + j, &bytes, sizeof(bytes));
+                }
+
+                for (; j < outCols; j++) {
+                    out[j] = encodePixel(center + j, neighbors, count);
+                }
+            }
+        }
+    }
+}
+
+#endif
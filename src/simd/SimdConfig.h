@@ -0,0 +1,16 @@
+#ifndef SIMD_CONFIG_H
+#define SIMD_CONFIG_H
+
+// 编译期可用的 SIMD 内核（运行时再由 isSimdAvailable 按 CPU 支持情况分派）
+
+#if !defined(DRIVEGUARD_NO_SIMD)
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DRIVEGUARD_SIMD_X86 1
+#endif
+// NEON 内核仅在 AArch64 上启用（依赖 vdivq_f32 等 ARMv8 指令）
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define DRIVEGUARD_SIMD_NEON 1
+#endif
+#endif
+
+#endif // SIMD_CONFIG_H
@@ -0,0 +1,102 @@
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "EnrollmentService.h"
+#include "FaceDetector.h"
+#include "FaceRecognizer.h"
+#include "FrameAnalyzer.h"
+#include "SyntheticFaceSource.h"
+
+// 人脸在连续闭眼中途短暂丢失：驾驶员闭眼 1 秒后人脸消失 10 帧（约 0.33 秒，短于轨迹超时），
+// 回来后继续闭眼约 2.7 秒。轨迹须关联回原编号、沿用原有的疲劳状态，
+// 连续闭眼计时跨越间隔（总计约 4 秒）判定睡眠；若回来时新建轨迹，计时从零开始，达不到睡眠时长
+
+using namespace DriveGuard;
+
+namespace {
+    const long OPEN_FRAMES = 15;      // 睁眼
+    const long CLOSED_FRAMES = 30;    // 丢失前闭眼
+    const long GAP_FRAMES = 10;       // 人脸丢失
+    const long RETURN_FRAMES = 80;    // 回来后继续闭眼
+    const int FRAME_INTERVAL_MS = 33; // 帧间隔（按采集时间戳推进，与实际处理耗时无关）
+}
+
+int main(int argc, char* argv[]) {
+    std::string modelDir = argc > 1 ? argv[1] : "../models";
+    FaceDetector detector(modelDir + "/haarcascade_frontalface_default.xml", modelDir + "/haarcascade_eye.xml");
+    if (!detector.isModelLoaded()) return 1;
+
+    // 在内存中把合成人脸录入为驾驶员（录入服务不启动，不写回模型）
+    std::vector<cv::Mat> samples = SyntheticFaceSource::enrollmentSamples(detector, 10);
+    if (samples.empty()) {
+        std::cerr << "[ERROR] 合成画面中检不出人脸" << std::endl;
+        return 1;
+    }
+    auto recognizer = std::make_shared<FaceRecognizer>();
+    recognizer->update(samples, std::vector<int>(samples.size(), 0));
+    recognizer->setLabelInfo(0, "driver", UserRole::DRIVER);
+    EnrollmentService enrollment(recognizer, "", "");
+
+    AnalyzerConfig config;
+    config.shedder.enabled = false; // 时间戳为合成的，不按实际耗时降载
+    FrameAnalyzer analyzer(detector, enrollment, config, ModelState::RECOGNIZING);
+
+    const long returnFrom = OPEN_FRAMES + CLOSED_FRAMES + GAP_FRAMES;
+    SyntheticFaceSource source(returnFrom + RETURN_FRAMES, [](long index) {
+        SyntheticFrame appearance;
+        appearance.eyesOpen = index < OPEN_FRAMES;
+        appearance.faceVisible = index < OPEN_FRAMES + CLOSED_FRAMES || index >= OPEN_FRAMES + CLOSED_FRAMES + GAP_FRAMES;
+        appearance.offset = cv::Point((int)(index % 3) * 2, 0);
+        return appearance;
+    });
+
+    FramePacket packet;
+    Clock::time_point start = Clock::now();
+    long index = 0;
+    int trackBefore = -1;
+    int trackAfter = -1;
+    bool sawOpenEyes = false;
+    bool sleepingBeforeGap = false;
+    bool sleeping = false;
+    while (source.read(packet.frame)) {
+        packet.seq = (uint64_t)index;
+        packet.captureTime = start + std::chrono::milliseconds(FRAME_INTERVAL_MS * index);
+        analyzer.detect(packet);
+        analyzer.analyze(packet);
+
+        for (const auto& result : packet.results) {
+            if (result.role != UserRole::DRIVER) continue;
+            if (index < OPEN_FRAMES && result.eyes.size() == 2) sawOpenEyes = true;
+            if (index < returnFrom) {
+                trackBefore = result.trackId;
+                sleepingBeforeGap = sleepingBeforeGap || result.driverState == DriverState::SLEEPING;
+            } else {
+                if (trackAfter < 0) trackAfter = result.trackId;
+                sleeping = sleeping || result.driverState == DriverState::SLEEPING;
+            }
+        }
+        index++;
+    }
+
+    if (!sawOpenEyes || trackBefore < 0) {
+        std::cerr << "[ERROR] 合成人脸未被识别为驾驶员或睁眼时未检出眼睛" << std::endl;
+        return 1;
+    }
+    if (sleepingBeforeGap) {
+        std::cerr << "[ERROR] 人脸丢失前闭眼时长不足，不应判定睡眠" << std::endl;
+        return 1;
+    }
+    if (trackAfter != trackBefore) {
+        std::cerr << "[ERROR] 人脸丢失后回来新建了轨迹：" << trackBefore << " -> " << trackAfter << std::endl;
+        return 1;
+    }
+    if (!sleeping) {
+        std::cerr << "[ERROR] 连续闭眼跨越人脸丢失间隔后未判定睡眠" << std::endl;
+        return 1;
+    }
+    std::cout << "[INFO] 人脸丢失 " << GAP_FRAMES << " 帧后沿用轨迹 " << trackBefore << "，判定睡眠" << std::endl;
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "EnrollmentService.h"
+#include "FaceDetector.h"
+#include "FaceRecognizer.h"
+#include "FrameAnalyzer.h"
+#include "Metrics.h"
+#include "SyntheticFaceSource.h"
+
+// 关闭身份缓存（每帧完整识别）时降载跳过乘客：合成人脸录入为乘客，每帧的采集时间早于分析 1 秒，
+// 平均延迟持续超出预算，降载升到 SKIP_PASSENGERS 之后，已确认的乘客须沿用上次结果、不再预测，
+// 且仍显示为已识别的乘客；升级之前每帧都须完整预测（缓存关闭，不会命中）
+
+using namespace DriveGuard;
+
+namespace {
+    const long FRAMES = 40;
+    const int STALE_MS = 1000; // 采集时间早于分析的时长（超出预算）
+}
+
+int main(int argc, char* argv[]) {
+    std::string modelDir = argc > 1 ? argv[1] : "../models";
+    FaceDetector detector(modelDir + "/haarcascade_frontalface_default.xml", modelDir + "/haarcascade_eye.xml");
+    if (!detector.isModelLoaded()) return 1;
+
+    // 在内存中把合成人脸录入为乘客（录入服务不启动，不写回模型）
+    std::vector<cv::Mat> samples = SyntheticFaceSource::enrollmentSamples(detector, 10);
+    if (samples.empty()) {
+        std::cerr << "[ERROR] 合成画面中检不出人脸" << std::endl;
+        return 1;
+    }
+    auto recognizer = std::make_shared<FaceRecognizer>();
+    recognizer->update(samples, std::vector<int>(samples.size(), 0));
+    recognizer->setLabelInfo(0, "passenger", UserRole::PASSENGER);
+    EnrollmentService enrollment(recognizer, "", "");
+
+    AnalyzerConfig config;
+    config.identityCache.enabled = false;
+    config.shedder.budgetMs = STALE_MS / 2;
+    config.shedder.reducedScale = 1.0; // 继续升级到 REDUCE_DETECTION 时检测结果不变（测试不调用 admit()，不会丢帧）
+    FrameAnalyzer analyzer(detector, enrollment, config, ModelState::RECOGNIZING);
+
+    SyntheticFaceSource source(FRAMES, [](long index) {
+        SyntheticFrame appearance;
+        appearance.offset = cv::Point((int)(index % 3) * 2, 0);
+        return appearance;
+    });
+
+    FramePacket packet;
+    long index = 0;
+    long predictedBeforeShedding = 0;
+    long shedFrames = 0;
+    while (source.read(packet.frame)) {
+        packet.seq = (uint64_t)index;
+        packet.captureTime = Clock::now() - std::chrono::milliseconds(STALE_MS);
+        bool shedding = Metrics::counterValue(Counter::SHED_ESCALATIONS) > 0;
+        uint64_t predictions = Metrics::counterValue(Counter::IDENTITY_CACHE_MISSES);
+        uint64_t skipped = Metrics::counterValue(Counter::SHED_PASSENGERS);
+        analyzer.detect(packet);
+        analyzer.analyze(packet);
+
+        bool passenger = packet.results.size() == 1 && packet.results[0].identified
+                      && packet.results[0].role == UserRole::PASSENGER;
+        predictions = Metrics::counterValue(Counter::IDENTITY_CACHE_MISSES) - predictions;
+        skipped = Metrics::counterValue(Counter::SHED_PASSENGERS) - skipped;
+        if (!shedding) {
+            if (passenger && predictions == 1) predictedBeforeShedding++;
+        } else {
+            if (!passenger) {
+                std::cerr << "[ERROR] 第 " << index << " 帧降载时乘客未沿用识别结果" << std::endl;
+                return 1;
+            }
+            if (predictions != 0 || skipped != 1) {
+                std::cerr << "[ERROR] 第 " << index << " 帧降载时仍重新识别了乘客（预测 " << predictions
+                          << " 次，跳过 " << skipped << " 次）" << std::endl;
+                return 1;
+            }
+            shedFrames++;
+        }
+        index++;
+    }
+
+    if (predictedBeforeShedding == 0) {
+        std::cerr << "[ERROR] 降载之前合成人脸未被识别为乘客" << std::endl;
+        return 1;
+    }
+    if (shedFrames == 0) {
+        std::cerr << "[ERROR] 延迟持续超出预算，降载级别未上升" << std::endl;
+        return 1;
+    }
+    std::cout << "[INFO] 关闭身份缓存时降载跳过乘客 " << shedFrames << " 帧（降载前完整识别 "
+              << predictedBeforeShedding << " 帧）" << std::endl;
+    return 0;
+}
@@ -0,0 +1,203 @@
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "FrameContext.h"
+#include "FrameSource.h"
+#include "HaarCascade.h"
+
+// 级联检测微基准：对比 cv::CascadeClassifier 与编译级联（HaarCascade）各内核的模型加载与
+// 每帧检测耗时，并逐帧校验检测结果一致（人脸、未合并的候选窗口、人脸区域内的眼睛）
+
+using BenchClock = std::chrono::steady_clock;
+
+static double elapsedMs(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+static void printUsage(const char* program) {
+    std::cout << "用法: " << program << " [选项]" << std::endl;
+    std::cout << "  --input <输入>      视频文件、图片目录或其他输入源，默认使用合成帧" << std::endl;
+    std::cout << "  --models <目录>     模型目录，默认 ../models" << std::endl;
+    std::cout << "  --frames <N>        最多使用的帧数，默认 50" << std::endl;
+    std::cout << "  --iterations <N>    重复次数，默认 3" << std::endl;
+}
+
+/**
+ * @brief 生成合成帧（低分辨率随机纹理放大并叠加椭圆，含大量缓变区域）
+ */
+static std::vector<cv::Mat> syntheticFrames(int count) {
+    std::vector<cv::Mat> frames;
+    cv::RNG rng(12345);
+    for (int i = 0; i < count; i++) {
+        cv::Mat coarse(24 + i % 9, 32 + i % 11, CV_8UC1);
+        cv::randu(coarse, cv::Scalar(0), cv::Scalar(256));
+        cv::Mat frame;
+        cv::resize(coarse, frame, cv::Size(640, 480), 0, 0, cv::INTER_CUBIC);
+        for (int k = 0; k < 6; k++) {
+            cv::Point center(rng.uniform(60, 580), rng.uniform(60, 420));
+            cv::Size axes(rng.uniform(20, 90), rng.uniform(20, 90));
+            cv::ellipse(frame, center, axes, 0, 0, 360, cv::Scalar(rng.uniform(0, 256)), -1);
+        }
+        cv::equalizeHist(frame, frame);
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+/**
+ * @brief 读取输入源的前若干帧（预处理为均衡化灰度图，与检测器的输入一致）
+ */
+static std::vector<cv::Mat> loadFrames(const std::string& input, int count) {
+    std::vector<cv::Mat> frames;
+    auto source = DriveGuard::FrameSource::create(input);
+    if (!source) return frames;
+
+    DriveGuard::FrameContext context;
+    cv::Mat frame;
+    while ((int)frames.size() < count && source->read(frame)) {
+        if (frame.empty()) continue;
+        context.prepare(frame);
+        frames.push_back(context.equalized().clone());
+    }
+    return frames;
+}
+
+/**
+ * @brief 按坐标排序（两种实现的输出顺序可能不同，比较的是集合）
+ */
+static std::vector<cv::Rect> sorted(std::vector<cv::Rect> rects) {
+    std::sort(rects.begin(), rects.end(), [](const cv::Rect& a, const cv::Rect& b) {
+        return std::tie(a.x, a.y, a.width, a.height) < std::tie(b.x, b.y, b.width, b.height);
+    });
+    return rects;
+}
+
+// 一种检测场景：对每帧（或每个人脸区域）执行一次检测
+struct Scenario {
+    std::string name;
+    std::vector<cv::Mat> images;
+    double scaleFactor;
+    int minNeighbors;
+    cv::Size minSize;
+};
+
+// 检测函数：(场景, 图像, 输出)
+using DetectFn = std::function<void(const Scenario&, const cv::Mat&, std::vector<cv::Rect>&)>;
+
+/**
+ * @brief 运行一个场景并返回每张图像的平均耗时（毫秒）
+ */
+static double run(const Scenario& scenario, const DetectFn& detect, int iterations,
+                  std::vector<std::vector<cv::Rect>>& results) {
+    results.assign(scenario.images.size(), {});
+    BenchClock::time_point t0 = BenchClock::now();
+    for (int it = 0; it < iterations; it++) {
+        for (std::size_t i = 0; i < scenario.images.size(); i++) {
+            detect(scenario, scenario.images[i], results[i]);
+        }
+    }
+    return elapsedMs(t0) / ((double)iterations * std::max<std::size_t>(1, scenario.images.size()));
+}
+
+int main(int argc, char* argv[]) {
+    std::string input;
+    std::string modelDir = "../models";
+    int frameCount = 50;
+    int iterations = 3;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--input" && i + 1 < argc) input = argv[++i];
+        else if (arg == "--models" && i + 1 < argc) modelDir = argv[++i];
+        else if (arg == "--frames" && i + 1 < argc) frameCount = std::stoi(argv[++i]);
+        else if (arg == "--iterations" && i + 1 < argc) iterations = std::stoi(argv[++i]);
+        else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : -1;
+        }
+    }
+
+#ifndef DRIVEGUARD_COMPILED_CASCADES
+    (void)input; (void)modelDir; (void)frameCount; (void)iterations;
+    std::cerr << "[ERROR] 本构建未包含编译级联 (DRIVEGUARD_COMPILED_CASCADES=OFF)" << std::endl;
+    return -1;
+#else
+    std::vector<cv::Mat> frames = input.empty() ? syntheticFrames(frameCount) : loadFrames(input, frameCount);
+    if (frames.empty()) {
+        std::cerr << "[ERROR] 没有可用的帧" << std::endl;
+        return -1;
+    }
+
+    // 模型加载：XML 解析 vs 编译级联
+    BenchClock::time_point t0 = BenchClock::now();
+    cv::CascadeClassifier faceReference(modelDir + "/haarcascade_frontalface_default.xml");
+    cv::CascadeClassifier eyeReference(modelDir + "/haarcascade_eye.xml");
+    double xmlLoadMs = elapsedMs(t0);
+    if (faceReference.empty() || eyeReference.empty()) {
+        std::cerr << "[ERROR] 无法读取级联模型：" << modelDir << std::endl;
+        return -1;
+    }
+    t0 = BenchClock::now();
+    DriveGuard::HaarCascade faceProbe(DriveGuard::cascades::FRONTAL_FACE);
+    DriveGuard::HaarCascade eyeProbe(DriveGuard::cascades::EYE);
+    double compiledLoadMs = elapsedMs(t0);
+
+    // 场景：与 FaceDetector 相同的参数；另以 minNeighbors = 0 比较未合并的全部候选窗口
+    Scenario faces{"face", frames, 1.1, 5, cv::Size(30, 30)};
+    Scenario raw{"face-raw", frames, 1.1, 0, cv::Size(30, 30)};
+    Scenario eyes{"eye", {}, 1.1, 3, cv::Size(15, 15)};
+    for (const auto& frame : frames) {
+        std::vector<cv::Rect> found;
+        faceReference.detectMultiScale(frame, found, faces.scaleFactor, faces.minNeighbors, 0, faces.minSize);
+        // 合成帧中没有人脸时取中心区域，仍可比较眼睛级联的判定
+        if (found.empty()) found.push_back(cv::Rect(frame.cols / 2 - 80, frame.rows / 2 - 80, 160, 160));
+        for (const auto& box : found) eyes.images.push_back(frame(box & cv::Rect(0, 0, frame.cols, frame.rows)));
+    }
+
+    std::cout << "===========================================" << std::endl;
+    std::printf("帧数: %zu  人脸区域: %zu  重复: %d  尺寸: %dx%d\n", frames.size(), eyes.images.size(), iterations,
+                frames[0].cols, frames[0].rows);
+    std::printf("模型加载: XML %.2f ms  编译级联 %.3f ms\n", xmlLoadMs, compiledLoadMs);
+    std::printf("%-10s %-10s %12s %10s %12s\n", "case", "path", "ms/image", "speedup", "identical");
+
+    using Kernel = DriveGuard::HaarCascade::Kernel;
+    bool allIdentical = true;
+    for (const Scenario* scenario : {&faces, &raw, &eyes}) {
+        cv::CascadeClassifier& reference = scenario == &eyes ? eyeReference : faceReference;
+        std::vector<std::vector<cv::Rect>> expected;
+        double referenceMs = run(*scenario, [&](const Scenario& s, const cv::Mat& image, std::vector<cv::Rect>& out) {
+            reference.detectMultiScale(image, out, s.scaleFactor, s.minNeighbors, 0, s.minSize);
+        }, iterations, expected);
+        std::printf("%-10s %-10s %12.3f %10s %12s\n", scenario->name.c_str(), "opencv", referenceMs, "1.00x", "-");
+
+        for (Kernel kernel : {Kernel::SCALAR, Kernel::AVX2}) {
+            if (!DriveGuard::isSimdAvailable(kernel)) continue;
+            DriveGuard::HaarCascade cascade(scenario == &eyes ? DriveGuard::cascades::EYE
+                                                              : DriveGuard::cascades::FRONTAL_FACE, kernel);
+            std::vector<std::vector<cv::Rect>> actual;
+            double ms = run(*scenario, [&](const Scenario& s, const cv::Mat& image, std::vector<cv::Rect>& out) {
+                cascade.detectMultiScale(image, out, s.scaleFactor, s.minNeighbors, s.minSize);
+            }, iterations, actual);
+
+            std::size_t mismatches = 0;
+            for (std::size_t i = 0; i < expected.size(); i++) {
+                if (sorted(expected[i]) != sorted(actual[i])) mismatches++;
+            }
+            allIdentical = allIdentical && mismatches == 0;
+
+            char identical[32];
+            std::snprintf(identical, sizeof(identical), mismatches == 0 ? "yes" : "NO (%zu)", mismatches);
+            std::printf("%-10s %-10s %12.3f %9.2fx %12s\n", scenario->name.c_str(),
+                        DriveGuard::simdLevelName(cascade.kernel()), ms, referenceMs / ms, identical);
+        }
+    }
+
+    return allIdentical ? 0 : 1;
+#endif
+}
@@ -0,0 +1,239 @@
+#include <opencv2/opencv.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 级联编译工具：将 OpenCV 的 Haar 级联 XML（stump 结构、非倾斜特征）转换为 C++ 常量表，
+// 由构建过程调用，生成的源文件编入核心库后运行时无需解析 XML（见 HaarCascade.h）
+
+namespace {
+    // 与 OpenCV 读取级联时相同：各级阈值减去该值
+    const float THRESHOLD_EPS = 1e-5f;
+
+    struct Rect {
+        int x = 0, y = 0, width = 0, height = 0;
+        float weight = 0.0f;
+    };
+
+    struct Stump {
+        int featureIdx;
+        float threshold;
+        float left;
+        float right;
+    };
+
+    struct Stage {
+        int ntrees;
+        float threshold;
+    };
+
+    struct Cascade {
+        int width = 0;
+        int height = 0;
+        std::vector<Stage> stages;
+        std::vector<Stump> stumps;
+        std::vector<std::vector<Rect>> features;
+    };
+
+    /**
+     * @brief 浮点常量（9 位有效数字，与 float 往返一致）
+     */
+    std::string literal(float value) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.8ef", value);
+        return buffer;
+    }
+
+    /**
+     * @brief 读取级联（数值的读取与类型转换方式与 cv::CascadeClassifier 相同）
+     */
+    bool readCascade(const cv::FileNode& root, Cascade& cascade) {
+        if ((std::string)root["stageType"] != "BOOST" || (std::string)root["featureType"] != "HAAR") {
+            std::cerr << "[ERROR] 仅支持 BOOST + HAAR 级联" << std::endl;
+            return false;
+        }
+        cascade.width = (int)root["width"];
+        cascade.height = (int)root["height"];
+        if (cascade.width <= 2 || cascade.height <= 2) {
+            std::cerr << "[ERROR] 无效的检测窗口尺寸" << std::endl;
+            return false;
+        }
+
+        for (const auto& stageNode : root["stages"]) {
+            Stage stage;
+            stage.threshold = (float)stageNode["stageThreshold"] - THRESHOLD_EPS;
+            stage.ntrees = 0;
+            for (const auto& weak : stageNode["weakClassifiers"]) {
+                cv::FileNode nodes = weak["internalNodes"];
+                cv::FileNode leaves = weak["leafValues"];
+                if (nodes.size() != 4 || leaves.size() != 2) {
+                    std::cerr << "[ERROR] 仅支持单节点（stump）弱分类器" << std::endl;
+                    return false;
+                }
+                Stump stump;
+                stump.featureIdx = (int)nodes[2];
+                stump.threshold = (float)nodes[3];
+                stump.left = (float)leaves[0];
+                stump.right = (float)leaves[1];
+                cascade.stumps.push_back(stump);
+                stage.ntrees++;
+            }
+            cascade.stages.push_back(stage);
+        }
+
+        for (const auto& featureNode : root["features"]) {
+            if (!featureNode["tilted"].empty() && (int)featureNode["tilted"] != 0) {
+                std::cerr << "[ERROR] 不支持倾斜 Haar 特征" << std::endl;
+                return false;
+            }
+            std::vector<Rect> rects;
+            for (const auto& rectNode : featureNode["rects"]) {
+                if (rectNode.size() != 5 || rects.size() == 3) {
+                    std::cerr << "[ERROR] 无效的特征矩形" << std::endl;
+                    return false;
+                }
+                Rect rect;
+                rect.x = (int)rectNode[0];
+                rect.y = (int)rectNode[1];
+                rect.width = (int)rectNode[2];
+                rect.height = (int)rectNode[3];
+                rect.weight = (float)rectNode[4];
+                rects.push_back(rect);
+            }
+            if (rects.size() < 2) {
+                std::cerr << "[ERROR] 特征至少需要两个矩形" << std::endl;
+                return false;
+            }
+            cascade.features.push_back(rects);
+        }
+
+        for (const auto& stump : cascade.stumps) {
+            if (stump.featureIdx < 0 || stump.featureIdx >= (int)cascade.features.size()) {
+                std::cerr << "[ERROR] 弱分类器引用了不存在的特征：" << stump.featureIdx << std::endl;
+                return false;
+            }
+        }
+        return !cascade.stages.empty();
+    }
+
+    /**
+     * @brief 输出 C++ 源文件
+     */
+    void writeSource(std::ostream& os, const Cascade& cascade, const std::string& name, const std::string& input) {
+        const std::string source = std::filesystem::path(input).filename().string();
+        os << "// 由 CascadeCompile 从 " << source << " 生成，请勿手动修改\n"
+           << "// " << cascade.width << "x" << cascade.height << " 窗口，" << cascade.stages.size() << " 级，"
+           << cascade.stumps.size() << " 个弱分类器，" << cascade.features.size() << " 个特征\n"
+           << "#include \"HaarCascade.h\"\n\n"
+           << "namespace DriveGuard {\n"
+           << "    namespace cascades {\n"
+           << "        namespace {\n";
+
+        os << "            constexpr HaarStage STAGES[] = {\n";
+        for (const auto& stage : cascade.stages) {
+            os << "                {" << stage.ntrees << ", " << literal(stage.threshold) << "},\n";
+        }
+        os << "            };\n\n";
+
+        os << "            constexpr HaarStump STUMPS[] = {\n";
+        for (const auto& stump : cascade.stumps) {
+            os << "                {" << stump.featureIdx << ", " << literal(stump.threshold) << ", "
+               << literal(stump.left) << ", " << literal(stump.right) << "},\n";
+        }
+        os << "            };\n\n";
+
+        os << "            constexpr HaarFeature FEATURES[] = {\n";
+        for (const auto& rects : cascade.features) {
+            os << "                {{";
+            for (int r = 0; r < 3; r++) {
+                Rect rect = r < (int)rects.size() ? rects[r] : Rect();
+                os << (r ? ", " : "") << "{" << rect.x << ", " << rect.y << ", " << rect.width << ", "
+                   << rect.height << ", " << literal(rect.weight) << "}";
+            }
+            os << "}},\n";
+        }
+        os << "            };\n"
+           << "        }\n\n";
+
+        os << "        extern const HaarCascadeData " << name << " = {\n"
+           << "            \"" << source << "\", " << cascade.width << ", " << cascade.height << ",\n"
+           << "            STAGES, " << cascade.stages.size() << ",\n"
+           << "            STUMPS, " << cascade.stumps.size() << ",\n"
+           << "            FEATURES, " << cascade.features.size() << "\n"
+           << "        };\n"
+           << "    }\n"
+           << "}\n";
+    }
+
+    void printUsage(const char* program) {
+        std::cout << "用法: " << program << " --input <级联 XML> --name <符号名> --output <源文件>" << std::endl;
+        std::cout << "  --input <path>      OpenCV Haar 级联模型（stump 结构）" << std::endl;
+        std::cout << "  --name <symbol>     生成的 DriveGuard::cascades 下的常量名（如 FRONTAL_FACE）" << std::endl;
+        std::cout << "  --output <path>     输出的 C++ 源文件" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string input;
+    std::string name;
+    std::string output;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--input" && i + 1 < argc) input = argv[++i];
+        else if (arg == "--name" && i + 1 < argc) name = argv[++i];
+        else if (arg == "--output" && i + 1 < argc) output = argv[++i];
+        else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : -1;
+        }
+    }
+    if (input.empty() || name.empty() || output.empty()) {
+        printUsage(argv[0]);
+        return -1;
+    }
+
+    Cascade cascade;
+    try {
+        cv::FileStorage fs(input, cv::FileStorage::READ);
+        if (!fs.isOpened()) {
+            std::cerr << "[ERROR] 无法打开级联模型：" << input << std::endl;
+            return -1;
+        }
+        if (!readCascade(fs.getFirstTopLevelNode(), cascade)) {
+            std::cerr << "[ERROR] 级联模型无法编译：" << input << std::endl;
+            return -1;
+        }
+    } catch (const cv::Exception& e) {
+        std::cerr << "[ERROR] 级联模型解析失败: " << e.what() << std::endl;
+        return -1;
+    }
+
+    // 先写临时文件再替换，构建中断时不会留下不完整的源文件
+    const std::string temporary = output + ".tmp";
+    {
+        std::ofstream ofs(temporary, std::ios::out | std::ios::trunc);
+        if (!ofs.is_open()) {
+            std::cerr << "[ERROR] 无法写入：" << output << std::endl;
+            return -1;
+        }
+        writeSource(ofs, cascade, name, input);
+        if (!ofs.good()) {
+            std::cerr << "[ERROR] 写入失败：" << output << std::endl;
+            return -1;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temporary, output, ec);
+    if (ec) {
+        std::cerr << "[ERROR] 无法写入：" << output << "（" << ec.message() << "）" << std::endl;
+        return -1;
+    }
+
+    std::cout << "[INFO] " << input << " -> " << output << "（" << cascade.stages.size() << " 级，"
+              << cascade.stumps.size() << " 个弱分类器）" << std::endl;
+    return 0;
+}
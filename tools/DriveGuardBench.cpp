@@ -0,0 +1,397 @@
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AllocationExemption.h"
+#include "EnrollmentService.h"
+#include "EventRecorder.h"
+#include "FaceDetector.h"
+#include "FaceRecognizer.h"
+#include "FrameAnalyzer.h"
+#include "FramePool.h"
+#include "FrameSource.h"
+#include "Metrics.h"
+#include "SyntheticFaceSource.h"
+
+// 端到端吞吐基准：在录制片段上逐帧运行与主程序相同的 FrameAnalyzer（检测 -> 识别 -> 眼部 -> DMS，可选事件记录），
+// 数据包经 FramePool 取出与归还，统计帧率与各阶段 p50/p95/p99 延迟，用于部署前发现性能回退；
+// 同时统计每帧处理过程中的堆分配次数，检查稳定运行后是否仍在分配内存（默认不允许任何分配，
+// AllocationExemption 标注的一次性延迟初始化单独计数，出现新轨迹或新模型版本的帧不检查）
+
+using BenchClock = std::chrono::steady_clock;
+
+// 分配计数：仅在逐帧处理期间开启，统计处理帧的线程（基准线程与执行 parallelFor 任务体的工作线程）的分配
+static std::atomic<bool> countingAllocations{false};
+static std::atomic<uint64_t> heapAllocations{0};  // operator new
+static std::atomic<uint64_t> matAllocations{0};   // cv::Mat 数据缓冲区（cv::fastMalloc，不经过 operator new）
+static std::atomic<uint64_t> exemptAllocations{0}; // 豁免区内的分配（不计入上限）
+
+// 按当前线程是否处于豁免区计入对应的计数
+static void countAllocation(std::atomic<uint64_t>& counter) {
+    if (!countingAllocations.load(std::memory_order_relaxed) || !DriveGuard::allocationTracked) return;
+    if (DriveGuard::allocationExempt) {
+        exemptAllocations.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void* operator new(std::size_t size) {
+    countAllocation(heapAllocations);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+/**
+ * @brief 统计 cv::Mat 缓冲区分配次数的默认分配器（实际分配交给 OpenCV 的标准分配器）
+ */
+class CountingMatAllocator : public cv::MatAllocator {
+public:
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override {
+        countAllocation(matAllocations);
+        return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    bool allocate(cv::UMatData* data, cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override {
+        return cv::Mat::getStdAllocator()->allocate(data, flags, usageFlags);
+    }
+
+    void deallocate(cv::UMatData* data) const override {
+        cv::Mat::getStdAllocator()->deallocate(data);
+    }
+};
+
+// 合成人脸画面的脚本：每个周期先睁眼，再连续闭眼至 SLEEPING（DMS 依次经过 FATIGUE、SLEEPING 并回到 NORMAL，
+// 触发事件与告警片段）；人脸位置逐帧轻微移动。默认预热一个周期，使所有外观与状态切换在统计前都出现过
+static const long SYNTHETIC_OPEN_FRAMES = 45;
+static const long SYNTHETIC_CLOSED_FRAMES = 105;
+static const long SYNTHETIC_PERIOD = SYNTHETIC_OPEN_FRAMES + SYNTHETIC_CLOSED_FRAMES;
+static const int SYNTHETIC_FRAME_INTERVAL_MS = 33; // 合成画面的采集时间间隔（与实际处理耗时无关）
+
+static DriveGuard::SyntheticFrame syntheticScript(long index) {
+    DriveGuard::SyntheticFrame appearance;
+    appearance.eyesOpen = index % SYNTHETIC_PERIOD < SYNTHETIC_OPEN_FRAMES;
+    appearance.offset = cv::Point((int)(index % 3) * 2, 0);
+    return appearance;
+}
+
+/**
+ * @brief 单阶段延迟样本（毫秒）
+ */
+struct StageSamples {
+    std::string name;
+    std::vector<double> millis;
+
+    double percentile(double p) const {
+        if (millis.empty()) return 0.0;
+        std::vector<double> sorted = millis;
+        std::size_t idx = (std::size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+        std::nth_element(sorted.begin(), sorted.begin() + idx, sorted.end());
+        return sorted[idx];
+    }
+
+    double mean() const {
+        if (millis.empty()) return 0.0;
+        double sum = 0.0;
+        for (double v : millis) sum += v;
+        return sum / millis.size();
+    }
+};
+
+static double elapsedMs(BenchClock::time_point start, BenchClock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// 单帧分配上限的默认值（新轨迹与新模型版本的帧不检查，其余帧不允许分配）
+static const long DEFAULT_MAX_ALLOCATIONS = 0;
+
+static void printUsage(const char* program) {
+    std::cout << "用法: " << program << " --input <视频文件|图片目录> | --synthetic <N> [选项]" << std::endl;
+    std::cout << "  --synthetic <N>     使用 N 帧合成人脸画面代替录制片段（在内存中录入为驾驶员，周期性睁眼与闭眼）" << std::endl;
+    std::cout << "  --models <目录>     模型目录，默认 ../models" << std::endl;
+    std::cout << "  --max-frames <N>    最多处理的帧数，默认处理整个片段" << std::endl;
+    std::cout << "  --warmup <N>        预热帧数（不计入统计），默认 5，合成画面默认一个脚本周期（" << SYNTHETIC_PERIOD << "）" << std::endl;
+    std::cout << "  --threshold <值>    识别置信度阈值，默认 80" << std::endl;
+    std::cout << "  --track-interval <N> 跟踪模式全帧检测周期，<=1 关闭跟踪，默认 10" << std::endl;
+    std::cout << "  --identity-refresh <N> 已识别轨迹的重新识别周期，<=1 每帧识别，默认 30" << std::endl;
+    std::cout << "  --eye-track-interval <N> 眼部级联检测周期，其余帧模板跟踪，<=1 每帧检测，默认 5" << std::endl;
+    std::cout << "  --cascade <后端>    级联检测后端：auto、opencv、compiled，默认 auto" << std::endl;
+    std::cout << "  --threads <N>       批量识别与眼部检测的并行线程数（OpenCV 线程池），1 为串行，默认全部核心" << std::endl;
+    std::cout << "  --events-dir <目录> 同时记录事件日志与告警片段（与主程序的 --events-dir 相同）" << std::endl;
+    std::cout << "  --max-allocations <N> 预热后单帧堆分配次数（不含豁免的一次性初始化，不检查出现新轨迹或新模型版本的帧）" << std::endl;
+    std::cout << "                      超过 N 时返回非零，<0 不检查，默认 " << DEFAULT_MAX_ALLOCATIONS << std::endl;
+    std::cout << "                      （opencv 后端的 cv::CascadeClassifier 每次检测都会分配，只统计不检查）" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string input;
+    std::string modelDir = "../models";
+    long maxFrames = -1;
+    long warmup = -1;
+    double threshold = 80.0;
+    int trackInterval = 10;
+    int identityRefresh = 30;
+    int eyeTrackInterval = 5;
+    int threads = -1;
+    long synthetic = 0;
+    std::string eventDir;
+    long maxAllocations = DEFAULT_MAX_ALLOCATIONS;
+    DriveGuard::CascadeBackend cascadeBackend = DriveGuard::CascadeBackend::AUTO;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--input" && i + 1 < argc) input = argv[++i];
+        else if (arg == "--synthetic" && i + 1 < argc) synthetic = std::stol(argv[++i]);
+        else if (arg == "--models" && i + 1 < argc) modelDir = argv[++i];
+        else if (arg == "--max-frames" && i + 1 < argc) maxFrames = std::stol(argv[++i]);
+        else if (arg == "--warmup" && i + 1 < argc) warmup = std::stol(argv[++i]);
+        else if (arg == "--threshold" && i + 1 < argc) threshold = std::stod(argv[++i]);
+        else if (arg == "--track-interval" && i + 1 < argc) trackInterval = std::stoi(argv[++i]);
+        else if (arg == "--identity-refresh" && i + 1 < argc) identityRefresh = std::stoi(argv[++i]);
+        else if (arg == "--eye-track-interval" && i + 1 < argc) eyeTrackInterval = std::stoi(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) threads = std::stoi(argv[++i]);
+        else if (arg == "--events-dir" && i + 1 < argc) eventDir = argv[++i];
+        else if (arg == "--max-allocations" && i + 1 < argc) maxAllocations = std::stol(argv[++i]);
+        else if (arg == "--cascade" && i + 1 < argc && DriveGuard::FaceDetector::parseBackend(argv[i + 1], cascadeBackend)) i++;
+        else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : -1;
+        }
+    }
+    if (input.empty() == (synthetic <= 0)) {
+        printUsage(argv[0]);
+        return -1;
+    }
+
+    if (warmup < 0) warmup = synthetic > 0 ? SYNTHETIC_PERIOD : 5;
+    if (threads > 0) cv::setNumThreads(threads);
+
+    std::unique_ptr<DriveGuard::FrameSource> source;
+    if (synthetic > 0) {
+        source = std::make_unique<DriveGuard::SyntheticFaceSource>(synthetic, syntheticScript);
+    } else {
+        source = DriveGuard::FrameSource::create(input);
+    }
+    if (!source) return -1;
+    if (source->isLive()) {
+        std::cerr << "[WARN] 基准测试使用实时摄像头，结果不可复现" << std::endl;
+    }
+
+    DriveGuard::FaceDetector detector(modelDir + "/haarcascade_frontalface_default.xml",
+                                      modelDir + "/haarcascade_eye.xml", cascadeBackend);
+    if (!detector.isModelLoaded()) return -1;
+    if (detector.backend() == DriveGuard::CascadeBackend::OPENCV && maxAllocations >= 0) {
+        std::cerr << "[WARN] opencv 后端的级联检测每次都在 OpenCV 内部分配，不检查单帧分配上限" << std::endl;
+        maxAllocations = -1;
+    }
+
+    auto recognizer = std::make_shared<DriveGuard::FaceRecognizer>();
+    // 优先使用二进制模型，不存在时回退到旧版 YAML 模型
+    const std::string binaryModel = modelDir + "/face_rec.dgm";
+    std::string modelPath = std::filesystem::exists(binaryModel) ? binaryModel : modelDir + "/face_rec.yml";
+    std::string labelInfoPath = modelDir + "/label_to_name.txt";
+    bool hasModel = false;
+    if (synthetic > 0) {
+        // 合成人脸在内存中录入为驾驶员，识别、眼部定位、身份缓存与疲劳判定全部参与（不读写模型文件）
+        std::vector<cv::Mat> samples = DriveGuard::SyntheticFaceSource::enrollmentSamples(detector, 10);
+        if (samples.empty()) {
+            std::cerr << "[ERROR] 合成画面中检不出人脸" << std::endl;
+            return -1;
+        }
+        recognizer->update(samples, std::vector<int>(samples.size(), 0));
+        recognizer->setLabelInfo(0, "driver", DriveGuard::UserRole::DRIVER);
+        modelPath.clear();
+        labelInfoPath.clear();
+        hasModel = true;
+    } else if (recognizer->loadModel(modelPath)) {
+        recognizer->loadLabelInfo(labelInfoPath);
+        hasModel = true;
+    } else {
+        std::cerr << "[WARN] 未找到识别模型，与主程序一样以检测模式运行（仅人脸检测）" << std::endl;
+    }
+
+    // 录入服务只用于向分析器提供模型快照：不启动后台线程，基准测试不录入也不写回模型
+    DriveGuard::EnrollmentService enrollment(recognizer, modelPath, labelInfoPath);
+
+    // 事件记录器（可选）：后台写线程的编码与写盘不计入分配统计，提交帧与事件的开销计入分析阶段
+    std::unique_ptr<DriveGuard::EventRecorder> recorder;
+    if (!eventDir.empty()) {
+        DriveGuard::EventRecorderConfig eventConfig;
+        eventConfig.directory = eventDir;
+        recorder = std::make_unique<DriveGuard::EventRecorder>(eventConfig);
+        if (!recorder->start()) return -1;
+    }
+
+    DriveGuard::AnalyzerConfig config;
+    config.confidenceThreshold = threshold;
+    config.tracker.enabled = trackInterval > 1;
+    config.tracker.redetectInterval = trackInterval;
+    config.eyeTracker.enabled = eyeTrackInterval > 1;
+    config.eyeTracker.redetectInterval = eyeTrackInterval;
+    config.identityCache.enabled = identityRefresh > 1;
+    config.identityCache.refreshInterval = identityRefresh;
+    config.shedder.enabled = false; // 测量完整路径，不因超出延迟预算而舍弃工作
+    DriveGuard::FrameAnalyzer analyzer(detector, enrollment, config,
+                                       hasModel ? DriveGuard::ModelState::RECOGNIZING : DriveGuard::ModelState::DETECTING,
+                                       recorder.get());
+
+    // detect / analyze / total 为本线程的墙钟耗时；recognize / eyes 取自 Metrics 的阶段计时，
+    // 为一帧内各人脸耗时之和（并行执行时可能超过 analyze）
+    StageSamples detectStage{"detect", {}};
+    StageSamples analyzeStage{"analyze", {}};
+    StageSamples recognizeStage{"recognize", {}};
+    StageSamples eyesStage{"eyes", {}};
+    StageSamples totalStage{"total", {}};
+    std::map<std::size_t, StageSamples> totalByFaces; // 按每帧人脸数分组的总延迟
+
+    long frameIndex = 0;
+    long measured = 0;
+    std::size_t totalFaces = 0;
+    double measuredMs = 0.0;
+    uint64_t totalAllocations = 0;
+    uint64_t totalMatAllocations = 0;
+    uint64_t maxFrameAllocations = 0;
+    uint64_t totalExemptAllocations = 0;
+    long uncheckedFrames = 0;           // 出现新轨迹或新模型版本、不检查分配的帧数
+    std::vector<int> seenTracks;        // 已出现过的轨迹编号
+    uint64_t modelVersion = enrollment.version();
+
+    static CountingMatAllocator countingMatAllocator;
+    cv::Mat::setDefaultAllocator(&countingMatAllocator);
+    DriveGuard::allocationTracked = true;
+
+    // 与流水线相同：数据包从帧池取出，处理完归还，下一帧复用其中的图像缓冲区与结果容器
+    DriveGuard::FramePool framePool(2);
+    DriveGuard::FramePacket packet;
+    framePool.acquire(packet);
+
+    // 合成画面按固定间隔的时间轴打时间戳（起点早于当前，使采集时间不晚于分析时间），疲劳判定与处理速度无关
+    const long timelineFrames = maxFrames < 0 ? synthetic : std::min(synthetic, maxFrames + warmup);
+    const DriveGuard::Clock::time_point timelineStart =
+        DriveGuard::Clock::now() - std::chrono::milliseconds(SYNTHETIC_FRAME_INTERVAL_MS * timelineFrames);
+
+    while ((maxFrames < 0 || frameIndex < maxFrames + warmup) && source->read(packet.frame)) {
+        if (packet.frame.empty()) continue;
+        bool record = frameIndex >= warmup;
+
+        // 与采集阶段相同：读取后打上序号与采集时间戳，疲劳判定与端到端延迟均以此为准
+        packet.seq = (uint64_t)frameIndex;
+        packet.captureTime = synthetic > 0
+            ? timelineStart + std::chrono::milliseconds(SYNTHETIC_FRAME_INTERVAL_MS * frameIndex)
+            : DriveGuard::Clock::now();
+        frameIndex++;
+        uint64_t version = enrollment.version();
+
+        auto recognizeBefore = DriveGuard::Metrics::stageTotal(DriveGuard::Stage::RECOGNIZE);
+        auto eyesBefore = DriveGuard::Metrics::stageTotal(DriveGuard::Stage::EYES);
+        heapAllocations = 0;
+        matAllocations = 0;
+        exemptAllocations = 0;
+        countingAllocations = true;
+
+        auto t0 = BenchClock::now();
+        analyzer.detect(packet);
+        auto t1 = BenchClock::now();
+        analyzer.analyze(packet);
+        auto t2 = BenchClock::now();
+        countingAllocations = false;
+
+        // 新轨迹首次出现时创建跟踪、眼部、身份缓存与疲劳状态，新模型版本更换快照并清空缓存，这些帧不检查分配
+        bool unchecked = version != modelVersion;
+        modelVersion = version;
+        for (const auto& result : packet.results) {
+            if (result.trackId < 0 || std::find(seenTracks.begin(), seenTracks.end(), result.trackId) != seenTracks.end()) continue;
+            seenTracks.push_back(result.trackId);
+            unchecked = true;
+        }
+
+        // 等记录器的写线程编码完这一帧、交还帧缓冲区后再归还数据包（不计入耗时），
+        // 与流水线稳定运行时一致：下一帧原地复用同一缓冲区，不因写线程滞后而重新分配
+        std::size_t faces = packet.context.faces().size();
+        while (DriveGuard::isFrameShared(packet.frame)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        countingAllocations = true;
+        framePool.release(std::move(packet));
+        framePool.acquire(packet);
+        countingAllocations = false;
+
+        if (!record) continue;
+
+        double totalMs = elapsedMs(t0, t2);
+        measured++;
+        totalAllocations += heapAllocations + matAllocations;
+        totalMatAllocations += matAllocations;
+        totalExemptAllocations += exemptAllocations;
+        if (unchecked) {
+            uncheckedFrames++;
+        } else {
+            maxFrameAllocations = std::max<uint64_t>(maxFrameAllocations, heapAllocations + matAllocations);
+        }
+        measuredMs += totalMs;
+        totalFaces += faces;
+        detectStage.millis.push_back(elapsedMs(t0, t1));
+        analyzeStage.millis.push_back(elapsedMs(t1, t2));
+        recognizeStage.millis.push_back(std::chrono::duration<double, std::milli>(
+            DriveGuard::Metrics::stageTotal(DriveGuard::Stage::RECOGNIZE) - recognizeBefore).count());
+        eyesStage.millis.push_back(std::chrono::duration<double, std::milli>(
+            DriveGuard::Metrics::stageTotal(DriveGuard::Stage::EYES) - eyesBefore).count());
+        totalStage.millis.push_back(totalMs);
+        totalByFaces[faces].millis.push_back(totalMs);
+    }
+
+    if (measured == 0) {
+        std::cerr << "[ERROR] 没有可统计的帧（片段过短或预热帧数过多）" << std::endl;
+        return -1;
+    }
+
+    std::cout << "===========================================" << std::endl;
+    std::cout << "DriveGuard 基准测试: " << source->describe() << std::endl;
+    std::printf("帧数: %ld  人脸总数: %zu  平均人脸/帧: %.2f\n",
+                measured, totalFaces, (double)totalFaces / measured);
+    std::printf("吞吐: %.2f fps\n", measured * 1000.0 / measuredMs);
+    std::printf("%-10s %10s %10s %10s %10s\n", "stage", "mean(ms)", "p50(ms)", "p95(ms)", "p99(ms)");
+    for (const StageSamples* stage : {&detectStage, &analyzeStage, &recognizeStage, &eyesStage, &totalStage}) {
+        std::printf("%-10s %10.3f %10.3f %10.3f %10.3f\n", stage->name.c_str(),
+                    stage->mean(), stage->percentile(50), stage->percentile(95), stage->percentile(99));
+    }
+
+    // 人脸数增加时帧延迟应基本持平（识别与眼部检测按人脸并行）
+    std::printf("\n%-10s %10s %10s %10s\n", "faces", "frames", "mean(ms)", "p95(ms)");
+    for (const auto& entry : totalByFaces) {
+        std::printf("%-10zu %10zu %10.3f %10.3f\n", entry.first, entry.second.millis.size(),
+                    entry.second.mean(), entry.second.percentile(95));
+    }
+
+    // 稳态分配：预热后每帧处理过程中的堆分配（含 cv::Mat 缓冲区）；豁免的一次性初始化单独列出
+    std::printf("\n稳态分配: 平均 %.2f 次/帧  最大 %llu 次/帧  总计 %llu 次（其中 Mat 缓冲区 %llu 次）\n",
+                (double)totalAllocations / measured, (unsigned long long)maxFrameAllocations,
+                (unsigned long long)totalAllocations, (unsigned long long)totalMatAllocations);
+    std::printf("豁免分配: 平均 %.2f 次/帧（工作线程、线程局部缓冲区与分类器副本的首次创建）\n",
+                (double)totalExemptAllocations / measured);
+    std::printf("不检查: %ld 帧（出现新轨迹或新模型版本），单帧最大值只统计其余帧\n", uncheckedFrames);
+    if (maxAllocations >= 0 && maxFrameAllocations > (uint64_t)maxAllocations) {
+        std::cerr << "[ERROR] 单帧堆分配 " << maxFrameAllocations << " 次，超过上限 " << maxAllocations << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,192 @@
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "FrameContext.h"
+#include "GalleryIndex.h"
+#include "GalleryMatrix.h"
+#include "LBPFeatureExtractor.h"
+
+// 大规模图库检索基准：合成 10 ~ 10000 个身份的人脸样本，对比逐样本匹配与 GalleryIndex
+// 在不同探测列表数下的单次查询耗时、相对逐样本匹配的 recall@1 与识别正确率
+
+using BenchClock = std::chrono::steady_clock;
+
+static double elapsedMs(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+static void printUsage(const char* program) {
+    std::cout << "用法: " << program << " [选项]" << std::endl;
+    std::cout << "  --identities <N>    最大身份数，默认 10000（依次测试 10/100/1000/... 直至该值）" << std::endl;
+    std::cout << "  --samples <N>       每个身份的录入样本数，默认 5" << std::endl;
+    std::cout << "  --queries <N>       每个规模的查询次数，默认 100" << std::endl;
+    std::cout << "  --candidates <N>    精排候选身份数，默认 8" << std::endl;
+    std::cout << "  --seed <N>          随机种子，默认 1" << std::endl;
+}
+
+/**
+ * @brief 合成身份：公共人脸底图与身份专属纹理的混合（身份间相似、样本间存在姿态与光照扰动）
+ */
+class SyntheticFaces {
+public:
+    explicit SyntheticFaces(unsigned seed) : rng_(seed) {
+        common_ = smoothTexture(10);
+    }
+
+    /**
+     * @brief 新增一个身份，返回其底图
+     */
+    cv::Mat identity() {
+        cv::Mat own = smoothTexture(16);
+        cv::Mat face;
+        cv::addWeighted(common_, 0.55, own, 0.45, 0.0, face);
+        return face;
+    }
+
+    /**
+     * @brief 由身份底图生成一张样本（小幅平移旋转、亮度对比度变化与噪声）
+     */
+    cv::Mat sample(const cv::Mat& face) {
+        std::uniform_real_distribution<double> shift(-2.0, 2.0), angle(-4.0, 4.0);
+        std::uniform_real_distribution<double> gain(0.85, 1.15), bias(-15.0, 15.0);
+        cv::Mat transform = cv::getRotationMatrix2D(cv::Point2f(face.cols / 2.0f, face.rows / 2.0f), angle(rng_), 1.0);
+        transform.at<double>(0, 2) += shift(rng_);
+        transform.at<double>(1, 2) += shift(rng_);
+
+        cv::Mat warped, noise, out;
+        cv::warpAffine(face, warped, transform, face.size(), cv::INTER_LINEAR, cv::BORDER_REFLECT);
+        warped.convertTo(out, CV_32F, gain(rng_), bias(rng_));
+        noise.create(out.size(), CV_32F);
+        cv::randn(noise, cv::Scalar(0), cv::Scalar(6));
+        out += noise;
+        out.convertTo(out, CV_8U);
+        return out;
+    }
+
+private:
+    cv::Mat smoothTexture(int size) {
+        cv::Mat coarse(size, size, CV_8UC1);
+        cv::randu(coarse, cv::Scalar(0), cv::Scalar(256));
+        cv::Mat texture;
+        cv::resize(coarse, texture, cv::Size(DriveGuard::FACE_SAMPLE_SIZE, DriveGuard::FACE_SAMPLE_SIZE), 0, 0, cv::INTER_CUBIC);
+        return texture;
+    }
+
+    std::mt19937 rng_;
+    cv::Mat common_;
+};
+
+int main(int argc, char* argv[]) {
+    int maxIdentities = 10000;
+    int samplesPerIdentity = 5;
+    int queryCount = 100;
+    int candidates = 8;
+    unsigned seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--identities" && i + 1 < argc) maxIdentities = std::stoi(argv[++i]);
+        else if (arg == "--samples" && i + 1 < argc) samplesPerIdentity = std::stoi(argv[++i]);
+        else if (arg == "--queries" && i + 1 < argc) queryCount = std::stoi(argv[++i]);
+        else if (arg == "--candidates" && i + 1 < argc) candidates = std::stoi(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = (unsigned)std::stoul(argv[++i]);
+        else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : -1;
+        }
+    }
+    if (maxIdentities < 1 || samplesPerIdentity < 1 || queryCount < 1) {
+        printUsage(argv[0]);
+        return -1;
+    }
+
+    cv::theRNG().state = seed;
+    DriveGuard::LBPFeatureExtractor extractor;
+    const cv::Size sampleSize(DriveGuard::FACE_SAMPLE_SIZE, DriveGuard::FACE_SAMPLE_SIZE);
+    const int cellArea = extractor.cellArea(sampleSize);
+    DriveGuard::GalleryMatrix gallery(extractor.histogramSize(), DriveGuard::GalleryMatrix::precisionFor(cellArea), cellArea);
+
+    DriveGuard::GalleryIndexConfig config;
+    config.minIdentities = 1;
+    config.candidates = candidates;
+    DriveGuard::GalleryIndex index(config);
+
+    SyntheticFaces faces(seed);
+    std::vector<cv::Mat> identities;
+    std::mt19937 pick(seed);
+    cv::Mat histogram;
+
+    // 图库规模：10, 100, 1000, ... 直至最大身份数
+    std::vector<int> sizes;
+    for (int size = 10; size < maxIdentities; size *= 10) sizes.push_back(size);
+    sizes.push_back(maxIdentities);
+
+    std::printf("%-9s %-9s %-8s %7s %12s %9s %9s %10s\n",
+                "ids", "rows", "search", "probes", "ms/query", "recall@1", "accuracy", "memory MB");
+    for (int size : sizes) {
+        // 录入新增身份
+        while ((int)identities.size() < size) {
+            cv::Mat face = faces.identity();
+            for (int s = 0; s < samplesPerIdentity; s++) {
+                extractor.compute(faces.sample(face), histogram);
+                gallery.append(histogram, (int)identities.size());
+            }
+            identities.push_back(face);
+        }
+
+        // 查询：随机身份的新样本
+        std::vector<cv::Mat> queries;
+        std::vector<int> truth;
+        std::uniform_int_distribution<int> who(0, size - 1);
+        for (int q = 0; q < queryCount; q++) {
+            truth.push_back(who(pick));
+            extractor.compute(faces.sample(identities[truth.back()]), histogram);
+            queries.push_back(histogram.clone());
+        }
+
+        // 逐样本匹配（基线）
+        std::vector<int> exact(queryCount);
+        int correct = 0;
+        std::vector<double> distances;
+        std::vector<DriveGuard::GalleryMatch> matches;
+        BenchClock::time_point t0 = BenchClock::now();
+        for (int q = 0; q < queryCount; q++) {
+            gallery.match(queries[q], 1, DBL_MAX, distances, matches);
+            exact[q] = matches.empty() ? -1 : matches.front().label;
+        }
+        double exhaustiveMs = elapsedMs(t0) / queryCount;
+        for (int q = 0; q < queryCount; q++) correct += exact[q] == truth[q];
+        std::printf("%-9d %-9zu %-8s %7s %12.3f %9s %8.1f%% %10.1f\n", size, gallery.rows(), "exact", "-",
+                    exhaustiveMs, "100.0%", 100.0 * correct / queryCount, gallery.bytes() / 1048576.0);
+
+        // 索引：构建一次，依次调整探测列表数
+        t0 = BenchClock::now();
+        index.build(gallery, extractor.params());
+        double buildMs = elapsedMs(t0);
+        for (int probes = 1; ; probes *= 2) {
+            int effective = std::min(probes, (int)index.lists());
+            index.setSearchParams(effective, candidates);
+            int agree = 0;
+            correct = 0;
+            t0 = BenchClock::now();
+            for (int q = 0; q < queryCount; q++) {
+                std::vector<DriveGuard::GalleryMatch> matches = index.search(gallery, queries[q], 1, DBL_MAX);
+                int label = matches.empty() ? -1 : matches.front().label;
+                agree += label == exact[q];
+                correct += label == truth[q];
+            }
+            double indexMs = elapsedMs(t0) / queryCount;
+            std::printf("%-9d %-9zu %-8s %7d %12.3f %8.1f%% %8.1f%% %10.1f\n", size, gallery.rows(), "index", effective,
+                        indexMs, 100.0 * agree / queryCount, 100.0 * correct / queryCount, index.bytes() / 1048576.0);
+            if (effective >= (int)index.lists()) break;
+        }
+        std::printf("%-9d 索引构建 %.0f ms：%zu 个原型，%zu 个倒排列表\n", size, buildMs, index.prototypes(), index.lists());
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include "FaceDetector.h"
+#include "FaceRecognizer.h"
+#include "FileLock.h"
+#include "GalleryImporter.h"
+#include "GalleryStore.h"
+
+// 图库批量导入：将按身份分目录存放的人脸照片一次性导入识别模型与映射表，
+// 读取、检测与特征提取在多个核心上并行，用于车队部署时预置成百上千名驾驶员，代替逐个现场录入
+
+using ImportClock = std::chrono::steady_clock;
+
+static double elapsedMs(ImportClock::time_point start) {
+    return std::chrono::duration<double, std::milli>(ImportClock::now() - start).count();
+}
+
+static void printUsage(const char* program) {
+    std::cout << "用法: " << program << " --dataset <目录> [选项]" << std::endl;
+    std::cout << "  --dataset <目录>    导入目录：<目录>/<姓名>/*.jpg，或按角色分组的 <目录>/driver|passenger/<姓名>/*.jpg" << std::endl;
+    std::cout << "  --models <目录>     模型目录，默认 ../models" << std::endl;
+    std::cout << "  --model <path>      识别模型，默认 <模型目录>/face_rec.dgm（存在时在其基础上追加）" << std::endl;
+    std::cout << "  --labels <path>     ID-Name 映射表，默认 <模型目录>/label_to_name.txt" << std::endl;
+    std::cout << "  --role <角色>       未按角色分组时的角色：driver、passenger，默认 driver" << std::endl;
+    std::cout << "  --max-per-identity <N> 每个身份最多导入的图片数（按文件名排序取前 N 张），<=0 不限，默认 0" << std::endl;
+    std::cout << "  --cropped           图片已是裁剪好的人脸，跳过人脸检测" << std::endl;
+    std::cout << "  --cascade <后端>    级联检测后端：auto、opencv、compiled，默认 auto" << std::endl;
+    std::cout << "  --threads <N>       并行线程数（OpenCV 线程池），1 为串行，默认全部核心" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string dataset;
+    std::string modelDir = "../models";
+    std::string modelPath;
+    std::string labelPath;
+    int threads = -1;
+    DriveGuard::ImportConfig config;
+    DriveGuard::CascadeBackend cascadeBackend = DriveGuard::CascadeBackend::AUTO;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--dataset" && i + 1 < argc) dataset = argv[++i];
+        else if (arg == "--models" && i + 1 < argc) modelDir = argv[++i];
+        else if (arg == "--model" && i + 1 < argc) modelPath = argv[++i];
+        else if (arg == "--labels" && i + 1 < argc) labelPath = argv[++i];
+        else if (arg == "--max-per-identity" && i + 1 < argc) config.maxPerIdentity = std::stoi(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) threads = std::stoi(argv[++i]);
+        else if (arg == "--cropped") config.cropped = true;
+        else if (arg == "--role" && i + 1 < argc && std::string(argv[i + 1]) == "driver") { config.role = DriveGuard::UserRole::DRIVER; i++; }
+        else if (arg == "--role" && i + 1 < argc && std::string(argv[i + 1]) == "passenger") { config.role = DriveGuard::UserRole::PASSENGER; i++; }
+        else if (arg == "--cascade" && i + 1 < argc && DriveGuard::FaceDetector::parseBackend(argv[i + 1], cascadeBackend)) i++;
+        else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : -1;
+        }
+    }
+    if (dataset.empty()) {
+        printUsage(argv[0]);
+        return -1;
+    }
+    if (modelPath.empty()) modelPath = modelDir + "/face_rec.dgm";
+    if (labelPath.empty()) labelPath = modelDir + "/label_to_name.txt";
+
+    if (threads > 0) cv::setNumThreads(threads);
+
+    DriveGuard::FaceDetector detector(modelDir + "/haarcascade_frontalface_default.xml",
+                                      modelDir + "/haarcascade_eye.xml", cascadeBackend);
+    if (!config.cropped && !detector.isModelLoaded()) return -1;
+
+    // DriveGuard 运行期间不得导入：其内存中的身份信息库会过期，下次录入将分配重复的标签并覆盖映射表
+    DriveGuard::FileLock modelOwner(DriveGuard::FileLock::ownerLockPath(modelPath),
+                                    DriveGuard::FileLock::Mode::EXCLUSIVE, false);
+    if (!modelOwner.locked()) {
+        std::cerr << "[ERROR] 模型正被其他进程使用（DriveGuard 运行中？），请先退出后再导入：" << modelPath << std::endl;
+        return -1;
+    }
+
+    // 已有模型时在其基础上导入：同名身份追加样本，其余分配新标签
+    DriveGuard::FaceRecognizer recognizer;
+    if (std::filesystem::exists(modelPath)) {
+        if (!recognizer.loadModel(modelPath)) return -1;
+        if (std::filesystem::exists(labelPath) && !recognizer.loadLabelInfo(labelPath)) return -1;
+    }
+    std::size_t existingIdentities = recognizer.identities().size();
+
+    ImportClock::time_point start = ImportClock::now();
+    DriveGuard::GalleryImporter importer(detector, config);
+    DriveGuard::ImportReport report;
+    if (!importer.import(dataset, recognizer, report)) return -1;
+    double importMs = elapsedMs(start);
+
+    start = ImportClock::now();
+    if (!recognizer.appendModel(modelPath)) return -1;
+    if (DriveGuard::GalleryStore::isBinaryPath(modelPath) && DriveGuard::GalleryStore::needsCompaction(modelPath)) {
+        DriveGuard::GalleryStore::compact(modelPath);
+    }
+    if (!recognizer.saveLabelInfo(labelPath)) return -1;
+    double saveMs = elapsedMs(start);
+
+    std::cout << "========== 导入结果 ==========" << std::endl;
+    std::cout << "图片: " << report.images << "，无法读取 " << report.unreadable << "，未检出人脸 " << report.noFace << std::endl;
+    std::cout << "样本: " << report.samples << "（图库共 " << recognizer.gallery().rows() << " 个）" << std::endl;
+    std::cout << "身份: " << report.identities << "（新增 " << report.newIdentities << "，原有 "
+              << existingIdentities << "，现共 " << recognizer.identities().size() << "）" << std::endl;
+    std::cout << "耗时: 导入 " << (int)importMs << " ms（" << (int)(report.images / std::max(importMs / 1000.0, 1e-3))
+              << " 张/秒，" << cv::getNumThreads() << " 线程），保存 " << (int)saveMs << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,217 @@
+#include <opencv2/opencv.hpp>
+#include <opencv2/face.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "FaceRecognizer.h"
+#include "FrameContext.h"
+#include "GalleryMatrix.h"
+#include "LBPFeatureExtractor.h"
+
+// LBP 特征提取微基准：对比 cv::face::LBPHFaceRecognizer 与 LBPFeatureExtractor 各内核的
+// 单样本特征提取耗时，并校验直方图逐位一致、模型文件互通与预测结果一致；
+// 另对比逐个 cv::Mat + compareHist 与 GalleryMatrix 各存储精度的匹配耗时与内存占用
+
+using BenchClock = std::chrono::steady_clock;
+
+static double elapsedUs(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::micro>(BenchClock::now() - start).count();
+}
+
+static void printUsage(const char* program) {
+    std::cout << "用法: " << program << " [选项]" << std::endl;
+    std::cout << "  --input <目录>      人脸图片目录（缩放为 " << DriveGuard::FACE_SAMPLE_SIZE << "x" << DriveGuard::FACE_SAMPLE_SIZE
+              << " 灰度图），默认使用合成样本" << std::endl;
+    std::cout << "  --samples <N>       合成样本数，默认 200" << std::endl;
+    std::cout << "  --iterations <N>    重复次数，默认 20" << std::endl;
+}
+
+/**
+ * @brief 生成平滑的合成人脸样本（低分辨率随机纹理放大，含大量相等像素与缓变区域）
+ */
+static std::vector<cv::Mat> syntheticSamples(int count) {
+    std::vector<cv::Mat> samples;
+    for (int i = 0; i < count; i++) {
+        cv::Mat coarse(12 + i % 13, 12 + i % 13, CV_8UC1);
+        cv::randu(coarse, cv::Scalar(0), cv::Scalar(256));
+        cv::Mat sample;
+        cv::resize(coarse, sample, cv::Size(DriveGuard::FACE_SAMPLE_SIZE, DriveGuard::FACE_SAMPLE_SIZE), 0, 0, cv::INTER_LINEAR);
+        samples.push_back(sample);
+    }
+    return samples;
+}
+
+/**
+ * @brief 读取目录中的人脸图片
+ */
+static std::vector<cv::Mat> loadSamples(const std::string& dir) {
+    std::vector<cv::String> files;
+    cv::glob(dir, files, false);
+
+    std::vector<cv::Mat> samples;
+    for (const auto& file : files) {
+        cv::Mat image = cv::imread(file, cv::IMREAD_GRAYSCALE);
+        if (image.empty()) continue;
+        cv::Mat sample;
+        cv::resize(image, sample, cv::Size(DriveGuard::FACE_SAMPLE_SIZE, DriveGuard::FACE_SAMPLE_SIZE));
+        samples.push_back(sample);
+    }
+    return samples;
+}
+
+int main(int argc, char* argv[]) {
+    std::string input;
+    int sampleCount = 200;
+    int iterations = 20;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--input" && i + 1 < argc) input = argv[++i];
+        else if (arg == "--samples" && i + 1 < argc) sampleCount = std::stoi(argv[++i]);
+        else if (arg == "--iterations" && i + 1 < argc) iterations = std::stoi(argv[++i]);
+        else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : -1;
+        }
+    }
+
+    std::vector<cv::Mat> samples = input.empty() ? syntheticSamples(sampleCount) : loadSamples(input);
+    if (samples.empty() || iterations <= 0) {
+        std::cerr << "[ERROR] 没有可用的样本" << std::endl;
+        return -1;
+    }
+    std::vector<int> labels;
+    for (std::size_t i = 0; i < samples.size(); i++) labels.push_back((int)(i % 10));
+
+    // OpenCV 路径：train() 对每个样本计算 elbp + spatial_histogram
+    cv::Ptr<cv::face::LBPHFaceRecognizer> reference = cv::face::LBPHFaceRecognizer::create();
+    auto t0 = BenchClock::now();
+    for (int it = 0; it < iterations; it++) {
+        reference->train(samples, labels);
+    }
+    double referenceUs = elapsedUs(t0) / ((double)iterations * samples.size());
+    std::vector<cv::Mat> expected = reference->getHistograms();
+
+    std::cout << "===========================================" << std::endl;
+    std::printf("样本数: %zu  重复: %d  尺寸: %dx%d\n", samples.size(), iterations,
+                DriveGuard::FACE_SAMPLE_SIZE, DriveGuard::FACE_SAMPLE_SIZE);
+    std::printf("%-14s %12s %10s %12s\n", "path", "us/sample", "speedup", "bit-exact");
+    std::printf("%-14s %12.2f %10s %12s\n", "opencv-lbph", referenceUs, "1.00x", "-");
+
+    using Kernel = DriveGuard::LBPFeatureExtractor::Kernel;
+    bool allExact = true;
+    for (Kernel kernel : {Kernel::SCALAR, Kernel::SSE41, Kernel::AVX2, Kernel::NEON}) {
+        if (!DriveGuard::isSimdAvailable(kernel)) continue;
+        DriveGuard::LBPFeatureExtractor extractor(DriveGuard::LBPParams(), kernel);
+        std::vector<cv::Mat> histograms(samples.size());
+
+        t0 = BenchClock::now();
+        for (int it = 0; it < iterations; it++) {
+            for (std::size_t i = 0; i < samples.size(); i++) {
+                extractor.compute(samples[i], histograms[i]);
+            }
+        }
+        double us = elapsedUs(t0) / ((double)iterations * samples.size());
+
+        std::size_t mismatches = 0;
+        for (std::size_t i = 0; i < samples.size(); i++) {
+            const cv::Mat& a = histograms[i];
+            const cv::Mat& b = expected[i];
+            if (a.total() != b.total() || std::memcmp(a.ptr<float>(0), b.ptr<float>(0), a.total() * sizeof(float)) != 0) {
+                mismatches++;
+            }
+        }
+        allExact = allExact && mismatches == 0;
+
+        char exact[32];
+        std::snprintf(exact, sizeof(exact), mismatches == 0 ? "yes" : "NO (%zu)", mismatches);
+        std::printf("%-14s %12.2f %9.2fx %12s\n", DriveGuard::simdLevelName(kernel),
+                    us, referenceUs / us, exact);
+    }
+
+    // 模型文件互通：加载 OpenCV 保存的模型并比较预测结果
+    const std::string modelPath = "lbp_bench_model.yml";
+    reference->write(modelPath);
+    DriveGuard::FaceRecognizer recognizer;
+    bool loaded = recognizer.loadModel(modelPath);
+    std::remove(modelPath.c_str());
+    if (!loaded) return -1;
+
+    std::size_t labelMismatches = 0;
+    double maxDistanceDiff = 0.0;
+    for (std::size_t i = 0; i < samples.size(); i++) {
+        // 轻微扰动，避免查询与训练样本完全相同
+        cv::Mat query = samples[(i * 7 + 3) % samples.size()].clone();
+        query.at<unsigned char>((int)(i % query.rows), (int)(i % query.cols)) ^= 0x10;
+
+        int expectedLabel = -1;
+        double expectedDistance = 0.0;
+        reference->predict(query, expectedLabel, expectedDistance);
+
+        double distance = 0.0;
+        int label = recognizer.predict(query, distance);
+        if (label != expectedLabel) labelMismatches++;
+        maxDistanceDiff = std::max(maxDistanceDiff, std::abs(distance - expectedDistance));
+    }
+    std::printf("预测一致性: 标签不一致 %zu / %zu  最大距离差 %.3g\n", labelMismatches, samples.size(), maxDistanceDiff);
+
+    // 图库匹配：不同图库规模下单次查询耗时与内存占用
+    DriveGuard::LBPFeatureExtractor extractor;
+    int cellArea = extractor.cellArea(cv::Size(DriveGuard::FACE_SAMPLE_SIZE, DriveGuard::FACE_SAMPLE_SIZE));
+    cv::Mat query;
+    extractor.compute(samples.front(), query);
+
+    std::printf("%-8s %-10s %12s %12s %12s\n", "rows", "storage", "us/query", "MB", "top1");
+    for (std::size_t rows : {30, 300, 1200}) {
+        std::vector<cv::Mat> separate;
+        std::vector<int> rowLabels;
+        for (std::size_t i = 0; i < rows; i++) {
+            separate.push_back(expected[(i + 1) % expected.size()]);
+            rowLabels.push_back((int)(i / 30));
+        }
+
+        // 基线：逐个 cv::Mat 的 compareHist 循环（原 LBPH predict 的做法）
+        int baselineLabel = -1;
+        t0 = BenchClock::now();
+        for (int it = 0; it < iterations; it++) {
+            double best = DBL_MAX;
+            for (std::size_t i = 0; i < rows; i++) {
+                double distance = cv::compareHist(separate[i], query, cv::HISTCMP_CHISQR_ALT);
+                if (distance < best) {
+                    best = distance;
+                    baselineLabel = rowLabels[i];
+                }
+            }
+        }
+        double baselineUs = elapsedUs(t0) / iterations;
+        std::printf("%-8zu %-10s %12.1f %12.2f %12d\n", rows, "cv::Mat", baselineUs,
+                    rows * expected.front().total() * sizeof(float) / 1048576.0, baselineLabel);
+
+        using Precision = DriveGuard::GalleryPrecision;
+        for (Precision precision : {Precision::FLOAT32, Precision::UINT16, Precision::UINT8}) {
+            if (precision == Precision::UINT8 && DriveGuard::GalleryMatrix::precisionFor(cellArea) != Precision::UINT8) continue;
+            DriveGuard::GalleryMatrix gallery((int)query.total(), precision, cellArea);
+            gallery.reserve(rows);
+            for (std::size_t i = 0; i < rows; i++) gallery.append(separate[i], rowLabels[i]);
+
+            std::vector<double> distances;
+            std::vector<DriveGuard::GalleryMatch> matches;
+            t0 = BenchClock::now();
+            for (int it = 0; it < iterations; it++) {
+                gallery.match(query, 1, DBL_MAX, distances, matches);
+            }
+            double us = elapsedUs(t0) / iterations;
+            const char* name = precision == Precision::FLOAT32 ? "float32" : precision == Precision::UINT16 ? "uint16" : "uint8";
+            std::printf("%-8zu %-10s %12.1f %12.2f %12d\n", rows, name, us, gallery.bytes() / 1048576.0,
+                        matches.empty() ? -1 : matches.front().label);
+        }
+    }
+
+    return allExact && labelMismatches == 0 ? 0 : 1;
+}
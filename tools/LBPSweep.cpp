@@ -0,0 +1,302 @@
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "FrameContext.h"
+#include "GalleryMatrix.h"
+#include "LBPFeatureExtractor.h"
+
+// LBPH 参数扫描：在带标签的人脸数据集上，对 半径 x 邻域点数 x 网格 x 样本尺寸 的每种组合
+// 录入并预测（各组合并行），再按各个阈值统计识别正确率、误识率、单次预测耗时与图库大小，
+// 用于选择满足正确率要求的最快配置
+
+using BenchClock = std::chrono::steady_clock;
+
+static double elapsedMs(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+static void printUsage(const char* program) {
+    std::cout << "用法: " << program << " --dataset <目录> [选项]" << std::endl;
+    std::cout << "  --dataset <目录>    数据集目录，每个子目录为一个身份，其中为该身份的人脸图片" << std::endl;
+    std::cout << "  --enroll <N>        每个身份用于录入的图片数（按文件名排序取前 N 张，其余用于预测），默认 5" << std::endl;
+    std::cout << "  --unknown-every <N> 每 N 个身份取一个不录入，其图片全部作为未登记人员查询，<=0 不保留，默认 4" << std::endl;
+    std::cout << "  --radius <列表>     LBP 采样半径，默认 1,2" << std::endl;
+    std::cout << "  --neighbors <列表>  邻域采样点数（1~8），默认 4,8" << std::endl;
+    std::cout << "  --grid <列表>       网格数（水平与垂直相同），默认 4,6,8" << std::endl;
+    std::cout << "  --crop <列表>       人脸样本边长（像素），默认 64," << DriveGuard::FACE_SAMPLE_SIZE << std::endl;
+    std::cout << "  --thresholds <列表> 置信度阈值（距离低于该值即通过），默认 40,60,80,100,120" << std::endl;
+    std::cout << "  --target-accuracy <值> 推荐配置须达到的识别正确率，默认 0.95" << std::endl;
+    std::cout << "  --max-far <值>      推荐配置允许的最高误识率，默认 0.01" << std::endl;
+    std::cout << "  --threads <N>       并行线程数（OpenCV 线程池），1 为串行（预测耗时最稳定），默认全部核心" << std::endl;
+}
+
+/**
+ * @brief 解析逗号分隔的数值列表
+ */
+template <typename T>
+static bool parseList(const std::string& text, std::vector<T>& values) {
+    values.clear();
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        try {
+            values.push_back((T)std::stod(item));
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return !values.empty();
+}
+
+/**
+ * @brief 数据集：录入图片与查询图片（灰度原图，按各组合的样本尺寸缩放）
+ */
+struct Dataset {
+    std::vector<std::string> names;     // 身份名（子目录名）
+    std::vector<cv::Mat> enrollImages;
+    std::vector<int> enrollLabels;
+    std::vector<cv::Mat> queryImages;
+    std::vector<int> queryLabels;       // 未登记人员为 -1
+    std::size_t unknownQueries = 0;
+};
+
+/**
+ * @brief 读取数据集（子目录按名称排序后依次编号）
+ */
+static bool loadDataset(const std::string& dir, int enrollCount, int unknownEvery, Dataset& dataset) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    std::vector<fs::path> identities;
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        if (entry.is_directory()) identities.push_back(entry.path());
+    }
+    if (ec) {
+        std::cerr << "[ERROR] 无法读取数据集目录：" << dir << std::endl;
+        return false;
+    }
+    std::sort(identities.begin(), identities.end());
+
+    for (std::size_t id = 0; id < identities.size(); id++) {
+        std::vector<cv::String> files;
+        cv::glob(identities[id].string(), files, false);
+        std::sort(files.begin(), files.end());
+
+        std::vector<cv::Mat> images;
+        for (const auto& file : files) {
+            cv::Mat image = cv::imread(file, cv::IMREAD_GRAYSCALE);
+            if (!image.empty()) images.push_back(image);
+        }
+        if (images.empty()) continue;
+
+        bool unknown = unknownEvery > 0 && identities.size() > 1 && (int)(id % unknownEvery) == unknownEvery - 1;
+        int label = unknown ? -1 : (int)dataset.names.size();
+        if (!unknown) dataset.names.push_back(identities[id].filename().string());
+        for (std::size_t i = 0; i < images.size(); i++) {
+            if (!unknown && (int)i < enrollCount) {
+                dataset.enrollImages.push_back(images[i]);
+                dataset.enrollLabels.push_back(label);
+            } else {
+                dataset.queryImages.push_back(images[i]);
+                dataset.queryLabels.push_back(label);
+                if (unknown) dataset.unknownQueries++;
+            }
+        }
+    }
+
+    if (dataset.enrollImages.empty() || dataset.queryImages.empty()) {
+        std::cerr << "[ERROR] 数据集中没有可用于录入或预测的图片：" << dir << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 一种参数组合
+struct SweepConfig {
+    DriveGuard::LBPParams params;
+    int crop;
+};
+
+// 一种参数组合的预测结果（阈值在汇总时应用）
+struct SweepResult {
+    bool supported = false;
+    std::vector<int> labels;         // 各查询的最近身份（图库为空时为 -1）
+    std::vector<double> distances;   // 各查询的最近距离
+    double enrollMs = 0.0;           // 录入总耗时
+    double predictMs = 0.0;          // 单次预测平均耗时（缩放 + 特征提取 + 图库匹配）
+    std::size_t modelBytes = 0;      // 图库占用的内存
+};
+
+/**
+ * @brief 以一种参数组合录入并预测全部查询
+ */
+static void runConfig(const Dataset& dataset, const SweepConfig& config, SweepResult& result) {
+    if (!DriveGuard::LBPFeatureExtractor::isSupported(config.params)) return;
+
+    DriveGuard::LBPFeatureExtractor extractor(config.params);
+    const cv::Size sampleSize(config.crop, config.crop);
+    const int cellArea = extractor.cellArea(sampleSize);
+    if (cellArea <= 0) return;
+    DriveGuard::GalleryMatrix gallery(extractor.histogramSize(), DriveGuard::GalleryMatrix::precisionFor(cellArea), cellArea);
+
+    // 录入：与录入模式相同，样本先缩放为统一尺寸的灰度人脸
+    cv::Mat sample, histogram;
+    BenchClock::time_point t0 = BenchClock::now();
+    for (std::size_t i = 0; i < dataset.enrollImages.size(); i++) {
+        cv::resize(dataset.enrollImages[i], sample, sampleSize);
+        if (extractor.compute(sample, histogram)) gallery.append(histogram, dataset.enrollLabels[i]);
+    }
+    result.enrollMs = elapsedMs(t0);
+    result.modelBytes = gallery.bytes();
+
+    // 预测：最近邻，不设阈值（各阈值在汇总时应用）
+    result.labels.assign(dataset.queryImages.size(), -1);
+    result.distances.assign(dataset.queryImages.size(), DBL_MAX);
+    std::vector<double> buffer;
+    t0 = BenchClock::now();
+    for (std::size_t q = 0; q < dataset.queryImages.size(); q++) {
+        cv::resize(dataset.queryImages[q], sample, sampleSize);
+        DriveGuard::GalleryMatch match;
+        if (extractor.compute(sample, histogram) && gallery.nearest(histogram, DBL_MAX, buffer, match)) {
+            result.labels[q] = match.label;
+            result.distances[q] = match.distance;
+        }
+    }
+    result.predictMs = elapsedMs(t0) / dataset.queryImages.size();
+    result.supported = true;
+}
+
+int main(int argc, char* argv[]) {
+    std::string datasetDir;
+    int enrollCount = 5;
+    int unknownEvery = 4;
+    std::vector<int> radii{1, 2};
+    std::vector<int> neighbors{4, 8};
+    std::vector<int> grids{4, 6, 8};
+    std::vector<int> crops{64, DriveGuard::FACE_SAMPLE_SIZE};
+    std::vector<double> thresholds{40, 60, 80, 100, 120};
+    double targetAccuracy = 0.95;
+    double maxFar = 0.01;
+    int threads = -1;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool ok = true;
+        if (arg == "--dataset" && i + 1 < argc) datasetDir = argv[++i];
+        else if (arg == "--enroll" && i + 1 < argc) enrollCount = std::stoi(argv[++i]);
+        else if (arg == "--unknown-every" && i + 1 < argc) unknownEvery = std::stoi(argv[++i]);
+        else if (arg == "--radius" && i + 1 < argc) ok = parseList(argv[++i], radii);
+        else if (arg == "--neighbors" && i + 1 < argc) ok = parseList(argv[++i], neighbors);
+        else if (arg == "--grid" && i + 1 < argc) ok = parseList(argv[++i], grids);
+        else if (arg == "--crop" && i + 1 < argc) ok = parseList(argv[++i], crops);
+        else if (arg == "--thresholds" && i + 1 < argc) ok = parseList(argv[++i], thresholds);
+        else if (arg == "--target-accuracy" && i + 1 < argc) targetAccuracy = std::stod(argv[++i]);
+        else if (arg == "--max-far" && i + 1 < argc) maxFar = std::stod(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) threads = std::stoi(argv[++i]);
+        else ok = false;
+        if (!ok) {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : -1;
+        }
+    }
+    if (datasetDir.empty() || enrollCount < 1) {
+        printUsage(argv[0]);
+        return -1;
+    }
+
+    if (threads > 0) cv::setNumThreads(threads);
+
+    Dataset dataset;
+    if (!loadDataset(datasetDir, enrollCount, unknownEvery, dataset)) return -1;
+    std::sort(thresholds.begin(), thresholds.end());
+
+    std::vector<SweepConfig> configs;
+    for (int crop : crops) {
+        for (int grid : grids) {
+            for (int radius : radii) {
+                for (int n : neighbors) {
+                    DriveGuard::LBPParams params;
+                    params.radius = radius;
+                    params.neighbors = n;
+                    params.gridX = grid;
+                    params.gridY = grid;
+                    configs.push_back({params, crop});
+                }
+            }
+        }
+    }
+
+    // 各组合互不依赖，每个任务使用自己的特征提取器与图库
+    std::vector<SweepResult> results(configs.size());
+    BenchClock::time_point t0 = BenchClock::now();
+    cv::parallel_for_(cv::Range(0, (int)configs.size()), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; i++) runConfig(dataset, configs[i], results[i]);
+    });
+    double sweepMs = elapsedMs(t0);
+
+    const std::size_t knownQueries = dataset.queryImages.size() - dataset.unknownQueries;
+    std::cout << "===========================================" << std::endl;
+    std::printf("身份: %zu（另有未登记 %zu 张）  录入图片: %zu  查询图片: %zu  组合: %zu  总耗时: %.1f s\n",
+                dataset.names.size(), dataset.unknownQueries, dataset.enrollImages.size(), knownQueries,
+                configs.size(), sweepMs / 1000.0);
+    std::cout << "accuracy = 已登记查询中识别正确且通过阈值的比例；FAR = 全部查询中以错误身份通过阈值的比例" << std::endl;
+    std::printf("%-6s %-9s %-5s %-5s %9s %9s %8s %12s %10s\n",
+                "radius", "neighbors", "grid", "crop", "threshold", "accuracy", "FAR", "predict(ms)", "model KB");
+
+    const SweepResult* best = nullptr;
+    const SweepConfig* bestConfig = nullptr;
+    double bestThreshold = 0.0, bestAccuracy = 0.0, bestFar = 0.0;
+    for (std::size_t i = 0; i < configs.size(); i++) {
+        const SweepConfig& config = configs[i];
+        const SweepResult& result = results[i];
+        if (!result.supported) {
+            std::printf("%-6d %-9d %-5d %-5d  不支持的参数组合\n", config.params.radius, config.params.neighbors,
+                        config.params.gridX, config.crop);
+            continue;
+        }
+
+        for (double threshold : thresholds) {
+            std::size_t correct = 0, falseAccepts = 0;
+            for (std::size_t q = 0; q < dataset.queryImages.size(); q++) {
+                if (!(result.distances[q] < threshold)) continue;
+                if (result.labels[q] == dataset.queryLabels[q]) {
+                    correct++;
+                } else {
+                    falseAccepts++;
+                }
+            }
+            double accuracy = knownQueries > 0 ? (double)correct / knownQueries : 0.0;
+            double far = (double)falseAccepts / dataset.queryImages.size();
+            std::printf("%-6d %-9d %-5d %-5d %9.1f %8.1f%% %7.2f%% %12.3f %10.1f\n", config.params.radius,
+                        config.params.neighbors, config.params.gridX, config.crop, threshold, accuracy * 100.0,
+                        far * 100.0, result.predictMs, result.modelBytes / 1024.0);
+
+            // 满足要求的组合中取预测最快的一个
+            if (accuracy >= targetAccuracy && far <= maxFar && (!best || result.predictMs < best->predictMs)) {
+                best = &result;
+                bestConfig = &config;
+                bestThreshold = threshold;
+                bestAccuracy = accuracy;
+                bestFar = far;
+            }
+        }
+    }
+
+    std::cout << "===========================================" << std::endl;
+    if (!best) {
+        std::printf("没有组合同时满足 accuracy >= %.1f%% 且 FAR <= %.2f%%\n", targetAccuracy * 100.0, maxFar * 100.0);
+        return 1;
+    }
+    std::printf("推荐: radius %d  neighbors %d  grid %dx%d  crop %d  threshold %.1f"
+                "（accuracy %.1f%%  FAR %.2f%%  预测 %.3f ms  图库 %.1f KB）\n",
+                bestConfig->params.radius, bestConfig->params.neighbors, bestConfig->params.gridX,
+                bestConfig->params.gridY, bestConfig->crop, bestThreshold, bestAccuracy * 100.0, bestFar * 100.0,
+                best->predictMs, best->modelBytes / 1024.0);
+    return 0;
+}
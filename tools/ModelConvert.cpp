@@ -0,0 +1,112 @@
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <set>
+#include <string>
+#include "FaceRecognizer.h"
+#include "GalleryStore.h"
+
+// 识别模型转换工具：旧版 YAML 模型（face_rec.yml）与二进制图库（face_rec.dgm）互转，
+// 校验 label_to_name.txt 与模型标签是否对应，并对比两种格式的加载耗时；也可手动压缩二进制模型的日志段
+
+using ConvertClock = std::chrono::steady_clock;
+
+static double elapsedMs(ConvertClock::time_point start) {
+    return std::chrono::duration<double, std::milli>(ConvertClock::now() - start).count();
+}
+
+static void printUsage(const char* program) {
+    std::cout << "用法: " << program << " --input <模型> --output <模型> [--labels <映射表>]" << std::endl;
+    std::cout << "      " << program << " --compact <二进制模型>" << std::endl;
+    std::cout << "  --input <path>      输入模型（.yml/.yaml/.xml 为 YAML，其余为二进制）" << std::endl;
+    std::cout << "  --output <path>     输出模型（格式同样按扩展名区分）" << std::endl;
+    std::cout << "  --labels <path>     ID-Name 映射表，校验每个标签都有对应用户" << std::endl;
+    std::cout << "  --compact <path>    将二进制模型的日志段合并进基础段" << std::endl;
+}
+
+/**
+ * @brief 加载模型并返回耗时（毫秒），失败返回负数
+ */
+static double timedLoad(DriveGuard::FaceRecognizer& recognizer, const std::string& path) {
+    ConvertClock::time_point start = ConvertClock::now();
+    if (!recognizer.loadModel(path)) return -1.0;
+    return elapsedMs(start);
+}
+
+int main(int argc, char* argv[]) {
+    std::string input;
+    std::string output;
+    std::string labels;
+    std::string compact;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--input" && i + 1 < argc) input = argv[++i];
+        else if (arg == "--output" && i + 1 < argc) output = argv[++i];
+        else if (arg == "--labels" && i + 1 < argc) labels = argv[++i];
+        else if (arg == "--compact" && i + 1 < argc) compact = argv[++i];
+        else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : -1;
+        }
+    }
+
+    if (!compact.empty()) {
+        if (!DriveGuard::GalleryStore::isBinaryPath(compact) || !DriveGuard::GalleryStore::compact(compact)) {
+            std::cerr << "[ERROR] 日志压缩失败：" << compact << std::endl;
+            return -1;
+        }
+        std::cout << "[INFO] 日志压缩完成：" << compact << std::endl;
+        return 0;
+    }
+    if (input.empty() || output.empty() || input == output) {
+        printUsage(argv[0]);
+        return -1;
+    }
+
+    DriveGuard::FaceRecognizer recognizer;
+    double inputMs = timedLoad(recognizer, input);
+    if (inputMs < 0) return -1;
+    if (!recognizer.saveModel(output)) return -1;
+
+    // 校验映射表：模型中的每个标签都应有对应用户
+    const DriveGuard::GalleryMatrix& gallery = recognizer.gallery();
+    std::set<int> modelLabels(gallery.labels().begin(), gallery.labels().end());
+    if (!labels.empty()) {
+        if (!std::filesystem::exists(labels)) {
+            std::cerr << "[ERROR] 映射表不存在：" << labels << std::endl;
+            return -1;
+        }
+        if (!recognizer.loadLabelInfo(labels)) return -1;
+        std::size_t missing = 0;
+        for (int label : modelLabels) {
+            if (!recognizer.identities().contains(label)) {
+                std::cerr << "[WARN] 标签 " << label << " 在映射表中没有对应用户" << std::endl;
+                missing++;
+            }
+        }
+        if (missing == 0) std::cout << "[INFO] 映射表校验通过" << std::endl;
+    }
+
+    // 重新加载输出模型，确认样本与标签一致并对比加载耗时
+    DriveGuard::FaceRecognizer reloaded;
+    double outputMs = timedLoad(reloaded, output);
+    if (outputMs < 0) return -1;
+
+    bool identical = reloaded.gallery().rows() == gallery.rows() && reloaded.gallery().labels() == gallery.labels();
+    cv::Mat a, b;
+    for (std::size_t r = 0; identical && r < gallery.rows(); r++) {
+        gallery.histogram(r, a);
+        reloaded.gallery().histogram(r, b);
+        identical = cv::norm(a, b, cv::NORM_INF) == 0.0;
+    }
+    if (!identical) {
+        std::cerr << "[ERROR] 转换结果与输入模型不一致" << std::endl;
+        return -1;
+    }
+
+    std::cout << "[INFO] 已转换 " << gallery.rows() << " 个样本（" << modelLabels.size() << " 个身份）" << std::endl;
+    std::cout << "[INFO] 加载耗时：" << input << " " << inputMs << " ms，" << output << " " << outputMs << " ms" << std::endl;
+    return 0;
+}